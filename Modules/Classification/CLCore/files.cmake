@@ -4,7 +4,9 @@ set(CPP_FILES
   mitkConfigurationHolder.cpp
   mitkAbstractClassifier.cpp
   mitkAbstractGlobalImageFeature.cpp
+  mitkFeatureMatrixStore.cpp
   mitkIntensityQuantifier.cpp
+  mitkIntensityQuantifierCache.cpp
 )
 
 set( TOOL_FILES
@@ -30,6 +30,7 @@ See LICENSE.txt or http://www.mitk.org for details.
 
 // MITK includes
 #include <mitkConfigurationHolder.h>
+#include <mitkFeatureMatrixStore.h>
 
 namespace mitk
 {
@@ -53,6 +54,14 @@ public:
   ///
   virtual Eigen::MatrixXi Predict(const Eigen::MatrixXd &X) = 0;
 
+  ///
+  /// @brief Predict class for all samples of a feature store. The cases are read and predicted one after another,
+  /// thus only the features of one case are held in memory.
+  /// @param store, The input samples.
+  /// @return The predicted classes. Y matrix of shape = [n_samples, 1]
+  ///
+  virtual Eigen::MatrixXi PredictFromStore(const FeatureMatrixStore *store);
+
   ///
   /// @brief GetPointWiseWeightCopy
   /// @return return label matrix of shape = [n_samples , 1]
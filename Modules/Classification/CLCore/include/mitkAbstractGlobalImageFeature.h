@@ -26,6 +26,7 @@ See LICENSE.txt or http://www.mitk.org for details.
 #include <mitkCommandLineParser.h>
 
 #include <mitkIntensityQuantifier.h>
+#include <mitkIntensityQuantifierCache.h>
 
 // STD Includes
 
@@ -192,6 +193,11 @@ public:
   itkSetMacro(Quantifier, IntensityQuantifier::Pointer);
   itkGetMacro(Quantifier, IntensityQuantifier::Pointer);
 
+  /** If a cache is set, InitializeQuantifier takes the quantifier from the cache, so that
+  * feature classes with the same histogram configuration share it. See IntensityQuantifierCache.*/
+  itkSetMacro(QuantifierCache, IntensityQuantifierCache::Pointer);
+  itkGetMacro(QuantifierCache, IntensityQuantifierCache::Pointer);
+
   itkGetConstMacro(Direction, int);
 
   itkSetMacro(MinimumIntensity, double);
@@ -239,6 +245,9 @@ public:
   void InitializeQuantifier(const Image::Pointer & feature, const Image::Pointer &mask, unsigned int defaultBins = 256);
   std::string QuantifierParameterString();
 
+private:
+  void InitializeQuantifierInstance(IntensityQuantifier* quantifier, const Image::Pointer & feature, const Image::Pointer &mask, unsigned int defaultBins);
+
 public:
 
 //#ifndef DOXYGEN_SKIP
@@ -269,6 +278,7 @@ private:
 
   bool m_UseQuantifier = false;
   IntensityQuantifier::Pointer m_Quantifier;
+  IntensityQuantifierCache::Pointer m_QuantifierCache;
 
   double m_MinimumIntensity = 0;
   bool m_UseMinimumIntensity = false;
@@ -0,0 +1,119 @@
+/*===================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center,
+Division of Medical and Biological Informatics.
+All rights reserved.
+
+This software is distributed WITHOUT ANY WARRANTY; without
+even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE.
+
+See LICENSE.txt or http://www.mitk.org for details.
+
+===================================================================*/
+
+#ifndef mitkFeatureMatrixStore_h
+#define mitkFeatureMatrixStore_h
+
+#include <MitkCLCoreExports.h>
+
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include <itkObject.h>
+
+#include <mitkCommon.h>
+
+// Eigen
+#include <Eigen/Dense>
+
+namespace mitk
+{
+/**
+* \brief File based store for the sample features and labels of a classification task.
+*
+* The samples are written case by case (e.g. one patient after another), so the feature matrix of a cohort
+* never has to be held in memory while it is extracted. Every case is stored as one chunk:
+* the number of samples, the labels (int32) and the features (float32, column-major). Because the chunk
+* is column-major, the features can also be written one column (feature image) at a time (see BeginCase(),
+* WriteFeature() and EndCase()).
+*
+* Classifiers predict the samples of the store chunk by chunk (see AbstractClassifier::PredictFromStore()).
+*
+* The features are stored as float, thus values are rounded to single precision. The store is not
+* thread safe.
+*/
+class MITKCLCORE_EXPORT FeatureMatrixStore : public itk::Object
+{
+public:
+  mitkClassMacroItkParent(FeatureMatrixStore, itk::Object)
+  itkFactorylessNewMacro(Self)
+
+  /** Creates a new (empty) store file. An existing file is overwritten.*/
+  void Create(const std::string& fileName, unsigned int numberOfFeatures);
+
+  /** Opens an existing store file. Further cases can be appended.*/
+  void Open(const std::string& fileName);
+
+  void Close();
+  bool IsOpen() const;
+
+  /** Appends one case. X has the shape [n_samples, n_features], Y the shape [n_samples, 1].*/
+  void AppendCase(const Eigen::MatrixXd& X, const Eigen::MatrixXi& Y);
+
+  /** Starts a case with the passed labels (shape [n_samples, 1]). Each feature must be written
+  * with WriteFeature() before the case is finished by EndCase().*/
+  void BeginCase(const Eigen::MatrixXi& Y);
+  /** Writes one feature (column) of the current case. values has the shape [n_samples, 1].*/
+  void WriteFeature(unsigned int feature, const Eigen::MatrixXd& values);
+  void EndCase();
+
+  unsigned int GetNumberOfFeatures() const;
+  unsigned long GetNumberOfSamples() const;
+  unsigned int GetNumberOfCases() const;
+  unsigned long GetNumberOfSamples(unsigned int caseIndex) const;
+
+  /** Reads the features and labels of one case. Reading uses its own file stream and does not change the store.*/
+  void ReadCase(unsigned int caseIndex, Eigen::MatrixXd& X, Eigen::MatrixXi& Y) const;
+
+  /** Reads all cases into one matrix. The cases are read directly into X and Y, only one feature
+  * column of a case is buffered at a time.*/
+  void ReadAll(Eigen::MatrixXd& X, Eigen::MatrixXi& Y) const;
+
+protected:
+  FeatureMatrixStore();
+  ~FeatureMatrixStore() override;
+
+private:
+  struct CaseInfo
+  {
+    std::streamoff Offset;
+    unsigned long NumberOfSamples;
+  };
+
+  std::streamoff GetFeatureOffset(const CaseInfo& info, unsigned int feature) const;
+  void CheckOpen() const;
+
+  /** Opens a read-only stream on the store file.*/
+  void OpenForReading(std::ifstream& stream) const;
+  /** Reads one case into the rows starting at row of X and Y, which must be large enough.*/
+  void ReadCase(std::ifstream& stream, unsigned int caseIndex, Eigen::MatrixXd& X, Eigen::MatrixXi& Y, Eigen::Index row) const;
+
+  std::fstream m_Stream;
+  std::string m_FileName;
+  unsigned int m_NumberOfFeatures;
+  unsigned long m_NumberOfSamples;
+  std::vector<CaseInfo> m_Cases;
+
+  bool m_CaseIsOpen;
+  std::vector<bool> m_WrittenFeatures;
+
+  FeatureMatrixStore(const Self&) = delete;
+  Self& operator=(const Self&) = delete;
+};
+}
+
+#endif //mitkFeatureMatrixStore_h
@@ -0,0 +1,96 @@
+/*===================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center,
+Division of Medical and Biological Informatics.
+All rights reserved.
+
+This software is distributed WITHOUT ANY WARRANTY; without
+even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE.
+
+See LICENSE.txt or http://www.mitk.org for details.
+
+===================================================================*/
+
+#ifndef mitkIntensityQuantifierCache_h
+#define mitkIntensityQuantifierCache_h
+
+#include <MitkCLCoreExports.h>
+
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+
+#include <itkObject.h>
+
+#include <mitkCommon.h>
+#include <mitkImage.h>
+#include <mitkIntensityQuantifier.h>
+
+namespace mitk
+{
+/**
+* \brief Shares initialized IntensityQuantifier objects between several feature classes.
+*
+* Initializing a quantifier from an image (and mask) requires a complete pass over the image
+* to find the minimum and maximum intensities. If several feature classes use the same
+* histogram configuration on the same image, this pass is done only once if the features share
+* a cache (see AbstractGlobalImageFeature::SetQuantifierCache).
+*
+* Quantifiers are identified by the configuration (see AbstractGlobalImageFeature::QuantifierParameterString)
+* and the images they were initialized from. By default, an image is identified by its address and modification
+* time. Images that hold the same data (e.g. copies that are used by different threads) can be registered with
+* the same alias by RegisterImage(); they are then regarded as the same image.
+*
+* The cache is thread safe. The returned quantifiers must not be changed afterwards.
+*/
+class MITKCLCORE_EXPORT IntensityQuantifierCache : public itk::Object
+{
+public:
+  mitkClassMacroItkParent(IntensityQuantifierCache, itk::Object)
+  itkFactorylessNewMacro(Self)
+
+  typedef std::function<void(IntensityQuantifier*)> InitializerType;
+
+  /** Registers an alias for the passed image. All images with the same alias share their quantifiers.*/
+  void RegisterImage(const Image* image, const std::string& alias);
+
+  /** Returns the string that identifies the image in the keys of the cache.*/
+  std::string GetImageKey(const Image* image) const;
+
+  /** Returns the quantifier for the passed key. If it does not exist yet, a new quantifier is
+  * created and initialized by the passed initializer. Concurrent requests for the same key wait
+  * until the first one has initialized the quantifier.*/
+  IntensityQuantifier::Pointer GetQuantifier(const std::string& key, const InitializerType& initializer);
+
+  /** Number of quantifiers in the cache.*/
+  std::size_t GetNumberOfQuantifiers() const;
+
+  /** Removes all quantifiers and image aliases.*/
+  void Clear();
+
+protected:
+  IntensityQuantifierCache();
+  ~IntensityQuantifierCache() override;
+
+private:
+  struct CacheEntry
+  {
+    std::once_flag initialized;
+    IntensityQuantifier::Pointer quantifier;
+  };
+
+  mutable std::mutex m_Mutex;
+  std::map<std::string, std::shared_ptr<CacheEntry> > m_Entries;
+  std::map<const Image*, std::string> m_ImageAliases;
+
+  IntensityQuantifierCache(const Self& source);
+  void operator=(const Self&);  //purposely not implemented
+};
+}
+
+#endif //mitkIntensityQuantifierCache_h
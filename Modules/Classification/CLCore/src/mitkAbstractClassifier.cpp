@@ -15,6 +15,45 @@ See LICENSE.txt or http://www.mitk.org for details.
 ===================================================================*/
 
 #include <mitkAbstractClassifier.h>
+#include <mitkExceptionMacro.h>
+
+Eigen::MatrixXi mitk::AbstractClassifier::PredictFromStore(const FeatureMatrixStore *store)
+{
+  if (store == nullptr)
+  {
+    mitkThrow() << "Cannot predict. No feature store given.";
+  }
+
+  const long numberOfSamples = store->GetNumberOfSamples();
+  Eigen::MatrixXi labels(numberOfSamples, 1);
+  Eigen::MatrixXd probabilities;
+
+  Eigen::MatrixXd X;
+  Eigen::MatrixXi Y;
+  long row = 0;
+  bool hasProbabilities = true;
+  for (unsigned int caseIndex = 0; caseIndex < store->GetNumberOfCases(); ++caseIndex)
+  {
+    store->ReadCase(caseIndex, X, Y);
+    labels.middleRows(row, X.rows()) = this->Predict(X);
+
+    // Collect the probabilities if the classifier provided them for this case.
+    hasProbabilities = hasProbabilities && m_OutProbability.rows() == X.rows();
+    if (hasProbabilities)
+    {
+      if (probabilities.rows() != numberOfSamples)
+      {
+        probabilities = Eigen::MatrixXd::Zero(numberOfSamples, m_OutProbability.cols());
+      }
+      probabilities.middleRows(row, X.rows()) = m_OutProbability;
+    }
+    row += X.rows();
+  }
+
+  m_OutLabel = labels;
+  m_OutProbability = hasProbabilities ? probabilities : Eigen::MatrixXd();
+  return m_OutLabel;
+}
 
 
 void mitk::AbstractClassifier::SetNthItems(const char * val, unsigned int idx)
@@ -0,0 +1,335 @@
+/*===================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center,
+Division of Medical and Biological Informatics.
+All rights reserved.
+
+This software is distributed WITHOUT ANY WARRANTY; without
+even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE.
+
+See LICENSE.txt or http://www.mitk.org for details.
+
+===================================================================*/
+
+#include <mitkFeatureMatrixStore.h>
+
+#include <mitkExceptionMacro.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+
+namespace
+{
+  const char StoreMagic[8] = { 'M', 'I', 'T', 'K', 'F', 'M', 'S', '1' };
+  const std::streamoff HeaderSize = sizeof(StoreMagic) + sizeof(std::uint32_t);
+  const std::streamoff CaseHeaderSize = sizeof(std::uint64_t);
+}
+
+mitk::FeatureMatrixStore::FeatureMatrixStore()
+  : m_NumberOfFeatures(0),
+  m_NumberOfSamples(0),
+  m_CaseIsOpen(false)
+{
+}
+
+mitk::FeatureMatrixStore::~FeatureMatrixStore()
+{
+  if (m_Stream.is_open())
+  {
+    m_Stream.close();
+  }
+}
+
+void mitk::FeatureMatrixStore::Create(const std::string& fileName, unsigned int numberOfFeatures)
+{
+  this->Close();
+
+  m_Stream.open(fileName.c_str(), std::ios::in | std::ios::out | std::ios::binary | std::ios::trunc);
+  if (!m_Stream.is_open())
+  {
+    mitkThrow() << "Cannot create feature store. File could not be opened: " << fileName;
+  }
+
+  std::uint32_t features = numberOfFeatures;
+  m_Stream.write(StoreMagic, sizeof(StoreMagic));
+  m_Stream.write(reinterpret_cast<const char*>(&features), sizeof(features));
+
+  m_FileName = fileName;
+  m_NumberOfFeatures = numberOfFeatures;
+  this->Modified();
+}
+
+void mitk::FeatureMatrixStore::Open(const std::string& fileName)
+{
+  this->Close();
+
+  m_Stream.open(fileName.c_str(), std::ios::in | std::ios::out | std::ios::binary);
+  if (!m_Stream.is_open())
+  {
+    mitkThrow() << "Cannot open feature store. File could not be opened: " << fileName;
+  }
+
+  char magic[sizeof(StoreMagic)];
+  std::uint32_t features = 0;
+  m_Stream.read(magic, sizeof(magic));
+  m_Stream.read(reinterpret_cast<char*>(&features), sizeof(features));
+  if (!m_Stream || std::memcmp(magic, StoreMagic, sizeof(StoreMagic)) != 0)
+  {
+    m_Stream.close();
+    mitkThrow() << "Cannot open feature store. File is not a feature store: " << fileName;
+  }
+  m_FileName = fileName;
+  m_NumberOfFeatures = features;
+
+  m_Stream.seekg(0, std::ios::end);
+  const std::streamoff fileSize = m_Stream.tellg();
+
+  // Index the cases by skipping from one case header to the next.
+  std::streamoff offset = HeaderSize;
+  while (offset < fileSize)
+  {
+    std::uint64_t samples = 0;
+    m_Stream.seekg(offset);
+    m_Stream.read(reinterpret_cast<char*>(&samples), sizeof(samples));
+
+    CaseInfo info;
+    info.Offset = offset;
+    info.NumberOfSamples = samples;
+    const std::streamoff end = this->GetFeatureOffset(info, m_NumberOfFeatures);
+    if (!m_Stream || end > fileSize)
+    {
+      this->Close();
+      mitkThrow() << "Cannot open feature store. File is truncated: " << fileName;
+    }
+    m_Cases.push_back(info);
+    m_NumberOfSamples += samples;
+    offset = end;
+  }
+  this->Modified();
+}
+
+void mitk::FeatureMatrixStore::Close()
+{
+  if (m_Stream.is_open())
+  {
+    m_Stream.close();
+  }
+  m_Stream.clear();
+  m_FileName.clear();
+  m_NumberOfFeatures = 0;
+  m_NumberOfSamples = 0;
+  m_Cases.clear();
+  m_CaseIsOpen = false;
+  m_WrittenFeatures.clear();
+}
+
+bool mitk::FeatureMatrixStore::IsOpen() const
+{
+  return m_Stream.is_open();
+}
+
+void mitk::FeatureMatrixStore::AppendCase(const Eigen::MatrixXd& X, const Eigen::MatrixXi& Y)
+{
+  if (X.cols() != m_NumberOfFeatures)
+  {
+    mitkThrow() << "Cannot append case. Number of features (" << X.cols() << ") does not match the store (" << m_NumberOfFeatures << ").";
+  }
+  if (X.rows() != Y.rows())
+  {
+    mitkThrow() << "Cannot append case. Number of samples of features (" << X.rows() << ") and labels (" << Y.rows() << ") differ.";
+  }
+
+  this->BeginCase(Y);
+  for (unsigned int feature = 0; feature < m_NumberOfFeatures; ++feature)
+  {
+    this->WriteFeature(feature, X.col(feature));
+  }
+  this->EndCase();
+}
+
+void mitk::FeatureMatrixStore::BeginCase(const Eigen::MatrixXi& Y)
+{
+  this->CheckOpen();
+  if (m_CaseIsOpen)
+  {
+    mitkThrow() << "Cannot begin case. The previous case was not finished.";
+  }
+
+  CaseInfo info;
+  m_Stream.seekp(0, std::ios::end);
+  info.Offset = m_Stream.tellp();
+  info.NumberOfSamples = Y.rows();
+
+  std::uint64_t samples = info.NumberOfSamples;
+  std::vector<std::int32_t> labels(Y.rows());
+  for (Eigen::Index i = 0; i < Y.rows(); ++i)
+  {
+    labels[i] = Y(i, 0);
+  }
+  m_Stream.write(reinterpret_cast<const char*>(&samples), sizeof(samples));
+  m_Stream.write(reinterpret_cast<const char*>(labels.data()), labels.size() * sizeof(std::int32_t));
+  if (!m_Stream)
+  {
+    mitkThrow() << "Cannot begin case. Writing to the feature store failed: " << m_FileName;
+  }
+
+  m_Cases.push_back(info);
+  m_CaseIsOpen = true;
+  m_WrittenFeatures.assign(m_NumberOfFeatures, false);
+}
+
+void mitk::FeatureMatrixStore::WriteFeature(unsigned int feature, const Eigen::MatrixXd& values)
+{
+  if (!m_CaseIsOpen)
+  {
+    mitkThrow() << "Cannot write feature. No case was started.";
+  }
+  const CaseInfo& info = m_Cases.back();
+  if (feature >= m_NumberOfFeatures || static_cast<unsigned long>(values.rows()) != info.NumberOfSamples)
+  {
+    mitkThrow() << "Cannot write feature " << feature << ". The store has " << m_NumberOfFeatures
+                << " features and the case has " << info.NumberOfSamples << " samples, but " << values.rows() << " values are given.";
+  }
+
+  std::vector<float> buffer(info.NumberOfSamples);
+  for (unsigned long i = 0; i < info.NumberOfSamples; ++i)
+  {
+    buffer[i] = static_cast<float>(values(i, 0));
+  }
+  m_Stream.seekp(this->GetFeatureOffset(info, feature));
+  m_Stream.write(reinterpret_cast<const char*>(buffer.data()), buffer.size() * sizeof(float));
+  if (!m_Stream)
+  {
+    mitkThrow() << "Cannot write feature. Writing to the feature store failed: " << m_FileName;
+  }
+  m_WrittenFeatures[feature] = true;
+}
+
+void mitk::FeatureMatrixStore::EndCase()
+{
+  if (!m_CaseIsOpen)
+  {
+    mitkThrow() << "Cannot end case. No case was started.";
+  }
+  auto missing = std::find(m_WrittenFeatures.begin(), m_WrittenFeatures.end(), false);
+  if (missing != m_WrittenFeatures.end())
+  {
+    mitkThrow() << "Cannot end case. Feature " << (missing - m_WrittenFeatures.begin()) << " was not written.";
+  }
+
+  m_Stream.flush();
+  m_NumberOfSamples += m_Cases.back().NumberOfSamples;
+  m_CaseIsOpen = false;
+  this->Modified();
+}
+
+unsigned int mitk::FeatureMatrixStore::GetNumberOfFeatures() const
+{
+  return m_NumberOfFeatures;
+}
+
+unsigned long mitk::FeatureMatrixStore::GetNumberOfSamples() const
+{
+  return m_NumberOfSamples;
+}
+
+unsigned int mitk::FeatureMatrixStore::GetNumberOfCases() const
+{
+  return m_CaseIsOpen ? m_Cases.size() - 1 : m_Cases.size();
+}
+
+unsigned long mitk::FeatureMatrixStore::GetNumberOfSamples(unsigned int caseIndex) const
+{
+  if (caseIndex >= this->GetNumberOfCases())
+  {
+    mitkThrow() << "Invalid case index " << caseIndex << ". The store has " << this->GetNumberOfCases() << " cases.";
+  }
+  return m_Cases[caseIndex].NumberOfSamples;
+}
+
+void mitk::FeatureMatrixStore::ReadCase(unsigned int caseIndex, Eigen::MatrixXd& X, Eigen::MatrixXi& Y) const
+{
+  const unsigned long samples = this->GetNumberOfSamples(caseIndex);
+
+  std::ifstream stream;
+  this->OpenForReading(stream);
+
+  X.resize(samples, m_NumberOfFeatures);
+  Y.resize(samples, 1);
+  this->ReadCase(stream, caseIndex, X, Y, 0);
+}
+
+void mitk::FeatureMatrixStore::ReadAll(Eigen::MatrixXd& X, Eigen::MatrixXi& Y) const
+{
+  std::ifstream stream;
+  this->OpenForReading(stream);
+
+  X.resize(m_NumberOfSamples, m_NumberOfFeatures);
+  Y.resize(m_NumberOfSamples, 1);
+
+  Eigen::Index row = 0;
+  for (unsigned int caseIndex = 0; caseIndex < this->GetNumberOfCases(); ++caseIndex)
+  {
+    this->ReadCase(stream, caseIndex, X, Y, row);
+    row += m_Cases[caseIndex].NumberOfSamples;
+  }
+}
+
+void mitk::FeatureMatrixStore::OpenForReading(std::ifstream& stream) const
+{
+  this->CheckOpen();
+
+  stream.open(m_FileName.c_str(), std::ios::in | std::ios::binary);
+  if (!stream.is_open())
+  {
+    mitkThrow() << "Cannot read feature store. File could not be opened: " << m_FileName;
+  }
+}
+
+void mitk::FeatureMatrixStore::ReadCase(std::ifstream& stream, unsigned int caseIndex, Eigen::MatrixXd& X, Eigen::MatrixXi& Y, Eigen::Index row) const
+{
+  const CaseInfo& info = m_Cases[caseIndex];
+  const unsigned long samples = info.NumberOfSamples;
+
+  std::vector<std::int32_t> labels(samples);
+  stream.seekg(info.Offset + CaseHeaderSize);
+  stream.read(reinterpret_cast<char*>(labels.data()), labels.size() * sizeof(std::int32_t));
+  for (unsigned long i = 0; i < samples; ++i)
+  {
+    Y(row + i, 0) = labels[i];
+  }
+
+  // The features follow the labels column by column, so only one column is buffered.
+  std::vector<float> buffer(samples);
+  for (unsigned int feature = 0; feature < m_NumberOfFeatures; ++feature)
+  {
+    stream.read(reinterpret_cast<char*>(buffer.data()), buffer.size() * sizeof(float));
+    for (unsigned long i = 0; i < samples; ++i)
+    {
+      X(row + i, feature) = buffer[i];
+    }
+  }
+
+  if (!stream)
+  {
+    mitkThrow() << "Cannot read case " << caseIndex << " from feature store: " << m_FileName;
+  }
+}
+
+std::streamoff mitk::FeatureMatrixStore::GetFeatureOffset(const CaseInfo& info, unsigned int feature) const
+{
+  const std::streamoff samples = info.NumberOfSamples;
+  return info.Offset + CaseHeaderSize + samples * sizeof(std::int32_t) + static_cast<std::streamoff>(feature) * samples * sizeof(float);
+}
+
+void mitk::FeatureMatrixStore::CheckOpen() const
+{
+  if (!m_Stream.is_open())
+  {
+    mitkThrow() << "Feature store is not open.";
+  }
+}
@@ -0,0 +1,83 @@
+/*===================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center,
+Division of Medical and Biological Informatics.
+All rights reserved.
+
+This software is distributed WITHOUT ANY WARRANTY; without
+even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE.
+
+See LICENSE.txt or http://www.mitk.org for details.
+
+===================================================================*/
+
+#include <mitkIntensityQuantifierCache.h>
+
+#include <sstream>
+
+mitk::IntensityQuantifierCache::IntensityQuantifierCache()
+{
+}
+
+mitk::IntensityQuantifierCache::~IntensityQuantifierCache()
+{
+}
+
+void mitk::IntensityQuantifierCache::RegisterImage(const Image* image, const std::string& alias)
+{
+  std::lock_guard<std::mutex> lock(m_Mutex);
+  m_ImageAliases[image] = alias;
+}
+
+std::string mitk::IntensityQuantifierCache::GetImageKey(const Image* image) const
+{
+  if (image == nullptr)
+    return "None";
+
+  std::lock_guard<std::mutex> lock(m_Mutex);
+  auto alias = m_ImageAliases.find(image);
+  if (alias != m_ImageAliases.end())
+    return alias->second;
+
+  std::ostringstream ss;
+  ss << static_cast<const void*>(image) << "@" << image->GetMTime();
+  return ss.str();
+}
+
+mitk::IntensityQuantifier::Pointer mitk::IntensityQuantifierCache::GetQuantifier(const std::string& key, const InitializerType& initializer)
+{
+  std::shared_ptr<CacheEntry> entry;
+  {
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    auto& cEntry = m_Entries[key];
+    if (!cEntry)
+      cEntry = std::make_shared<CacheEntry>();
+    entry = cEntry;
+  }
+
+  // The initialization is done outside the lock, so that quantifiers with
+  // different keys can be initialized concurrently.
+  std::call_once(entry->initialized, [&entry, &initializer]()
+  {
+    auto quantifier = IntensityQuantifier::New();
+    initializer(quantifier);
+    entry->quantifier = quantifier;
+  });
+  return entry->quantifier;
+}
+
+std::size_t mitk::IntensityQuantifierCache::GetNumberOfQuantifiers() const
+{
+  std::lock_guard<std::mutex> lock(m_Mutex);
+  return m_Entries.size();
+}
+
+void mitk::IntensityQuantifierCache::Clear()
+{
+  std::lock_guard<std::mutex> lock(m_Mutex);
+  m_Entries.clear();
+  m_ImageAliases.clear();
+}
@@ -297,16 +297,18 @@ void mitk::LibSVMClassifier::ReadXValues(LibSVM::svm_problem * problem, LibSVM::
   problem->x = static_cast<LibSVM::svm_node **>(malloc(sizeof(LibSVM::svm_node *)  * noOfPoints));
   (*xSpace) = static_cast<LibSVM::svm_node *> (malloc(sizeof(LibSVM::svm_node) * noOfPoints * (features+1)));
 
+  // Each sample is terminated by index -1. The feature indices start at 1, as in Predict().
   for (int row = 0; row < noOfPoints; ++row)
   {
+    LibSVM::svm_node * sample = &((*xSpace)[row*(features+1)]);
     for (int col = 0; col < features; ++col)
     {
-      (*xSpace)[row*features + col].index = col;
-      (*xSpace)[row*features + col].value = X(row,col);
+      sample[col].index = col+1;
+      sample[col].value = X(row,col);
     }
-    (*xSpace)[row*features + features].index = -1;
+    sample[features].index = -1;
 
-    problem->x[row] = &((*xSpace)[row*features]);
+    problem->x[row] = sample;
   }
 }
 
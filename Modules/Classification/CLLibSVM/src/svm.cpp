@@ -119,7 +119,7 @@ static void info(const char *fmt,...) {}
 class Cache
 {
 public:
-  Cache(int l,long int size);
+  Cache(int l,long long size);
   ~Cache();
 
   // request data [0,len)
@@ -129,7 +129,7 @@ public:
   void swap_index(int i, int j);
 private:
   int l;
-  long int size;
+  long long size;
   struct head_t
   {
     head_t *prev, *next; // a circular list
@@ -143,12 +143,12 @@ private:
   void lru_insert(head_t *h);
 };
 
-Cache::Cache(int l_,long int size_):l(l_),size(size_)
+Cache::Cache(int l_,long long size_):l(l_),size(size_)
 {
   head = (head_t *)calloc(l,sizeof(head_t)); // initialized to 0
   size /= sizeof(Qfloat);
   size -= l * sizeof(head_t) / sizeof(Qfloat);
-  size = max(size, 2 * (long int) l); // cache must be large enough for two columns
+  size = max(size, 2 * (long long) l); // cache must be large enough for two columns
   lru_head.next = lru_head.prev = &lru_head;
 }
 
@@ -263,16 +263,25 @@ public:
   void swap_index(int i, int j) const override // no so const...
   {
     swap(x[i],x[j]);
+    if(x_dense) swap(x_dense[i],x_dense[j]);
     if(x_square) swap(x_square[i],x_square[j]);
   }
 protected:
 
   double (Kernel::*kernel_function)(int i, int j) const;
 
+  // rows of the Q matrix that are shorter are computed by a single thread
+  enum { min_parallel_len = 256 };
+
 private:
   const svm_node **x;
   double *x_square;
 
+  // dense copy of x, used if all samples have the features 1..n (no gaps)
+  const double **x_dense;
+  double *x_dense_space;
+  int dense_dim;
+
   // svm_parameter
   const int kernel_type;
   const int degree;
@@ -280,21 +289,26 @@ private:
   const double coef0;
 
   static double dot(const svm_node *px, const svm_node *py);
+  static double dense_dot(const double *px, const double *py, int n);
+  double dot(int i, int j) const
+  {
+    return x_dense ? dense_dot(x_dense[i],x_dense[j],dense_dim) : dot(x[i],x[j]);
+  }
   double kernel_linear(int i, int j) const
   {
-    return dot(x[i],x[j]);
+    return dot(i,j);
   }
   double kernel_poly(int i, int j) const
   {
-    return powi(gamma*dot(x[i],x[j])+coef0,degree);
+    return powi(gamma*dot(i,j)+coef0,degree);
   }
   double kernel_rbf(int i, int j) const
   {
-    return exp(-gamma*(x_square[i]+x_square[j]-2*dot(x[i],x[j])));
+    return exp(-gamma*(x_square[i]+x_square[j]-2*dot(i,j)));
   }
   double kernel_sigmoid(int i, int j) const
   {
-    return tanh(gamma*dot(x[i],x[j])+coef0);
+    return tanh(gamma*dot(i,j)+coef0);
   }
   double kernel_precomputed(int i, int j) const
   {
@@ -327,11 +341,42 @@ Kernel::Kernel(int l, svm_node * const * x_, const svm_parameter& param)
 
   clone(x,x_,l);
 
+  // Feature vectors of radiomics are dense. For those a plain array is
+  // used, which avoids the index comparisons of the sparse dot product.
+  x_dense = nullptr;
+  x_dense_space = nullptr;
+  dense_dim = 0;
+  bool is_dense = (kernel_type != PRECOMPUTED);
+  for(int i=0;i<l && is_dense;i++)
+  {
+    int k = 0;
+    while(x[i][k].index != -1 && x[i][k].index == k+1)
+      ++k;
+    is_dense = (x[i][k].index == -1);
+    dense_dim = max(dense_dim, k);
+  }
+  if(is_dense && l > 0)
+  {
+    x_dense = new const double*[l];
+    x_dense_space = new double[(size_t)l*dense_dim];
+    for(int i=0;i<l;i++)
+    {
+      double *row = x_dense_space + (size_t)i*dense_dim;
+      int k = 0;
+      for(;x[i][k].index != -1;k++)
+        row[k] = x[i][k].value;
+      for(;k<dense_dim;k++)
+        row[k] = 0;
+      x_dense[i] = row;
+    }
+  }
+
   if(kernel_type == RBF)
   {
     x_square = new double[l];
+#pragma omp parallel for schedule(static) if(l > min_parallel_len)
     for(int i=0;i<l;i++)
-      x_square[i] = dot(x[i],x[i]);
+      x_square[i] = dot(i,i);
   }
   else
     x_square = nullptr;
@@ -341,6 +386,25 @@ Kernel::~Kernel()
 {
   delete[] x;
   delete[] x_square;
+  delete[] x_dense;
+  delete[] x_dense_space;
+}
+
+double Kernel::dense_dot(const double *px, const double *py, int n)
+{
+  // independent partial sums, so the compiler can use vector instructions
+  double sum0 = 0, sum1 = 0, sum2 = 0, sum3 = 0;
+  int k = 0;
+  for(;k+4<=n;k+=4)
+  {
+    sum0 += px[k] * py[k];
+    sum1 += px[k+1] * py[k+1];
+    sum2 += px[k+2] * py[k+2];
+    sum3 += px[k+3] * py[k+3];
+  }
+  for(;k<n;k++)
+    sum0 += px[k] * py[k];
+  return (sum0 + sum1) + (sum2 + sum3);
 }
 
 double Kernel::dot(const svm_node *px, const svm_node *py)
@@ -1323,8 +1387,9 @@ public:
     :Kernel(prob.l, prob.x, param)
   {
     clone(y,y_,prob.l);
-    cache = new Cache(prob.l,(long int)(param.cache_size*(1<<20)));
+    cache = new Cache(prob.l,(long long)(param.cache_size*(1<<20)));
     QD = new double[prob.l];
+#pragma omp parallel for schedule(static) if(prob.l > min_parallel_len)
     for(int i=0;i<prob.l;i++)
       QD[i] = (this->*kernel_function)(i,i);
   }
@@ -1332,10 +1397,11 @@ public:
   Qfloat *get_Q(int i, int len) const override
   {
     Qfloat *data;
-    int start, j;
+    int start;
     if((start = cache->get_data(i,&data,len)) < len)
     {
-      for(j=start;j<len;j++)
+#pragma omp parallel for schedule(guided) if(len - start > min_parallel_len)
+      for(int j=start;j<len;j++)
         data[j] = (Qfloat)(y[i]*y[j]*(this->*kernel_function)(i,j));
     }
     return data;
@@ -1372,8 +1438,9 @@ public:
   ONE_CLASS_Q(const svm_problem& prob, const svm_parameter& param)
     :Kernel(prob.l, prob.x, param)
   {
-    cache = new Cache(prob.l,(long int)(param.cache_size*(1<<20)));
+    cache = new Cache(prob.l,(long long)(param.cache_size*(1<<20)));
     QD = new double[prob.l];
+#pragma omp parallel for schedule(static) if(prob.l > min_parallel_len)
     for(int i=0;i<prob.l;i++)
       QD[i] = (this->*kernel_function)(i,i);
   }
@@ -1381,10 +1448,11 @@ public:
   Qfloat *get_Q(int i, int len) const override
   {
     Qfloat *data;
-    int start, j;
+    int start;
     if((start = cache->get_data(i,&data,len)) < len)
     {
-      for(j=start;j<len;j++)
+#pragma omp parallel for schedule(guided) if(len - start > min_parallel_len)
+      for(int j=start;j<len;j++)
         data[j] = (Qfloat)(this->*kernel_function)(i,j);
     }
     return data;
@@ -1419,7 +1487,7 @@ public:
     :Kernel(prob.l, prob.x, param)
   {
     l = prob.l;
-    cache = new Cache(l,(long int)(param.cache_size*(1<<20)));
+    cache = new Cache(l,(long long)(param.cache_size*(1<<20)));
     QD = new double[2*l];
     sign = new schar[2*l];
     index = new int[2*l];
@@ -1450,8 +1518,9 @@ public:
     int j, real_i = index[i];
     if(cache->get_data(real_i,&data,l) < l)
     {
-      for(j=0;j<l;j++)
-        data[j] = (Qfloat)(this->*kernel_function)(real_i,j);
+#pragma omp parallel for schedule(guided) if(l > min_parallel_len)
+      for(int k=0;k<l;k++)
+        data[k] = (Qfloat)(this->*kernel_function)(real_i,k);
     }
 
     // reorder and copy
@@ -27,6 +27,9 @@ See LICENSE.txt or http://www.mitk.org for details.
 #include <itkCSVArray2DDataObject.h>
 #include <itkCSVNumericObjectFileWriter.h>
 
+#include <chrono>
+#include <random>
+
 //#include <boost/algorithm/string.hpp>
 
 class mitkLibSVMClassifierTestSuite : public mitk::TestFixture
@@ -34,6 +37,7 @@ class mitkLibSVMClassifierTestSuite : public mitk::TestFixture
   CPPUNIT_TEST_SUITE(mitkLibSVMClassifierTestSuite);
   MITK_TEST(TrainSVMClassifier_MatlabDataSet_shouldReturnTrue);
   MITK_TEST(TrainSVMClassifier_BreastCancerDataSet_shouldReturnTrue);
+  MITK_TEST(TrainSVMClassifier_SyntheticDataSet_shouldReturnTrue);
   CPPUNIT_TEST_SUITE_END();
 
 private:
@@ -306,6 +310,44 @@ public:
     MITK_TEST_CONDITION(isIntervall<int>(m_TestYPredict,classes,75,100),"Testvalue is in range.");
   }
 
+  /*
+  Train the classifier with a synthetic dataset of the size of a radiomics cohort
+  (two gaussian classes, which differ in the first features) and report the training time.
+  */
+  void TrainSVMClassifier_SyntheticDataSet_shouldReturnTrue()
+  {
+    const int numberOfSamples = 20000;
+    const int numberOfFeatures = 100;
+
+    std::mt19937 generator(42);
+    std::normal_distribution<double> distribution;
+    MatrixDoubleType X(numberOfSamples, numberOfFeatures);
+    MatrixIntType Y(numberOfSamples, 1);
+    for (int i = 0; i < numberOfSamples; ++i)
+    {
+      Y(i, 0) = i % 2;
+      for (int j = 0; j < numberOfFeatures; ++j)
+      {
+        X(i, j) = distribution(generator) + ((j < 5) ? (Y(i, 0) ? 0.7 : -0.7) : 0.0);
+      }
+    }
+
+    classifier = mitk::LibSVMClassifier::New();
+    classifier->SetGamma(1/(double)(numberOfFeatures));
+    classifier->SetSvmType(0);
+    classifier->SetKernelType(2);
+    classifier->SetCacheSize(500);
+
+    auto start = std::chrono::steady_clock::now();
+    classifier->Train(X.topRows(numberOfSamples / 2), Y.topRows(numberOfSamples / 2));
+    std::chrono::duration<double> trainingTime = std::chrono::steady_clock::now() - start;
+    Eigen::MatrixXi classes = classifier->Predict(X.bottomRows(numberOfSamples / 2));
+
+    MITK_INFO << "SVM training of " << numberOfSamples / 2 << " samples with " << numberOfFeatures
+              << " features: " << trainingTime.count() << " s";
+    MITK_TEST_CONDITION(isIntervall<int>(Y.bottomRows(numberOfSamples / 2), classes, 90, 100), "Testvalue is in range.");
+  }
+
   void TestThreadedDecisionForest()
   {
   }
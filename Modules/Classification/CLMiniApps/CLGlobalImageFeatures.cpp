@@ -25,6 +25,7 @@ See LICENSE.txt or http://www.mitk.org for details.
 
 #include <mitkSplitParameterToVector.h>
 #include <mitkGlobalImageFeaturesParameter.h>
+#include <mitkGlobalImageFeaturesEngine.h>
 
 #include <mitkGIFCooccurenceMatrix.h>
 #include <mitkGIFCooccurenceMatrix2.h>
@@ -52,6 +53,9 @@ See LICENSE.txt or http://www.mitk.org for details.
 
 #include <iostream>
 #include <locale>
+#include <mutex>
+
+#include <itksys/SystemTools.hxx>
 
 #include <itkImageDuplicator.h>
 #include <itkImageRegionIterator.h>
@@ -362,7 +366,115 @@ void SaveSliceOrImageAsPNG(mitk::Image::Pointer image, mitk::Image::Pointer mask
   }
 }
 
-int main(int argc, char* argv[])
+/** Brings image and mask into the same space and creates the mask without NaN voxels.
+* Returns false if the images do not match and cannot be corrected.*/
+static bool
+PrepareImages(const mitk::cl::GlobalImageFeaturesParameter& param, mitk::Image::Pointer& image, mitk::Image::Pointer& mask, mitk::Image::Pointer& maskNoNaN)
+{
+  if ((image->GetDimension() != mask->GetDimension()))
+  {
+    MITK_INFO << "Dimension of image does not match. ";
+    MITK_INFO << "Correct one image, may affect the result";
+    if (image->GetDimension() == 2)
+    {
+      mitk::Convert2Dto3DImageFilter::Pointer multiFilter2 = mitk::Convert2Dto3DImageFilter::New();
+      multiFilter2->SetInput(image);
+      multiFilter2->Update();
+      image = multiFilter2->GetOutput();
+    }
+    if (mask->GetDimension() == 2)
+    {
+      mitk::Convert2Dto3DImageFilter::Pointer multiFilter3 = mitk::Convert2Dto3DImageFilter::New();
+      multiFilter3->SetInput(mask);
+      multiFilter3->Update();
+      mask = multiFilter3->GetOutput();
+    }
+  }
+
+  if (param.resampleToFixIsotropic)
+  {
+    mitk::Image::Pointer newImage = mitk::Image::New();
+    AccessByItk_2(image, ResampleImage, param.resampleResolution, newImage);
+    image = newImage;
+  }
+  if ( ! mitk::Equal(mask->GetGeometry(0)->GetOrigin(), image->GetGeometry(0)->GetOrigin()))
+  {
+    MITK_INFO << "Not equal Origins";
+    if (param.ensureSameSpace)
+    {
+      MITK_INFO << "Warning!";
+      MITK_INFO << "The origin of the input image and the mask do not match. They are";
+      MITK_INFO << "now corrected. Please check to make sure that the images still match";
+      image->GetGeometry(0)->SetOrigin(mask->GetGeometry(0)->GetOrigin());
+    } else
+    {
+      return false;
+    }
+  }
+
+  if (param.resampleMask)
+  {
+    mitk::Image::Pointer newMaskImage = mitk::Image::New();
+    AccessByItk_2(mask, ResampleMask, image, newMaskImage);
+    mask = newMaskImage;
+  }
+
+  if ( ! mitk::Equal(mask->GetGeometry(0)->GetSpacing(), image->GetGeometry(0)->GetSpacing()))
+  {
+    MITK_INFO << "Not equal Spacing";
+    if (param.ensureSameSpace)
+    {
+      MITK_INFO << "Warning!";
+      MITK_INFO << "The spacing of the mask was set to match the spacing of the input image.";
+      MITK_INFO << "This might cause unintended spacing of the mask image";
+      image->GetGeometry(0)->SetSpacing(mask->GetGeometry(0)->GetSpacing());
+    } else
+    {
+      MITK_INFO << "The spacing of the mask and the input images is not equal.";
+      MITK_INFO << "Terminating the programm. You may use the '-fi' option";
+      return false;
+    }
+  }
+
+  MITK_INFO << "Start creating Mask without NaN";
+
+  maskNoNaN = mitk::Image::New();
+  AccessByItk_2(image, CreateNoNaNMask,  mask, maskNoNaN);
+  return true;
+}
+
+/** Reads the cases of a cohort file. Each line contains the path of the image and the mask,
+* optionally followed by the path of the morphological mask, separated by ';'.*/
+static std::vector<std::vector<std::string> >
+ReadCohortFile(const std::string& path)
+{
+  std::vector<std::vector<std::string> > cases;
+  std::ifstream file(path);
+  std::string line;
+  while (std::getline(file, line))
+  {
+    std::vector<std::string> paths;
+    std::stringstream ss(line);
+    std::string entry;
+    while (std::getline(ss, entry, ';'))
+    {
+      if (!entry.empty())
+        paths.push_back(entry);
+    }
+    if (paths.size() >= 2)
+    {
+      cases.push_back(paths);
+    }
+    else if (!paths.empty())
+    {
+      MITK_WARN << "Skipping invalid line of cohort file: " << line;
+    }
+  }
+  return cases;
+}
+
+static std::vector<mitk::AbstractGlobalImageFeature::Pointer>
+CreateFeatures()
 {
   // Commented : Updated to a common interface, include, if possible, mask is type unsigned short, uses Quantification, Comments
   //                                 Name follows standard scheme with Class Name::Feature Name
@@ -402,6 +514,42 @@ int main(int argc, char* argv[])
   features.push_back(ipCalculator.GetPointer());
   features.push_back(ngtdCalculator.GetPointer());
 
+  return features;
+}
+
+static void
+ConfigureFeatures(const std::vector<mitk::AbstractGlobalImageFeature::Pointer>& features,
+                  const mitk::cl::GlobalImageFeaturesParameter& param,
+                  const std::map<std::string, us::Any>& parsedArgs,
+                  int direction)
+{
+  for (auto cFeature : features)
+  {
+    if (param.defineGlobalMinimumIntensity)
+    {
+      cFeature->SetMinimumIntensity(param.globalMinimumIntensity);
+      cFeature->SetUseMinimumIntensity(true);
+    }
+    if (param.defineGlobalMaximumIntensity)
+    {
+      cFeature->SetMaximumIntensity(param.globalMaximumIntensity);
+      cFeature->SetUseMaximumIntensity(true);
+    }
+    if (param.defineGlobalNumberOfBins)
+    {
+      cFeature->SetBins(param.globalNumberOfBins);
+      MITK_INFO << param.globalNumberOfBins;
+    }
+    cFeature->SetParameter(parsedArgs);
+    cFeature->SetDirection(direction);
+    cFeature->SetEncodeParameters(param.encodeParameter);
+  }
+}
+
+int main(int argc, char* argv[])
+{
+  std::vector<mitk::AbstractGlobalImageFeature::Pointer> features = CreateFeatures();
+
   mitkCommandLineParser parser;
   parser.setArgumentPrefix("--", "-");
   mitk::cl::GlobalImageFeaturesParameter param;
@@ -418,6 +566,10 @@ int main(int argc, char* argv[])
   parser.addArgument("direction", "dir", mitkCommandLineParser::String, "Int", "Allows to specify the direction for Cooc and RL. 0: All directions, 1: Only single direction (Test purpose), 2,3,4... Without dimension 0,1,2... ", us::Any());
   parser.addArgument("slice-wise", "slice", mitkCommandLineParser::String, "Int", "Allows to specify if the image is processed slice-wise (number giving direction) ", us::Any());
   parser.addArgument("output-mode", "omode", mitkCommandLineParser::Int, "Int", "Defines if the results of an image / slice are written in a single row (0 , default) or column (1).");
+  parser.addArgument("threads", "threads", mitkCommandLineParser::Int, "Int", "Number of feature classes (or cohort cases) that are calculated concurrently. 0 uses all cores. Default is 1.", us::Any());
+  parser.addArgument("crop-to-mask", "crop", mitkCommandLineParser::Bool, "Bool", "Crops image and masks to the bounding box of the mask before the features are calculated. Changes features that describe the whole image.", us::Any());
+  parser.addArgument("crop-margin", "crop-margin", mitkCommandLineParser::Int, "Int", "Number of voxels that are kept around the bounding box of the mask if the images are cropped. Default is 2.", us::Any());
+  parser.addArgument("cohort", "cohort", mitkCommandLineParser::InputFile, "Cohort file", "Text file with additional cases (one 'image;mask[;morph-mask]' per line) that are processed after the given image by a pool of workers.", us::Any());
 
   // Miniapp Infos
   parser.setCategory("Classification Tools");
@@ -473,93 +625,24 @@ int main(int argc, char* argv[])
     morphMask = mitk::IOUtil::Load<mitk::Image>(param.morphPath);
   }
 
-  log << " Check for Dimensions -";
-  if ((image->GetDimension() != mask->GetDimension()))
-  {
-    MITK_INFO << "Dimension of image does not match. ";
-    MITK_INFO << "Correct one image, may affect the result";
-    if (image->GetDimension() == 2)
-    {
-      mitk::Convert2Dto3DImageFilter::Pointer multiFilter2 = mitk::Convert2Dto3DImageFilter::New();
-      multiFilter2->SetInput(tmpImage);
-      multiFilter2->Update();
-      image = multiFilter2->GetOutput();
-    }
-    if (mask->GetDimension() == 2)
-    {
-      mitk::Convert2Dto3DImageFilter::Pointer multiFilter3 = mitk::Convert2Dto3DImageFilter::New();
-      multiFilter3->SetInput(tmpMask);
-      multiFilter3->Update();
-      mask = multiFilter3->GetOutput();
-    }
-  }
-
   int writeDirection = 0;
   if (parsedArgs.count("output-mode"))
   {
     writeDirection = us::any_cast<int>(parsedArgs["output-mode"]);
   }
 
-  log << " Check for Resolution -";
-  if (param.resampleToFixIsotropic)
-  {
-    mitk::Image::Pointer newImage = mitk::Image::New();
-    AccessByItk_2(image, ResampleImage, param.resampleResolution, newImage);
-    image = newImage;
-  }
-  if ( ! mitk::Equal(mask->GetGeometry(0)->GetOrigin(), image->GetGeometry(0)->GetOrigin()))
-  {
-    MITK_INFO << "Not equal Origins";
-    if (param.ensureSameSpace)
-    {
-      MITK_INFO << "Warning!";
-      MITK_INFO << "The origin of the input image and the mask do not match. They are";
-      MITK_INFO << "now corrected. Please check to make sure that the images still match";
-      image->GetGeometry(0)->SetOrigin(mask->GetGeometry(0)->GetOrigin());
-    } else
-    {
-      return -1;
-    }
-  }
-
-  log << " Resample if required -";
-  if (param.resampleMask)
-  {
-    mitk::Image::Pointer newMaskImage = mitk::Image::New();
-    AccessByItk_2(mask, ResampleMask, image, newMaskImage);
-    mask = newMaskImage;
-  }
-
-  log << " Check for Equality -";
-  if ( ! mitk::Equal(mask->GetGeometry(0)->GetSpacing(), image->GetGeometry(0)->GetSpacing()))
-  {
-    MITK_INFO << "Not equal Spacing";
-    if (param.ensureSameSpace)
-    {
-      MITK_INFO << "Warning!";
-      MITK_INFO << "The spacing of the mask was set to match the spacing of the input image.";
-      MITK_INFO << "This might cause unintended spacing of the mask image";
-      image->GetGeometry(0)->SetSpacing(mask->GetGeometry(0)->GetSpacing());
-    } else
-    {
-      MITK_INFO << "The spacing of the mask and the input images is not equal.";
-      MITK_INFO << "Terminating the programm. You may use the '-fi' option";
-      return -1;
-    }
-  }
-
   int direction = 0;
   if (parsedArgs.count("direction"))
   {
     direction = mitk::cl::splitDouble(parsedArgs["direction"].ToString(), ';')[0];
   }
 
-  MITK_INFO << "Start creating Mask without NaN";
-
-  mitk::Image::Pointer maskNoNaN = mitk::Image::New();
-  AccessByItk_2(image, CreateNoNaNMask,  mask, maskNoNaN);
-  //CreateNoNaNMask(mask, image, maskNoNaN);
-
+  log << " Prepare images -";
+  mitk::Image::Pointer maskNoNaN;
+  if (!PrepareImages(param, image, mask, maskNoNaN))
+  {
+    return -1;
+  }
 
   bool sliceWise = false;
   int sliceDirection = 0;
@@ -582,26 +665,20 @@ int main(int argc, char* argv[])
   }
 
   log << " Configure features -";
-  for (auto cFeature : features)
+  ConfigureFeatures(features, param, parsedArgs, direction);
+
+  mitk::cl::GlobalImageFeaturesEngine engine;
+  if (parsedArgs.count("threads"))
   {
-    if (param.defineGlobalMinimumIntensity)
-    {
-      cFeature->SetMinimumIntensity(param.globalMinimumIntensity);
-      cFeature->SetUseMinimumIntensity(true);
-    }
-    if (param.defineGlobalMaximumIntensity)
-    {
-      cFeature->SetMaximumIntensity(param.globalMaximumIntensity);
-      cFeature->SetUseMaximumIntensity(true);
-    }
-    if (param.defineGlobalNumberOfBins)
-    {
-      cFeature->SetBins(param.globalNumberOfBins);
-      MITK_INFO << param.globalNumberOfBins;
-    }
-    cFeature->SetParameter(parsedArgs);
-    cFeature->SetDirection(direction);
-    cFeature->SetEncodeParameters(param.encodeParameter);
+    engine.SetNumberOfThreads(us::any_cast<int>(parsedArgs["threads"]));
+  }
+  if (parsedArgs.count("crop-to-mask"))
+  {
+    engine.SetCropToMask(us::any_cast<bool>(parsedArgs["crop-to-mask"]));
+  }
+  if (parsedArgs.count("crop-margin"))
+  {
+    engine.SetCropMargin(us::any_cast<int>(parsedArgs["crop-margin"]));
   }
 
   bool addDescription = parsedArgs.count("description");
@@ -668,15 +745,18 @@ int main(int argc, char* argv[])
       mitk::IOUtil::Save(cMask, param.analysisMaskPath);
     }
 
-    mitk::AbstractGlobalImageFeature::FeatureListType stats;
-
     for (auto cFeature : features)
     {
       log << " Calculating " << cFeature->GetFeatureClassName() << " -";
-      cFeature->SetMorphMask(cMorphMask);
-      cFeature->CalculateFeaturesUsingParameters(cImage, cMask, cMaskNoNaN, stats);
     }
 
+    mitk::cl::GlobalImageFeaturesEngine::CaseType inputs;
+    inputs.image = cImage;
+    inputs.mask = cMask;
+    inputs.maskNoNaN = cMaskNoNaN;
+    inputs.morphMask = cMorphMask;
+    mitk::AbstractGlobalImageFeature::FeatureListType stats = engine.Calculate(features, inputs);
+
     for (std::size_t i = 0; i < stats.size(); ++i)
     {
       std::cout << stats[i].first << " - " << stats[i].second << std::endl;
@@ -751,6 +831,59 @@ int main(int argc, char* argv[])
     writer.AddResult(description, currentSlice, statStd, param.useHeader, addDescription);
   }
 
+  if (parsedArgs.count("cohort"))
+  {
+    log << " Process Cohort -";
+    if (sliceWise)
+    {
+      MITK_WARN << "Slice-wise processing is not supported for cohorts. The cohort cases are processed as whole images.";
+    }
+
+    auto cohort = ReadCohortFile(parsedArgs["cohort"].ToString());
+    MITK_INFO << "Processing " << cohort.size() << " cohort cases";
+
+    // Reading is serialized, the preparation and the calculation run concurrently.
+    std::mutex loadMutex;
+    auto loader = [&](std::size_t index) -> mitk::cl::GlobalImageFeaturesEngine::CaseType
+    {
+      mitk::cl::GlobalImageFeaturesEngine::CaseType inputs;
+      {
+        std::lock_guard<std::mutex> lock(loadMutex);
+        inputs.image = mitk::IOUtil::Load<mitk::Image>(cohort[index][0]);
+        inputs.mask = mitk::IOUtil::Load<mitk::Image>(cohort[index][1]);
+        inputs.morphMask = (cohort[index].size() > 2) ? mitk::IOUtil::Load<mitk::Image>(cohort[index][2]) : inputs.mask;
+      }
+      if (!PrepareImages(param, inputs.image, inputs.mask, inputs.maskNoNaN))
+      {
+        mitkThrow() << "Image and mask do not match.";
+      }
+      return inputs;
+    };
+    auto factory = [&]()
+    {
+      auto caseFeatures = CreateFeatures();
+      ConfigureFeatures(caseFeatures, param, parsedArgs, direction);
+      return caseFeatures;
+    };
+
+    auto results = engine.CalculateCohort(factory, loader, cohort.size());
+    for (std::size_t i = 0; i < results.size(); ++i)
+    {
+      if (!results[i].valid)
+      {
+        MITK_WARN << "Could not process case " << cohort[i][0] << " / " << cohort[i][1] << ": " << results[i].errorMessage;
+        continue;
+      }
+
+      writer.AddSubjectInformation(MITK_REVISION);
+      writer.AddSubjectInformation(itksys::SystemTools::GetFilenamePath(cohort[i][0]));
+      writer.AddSubjectInformation(itksys::SystemTools::GetFilenameName(cohort[i][0]));
+      writer.AddSubjectInformation(itksys::SystemTools::GetFilenameName(cohort[i][1]));
+      writer.AddResult(description, currentSlice, results[i].features, param.useHeader, addDescription);
+      ++currentSlice;
+    }
+  }
+
   if (param.useLogfile)
   {
     log << "Finished calculation" << std::endl;
@@ -86,7 +86,8 @@ namespace itk
     * the given image's requested region, for a given set of offsets. That is, if
     * a given offset falls outside of the requested region (or outside the mask)
     * at a particular point, that distance/intensity pair will not be added to
-    * the matrix.
+    * the matrix. The runs are found with linear scans over a quantized copy of
+    * the bounding box of the mask (see mitk::GIFTextureBinVolume).
     *
     * The number of histogram bins on each axis can be set (defaults to 256). Also,
     * by default the histogram min and max corresponds to the largest and smallest
@@ -36,10 +36,10 @@ See LICENSE.txt or http://www.mitk.org for details.
 
 #include "itkEnhancedScalarImageToRunLengthMatrixFilter.h"
 
-#include "itkConstNeighborhoodIterator.h"
-#include "itkNeighborhood.h"
-#include "vnl/vnl_math.h"
 #include "itkMacro.h"
+#include "vnl/vnl_math.h"
+
+#include "mitkGIFTextureBinVolume.h"
 
 namespace itk
 {
@@ -168,187 +168,58 @@ namespace itk
 
       MeasurementVectorType run( output->GetMeasurementVectorSize() );
       typename HistogramType::IndexType hIndex;
+      typename HistogramType::IndexType distanceIndex;
+
+      // Quantize the requested region once. Pixels outside the mask, outside
+      // [min, max] or with invalid values are not part of any run.
+      const ImageType * maskImage = this->GetMaskImage();
+      const PixelType insidePixelValue = this->m_InsidePixelValue;
+      const PixelType minimum = this->m_Min;
+      const PixelType maximum = this->m_Max;
+      MeasurementVectorType binMeasurement( output->GetMeasurementVectorSize() );
+      binMeasurement[1] = this->m_MinDistance;
+
+      typedef mitk::GIFTextureBinVolume<ImageDimension> BinVolumeType;
+      BinVolumeType bins;
+      bins.Initialize( inputImage, maskImage, inputImage->GetRequestedRegion(),
+        [&]( PixelType value )
+        {
+          if ( value != value || value < minimum || value > maximum )
+          {
+            return BinVolumeType::InvalidBin();
+          }
+          binMeasurement[0] = value;
+          typename HistogramType::IndexType index;
+          if ( !output->GetIndex( binMeasurement, index ) )
+          {
+            return BinVolumeType::InvalidBin();
+          }
+          return static_cast<int>( index[0] );
+        },
+        [&]( PixelType maskValue ) { return maskValue == insidePixelValue; } );
 
-      // Iterate over all of those pixels and offsets, adding each
-      // distance/intensity pair to the histogram
-
-      typedef ConstNeighborhoodIterator<ImageType> NeighborhoodIteratorType;
-      typename NeighborhoodIteratorType::RadiusType radius;
-      radius.Fill( 1 );
-      NeighborhoodIteratorType neighborIt( radius,
-        inputImage, inputImage->GetRequestedRegion() );
-
-      // this temp image has the same dimension for each offset
-      // moving the allocation out of loop of offsets
-      // while keeping FillBuffer with boolean false in each loop
-      typedef Image<bool, ImageDimension> BoolImageType;
-      typename BoolImageType::Pointer alreadyVisitedImage = BoolImageType::New();
-      alreadyVisitedImage->CopyInformation( inputImage );
-      alreadyVisitedImage->SetRegions( inputImage->GetRequestedRegion() );
-      alreadyVisitedImage->Allocate();
-
+      typename BinVolumeType::RunCountMapType runs;
       typename OffsetVector::ConstIterator offsets;
       for( offsets = this->GetOffsets()->Begin();
         offsets != this->GetOffsets()->End(); offsets++ )
       {
-        alreadyVisitedImage->FillBuffer( false );
-
-        neighborIt.GoToBegin();
         OffsetType offset = offsets.Value();
-
         this->NormalizeOffsetDirection(offset);
+        itkDebugMacro("===> offset = " << offset << std::endl);
 
-        for( neighborIt.GoToBegin(); !neighborIt.IsAtEnd(); ++neighborIt )
+        bins.CountRuns( offset, runs );
+        for ( auto runCount : runs )
         {
-          const PixelType centerPixelIntensity = neighborIt.GetCenterPixel();
-          if (centerPixelIntensity != centerPixelIntensity) // Check for invalid values
-          {
-            continue;
-          }
-          IndexType centerIndex = neighborIt.GetIndex();
-          if( centerPixelIntensity < this->m_Min ||
-            centerPixelIntensity > this->m_Max ||
-            alreadyVisitedImage->GetPixel( centerIndex ) || ( this->GetMaskImage() &&
-            this->GetMaskImage()->GetPixel( centerIndex ) !=
-            this->m_InsidePixelValue ) )
-          {
-            continue; // don't put a pixel in the histogram if the value
-            // is out-of-bounds or is outside the mask.
-          }
-
-          itkDebugMacro("===> offset = " << offset << std::endl);
-
-          MeasurementType centerBinMin = this->GetOutput()->
-            GetBinMinFromValue( 0, centerPixelIntensity );
-          MeasurementType centerBinMax = this->GetOutput()->
-            GetBinMaxFromValue( 0, centerPixelIntensity );
-          MeasurementType lastBinMax = this->GetOutput()->
-            GetDimensionMaxs( 0 )[ this->GetOutput()->GetSize( 0 ) - 1 ];
-
-          PixelType pixelIntensity( NumericTraits<PixelType>::ZeroValue() );
-          IndexType index;
-
-          int steps = 0;
-          index = centerIndex + offset;
-          IndexType lastGoodIndex = centerIndex;
-          bool runLengthSegmentAlreadyVisited = false;
-
-          // Scan from the current pixel at index, following
-          // the direction of offset. Run length is computed as the
-          // length of continuous pixels whose pixel values are
-          // in the same bin.
-
-          while ( inputImage->GetRequestedRegion().IsInside(index) )
-          {
-            pixelIntensity = inputImage->GetPixel(index);
-            // For the same offset, each run length segment can
-            // only be visited once
-            if (alreadyVisitedImage->GetPixel( index ) )
-            {
-              runLengthSegmentAlreadyVisited = true;
-              break;
-            }
-            if (pixelIntensity != pixelIntensity)
-            {
-              break;
-            }
-
-
-            // Special attention paid to boundaries of bins.
-            // For the last bin,
-            // it is left close and right close (following the previous
-            // gerrit patch).
-            // For all
-            // other bins,
-            // the bin is left close and right open.
-
-            if ( pixelIntensity >= centerBinMin
-              && ( pixelIntensity < centerBinMax || ( pixelIntensity == centerBinMax && centerBinMax == lastBinMax ) )
-              && (!this->GetMaskImage() || this->GetMaskImage()->GetPixel(index) == this->m_InsidePixelValue))
-            {
-              alreadyVisitedImage->SetPixel( index, true );
-              lastGoodIndex = index;
-              index += offset;
-              steps++;
-            }
-            else
-            {
-              break;
-            }
-          }
-
-          if ( runLengthSegmentAlreadyVisited )
-          {
-            MITK_INFO << "Already visited 1 " << index;
-            continue;
-          }
-          IndexType lastGoodIndex2 = lastGoodIndex;
-          index = centerIndex - offset;
-          lastGoodIndex = centerIndex;
-          while ( inputImage->GetRequestedRegion().IsInside(index) )
-          {
-            pixelIntensity = inputImage->GetPixel(index);
-            if (pixelIntensity != pixelIntensity)
-            {
-              break;
-            }
-            if (alreadyVisitedImage->GetPixel( index ) )
-            {
-              if (pixelIntensity >= centerBinMin
-                && (pixelIntensity < centerBinMax || (pixelIntensity == centerBinMax && centerBinMax == lastBinMax)))
-              {
-                runLengthSegmentAlreadyVisited = true;
-              }
-              break;
-            }
-
-            if ( pixelIntensity >= centerBinMin
-              && ( pixelIntensity < centerBinMax || ( pixelIntensity == centerBinMax && centerBinMax == lastBinMax ) )
-              && (!this->GetMaskImage() || this->GetMaskImage()->GetPixel(index) == this->m_InsidePixelValue))
-            {
-              alreadyVisitedImage->SetPixel( index, true );
-              lastGoodIndex = index;
-              steps++;
-              index -= offset;
-            }
-            else
-              break;
-          }
-          if (runLengthSegmentAlreadyVisited)
-          {
-            MITK_INFO << "Already visited 2 " << index;
-            continue;
-          }
-          PointType centerPoint;
-          inputImage->TransformIndexToPhysicalPoint(
-            centerIndex, centerPoint );
-          PointType point;
-          inputImage->TransformIndexToPhysicalPoint( lastGoodIndex, point );
-          PointType point2;
-          inputImage->TransformIndexToPhysicalPoint( lastGoodIndex2, point2 );
-
-          run[0] = centerPixelIntensity;
-          run[1] = steps;
-          //run[1] = point.EuclideanDistanceTo( point2 );
+          // The distance of a run is the number of steps from its first to its last pixel.
+          run[0] = this->m_Min;
+          run[1] = runCount.first.second - 1;
 
           if( run[1] >= this->m_MinDistance && run[1] <= this->m_MaxDistance )
           {
-            output->GetIndex( run, hIndex );
-            output->IncreaseFrequencyOfIndex( hIndex, 1 );
-
-            itkDebugStatement(typename HistogramType::IndexType tempMeasurementIndex;)
-              itkDebugStatement(output->GetIndex(run,tempMeasurementIndex);)
-              itkDebugMacro( "centerIndex<->index: "
-              << static_cast<int>( centerPixelIntensity )
-              << "@"<< centerIndex
-              << "<->" << static_cast<int>( pixelIntensity ) << "@" << index
-              <<", Bin# " << tempMeasurementIndex
-              << ", Measurement: (" << run[0] << ", " << run[1] << ")"
-              << ", Center bin [" << this->GetOutput()->GetBinMinFromValue( 0, run[0] )
-              << "," << this->GetOutput()->GetBinMaxFromValue( 0, run[0] ) << "]"
-              << "~[" << this->GetOutput()->GetBinMinFromValue( 1, run[1] )
-              << "," << this->GetOutput()->GetBinMaxFromValue( 1, run[1] ) << "]"
-              << std::endl );
+            output->GetIndex( run, distanceIndex );
+            hIndex[0] = runCount.first.first;
+            hIndex[1] = distanceIndex[1];
+            output->IncreaseFrequencyOfIndex( hIndex, runCount.second );
           }
         }
       }
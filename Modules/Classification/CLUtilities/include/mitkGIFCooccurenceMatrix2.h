@@ -32,6 +32,9 @@ namespace mitk
   * standard value of these features. Both mehtods are calcuated by this filters and reported, distinguisehd by either
   * an "Overall" if a single matrix is used, a "Mean" for the mean Value, or an "Std.Dev." for the standard deviation.
   *
+  * The matrices of all directions are accumulated in a single (multi-threaded) pass over the bounding box of the mask,
+  * the image is quantized only once for this pass.
+  *
   * The connected areas are based on the binned image, the binning parameters can be set via the default
   * parameters as described in AbstractGlobalImageFeature. The intensity used for the calculation is
   * always equal to the bin number. It is also possible to determine the
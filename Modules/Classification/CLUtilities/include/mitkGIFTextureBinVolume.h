@@ -0,0 +1,422 @@
+/*===================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center,
+Division of Medical and Biological Informatics.
+All rights reserved.
+
+This software is distributed WITHOUT ANY WARRANTY; without
+even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE.
+
+See LICENSE.txt or http://www.mitk.org for details.
+
+===================================================================*/
+
+#ifndef mitkGIFTextureBinVolume_h
+#define mitkGIFTextureBinVolume_h
+
+#include <algorithm>
+#include <limits>
+#include <map>
+#include <utility>
+#include <vector>
+
+#include <itkImageRegion.h>
+#include <itkImageRegionConstIterator.h>
+#include <itkImageRegionConstIteratorWithIndex.h>
+#include <itkOffset.h>
+
+namespace mitk
+{
+  /** \class GIFTextureBinVolume
+   * \brief Quantized copy of the bounding box of a mask, shared by the run length, size zone and
+   * dependence matrix computations.
+   *
+   * Initialize() stores the bin of every voxel of the bounding box of the valid voxels in a flat buffer
+   * (first dimension is the fastest). Voxels that are not valid (outside the mask, NaN, out of range) get
+   * InvalidBin(). All texture matrices only relate valid voxels to each other, thus the voxels outside the
+   * bounding box never contribute and the box is all that is needed.
+   *
+   * Runs are found with linear scans over the buffer, zones with a union-find labeling that links only
+   * voxels of the same bin. Both are parallelized over slabs of the last dimension (OpenMP).*/
+  template <unsigned int VImageDimension>
+  class GIFTextureBinVolume
+  {
+  public:
+    typedef itk::ImageRegion<VImageDimension> RegionType;
+    typedef itk::Offset<VImageDimension> OffsetType;
+    typedef unsigned long SizeValueType;
+
+    /** Number of runs per (bin, run length).*/
+    typedef std::map<std::pair<int, SizeValueType>, SizeValueType> RunCountMapType;
+
+    struct ZoneType
+    {
+      int Bin;
+      SizeValueType Size;
+    };
+    typedef std::vector<ZoneType> ZoneVectorType;
+
+    static int InvalidBin() { return std::numeric_limits<int>::min(); }
+
+    GIFTextureBinVolume() : m_NumberOfVoxels(0)
+    {
+      for (unsigned int d = 0; d < VImageDimension; ++d)
+      {
+        m_Size[d] = 0;
+        m_Stride[d] = 0;
+      }
+    }
+
+    /** Quantizes the region of the image.
+     * @param image Image with the intensities.
+     * @param mask Optional mask; must cover the region of the image. May be null.
+     * @param region Region that should be analysed.
+     * @param binOf Functor that maps an intensity to its bin, or to InvalidBin() if the voxel should be ignored.
+     * @param isInMask Functor that returns true if a mask value marks a voxel of interest. Ignored if mask is null.*/
+    template <typename TImage, typename TMaskImage, typename TBinFunction, typename TMaskFunction>
+    void Initialize(const TImage* image, const TMaskImage* mask, const RegionType& region,
+                    TBinFunction binOf, TMaskFunction isInMask)
+    {
+      typedef itk::ImageRegionConstIteratorWithIndex<TImage> IndexIterType;
+      typedef itk::ImageRegionConstIterator<TImage> IterType;
+      typedef itk::ImageRegionConstIterator<TMaskImage> MaskIterType;
+
+      m_Bins.clear();
+      m_NumberOfVoxels = 0;
+
+      typename RegionType::IndexType lower, upper;
+      bool isEmpty = true;
+      IndexIterType boxIter(image, region);
+      MaskIterType boxMaskIter;
+      if (mask)
+      {
+        boxMaskIter = MaskIterType(mask, region);
+      }
+      while (!boxIter.IsAtEnd())
+      {
+        if ((!mask || isInMask(boxMaskIter.Get())) && binOf(boxIter.Get()) != InvalidBin())
+        {
+          auto index = boxIter.GetIndex();
+          for (unsigned int d = 0; d < VImageDimension; ++d)
+          {
+            lower[d] = isEmpty ? index[d] : std::min(lower[d], index[d]);
+            upper[d] = isEmpty ? index[d] : std::max(upper[d], index[d]);
+          }
+          isEmpty = false;
+        }
+        ++boxIter;
+        if (mask)
+        {
+          ++boxMaskIter;
+        }
+      }
+
+      if (isEmpty)
+      {
+        for (unsigned int d = 0; d < VImageDimension; ++d)
+        {
+          m_Size[d] = 0;
+          m_Stride[d] = 0;
+        }
+        return;
+      }
+
+      m_Region.SetIndex(lower);
+      for (unsigned int d = 0; d < VImageDimension; ++d)
+      {
+        m_Region.SetSize(d, upper[d] - lower[d] + 1);
+        m_Size[d] = m_Region.GetSize(d);
+        m_Stride[d] = (d == 0) ? 1 : m_Stride[d - 1] * m_Size[d - 1];
+      }
+      m_NumberOfVoxels = m_Region.GetNumberOfPixels();
+
+      m_Bins.resize(m_NumberOfVoxels);
+      IterType imageIter(image, m_Region);
+      MaskIterType maskIter;
+      if (mask)
+      {
+        maskIter = MaskIterType(mask, m_Region);
+      }
+      for (SizeValueType pos = 0; !imageIter.IsAtEnd(); ++pos, ++imageIter)
+      {
+        m_Bins[pos] = binOf(imageIter.Get());
+        if (mask)
+        {
+          if (!isInMask(maskIter.Get()))
+          {
+            m_Bins[pos] = InvalidBin();
+          }
+          ++maskIter;
+        }
+      }
+    }
+
+    /** Bounding box of the valid voxels in index space of the image.*/
+    const RegionType& GetRegion() const { return m_Region; }
+
+    /** Number of voxels of the bounding box; 0 if no voxel is valid.*/
+    SizeValueType GetNumberOfVoxels() const { return m_NumberOfVoxels; }
+
+    /** Bins of the bounding box, the first dimension is the fastest.*/
+    const std::vector<int>& GetBins() const { return m_Bins; }
+
+    /** Size of the bounding box in dimension d.*/
+    long GetSize(unsigned int d) const { return m_Size[d]; }
+
+    /** Linear distance of two neighbouring voxels in dimension d.*/
+    long GetStride(unsigned int d) const { return m_Stride[d]; }
+
+    /** Counts all maximal runs of valid voxels with equal bin along the offset.
+     * Runs along offset and -offset are the same, the sign of the offset is irrelevant.*/
+    void CountRuns(const OffsetType& offset, RunCountMapType& runs) const
+    {
+      runs.clear();
+
+      long linearOffset = 0;
+      bool isZero = true;
+      for (unsigned int d = 0; d < VImageDimension; ++d)
+      {
+        linearOffset += offset[d] * m_Stride[d];
+        isZero = isZero && offset[d] == 0;
+      }
+      if (m_NumberOfVoxels == 0 || isZero)
+      {
+        return;
+      }
+
+      // Walk the runs in the direction of increasing memory addresses, so a run
+      // is always found from its first voxel.
+      OffsetType step = offset;
+      if (linearOffset < 0)
+      {
+        for (unsigned int d = 0; d < VImageDimension; ++d)
+        {
+          step[d] = -offset[d];
+        }
+        linearOffset = -linearOffset;
+      }
+
+      const long numberOfSlabs = m_Size[VImageDimension - 1];
+      const long slabSize = m_Stride[VImageDimension - 1];
+
+#pragma omp parallel
+      {
+        RunCountMapType localRuns;
+
+#pragma omp for schedule(dynamic)
+        for (long slab = 0; slab < numberOfSlabs; ++slab)
+        {
+          long coordinate[VImageDimension];
+          for (long pos = slab * slabSize; pos < (slab + 1) * slabSize; ++pos)
+          {
+            const int bin = m_Bins[pos];
+            if (bin == InvalidBin())
+            {
+              continue;
+            }
+            this->ToCoordinate(pos, coordinate);
+            if (this->IsInside(coordinate, step, -1) && m_Bins[pos - linearOffset] == bin)
+            {
+              continue; // not the first voxel of its run
+            }
+
+            SizeValueType length = 1;
+            long next = pos;
+            long factor = 1;
+            while (this->IsInside(coordinate, step, factor) && m_Bins[next + linearOffset] == bin)
+            {
+              next += linearOffset;
+              ++length;
+              ++factor;
+            }
+            ++localRuns[std::make_pair(bin, length)];
+          }
+        }
+
+#pragma omp critical
+        {
+          for (auto run : localRuns)
+          {
+            runs[run.first] += run.second;
+          }
+        }
+      }
+    }
+
+    /** Labels all zones, i.e. connected sets of valid voxels with equal bin. Two voxels are connected
+     * if they differ by one of the passed offsets (or its negative).
+     * The zones are ordered by the position of their first voxel.*/
+    void LabelZones(const std::vector<OffsetType>& connectivity, ZoneVectorType& zones) const
+    {
+      zones.clear();
+      if (m_NumberOfVoxels == 0)
+      {
+        return;
+      }
+
+      // Each voxel is only linked to its neighbours at lower memory addresses.
+      std::vector<OffsetType> backward;
+      std::vector<long> linearBackward;
+      long maximumSlabDistance = 0;
+      for (auto offset : connectivity)
+      {
+        long linearOffset = 0;
+        for (unsigned int d = 0; d < VImageDimension; ++d)
+        {
+          linearOffset += offset[d] * m_Stride[d];
+        }
+        if (linearOffset == 0)
+        {
+          continue;
+        }
+        if (linearOffset > 0)
+        {
+          for (unsigned int d = 0; d < VImageDimension; ++d)
+          {
+            offset[d] = -offset[d];
+          }
+          linearOffset = -linearOffset;
+        }
+        backward.push_back(offset);
+        linearBackward.push_back(linearOffset);
+        maximumSlabDistance = std::max<long>(maximumSlabDistance, -offset[VImageDimension - 1]);
+      }
+
+      std::vector<SizeValueType> parents(m_NumberOfVoxels);
+      for (SizeValueType pos = 0; pos < m_NumberOfVoxels; ++pos)
+      {
+        parents[pos] = pos;
+      }
+
+      const long numberOfSlabs = m_Size[VImageDimension - 1];
+      const long slabSize = m_Stride[VImageDimension - 1];
+
+      // Label every slab on its own. A thread only touches voxels of its slab, because
+      // roots are always the voxel with the lowest address of a zone.
+#pragma omp parallel for schedule(dynamic)
+      for (long slab = 0; slab < numberOfSlabs; ++slab)
+      {
+        this->LinkSlab(slab * slabSize, (slab + 1) * slabSize, backward, linearBackward, slab, parents);
+      }
+
+      // Merge the zones that cross the borders of the slabs.
+      for (long slab = 1; slab < numberOfSlabs; ++slab)
+      {
+        const long end = std::min(slab + maximumSlabDistance, numberOfSlabs);
+        this->LinkSlab(slab * slabSize, end * slabSize, backward, linearBackward, -slab, parents);
+      }
+
+      // Every parent has a lower address, thus one ascending pass makes all voxels point to their root.
+      std::vector<SizeValueType> sizes(m_NumberOfVoxels, 0);
+      for (SizeValueType pos = 0; pos < m_NumberOfVoxels; ++pos)
+      {
+        if (m_Bins[pos] == InvalidBin())
+        {
+          continue;
+        }
+        parents[pos] = parents[parents[pos]];
+        ++sizes[parents[pos]];
+      }
+
+      for (SizeValueType pos = 0; pos < m_NumberOfVoxels; ++pos)
+      {
+        if (sizes[pos] > 0)
+        {
+          ZoneType zone;
+          zone.Bin = m_Bins[pos];
+          zone.Size = sizes[pos];
+          zones.push_back(zone);
+        }
+      }
+    }
+
+  private:
+    void ToCoordinate(long pos, long* coordinate) const
+    {
+      for (unsigned int d = 0; d < VImageDimension; ++d)
+      {
+        coordinate[d] = pos % m_Size[d];
+        pos /= m_Size[d];
+      }
+    }
+
+    bool IsInside(const long* coordinate, const OffsetType& offset, long factor) const
+    {
+      for (unsigned int d = 0; d < VImageDimension; ++d)
+      {
+        const long neighbour = coordinate[d] + factor * offset[d];
+        if (neighbour < 0 || neighbour >= m_Size[d])
+        {
+          return false;
+        }
+      }
+      return true;
+    }
+
+    static SizeValueType FindRoot(std::vector<SizeValueType>& parents, SizeValueType pos)
+    {
+      while (parents[pos] != pos)
+      {
+        parents[pos] = parents[parents[pos]];
+        pos = parents[pos];
+      }
+      return pos;
+    }
+
+    /** Links the voxels of [begin, end) to their backward neighbours with the same bin.
+     * If slab >= 0, only neighbours within this slab are linked; otherwise only neighbours in a slab
+     * before -slab (used to merge the borders of the slabs).*/
+    void LinkSlab(long begin, long end, const std::vector<OffsetType>& backward,
+                  const std::vector<long>& linearBackward, long slab, std::vector<SizeValueType>& parents) const
+    {
+      long coordinate[VImageDimension];
+      for (long pos = begin; pos < end; ++pos)
+      {
+        const int bin = m_Bins[pos];
+        if (bin == InvalidBin())
+        {
+          continue;
+        }
+        this->ToCoordinate(pos, coordinate);
+        for (std::size_t k = 0; k < backward.size(); ++k)
+        {
+          if (!this->IsInside(coordinate, backward[k], 1))
+          {
+            continue;
+          }
+          const long neighbourSlab = coordinate[VImageDimension - 1] + backward[k][VImageDimension - 1];
+          if ((slab >= 0 && neighbourSlab != slab) || (slab < 0 && neighbourSlab >= -slab))
+          {
+            continue;
+          }
+          const long neighbour = pos + linearBackward[k];
+          if (m_Bins[neighbour] != bin)
+          {
+            continue;
+          }
+          SizeValueType root = FindRoot(parents, pos);
+          SizeValueType neighbourRoot = FindRoot(parents, neighbour);
+          if (root < neighbourRoot)
+          {
+            parents[neighbourRoot] = root;
+          }
+          else if (neighbourRoot < root)
+          {
+            parents[root] = neighbourRoot;
+          }
+        }
+      }
+    }
+
+    RegionType m_Region;
+    long m_Size[VImageDimension];
+    long m_Stride[VImageDimension];
+    SizeValueType m_NumberOfVoxels;
+    std::vector<int> m_Bins;
+  };
+}
+
+#endif
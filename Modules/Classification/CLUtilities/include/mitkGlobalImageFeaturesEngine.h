@@ -0,0 +1,116 @@
+/*===================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center,
+Division of Medical and Biological Informatics.
+All rights reserved.
+
+This software is distributed WITHOUT ANY WARRANTY; without
+even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE.
+
+See LICENSE.txt or http://www.mitk.org for details.
+
+===================================================================*/
+
+#ifndef mitkGlobalImageFeaturesEngine_h
+#define mitkGlobalImageFeaturesEngine_h
+
+#include "MitkCLUtilitiesExports.h"
+
+#include <functional>
+#include <string>
+#include <vector>
+
+#include <mitkAbstractGlobalImageFeature.h>
+#include <mitkImage.h>
+
+namespace mitk
+{
+  namespace cl
+  {
+    /**
+    * \brief Executes a set of global image features on one image / mask combination or on a cohort.
+    *
+    * For a single case, the engine
+    * - optionally crops image and masks once to the bounding box of the mask (plus a margin), so
+    *   that all feature classes work on the small region instead of the whole image,
+    * - shares the initialized IntensityQuantifier objects between all feature classes with the same
+    *   histogram configuration (see mitk::IntensityQuantifierCache), and
+    * - calculates the feature classes concurrently. Each worker thread uses its own copy of the input
+    *   images, as the feature classes access the images by write accessors. The results are returned
+    *   in the order of the passed feature classes, thus they are identical to a sequential execution.
+    *
+    * For a cohort, a pool of worker threads processes the cases. Each worker uses its own feature instances
+    * (created by the passed factory) and calculates the feature classes of a case sequentially.
+    *
+    * Cropping is off by default, because features that describe the whole image (e.g. image description features
+    * or histograms that ignore the mask) change if the image is cropped. The margin has to cover the neighbourhood
+    * used by local features.
+    */
+    class MITKCLUTILITIES_EXPORT GlobalImageFeaturesEngine
+    {
+    public:
+      typedef mitk::AbstractGlobalImageFeature::FeatureListType FeatureListType;
+      typedef std::vector<mitk::AbstractGlobalImageFeature::Pointer> FeatureVectorType;
+      typedef std::function<FeatureVectorType()> FeatureFactoryType;
+
+      /** Input images of one case. maskNoNaN and morphMask are optional; if they are not set, mask is used.*/
+      struct CaseType
+      {
+        mitk::Image::Pointer image;
+        mitk::Image::Pointer mask;
+        mitk::Image::Pointer maskNoNaN;
+        mitk::Image::Pointer morphMask;
+      };
+      typedef std::function<CaseType(std::size_t)> CaseLoaderType;
+
+      struct CaseResultType
+      {
+        FeatureListType features;
+        bool valid = false;
+        std::string errorMessage;
+      };
+
+      GlobalImageFeaturesEngine();
+
+      /** Number of worker threads. 0 uses the number of available cores. Default is 1 (sequential execution).*/
+      void SetNumberOfThreads(unsigned int threads);
+      unsigned int GetNumberOfThreads() const;
+
+      void SetCropToMask(bool crop);
+      bool GetCropToMask() const;
+
+      /** Number of voxels that are added in each direction around the bounding box of the mask.*/
+      void SetCropMargin(unsigned int margin);
+      unsigned int GetCropMargin() const;
+
+      /** If true (default), all feature classes of a case share their intensity quantifiers.*/
+      void SetShareQuantifiers(bool share);
+      bool GetShareQuantifiers() const;
+
+      /** Calculates all passed feature classes for one case. The results are in the order of the features.*/
+      FeatureListType Calculate(const FeatureVectorType& features, const CaseType& inputs) const;
+
+      /** Calculates the features for numberOfCases cases. The cases are loaded by the loader, which is called
+      * concurrently by the worker threads. A case that could not be loaded or calculated is marked as
+      * not valid, the other cases are not affected. The results are in the order of the cases.*/
+      std::vector<CaseResultType> CalculateCohort(const FeatureFactoryType& featureFactory, const CaseLoaderType& loader, std::size_t numberOfCases) const;
+
+      /** Crops all images of the case to the bounding box of the mask plus the passed margin.
+      * If the mask contains no voxel, the case is not changed.*/
+      static CaseType CropToMask(const CaseType& inputs, unsigned int margin);
+
+    private:
+      unsigned int GetEffectiveNumberOfThreads(std::size_t numberOfTasks) const;
+
+      unsigned int m_NumberOfThreads;
+      bool m_CropToMask;
+      unsigned int m_CropMargin;
+      bool m_ShareQuantifiers;
+    };
+  }
+}
+
+#endif //mitkGlobalImageFeaturesEngine_h
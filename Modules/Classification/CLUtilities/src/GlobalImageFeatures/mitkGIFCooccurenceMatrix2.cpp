@@ -7,10 +7,12 @@
 
 // ITK
 #include <itkEnhancedScalarImageToTextureFeaturesFilter.h>
-#include <itkShapedNeighborhoodIterator.h>
+#include <itkNeighborhood.h>
 #include <itkImageRegionConstIterator.h>
+#include <itkImageRegionConstIteratorWithIndex.h>
 
 // STL
+#include <algorithm>
 #include <sstream>
 #include <cmath>
 
@@ -153,212 +155,248 @@ double mitk::CoocurenceMatrixHolder::IndexToMaxIntensity(int index)
 
 template<typename TPixel, unsigned int VImageDimension>
 void
-CalculateCoOcMatrix(itk::Image<TPixel, VImageDimension>* itkImage,
-                    itk::Image<unsigned short, VImageDimension>* mask,
-                    itk::Offset<VImageDimension> offset,
-                    int range,
-                    mitk::CoocurenceMatrixHolder &holder)
+CalculateCoOcMatrices(itk::Image<TPixel, VImageDimension>* itkImage,
+                      itk::Image<unsigned short, VImageDimension>* mask,
+                      const std::vector<itk::Offset<VImageDimension> > &offsets,
+                      std::vector<mitk::CoocurenceMatrixHolder> &holders)
 {
   typedef itk::Image<TPixel, VImageDimension> ImageType;
   typedef itk::Image<unsigned short, VImageDimension> MaskImageType;
-  typedef itk::ShapedNeighborhoodIterator<ImageType> ShapeIterType;
-  typedef itk::ShapedNeighborhoodIterator<MaskImageType> ShapeMaskIterType;
   typedef itk::ImageRegionConstIterator<ImageType> ConstIterType;
   typedef itk::ImageRegionConstIterator<MaskImageType> ConstMaskIterType;
+  typedef itk::ImageRegionConstIteratorWithIndex<MaskImageType> ConstMaskIndexIterType;
 
+  if (offsets.empty())
+    return;
 
-  itk::Size<VImageDimension> radius;
-  radius.Fill(range+1);
-  ShapeIterType imageOffsetIter(radius, itkImage, itkImage->GetLargestPossibleRegion());
-  ShapeMaskIterType maskOffsetIter(radius, mask, mask->GetLargestPossibleRegion());
-  imageOffsetIter.ActivateOffset(offset);
-  maskOffsetIter.ActivateOffset(offset);
-  ConstIterType imageIter(itkImage, itkImage->GetLargestPossibleRegion());
-  ConstMaskIterType maskIter(mask, mask->GetLargestPossibleRegion());
-  //  iterator.GetIndex() + ci.GetNeighborhoodOffset()
-  auto region = mask->GetLargestPossibleRegion();
-
-
-  while (!maskIter.IsAtEnd())
+  // Only pairs of two masked voxels are counted, thus the matrices depend only on
+  // the bounding box of the mask.
+  typename MaskImageType::IndexType lower, upper;
+  bool maskIsEmpty = true;
+  ConstMaskIndexIterType boxIter(mask, mask->GetLargestPossibleRegion());
+  while (!boxIter.IsAtEnd())
   {
-    auto ciMask = maskOffsetIter.Begin();
-    auto ciValue = imageOffsetIter.Begin();
-    if (maskIter.Value() > 0 &&
-      ciMask.Get() > 0 &&
-      imageIter.Get() == imageIter.Get() &&
-      ciValue.Get() == ciValue.Get() &&
-      region.IsInside(maskOffsetIter.GetIndex() + ciMask.GetNeighborhoodOffset()))
+    if (boxIter.Value() > 0)
     {
-      int i = holder.IntensityToIndex(imageIter.Get());
-      int j = holder.IntensityToIndex(ciValue.Get());
-      holder.m_Matrix(i, j) += 1;
-      holder.m_Matrix(j, i) += 1;
+      auto index = boxIter.GetIndex();
+      for (unsigned int d = 0; d < VImageDimension; ++d)
+      {
+        lower[d] = maskIsEmpty ? index[d] : std::min(lower[d], index[d]);
+        upper[d] = maskIsEmpty ? index[d] : std::max(upper[d], index[d]);
+      }
+      maskIsEmpty = false;
     }
-    ++imageOffsetIter;
-    ++maskOffsetIter;
-    ++imageIter;
-    ++maskIter;
+    ++boxIter;
   }
-}
-
-void CalculateFeatures(
-  mitk::CoocurenceMatrixHolder &holder,
-  mitk::CoocurenceMatrixFeatures & results
-  )
-{
-  auto pijMatrix = holder.m_Matrix;
-  auto piMatrix = holder.m_Matrix;
-  auto pjMatrix = holder.m_Matrix;
-  double Ng = holder.m_NumberOfBins;
-  int NgSize = holder.m_NumberOfBins;
-  pijMatrix /= pijMatrix.sum();
-  piMatrix.rowwise().normalize();
-  pjMatrix.colwise().normalize();
-
-  for (int i = 0; i < holder.m_NumberOfBins; ++i)
-    for (int j = 0; j < holder.m_NumberOfBins; ++j)
-    {
-      if (pijMatrix(i, j) != pijMatrix(i, j))
-        pijMatrix(i, j) = 0;
-      if (piMatrix(i, j) != piMatrix(i, j))
-        piMatrix(i, j) = 0;
-      if (pjMatrix(i, j) != pjMatrix(i, j))
-        pjMatrix(i, j) = 0;
-    }
+  if (maskIsEmpty)
+    return;
 
-  Eigen::VectorXd piVector = pijMatrix.colwise().sum();
-  Eigen::VectorXd pjVector = pijMatrix.rowwise().sum();
-  double sigmai = 0;;
-  for (int i = 0; i < holder.m_NumberOfBins; ++i)
+  typename MaskImageType::RegionType box;
+  box.SetIndex(lower);
+  for (unsigned int d = 0; d < VImageDimension; ++d)
   {
-    double iInt = i + 1;// holder.IndexToMeanIntensity(i);
-    results.RowAverage += iInt * piVector(i);
-    if (piVector(i) > 0)
-    {
-      results.RowEntropy -= piVector(i) * std::log(piVector(i)) / std::log(2);
-    }
+    box.SetSize(d, upper[d] - lower[d] + 1);
   }
-  for (int i = 0; i < holder.m_NumberOfBins; ++i)
+
+  // Quantize the box once. Voxels outside the mask or with NaN values get the bin -1.
+  const int numberOfBins = holders[0].m_NumberOfBins;
+  mitk::CoocurenceMatrixHolder binning = holders[0];
+  std::vector<int> bins(box.GetNumberOfPixels());
+  ConstIterType imageIter(itkImage, box);
+  ConstMaskIterType maskIter(mask, box);
+  for (std::size_t pos = 0; !maskIter.IsAtEnd(); ++pos, ++imageIter, ++maskIter)
   {
-    double iInt = i + 1; // holder.IndexToMeanIntensity(i);
-    results.RowVariance += (iInt - results.RowAverage)*(iInt - results.RowAverage) * piVector(i);
+    double value = imageIter.Get();
+    bins[pos] = (maskIter.Value() > 0 && value == value) ? binning.IntensityToIndex(value) : -1;
   }
-  results.RowMaximum = piVector.maxCoeff();
-  sigmai = std::sqrt(results.RowVariance);
-
-  Eigen::VectorXd pimj(NgSize);
-  pimj.fill(0);
-  Eigen::VectorXd pipj(2*NgSize);
-  pipj.fill(0);
 
+  // Linear offsets within the box, the first dimension is the fastest.
+  long size[VImageDimension];
+  long stride[VImageDimension];
+  long numberOfLines = 1;
+  for (unsigned int d = 0; d < VImageDimension; ++d)
+  {
+    size[d] = box.GetSize(d);
+    stride[d] = (d == 0) ? 1 : stride[d - 1] * size[d - 1];
+    if (d > 0)
+      numberOfLines *= size[d];
+  }
+  std::vector<long> linearOffsets(offsets.size(), 0);
+  for (std::size_t k = 0; k < offsets.size(); ++k)
+  {
+    for (unsigned int d = 0; d < VImageDimension; ++d)
+    {
+      linearOffsets[k] += offsets[k][d] * stride[d];
+    }
+  }
 
-  results.JointMaximum += pijMatrix.maxCoeff();
+  const std::size_t matrixSize = numberOfBins * numberOfBins;
+  std::vector<double> counts(offsets.size() * matrixSize, 0);
 
-  for (int i = 0; i < holder.m_NumberOfBins; ++i)
+  // All offsets are accumulated while a line of the box is traversed. Each thread
+  // counts into its own matrices, which are added afterwards.
+#pragma omp parallel
   {
-    for (int j = 0; j < holder.m_NumberOfBins; ++j)
+    std::vector<unsigned int> localCounts(offsets.size() * matrixSize, 0);
+
+#pragma omp for schedule(static)
+    for (long line = 0; line < numberOfLines; ++line)
     {
-      //double iInt = holder.IndexToMeanIntensity(i);
-      //double jInt = holder.IndexToMeanIntensity(j);
-      double iInt = i + 1;// holder.IndexToMeanIntensity(i);
-      double jInt = j + 1;// holder.IndexToMeanIntensity(j);
-      double pij = pijMatrix(i, j);
-
-      int deltaK = (i - j)>0?(i-j) : (j-i);
-      pimj(deltaK) += pij;
-      pipj(i + j) += pij;
-
-      results.JointAverage += iInt * pij;
-      if (pij > 0)
+      long coordinate[VImageDimension];
+      coordinate[0] = 0;
+      long remainder = line;
+      for (unsigned int d = 1; d < VImageDimension; ++d)
       {
-        results.JointEntropy -= pij * std::log(pij) / std::log(2);
-        results.FirstRowColumnEntropy -= pij * std::log(piVector(i)*pjVector(j)) / std::log(2);
+        coordinate[d] = remainder % size[d];
+        remainder /= size[d];
       }
-      if (piVector(i) > 0 && pjVector(j) > 0 )
+      const long lineStart = line * size[0];
+
+      for (std::size_t k = 0; k < offsets.size(); ++k)
       {
-        results.SecondRowColumnEntropy -= piVector(i)*pjVector(j) * std::log(piVector(i)*pjVector(j)) / std::log(2);
+        bool lineIsInside = true;
+        for (unsigned int d = 1; d < VImageDimension; ++d)
+        {
+          long neighbour = coordinate[d] + offsets[k][d];
+          lineIsInside = lineIsInside && neighbour >= 0 && neighbour < size[d];
+        }
+        if (!lineIsInside)
+          continue;
+
+        const long xStart = std::max<long>(0, -offsets[k][0]);
+        const long xEnd = std::min<long>(size[0], size[0] - offsets[k][0]);
+        const long neighbourStart = lineStart + linearOffsets[k];
+        unsigned int* matrix = localCounts.data() + k * matrixSize;
+        for (long x = xStart; x < xEnd; ++x)
+        {
+          const int i = bins[lineStart + x];
+          const int j = bins[neighbourStart + x];
+          if (i >= 0 && j >= 0)
+          {
+            ++matrix[i * numberOfBins + j];
+          }
+        }
       }
-      results.AngularSecondMoment += pij*pij;
-      results.Contrast += (iInt - jInt)* (iInt - jInt) * pij;
-      results.Dissimilarity += std::abs<double>(iInt - jInt) * pij;
-      results.InverseDifference += pij / (1 + (std::abs<double>(iInt - jInt)));
-      results.InverseDifferenceNormalised += pij / (1 + (std::abs<double>(iInt - jInt) / Ng));
-      results.InverseDifferenceMoment += pij / (1 + (iInt - jInt)*(iInt - jInt));
-      results.InverseDifferenceMomentNormalised += pij / (1 + (iInt - jInt)*(iInt - jInt)/Ng/Ng);
-      results.Autocorrelation += iInt*jInt * pij;
-      double cluster = (iInt + jInt - 2 * results.RowAverage);
-      results.ClusterTendency += cluster*cluster * pij;
-      results.ClusterShade += cluster*cluster*cluster * pij;
-      results.ClusterProminence += cluster*cluster*cluster*cluster * pij;
-      if (iInt != jInt)
+    }
+
+#pragma omp critical
+    {
+      for (std::size_t pos = 0; pos < counts.size(); ++pos)
       {
-        results.InverseVariance += pij / (iInt - jInt) / (iInt - jInt);
+        counts[pos] += localCounts[pos];
       }
     }
   }
-  results.Correlation = 1 / sigmai / sigmai * (-results.RowAverage*results.RowAverage+ results.Autocorrelation);
-  results.FirstMeasureOfInformationCorrelation = (results.JointEntropy - results.FirstRowColumnEntropy) / results.RowEntropy;
-  if (results.JointEntropy < results.SecondRowColumnEntropy)
+
+  // Every pair is counted in both orders.
+  for (std::size_t k = 0; k < offsets.size(); ++k)
   {
-    results.SecondMeasureOfInformationCorrelation = sqrt(1 - exp(-2 * (results.SecondRowColumnEntropy - results.JointEntropy)));
+    const double* matrix = counts.data() + k * matrixSize;
+    for (int i = 0; i < numberOfBins; ++i)
+    {
+      for (int j = 0; j < numberOfBins; ++j)
+      {
+        holders[k].m_Matrix(i, j) += matrix[i * numberOfBins + j] + matrix[j * numberOfBins + i];
+      }
+    }
   }
-  else
+}
+
+void CalculateFeatures(
+  mitk::CoocurenceMatrixHolder &holder,
+  mitk::CoocurenceMatrixFeatures & results
+  )
+{
+  const int NgSize = holder.m_NumberOfBins;
+  const double Ng = NgSize;
+  const double log2 = std::log(2);
+
+  Eigen::ArrayXXd pijMatrix = Eigen::ArrayXXd::Zero(NgSize, NgSize);
+  const double sum = holder.m_Matrix.sum();
+  if (sum > 0)
   {
-    results.SecondMeasureOfInformationCorrelation = 0;
+    pijMatrix = holder.m_Matrix.array() / sum;
   }
 
-  for (int i = 0; i < holder.m_NumberOfBins; ++i)
-  {
-    for (int j = 0; j < holder.m_NumberOfBins; ++j)
-    {
-      //double iInt = holder.IndexToMeanIntensity(i);
-      //double jInt = holder.IndexToMeanIntensity(j);
-      double iInt = i + 1;
-      double pij = pijMatrix(i, j);
+  // Intensities are given by the (one-based) bin index
+  Eigen::ArrayXd index = Eigen::ArrayXd::LinSpaced(NgSize, 1, Ng);
+  Eigen::ArrayXXd iInt = index.replicate(1, NgSize);
+  Eigen::ArrayXXd jInt = iInt.transpose();
+  Eigen::ArrayXXd difference = iInt - jInt;
+  Eigen::ArrayXXd absDifference = difference.abs();
+  Eigen::ArrayXXd squaredDifference = difference.square();
 
-      results.JointVariance += (iInt - results.JointAverage)* (iInt - results.JointAverage)*pij;
-    }
-  }
+  Eigen::ArrayXd piVector = pijMatrix.colwise().sum().transpose();
+  Eigen::ArrayXd pjVector = pijMatrix.rowwise().sum();
 
-  for (int k = 0; k < NgSize; ++k)
+  results.RowAverage = (index * piVector).sum();
+  results.RowEntropy = -(piVector > 0).select(piVector * piVector.log(), 0.0).sum() / log2;
+  results.RowVariance = ((index - results.RowAverage).square() * piVector).sum();
+  results.RowMaximum = piVector.maxCoeff();
+  double sigmai = std::sqrt(results.RowVariance);
+
+  // Diagonal (|i-j| = k) and anti-diagonal (i+j = k) sums
+  Eigen::VectorXd pimj(NgSize);
+  pimj.fill(0);
+  Eigen::VectorXd pipj(2*NgSize);
+  pipj.fill(0);
+  Eigen::MatrixXd pijAsMatrix = pijMatrix.matrix();
+  Eigen::MatrixXd pijReversed = pijAsMatrix.rowwise().reverse();
+  pimj(0) = pijAsMatrix.diagonal().sum();
+  for (int k = 1; k < NgSize; ++k)
   {
-    results.DifferenceAverage += k* pimj(k);
-    if (pimj(k) > 0)
-    {
-      results.DifferenceEntropy -= pimj(k) * log(pimj(k)) / std::log(2);
-    }
+    pimj(k) = pijAsMatrix.diagonal(k).sum() + pijAsMatrix.diagonal(-k).sum();
   }
-  for (int k = 0; k < NgSize; ++k)
+  for (int k = 0; k < 2 * NgSize - 1; ++k)
   {
-    results.DifferenceVariance += (results.DifferenceAverage-k)* (results.DifferenceAverage-k)*pimj(k);
+    pipj(k) = pijReversed.diagonal(NgSize - 1 - k).sum();
   }
 
+  Eigen::ArrayXXd marginalProduct = (piVector.matrix() * pjVector.matrix().transpose()).array();
+  Eigen::ArrayXXd cluster = iInt + jInt - 2 * results.RowAverage;
 
-  for (int k = 0; k <2* NgSize ; ++k)
+  results.JointMaximum += pijMatrix.maxCoeff();
+  results.JointAverage = (iInt * pijMatrix).sum();
+  results.JointEntropy = -(pijMatrix > 0).select(pijMatrix * pijMatrix.log(), 0.0).sum() / log2;
+  results.FirstRowColumnEntropy = -(pijMatrix > 0).select(pijMatrix * marginalProduct.log(), 0.0).sum() / log2;
+  results.SecondRowColumnEntropy = -(marginalProduct > 0).select(marginalProduct * marginalProduct.log(), 0.0).sum() / log2;
+  results.AngularSecondMoment = pijMatrix.square().sum();
+  results.Contrast = (squaredDifference * pijMatrix).sum();
+  results.Dissimilarity = (absDifference * pijMatrix).sum();
+  results.InverseDifference = (pijMatrix / (1 + absDifference)).sum();
+  results.InverseDifferenceNormalised = (pijMatrix / (1 + absDifference / Ng)).sum();
+  results.InverseDifferenceMoment = (pijMatrix / (1 + squaredDifference)).sum();
+  results.InverseDifferenceMomentNormalised = (pijMatrix / (1 + squaredDifference / Ng / Ng)).sum();
+  results.Autocorrelation = (iInt * jInt * pijMatrix).sum();
+  results.ClusterTendency = (cluster.square() * pijMatrix).sum();
+  results.ClusterShade = (cluster.cube() * pijMatrix).sum();
+  results.ClusterProminence = (cluster.square().square() * pijMatrix).sum();
+  results.InverseVariance = (squaredDifference > 0).select(pijMatrix / squaredDifference, 0.0).sum();
+
+  results.Correlation = 1 / sigmai / sigmai * (-results.RowAverage*results.RowAverage+ results.Autocorrelation);
+  results.FirstMeasureOfInformationCorrelation = (results.JointEntropy - results.FirstRowColumnEntropy) / results.RowEntropy;
+  if (results.JointEntropy < results.SecondRowColumnEntropy)
   {
-    results.SumAverage += (2+k)* pipj(k);
-    if (pipj(k) > 0)
-    {
-      results.SumEntropy -= pipj(k) * log(pipj(k)) / std::log(2);
-    }
+    results.SecondMeasureOfInformationCorrelation = sqrt(1 - exp(-2 * (results.SecondRowColumnEntropy - results.JointEntropy)));
   }
-  for (int k = 0; k < 2*NgSize; ++k)
+  else
   {
-    results.SumVariance += (2+k - results.SumAverage)* (2+k - results.SumAverage)*pipj(k);
+    results.SecondMeasureOfInformationCorrelation = 0;
   }
 
-  //MITK_INFO << std::endl << holder.m_Matrix;
-  //MITK_INFO << std::endl << pijMatrix;
-  //MITK_INFO << std::endl << piMatrix;
-  //MITK_INFO << std::endl << pjMatrix;
+  results.JointVariance = ((iInt - results.JointAverage).square() * pijMatrix).sum();
 
-  //for (int i = 0; i < holder.m_NumberOfBins; ++i)
-  //{
-  //  MITK_INFO << "Bin " << i << " Min: " << holder.IndexToMinIntensity(i) << " Max: " << holder.IndexToMaxIntensity(i);
-  //}
-  //MITK_INFO << pimj;
-  //MITK_INFO << pipj;
+  Eigen::ArrayXd differenceIndex = Eigen::ArrayXd::LinSpaced(NgSize, 0, Ng - 1);
+  Eigen::ArrayXd pimjArray = pimj.array();
+  results.DifferenceAverage = (differenceIndex * pimjArray).sum();
+  results.DifferenceEntropy = -(pimjArray > 0).select(pimjArray * pimjArray.log(), 0.0).sum() / log2;
+  results.DifferenceVariance = ((results.DifferenceAverage - differenceIndex).square() * pimjArray).sum();
 
+  Eigen::ArrayXd sumIndex = Eigen::ArrayXd::LinSpaced(2 * NgSize, 2, 2 * Ng + 1);
+  Eigen::ArrayXd pipjArray = pipj.array();
+  results.SumAverage = (sumIndex * pipjArray).sum();
+  results.SumEntropy = -(pipjArray > 0).select(pipjArray * pipjArray.log(), 0.0).sum() / log2;
+  results.SumVariance = ((sumIndex - results.SumAverage).square() * pipjArray).sum();
 }
 
 template<typename TPixel, unsigned int VImageDimension>
@@ -411,6 +449,8 @@ CalculateCoocurenceFeatures(itk::Image<TPixel, VImageDimension>* itkImage, mitk:
   std::vector<mitk::CoocurenceMatrixFeatures> resultVector;
   mitk::CoocurenceMatrixHolder holderOverall(rangeMin, rangeMax, numberOfBins);
   mitk::CoocurenceMatrixFeatures overallFeature;
+
+  std::vector<itk::Offset<VImageDimension> > usedOffsets;
   for (std::size_t i = 0; i < offsetVector.size(); ++i)
   {
     if (config.direction > 1)
@@ -420,12 +460,14 @@ CalculateCoocurenceFeatures(itk::Image<TPixel, VImageDimension>* itkImage, mitk:
         continue;
       }
     }
+    usedOffsets.push_back(offsetVector[i]);
+  }
 
-
-    offset = offsetVector[i];
-    mitk::CoocurenceMatrixHolder holder(rangeMin, rangeMax, numberOfBins);
+  std::vector<mitk::CoocurenceMatrixHolder> holders(usedOffsets.size(), holderOverall);
+  CalculateCoOcMatrices<TPixel, VImageDimension>(itkImage, maskImage, usedOffsets, holders);
+  for (auto &holder : holders)
+  {
     mitk::CoocurenceMatrixFeatures coocResults;
-    CalculateCoOcMatrix<TPixel, VImageDimension>(itkImage, maskImage, offset, config.range, holder);
     holderOverall.m_Matrix += holder.m_Matrix;
     CalculateFeatures(holder, coocResults);
     resultVector.push_back(coocResults);
@@ -5,8 +5,10 @@
 #include <mitkImageCast.h>
 #include <mitkImageAccessByItk.h>
 
+#include <mitkGIFTextureBinVolume.h>
+
 // ITK
-#include <itkImageRegionIteratorWithIndex.h>
+#include <itkNeighborhood.h>
 
 // STL
 
@@ -114,86 +116,37 @@ double mitk::GreyLevelSizeZoneMatrixHolder::IndexToMaxIntensity(int index)
 }
 
 template<typename TPixel, unsigned int VImageDimension>
+static void
+CalculateGlSZones(itk::Image<TPixel, VImageDimension>* itkImage,
+                  itk::Image<unsigned short, VImageDimension>* mask,
+                  const std::vector<itk::Offset<VImageDimension> > &offsets,
+                  mitk::GreyLevelSizeZoneMatrixHolder &binning,
+                  typename mitk::GIFTextureBinVolume<VImageDimension>::ZoneVectorType &zones)
+{
+  typedef mitk::GIFTextureBinVolume<VImageDimension> BinVolumeType;
+
+  BinVolumeType bins;
+  bins.Initialize(itkImage, mask, mask->GetLargestPossibleRegion(),
+    [&binning](TPixel value) { return (value == value) ? binning.IntensityToIndex(value) : BinVolumeType::InvalidBin(); },
+    [](unsigned short maskValue) { return maskValue > 0; });
+  bins.LabelZones(offsets, zones);
+}
+
+template<unsigned int VImageDimension>
 static int
-CalculateGlSZMatrix(itk::Image<TPixel, VImageDimension>* itkImage,
-                    itk::Image<unsigned short, VImageDimension>* mask,
-                    std::vector<itk::Offset<VImageDimension> > offsets,
+CalculateGlSZMatrix(const typename mitk::GIFTextureBinVolume<VImageDimension>::ZoneVectorType &zones,
                     bool estimateLargestRegion,
                     mitk::GreyLevelSizeZoneMatrixHolder &holder)
 {
-  typedef itk::Image<TPixel, VImageDimension> ImageType;
-  typedef itk::Image<unsigned short, VImageDimension> MaskImageType;
-  typedef typename ImageType::IndexType IndexType;
-
-  typedef itk::ImageRegionIteratorWithIndex<ImageType> ConstIterType;
-  typedef itk::ImageRegionIteratorWithIndex<MaskImageType> ConstMaskIterType;
-
-  auto region = mask->GetLargestPossibleRegion();
-  typename MaskImageType::RegionType newRegion;
-  newRegion.SetSize(region.GetSize());
-  newRegion.SetIndex(region.GetIndex());
-
-  ConstIterType imageIter(itkImage, itkImage->GetLargestPossibleRegion());
-  ConstMaskIterType maskIter(mask, mask->GetLargestPossibleRegion());
-
-  typename MaskImageType::Pointer visitedImage = MaskImageType::New();
-  visitedImage->SetRegions(newRegion);
-  visitedImage->Allocate();
-  visitedImage->FillBuffer(0);
-
   int largestRegion = 0;
-
-  while (!maskIter.IsAtEnd())
+  for (auto zone : zones)
   {
-    if (maskIter.Value() > 0 )
+    largestRegion = std::max<int>(zone.Size, largestRegion);
+    if (!estimateLargestRegion)
     {
-      auto startIntensityIndex = holder.IntensityToIndex(imageIter.Value());
-      std::vector<IndexType> indices;
-      indices.push_back(maskIter.GetIndex());
-      unsigned int steps = 0;
-
-      while (indices.size() > 0)
-      {
-        auto currentIndex = indices.back();
-        indices.pop_back();
-
-        if (!region.IsInside(currentIndex))
-        {
-          continue;
-        }
-
-        auto wasVisited = visitedImage->GetPixel(currentIndex);
-        auto newIntensityIndex = holder.IntensityToIndex(itkImage->GetPixel(currentIndex));
-        auto isInMask = mask->GetPixel(currentIndex);
-
-        if ((isInMask > 0) &&
-            (newIntensityIndex == startIntensityIndex) &&
-            (wasVisited < 1))
-        {
-          ++steps;
-          visitedImage->SetPixel(currentIndex, 1);
-          for (auto offset : offsets)
-          {
-            auto newIndex = currentIndex + offset;
-            indices.push_back(newIndex);
-            newIndex = currentIndex - offset;
-            indices.push_back(newIndex);
-          }
-
-        }
-      }
-      if (steps > 0)
-      {
-        largestRegion = std::max<int>(steps, largestRegion);
-        steps = std::min<unsigned int>(steps, holder.m_MaximumSize);
-        if (!estimateLargestRegion)
-        {
-          holder.m_Matrix(startIntensityIndex, steps - 1) += 1;
-        }
-      }
+      unsigned int steps = std::min<unsigned int>(zone.Size, holder.m_MaximumSize);
+      holder.m_Matrix(zone.Bin, steps - 1) += 1;
     }
-    ++imageIter;
-    ++maskIter;
   }
   return largestRegion;
 }
@@ -335,10 +288,12 @@ CalculateGreyLevelSizeZoneFeatures(itk::Image<TPixel, VImageDimension>* itkImage
 
   std::vector<mitk::GreyLevelSizeZoneFeatures> resultVector;
   mitk::GreyLevelSizeZoneMatrixHolder tmpHolder(rangeMin, rangeMax, numberOfBins, 3);
-  int largestRegion = CalculateGlSZMatrix<TPixel, VImageDimension>(itkImage, maskImage, offsetVector, true, tmpHolder);
+  typename mitk::GIFTextureBinVolume<VImageDimension>::ZoneVectorType zones;
+  CalculateGlSZones<TPixel, VImageDimension>(itkImage, maskImage, offsetVector, tmpHolder, zones);
+  int largestRegion = CalculateGlSZMatrix<VImageDimension>(zones, true, tmpHolder);
   mitk::GreyLevelSizeZoneMatrixHolder holderOverall(rangeMin, rangeMax, numberOfBins,largestRegion);
   mitk::GreyLevelSizeZoneFeatures overallFeature;
-  CalculateGlSZMatrix<TPixel, VImageDimension>(itkImage, maskImage, offsetVector, false, holderOverall);
+  CalculateGlSZMatrix<VImageDimension>(zones, false, holderOverall);
   CalculateFeatures(holderOverall, overallFeature);
 
   MatrixFeaturesTo(overallFeature, config.prefix, featureList);
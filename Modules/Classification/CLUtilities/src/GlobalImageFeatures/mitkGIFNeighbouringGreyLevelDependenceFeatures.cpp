@@ -5,13 +5,14 @@
 #include <mitkImageCast.h>
 #include <mitkImageAccessByItk.h>
 
+#include <mitkGIFTextureBinVolume.h>
+
 // ITK
 #include <itkEnhancedScalarImageToTextureFeaturesFilter.h>
 #include <itkMinimumMaximumImageCalculator.h>
-#include <itkNeighborhoodIterator.h>
-#include <itkImageRegionConstIterator.h>
 
 // STL
+#include <algorithm>
 #include <sstream>
 
 namespace mitk
@@ -152,10 +153,8 @@ CalculateNGLDMMatrix(itk::Image<TPixel, VImageDimension>* itkImage,
                     unsigned int direction,
                     mitk::NGLDMMatrixHolder &holder)
 {
-  typedef itk::Image<TPixel, VImageDimension> ImageType;
-  typedef itk::Image<unsigned short, VImageDimension> MaskImageType;
-  typedef itk::NeighborhoodIterator<ImageType> ShapeIterType;
-  typedef itk::NeighborhoodIterator<MaskImageType> ShapeMaskIterType;
+  typedef mitk::GIFTextureBinVolume<VImageDimension> BinVolumeType;
+  typedef itk::Offset<VImageDimension> OffsetType;
 
   holder.m_NumberOfCompleteNeighbourhoods = 0;
   holder.m_NumberOfNeighbourhoods = 0;
@@ -170,68 +169,160 @@ CalculateNGLDMMatrix(itk::Image<TPixel, VImageDimension>* itkImage,
     radius[direction - 2] = 0;
   }
 
-  ShapeIterType imageIter(radius, itkImage, itkImage->GetLargestPossibleRegion());
-  ShapeMaskIterType maskIter(radius, mask, mask->GetLargestPossibleRegion());
-
-  auto region = mask->GetLargestPossibleRegion();
-
-  auto center = imageIter.Size() / 2;
-  auto iterSize = imageIter.Size();
-  holder.m_NeighbourhoodSize = iterSize-1;
-  while (!maskIter.IsAtEnd())
+  // All offsets of the neighbourhood except the center.
+  std::vector<OffsetType> offsets;
+  OffsetType offset;
+  unsigned int iterSize = 1;
+  for (unsigned int d = 0; d < VImageDimension; ++d)
   {
-    int sameValues = 0;
-    bool completeNeighbourhood = true;
+    offset[d] = -static_cast<long>(radius[d]);
+    iterSize *= 2 * radius[d] + 1;
+  }
+  for (unsigned int position = 0; position < iterSize; ++position)
+  {
+    bool isCenter = true;
+    for (unsigned int d = 0; d < VImageDimension; ++d)
+    {
+      isCenter = isCenter && offset[d] == 0;
+    }
+    if (!isCenter)
+    {
+      offsets.push_back(offset);
+    }
+    for (unsigned int d = 0; d < VImageDimension; ++d)
+    {
+      if (offset[d] < static_cast<long>(radius[d]))
+      {
+        ++offset[d];
+        break;
+      }
+      offset[d] = -static_cast<long>(radius[d]);
+    }
+  }
+  holder.m_NeighbourhoodSize = iterSize-1;
 
-    int i = holder.IntensityToIndex(imageIter.GetCenterPixel());
+  // Neighbours outside the region or the mask both make a neighbourhood incomplete, thus
+  // only the bounding box of the mask is needed.
+  BinVolumeType bins;
+  bins.Initialize(itkImage, mask, mask->GetLargestPossibleRegion(),
+    [&holder](TPixel value) { return (value == value) ? holder.IntensityToIndex(value) : BinVolumeType::InvalidBin(); },
+    [](unsigned short maskValue) { return maskValue > 0; });
+  if (bins.GetNumberOfVoxels() == 0)
+  {
+    return;
+  }
 
-    if ((imageIter.GetCenterPixel() != imageIter.GetCenterPixel()) ||
-      (maskIter.GetCenterPixel() < 1))
+  const std::vector<int> &binBuffer = bins.GetBins();
+  long size[VImageDimension];
+  long numberOfLines = 1;
+  for (unsigned int d = 0; d < VImageDimension; ++d)
+  {
+    size[d] = bins.GetSize(d);
+    if (d > 0)
+      numberOfLines *= size[d];
+  }
+  std::vector<long> linearOffsets(offsets.size(), 0);
+  for (std::size_t k = 0; k < offsets.size(); ++k)
+  {
+    for (unsigned int d = 0; d < VImageDimension; ++d)
     {
-      ++imageIter;
-      ++maskIter;
-      continue;
+      linearOffsets[k] += offsets[k][d] * bins.GetStride(d);
     }
+  }
 
-    for (unsigned int position = 0; position < iterSize; ++position)
+  // The neighbourhoods of a whole line are evaluated offset by offset. Each thread
+  // counts into its own matrix, which are added afterwards.
+#pragma omp parallel
+  {
+    Eigen::MatrixXd localMatrix = Eigen::MatrixXd::Zero(holder.m_Matrix.rows(), holder.m_Matrix.cols());
+    unsigned long localNeighbourVoxels = 0;
+    unsigned long localDependenceNeighbourVoxels = 0;
+    unsigned long localNeighbourhoods = 0;
+    unsigned long localCompleteNeighbourhoods = 0;
+    std::vector<int> sameValues(size[0]);
+    std::vector<char> completeNeighbourhood(size[0]);
+
+#pragma omp for schedule(static)
+    for (long line = 0; line < numberOfLines; ++line)
     {
-      if (position == center)
-      {
-        continue;
-      }
-      if ( ! region.IsInside(maskIter.GetIndex(position)))
+      long coordinate[VImageDimension];
+      coordinate[0] = 0;
+      long remainder = line;
+      for (unsigned int d = 1; d < VImageDimension; ++d)
       {
-        completeNeighbourhood = false;
-        continue;
+        coordinate[d] = remainder % size[d];
+        remainder /= size[d];
       }
-      bool isInBounds;
-      auto jIntensity = imageIter.GetPixel(position, isInBounds);
-      auto jMask = maskIter.GetPixel(position, isInBounds);
-      if (jMask < 1 || (jIntensity != jIntensity) || ( ! isInBounds))
+      const long lineStart = line * size[0];
+      std::fill(sameValues.begin(), sameValues.end(), 0);
+      std::fill(completeNeighbourhood.begin(), completeNeighbourhood.end(), 1);
+
+      for (std::size_t k = 0; k < offsets.size(); ++k)
       {
-        completeNeighbourhood = false;
-        continue;
+        bool lineIsInside = true;
+        for (unsigned int d = 1; d < VImageDimension; ++d)
+        {
+          long neighbour = coordinate[d] + offsets[k][d];
+          lineIsInside = lineIsInside && neighbour >= 0 && neighbour < size[d];
+        }
+        if (!lineIsInside)
+        {
+          std::fill(completeNeighbourhood.begin(), completeNeighbourhood.end(), 0);
+          continue;
+        }
+
+        const long xStart = std::max<long>(0, -offsets[k][0]);
+        const long xEnd = std::min<long>(size[0], size[0] - offsets[k][0]);
+        std::fill(completeNeighbourhood.begin(), completeNeighbourhood.begin() + std::min(xStart, size[0]), 0);
+        std::fill(completeNeighbourhood.begin() + std::max(xEnd, 0L), completeNeighbourhood.end(), 0);
+        const long neighbourStart = lineStart + linearOffsets[k];
+        for (long x = xStart; x < xEnd; ++x)
+        {
+          const int i = binBuffer[lineStart + x];
+          const int j = binBuffer[neighbourStart + x];
+          if (i == BinVolumeType::InvalidBin())
+          {
+            continue;
+          }
+          if (j == BinVolumeType::InvalidBin())
+          {
+            completeNeighbourhood[x] = 0;
+            continue;
+          }
+          localNeighbourVoxels += 1;
+          if (std::abs(i - j) <= alpha)
+          {
+            localDependenceNeighbourVoxels += 1;
+            ++sameValues[x];
+          }
+        }
       }
 
-      int j = holder.IntensityToIndex(jIntensity);
-      holder.m_NumberOfNeighbourVoxels += 1;
-      if (std::abs(i - j) <= alpha)
+      for (long x = 0; x < size[0]; ++x)
       {
-        holder.m_NumberOfDependenceNeighbourVoxels += 1;
-        ++sameValues;
+        const int i = binBuffer[lineStart + x];
+        if (i == BinVolumeType::InvalidBin())
+        {
+          continue;
+        }
+        localMatrix(i, sameValues[x]) += 1;
+        localNeighbourhoods += 1;
+        if (completeNeighbourhood[x])
+        {
+          localCompleteNeighbourhoods += 1;
+        }
       }
     }
-    holder.m_Matrix(i, sameValues) += 1;
-    holder.m_NumberOfNeighbourhoods += 1;
-    if (completeNeighbourhood)
+
+#pragma omp critical
     {
-      holder.m_NumberOfCompleteNeighbourhoods += 1;
+      holder.m_Matrix += localMatrix;
+      holder.m_NumberOfNeighbourVoxels += localNeighbourVoxels;
+      holder.m_NumberOfDependenceNeighbourVoxels += localDependenceNeighbourVoxels;
+      holder.m_NumberOfNeighbourhoods += localNeighbourhoods;
+      holder.m_NumberOfCompleteNeighbourhoods += localCompleteNeighbourhoods;
     }
-
-    ++imageIter;
-    ++maskIter;
   }
-
 }
 
 void LocalCalculateFeatures(
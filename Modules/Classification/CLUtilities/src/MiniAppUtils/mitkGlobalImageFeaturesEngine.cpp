@@ -0,0 +1,394 @@
+/*===================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center,
+Division of Medical and Biological Informatics.
+All rights reserved.
+
+This software is distributed WITHOUT ANY WARRANTY; without
+even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE.
+
+See LICENSE.txt or http://www.mitk.org for details.
+
+===================================================================*/
+
+#include <mitkGlobalImageFeaturesEngine.h>
+
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <map>
+#include <thread>
+
+#include <mitkImageAccessByItk.h>
+#include <mitkITKImageImport.h>
+#include <mitkIntensityQuantifierCache.h>
+
+#include <itkImageRegionConstIteratorWithIndex.h>
+#include <itkRegionOfInterestImageFilter.h>
+
+typedef std::vector<itk::IndexValueType> BoundingIndexType;
+
+template<typename TPixel, unsigned int VImageDimension>
+static void
+CalculateMaskBoundingBox(itk::Image<TPixel, VImageDimension>* itkMask, BoundingIndexType& lower, BoundingIndexType& upper)
+{
+  typedef itk::Image<TPixel, VImageDimension> ImageType;
+
+  lower.clear();
+  upper.clear();
+
+  itk::ImageRegionConstIteratorWithIndex<ImageType> iter(itkMask, itkMask->GetLargestPossibleRegion());
+  while (!iter.IsAtEnd())
+  {
+    if (iter.Value() > 0)
+    {
+      auto index = iter.GetIndex();
+      if (lower.empty())
+      {
+        for (unsigned int i = 0; i < VImageDimension; ++i)
+        {
+          lower.push_back(index[i]);
+        }
+        upper = lower;
+      }
+      else
+      {
+        for (unsigned int i = 0; i < VImageDimension; ++i)
+        {
+          lower[i] = std::min(lower[i], index[i]);
+          upper[i] = std::max(upper[i], index[i]);
+        }
+      }
+    }
+    ++iter;
+  }
+}
+
+template<typename TPixel, unsigned int VImageDimension>
+static void
+CropImage(itk::Image<TPixel, VImageDimension>* itkImage, const BoundingIndexType& lower, const BoundingIndexType& upper, unsigned int margin, mitk::Image::Pointer& newImage)
+{
+  typedef itk::Image<TPixel, VImageDimension> ImageType;
+  typedef itk::RegionOfInterestImageFilter<ImageType, ImageType> FilterType;
+
+  auto largestRegion = itkImage->GetLargestPossibleRegion();
+  typename ImageType::RegionType region;
+  for (unsigned int i = 0; i < VImageDimension; ++i)
+  {
+    itk::IndexValueType first = largestRegion.GetIndex()[i];
+    itk::IndexValueType last = first + static_cast<itk::IndexValueType>(largestRegion.GetSize()[i]) - 1;
+    itk::IndexValueType start = std::max(first, lower[i] - static_cast<itk::IndexValueType>(margin));
+    itk::IndexValueType end = std::min(last, upper[i] + static_cast<itk::IndexValueType>(margin));
+    region.SetIndex(i, start);
+    region.SetSize(i, end - start + 1);
+  }
+
+  typename FilterType::Pointer filter = FilterType::New();
+  filter->SetInput(itkImage);
+  filter->SetRegionOfInterest(region);
+  filter->Update();
+
+  newImage->InitializeByItk(filter->GetOutput());
+  mitk::GrabItkImageMemory(filter->GetOutput(), newImage);
+}
+
+static bool
+HaveSameSize(const mitk::Image::Pointer& image1, const mitk::Image::Pointer& image2)
+{
+  if (image1->GetDimension() != image2->GetDimension())
+    return false;
+  for (unsigned int i = 0; i < image1->GetDimension(); ++i)
+  {
+    if (image1->GetDimension(i) != image2->GetDimension(i))
+      return false;
+  }
+  return true;
+}
+
+static mitk::cl::GlobalImageFeaturesEngine::CaseType
+CompleteCase(const mitk::cl::GlobalImageFeaturesEngine::CaseType& inputs)
+{
+  if (inputs.image.IsNull() || inputs.mask.IsNull())
+  {
+    mitkThrow() << "Cannot calculate features. Image or mask is not set.";
+  }
+
+  auto result = inputs;
+  if (result.maskNoNaN.IsNull())
+    result.maskNoNaN = result.mask;
+  if (result.morphMask.IsNull())
+    result.morphMask = result.mask;
+  return result;
+}
+
+/** Copies all images of the case. Images that are used for several inputs (e.g. mask and
+* morphological mask) are copied only once.*/
+static mitk::cl::GlobalImageFeaturesEngine::CaseType
+CloneCase(const mitk::cl::GlobalImageFeaturesEngine::CaseType& inputs)
+{
+  std::map<const mitk::Image*, mitk::Image::Pointer> clones;
+  auto cloneImage = [&clones](const mitk::Image::Pointer& image) -> mitk::Image::Pointer
+  {
+    auto& clone = clones[image.GetPointer()];
+    if (clone.IsNull())
+      clone = image->Clone();
+    return clone;
+  };
+
+  mitk::cl::GlobalImageFeaturesEngine::CaseType result;
+  result.image = cloneImage(inputs.image);
+  result.mask = cloneImage(inputs.mask);
+  result.maskNoNaN = cloneImage(inputs.maskNoNaN);
+  result.morphMask = cloneImage(inputs.morphMask);
+  return result;
+}
+
+mitk::cl::GlobalImageFeaturesEngine::GlobalImageFeaturesEngine() :
+  m_NumberOfThreads(1),
+  m_CropToMask(false),
+  m_CropMargin(2),
+  m_ShareQuantifiers(true)
+{
+}
+
+void mitk::cl::GlobalImageFeaturesEngine::SetNumberOfThreads(unsigned int threads)
+{
+  m_NumberOfThreads = threads;
+}
+
+unsigned int mitk::cl::GlobalImageFeaturesEngine::GetNumberOfThreads() const
+{
+  return m_NumberOfThreads;
+}
+
+void mitk::cl::GlobalImageFeaturesEngine::SetCropToMask(bool crop)
+{
+  m_CropToMask = crop;
+}
+
+bool mitk::cl::GlobalImageFeaturesEngine::GetCropToMask() const
+{
+  return m_CropToMask;
+}
+
+void mitk::cl::GlobalImageFeaturesEngine::SetCropMargin(unsigned int margin)
+{
+  m_CropMargin = margin;
+}
+
+unsigned int mitk::cl::GlobalImageFeaturesEngine::GetCropMargin() const
+{
+  return m_CropMargin;
+}
+
+void mitk::cl::GlobalImageFeaturesEngine::SetShareQuantifiers(bool share)
+{
+  m_ShareQuantifiers = share;
+}
+
+bool mitk::cl::GlobalImageFeaturesEngine::GetShareQuantifiers() const
+{
+  return m_ShareQuantifiers;
+}
+
+unsigned int mitk::cl::GlobalImageFeaturesEngine::GetEffectiveNumberOfThreads(std::size_t numberOfTasks) const
+{
+  unsigned int threads = m_NumberOfThreads;
+  if (threads == 0)
+    threads = std::max(1u, std::thread::hardware_concurrency());
+  return static_cast<unsigned int>(std::max<std::size_t>(1, std::min<std::size_t>(threads, numberOfTasks)));
+}
+
+mitk::cl::GlobalImageFeaturesEngine::CaseType
+mitk::cl::GlobalImageFeaturesEngine::CropToMask(const CaseType& inputs, unsigned int margin)
+{
+  auto result = CompleteCase(inputs);
+
+  BoundingIndexType lower, upper;
+  AccessByItk_2(result.mask, CalculateMaskBoundingBox, lower, upper);
+  if (lower.empty())
+  {
+    MITK_WARN << "Mask contains no voxel. The images are not cropped.";
+    return result;
+  }
+
+  std::map<const mitk::Image*, mitk::Image::Pointer> croppedImages;
+  auto cropImage = [&](const mitk::Image::Pointer& image) -> mitk::Image::Pointer
+  {
+    auto& croppedImage = croppedImages[image.GetPointer()];
+    if (croppedImage.IsNull())
+    {
+      if (HaveSameSize(image, result.mask))
+      {
+        croppedImage = mitk::Image::New();
+        AccessByItk_n(image, CropImage, (lower, upper, margin, croppedImage));
+      }
+      else
+      {
+        MITK_WARN << "Size of an input image does not match the mask. This image is not cropped.";
+        croppedImage = image;
+      }
+    }
+    return croppedImage;
+  };
+
+  CaseType croppedCase;
+  croppedCase.image = cropImage(result.image);
+  croppedCase.mask = cropImage(result.mask);
+  croppedCase.maskNoNaN = cropImage(result.maskNoNaN);
+  croppedCase.morphMask = cropImage(result.morphMask);
+  return croppedCase;
+}
+
+mitk::cl::GlobalImageFeaturesEngine::FeatureListType
+mitk::cl::GlobalImageFeaturesEngine::Calculate(const FeatureVectorType& features, const CaseType& inputs) const
+{
+  CaseType cInputs = CompleteCase(inputs);
+  if (m_CropToMask)
+  {
+    cInputs = CropToMask(cInputs, m_CropMargin);
+  }
+
+  mitk::IntensityQuantifierCache::Pointer cache;
+  std::vector<mitk::IntensityQuantifierCache::Pointer> previousCaches;
+  if (m_ShareQuantifiers)
+  {
+    cache = mitk::IntensityQuantifierCache::New();
+    for (auto cFeature : features)
+    {
+      previousCaches.push_back(cFeature->GetQuantifierCache());
+      cFeature->SetQuantifierCache(cache);
+    }
+  }
+
+  const unsigned int threads = GetEffectiveNumberOfThreads(features.size());
+  std::vector<FeatureListType> results(features.size());
+  std::vector<std::exception_ptr> errors(features.size());
+  std::atomic<std::size_t> nextFeature(0);
+
+  auto worker = [&](unsigned int workerID)
+  {
+    // The feature classes use write accessors on the images, thus every
+    // worker except the first one works on its own copy of the inputs.
+    CaseType workerInputs = cInputs;
+    if (workerID > 0)
+    {
+      try
+      {
+        workerInputs = CloneCase(cInputs);
+      }
+      catch (...)
+      {
+        // The remaining features are calculated by the other workers.
+        MITK_WARN << "Worker " << workerID << " could not copy the input images.";
+        return;
+      }
+    }
+
+    if (cache.IsNotNull())
+    {
+      cache->RegisterImage(workerInputs.image, "Image");
+      cache->RegisterImage(workerInputs.mask, "Mask");
+      cache->RegisterImage(workerInputs.maskNoNaN, "MaskNoNaN");
+      cache->RegisterImage(workerInputs.morphMask, "MorphMask");
+    }
+
+    for (std::size_t i = nextFeature++; i < features.size(); i = nextFeature++)
+    {
+      try
+      {
+        features[i]->SetMorphMask(workerInputs.morphMask);
+        features[i]->CalculateFeaturesUsingParameters(workerInputs.image, workerInputs.mask, workerInputs.maskNoNaN, results[i]);
+      }
+      catch (...)
+      {
+        errors[i] = std::current_exception();
+      }
+    }
+  };
+
+  if (threads > 1)
+  {
+    std::vector<std::thread> pool;
+    for (unsigned int workerID = 1; workerID < threads; ++workerID)
+    {
+      pool.emplace_back(worker, workerID);
+    }
+    worker(0);
+    for (auto& thread : pool)
+    {
+      thread.join();
+    }
+  }
+  else
+  {
+    worker(0);
+  }
+
+  for (std::size_t i = 0; i < features.size(); ++i)
+  {
+    if (m_ShareQuantifiers)
+      features[i]->SetQuantifierCache(previousCaches[i]);
+  }
+  for (auto& error : errors)
+  {
+    if (error)
+      std::rethrow_exception(error);
+  }
+
+  FeatureListType result;
+  for (auto& cResult : results)
+  {
+    result.insert(result.end(), cResult.begin(), cResult.end());
+  }
+  return result;
+}
+
+std::vector<mitk::cl::GlobalImageFeaturesEngine::CaseResultType>
+mitk::cl::GlobalImageFeaturesEngine::CalculateCohort(const FeatureFactoryType& featureFactory, const CaseLoaderType& loader, std::size_t numberOfCases) const
+{
+  std::vector<CaseResultType> results(numberOfCases);
+  std::atomic<std::size_t> nextCase(0);
+
+  // The cases are distributed over the workers; the feature classes of a case are calculated sequentially.
+  GlobalImageFeaturesEngine caseEngine(*this);
+  caseEngine.SetNumberOfThreads(1);
+
+  auto worker = [&]()
+  {
+    FeatureVectorType features = featureFactory();
+    for (std::size_t i = nextCase++; i < numberOfCases; i = nextCase++)
+    {
+      try
+      {
+        results[i].features = caseEngine.Calculate(features, loader(i));
+        results[i].valid = true;
+      }
+      catch (const std::exception& e)
+      {
+        results[i].errorMessage = e.what();
+      }
+      catch (...)
+      {
+        results[i].errorMessage = "Unknown error";
+      }
+    }
+  };
+
+  const unsigned int threads = GetEffectiveNumberOfThreads(numberOfCases);
+  std::vector<std::thread> pool;
+  for (unsigned int workerID = 1; workerID < threads; ++workerID)
+  {
+    pool.emplace_back(worker);
+  }
+  worker();
+  for (auto& thread : pool)
+  {
+    thread.join();
+  }
+
+  return results;
+}
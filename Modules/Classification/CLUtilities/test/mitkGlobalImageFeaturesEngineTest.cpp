@@ -0,0 +1,178 @@
+/*===================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center,
+Division of Medical and Biological Informatics.
+All rights reserved.
+
+This software is distributed WITHOUT ANY WARRANTY; without
+even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE.
+
+See LICENSE.txt or http://www.mitk.org for details.
+
+===================================================================*/
+
+#include <mitkTestingMacros.h>
+#include <mitkTestFixture.h>
+#include "mitkIOUtil.h"
+#include <cmath>
+
+#include <mitkGlobalImageFeaturesEngine.h>
+#include <mitkGIFCooccurenceMatrix2.h>
+#include <mitkGIFFirstOrderHistogramStatistics.h>
+#include <mitkGIFGreyLevelSizeZone.h>
+#include <mitkGIFNeighbouringGreyLevelDependenceFeatures.h>
+
+class mitkGlobalImageFeaturesEngineTestSuite : public mitk::TestFixture
+{
+  CPPUNIT_TEST_SUITE(mitkGlobalImageFeaturesEngineTestSuite);
+
+  MITK_TEST(ConcurrentCalculation_EqualsSequential);
+  MITK_TEST(SharedQuantifier_IsReused);
+  MITK_TEST(CropToMask_KeepsMaskedFeatures);
+  MITK_TEST(Cohort_EqualsSingleCases);
+
+  CPPUNIT_TEST_SUITE_END();
+
+private:
+  mitk::Image::Pointer m_IBSI_Phantom_Image_Large;
+  mitk::Image::Pointer m_IBSI_Phantom_Mask_Large;
+
+  mitk::cl::GlobalImageFeaturesEngine::FeatureVectorType CreateFeatures()
+  {
+    mitk::cl::GlobalImageFeaturesEngine::FeatureVectorType features;
+    features.push_back(mitk::GIFFirstOrderHistogramStatistics::New().GetPointer());
+    features.push_back(mitk::GIFCooccurenceMatrix2::New().GetPointer());
+    features.push_back(mitk::GIFGreyLevelSizeZone::New().GetPointer());
+    features.push_back(mitk::GIFNeighbouringGreyLevelDependenceFeature::New().GetPointer());
+
+    for (auto cFeature : features)
+    {
+      mitk::AbstractGlobalImageFeature::ParameterTypes parameter;
+      parameter[cFeature->GetLongName()] = us::Any(true);
+      cFeature->SetParameter(parameter);
+      cFeature->SetUseBinsize(true);
+      cFeature->SetBinsize(1.0);
+      cFeature->SetUseMinimumIntensity(true);
+      cFeature->SetUseMaximumIntensity(true);
+      cFeature->SetMinimumIntensity(0.5);
+      cFeature->SetMaximumIntensity(6.5);
+    }
+    return features;
+  }
+
+  mitk::cl::GlobalImageFeaturesEngine::CaseType CreateCase()
+  {
+    mitk::cl::GlobalImageFeaturesEngine::CaseType inputs;
+    inputs.image = m_IBSI_Phantom_Image_Large;
+    inputs.mask = m_IBSI_Phantom_Mask_Large;
+    return inputs;
+  }
+
+  void CheckEqualResults(const mitk::AbstractGlobalImageFeature::FeatureListType& expected,
+                         const mitk::AbstractGlobalImageFeature::FeatureListType& result)
+  {
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("Number of features should not depend on the execution.", expected.size(), result.size());
+    for (std::size_t i = 0; i < expected.size(); ++i)
+    {
+      CPPUNIT_ASSERT_EQUAL_MESSAGE("Order of features should not depend on the execution.", expected[i].first, result[i].first);
+      if (std::isnan(expected[i].second))
+      {
+        CPPUNIT_ASSERT_MESSAGE(expected[i].first + " should be NaN.", std::isnan(result[i].second));
+      }
+      else
+      {
+        CPPUNIT_ASSERT_DOUBLES_EQUAL_MESSAGE(expected[i].first + " should not depend on the execution.", expected[i].second, result[i].second, 1e-10);
+      }
+    }
+  }
+
+public:
+
+  void setUp(void) override
+  {
+    m_IBSI_Phantom_Image_Large = mitk::IOUtil::Load<mitk::Image>(GetTestDataFilePath("Radiomics/IBSI_Phantom_Image_Large.nrrd"));
+    m_IBSI_Phantom_Mask_Large = mitk::IOUtil::Load<mitk::Image>(GetTestDataFilePath("Radiomics/IBSI_Phantom_Mask_Large.nrrd"));
+  }
+
+  void ConcurrentCalculation_EqualsSequential()
+  {
+    mitk::cl::GlobalImageFeaturesEngine sequentialEngine;
+    sequentialEngine.SetShareQuantifiers(false);
+    auto expected = sequentialEngine.Calculate(CreateFeatures(), CreateCase());
+    CPPUNIT_ASSERT_MESSAGE("Features should be calculated.", expected.size() > 0);
+
+    mitk::cl::GlobalImageFeaturesEngine concurrentEngine;
+    concurrentEngine.SetNumberOfThreads(4);
+    auto result = concurrentEngine.Calculate(CreateFeatures(), CreateCase());
+    CheckEqualResults(expected, result);
+  }
+
+  void SharedQuantifier_IsReused()
+  {
+    auto features = CreateFeatures();
+    auto cache = mitk::IntensityQuantifierCache::New();
+    for (auto cFeature : features)
+    {
+      cFeature->SetQuantifierCache(cache);
+      cFeature->InitializeQuantifier(m_IBSI_Phantom_Image_Large, m_IBSI_Phantom_Mask_Large);
+    }
+
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("Features with the same configuration should share one quantifier.", std::size_t(1), cache->GetNumberOfQuantifiers());
+    CPPUNIT_ASSERT_MESSAGE("Features should use the same quantifier instance.",
+      features[0]->GetQuantifier().GetPointer() == features[3]->GetQuantifier().GetPointer());
+
+    features[1]->SetBinsize(2.0);
+    features[1]->InitializeQuantifier(m_IBSI_Phantom_Image_Large, m_IBSI_Phantom_Mask_Large);
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("A different configuration should create a new quantifier.", std::size_t(2), cache->GetNumberOfQuantifiers());
+  }
+
+  void CropToMask_KeepsMaskedFeatures()
+  {
+    mitk::cl::GlobalImageFeaturesEngine engine;
+    auto expected = engine.Calculate(CreateFeatures(), CreateCase());
+
+    auto croppedCase = mitk::cl::GlobalImageFeaturesEngine::CropToMask(CreateCase(), 2);
+    CPPUNIT_ASSERT_MESSAGE("Cropped image should not be larger than the input.",
+      croppedCase.image->GetDimension(0) <= m_IBSI_Phantom_Image_Large->GetDimension(0));
+    CPPUNIT_ASSERT_MESSAGE("Mask and image should be cropped to the same size.",
+      croppedCase.image->GetDimension(0) == croppedCase.mask->GetDimension(0) &&
+      croppedCase.image->GetDimension(1) == croppedCase.mask->GetDimension(1) &&
+      croppedCase.image->GetDimension(2) == croppedCase.mask->GetDimension(2));
+
+    engine.SetCropToMask(true);
+    auto result = engine.Calculate(CreateFeatures(), CreateCase());
+    CheckEqualResults(expected, result);
+  }
+
+  void Cohort_EqualsSingleCases()
+  {
+    mitk::cl::GlobalImageFeaturesEngine engine;
+    auto expected = engine.Calculate(CreateFeatures(), CreateCase());
+
+    engine.SetNumberOfThreads(2);
+    auto results = engine.CalculateCohort(
+      [this]() { return CreateFeatures(); },
+      [this](std::size_t index) -> mitk::cl::GlobalImageFeaturesEngine::CaseType
+      {
+        if (index == 1)
+        {
+          mitkThrow() << "Invalid case";
+        }
+        auto inputs = CreateCase();
+        inputs.image = inputs.image->Clone();
+        inputs.mask = inputs.mask->Clone();
+        return inputs;
+      }, 3);
+
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("Every case should have a result.", std::size_t(3), results.size());
+    CPPUNIT_ASSERT_MESSAGE("Failing case should be marked as not valid.", !results[1].valid);
+    CPPUNIT_ASSERT_MESSAGE("Other cases should be valid.", results[0].valid && results[2].valid);
+    CheckEqualResults(expected, results[0].features);
+    CheckEqualResults(expected, results[2].features);
+  }
+};
+
+MITK_TEST_SUITE_REGISTRATION(mitkGlobalImageFeaturesEngine )
@@ -5,6 +5,7 @@ set(CPP_FILES
     mitkModuleActivator.cpp
 
     Classifier/mitkVigraRandomForestClassifier.cpp
+    Classifier/mitkFlatRandomForest.cpp
     Classifier/mitkPURFClassifier.cpp
 
     Algorithm/itkHessianMatrixEigenvalueImageFilter.cpp
@@ -0,0 +1,104 @@
+/*===================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center,
+Division of Medical and Biological Informatics.
+All rights reserved.
+
+This software is distributed WITHOUT ANY WARRANTY; without
+even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE.
+
+See LICENSE.txt or http://www.mitk.org for details.
+
+===================================================================*/
+
+#ifndef mitkFlatRandomForest_h
+#define mitkFlatRandomForest_h
+
+#include <MitkCLVigraRandomForestExports.h>
+
+#include <vector>
+
+#include <Eigen/Dense>
+#include <itkMultiThreader.h>
+#include <vigra/random_forest.hxx>
+
+namespace mitk
+{
+  /** \class FlatRandomForest
+   * \brief Compiled copy of a vigra::RandomForest<int> for fast prediction.
+   *
+   * The nodes of all trees are stored in one contiguous array. Each tree is laid out breadth-first and the two
+   * children of a split node are neighbours, so a node only stores the index of its first child. The class
+   * probabilities of the leaves are stored in a second array.
+   *
+   * Predict() reads the features directly from the (column-major) Eigen matrix; no copy or vigra view is
+   * needed. The samples are processed in blocks; all trees are evaluated for one block before the next block
+   * is started, thus a tree stays in the cache while it is applied to the samples of the block. The blocks are
+   * distributed over threads. The results are identical to the prediction of vigra (same traversal, same order
+   * of summation).
+   *
+   * Only threshold split nodes and constant probability leaves are supported; these are the only nodes
+   * created by the splitters of this module.*/
+  class MITKCLVIGRARANDOMFOREST_EXPORT FlatRandomForest
+  {
+  public:
+    struct NodeType
+    {
+      /** Split threshold. Samples with feature < threshold go to the first child.*/
+      double Threshold;
+      /** Feature (column) used for the split; -1 for leaves.*/
+      int Feature;
+      /** Index of the first child for split nodes, index of the leaf for leaves.*/
+      int Child;
+    };
+
+    FlatRandomForest();
+
+    /** Compiles the trees of the forest. Throws an mitk::Exception if the forest contains unsupported node types.*/
+    void Initialize(const vigra::RandomForest<int> &forest);
+
+    void Clear();
+    bool IsEmpty() const;
+
+    unsigned int GetNumberOfTrees() const;
+    unsigned int GetNumberOfClasses() const;
+    const std::vector<NodeType> &GetNodes() const;
+
+    /** Number of samples that are processed together (default 256).*/
+    void SetBlockSize(unsigned int blockSize);
+    unsigned int GetBlockSize() const;
+
+    /** Number of threads used by Predict(); 0 (default) uses the global default of itk::MultiThreader.*/
+    void SetNumberOfThreads(unsigned int numberOfThreads);
+    unsigned int GetNumberOfThreads() const;
+
+    /** Predicts the class probabilities and labels of the samples (rows) of X.
+     * @param treeWeights Optional weight of each tree (rows = number of trees). If it is null, the votes are
+     * accumulated as vigra::RandomForest::predictProbabilities() does and samples with NaN features cause an
+     * exception.
+     * @param truncateVotes If true, the vote of a tree for a class is truncated to an integer before it is
+     * accumulated (behaviour of VigraRandomForestClassifier::PredictWeighted()).*/
+    void Predict(const Eigen::MatrixXd &X, const Eigen::MatrixXd *treeWeights, bool truncateVotes,
+      Eigen::MatrixXd &probabilities, Eigen::MatrixXi &labels) const;
+
+  private:
+    struct PredictionData;
+    static ITK_THREAD_RETURN_TYPE PredictCallback(void *);
+    void PredictBlock(PredictionData *data, long begin, long end, std::vector<double> &votes, std::vector<double> &totals) const;
+
+    std::vector<NodeType> m_Nodes;
+    std::vector<int> m_TreeRoots;
+    /** Per leaf: number of observations followed by the probability of each class.*/
+    std::vector<double> m_LeafValues;
+    std::vector<int> m_ClassLabels;
+    int m_NumberOfFeatures;
+    bool m_IsSampleWeighted;
+    unsigned int m_BlockSize;
+    unsigned int m_NumberOfThreads;
+  };
+}
+
+#endif //mitkFlatRandomForest_h
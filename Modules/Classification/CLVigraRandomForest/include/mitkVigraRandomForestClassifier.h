@@ -19,6 +19,7 @@ See LICENSE.txt or http://www.mitk.org for details.
 
 #include <MitkCLVigraRandomForestExports.h>
 #include <mitkAbstractClassifier.h>
+#include <mitkFlatRandomForest.h>
 
 //#include <vigra/multi_array.hxx>
 #include <vigra/random_forest.hxx>
@@ -74,7 +75,6 @@ namespace mitk
 
 
     struct TrainingData;
-    struct PredictionData;
     struct EigenToVigraTransform;
     struct Parameter;
 
@@ -84,10 +84,15 @@ namespace mitk
     Parameter * m_Parameter;
     vigra::RandomForest<int> m_RandomForest;
 
+    // Compiled copy of m_RandomForest used for prediction; rebuilt on demand
+    // after the forest was changed.
+    FlatRandomForest m_FlatRandomForest;
+    bool m_FlatRandomForestIsValid;
+
+    void UpdateFlatRandomForest();
+    void InitializeTreeWeights();
+
     static ITK_THREAD_RETURN_TYPE TrainTreesCallback(void *);
-    static ITK_THREAD_RETURN_TYPE PredictCallback(void *);
-    static ITK_THREAD_RETURN_TYPE PredictWeightedCallback(void *);
-    static void VigraPredictWeighted(PredictionData *data, vigra::MultiArrayView<2, double> & X, vigra::MultiArrayView<2, int> & Y, vigra::MultiArrayView<2, double> & P);
   };
 }
 
@@ -0,0 +1,306 @@
+/*===================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center,
+Division of Medical and Biological Informatics.
+All rights reserved.
+
+This software is distributed WITHOUT ANY WARRANTY; without
+even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE.
+
+See LICENSE.txt or http://www.mitk.org for details.
+
+===================================================================*/
+
+// MITK includes
+#include <mitkFlatRandomForest.h>
+#include <mitkExceptionMacro.h>
+
+// STL includes
+#include <algorithm>
+#include <atomic>
+#include <deque>
+#include <utility>
+
+struct mitk::FlatRandomForest::PredictionData
+{
+  PredictionData(const mitk::FlatRandomForest *forest,
+    const Eigen::MatrixXd &feature,
+    const Eigen::MatrixXd *treeWeights,
+    bool truncateVotes,
+    Eigen::MatrixXd &probabilities,
+    Eigen::MatrixXi &labels)
+    : m_Forest(forest),
+    m_Feature(feature),
+    m_TreeWeights(treeWeights),
+    m_TruncateVotes(truncateVotes),
+    m_Probabilities(probabilities),
+    m_Labels(labels),
+    m_NextBlock(0),
+    m_ContainsNaN(false)
+  {
+  }
+  const mitk::FlatRandomForest *m_Forest;
+  const Eigen::MatrixXd &m_Feature;
+  const Eigen::MatrixXd *m_TreeWeights;
+  bool m_TruncateVotes;
+  Eigen::MatrixXd &m_Probabilities;
+  Eigen::MatrixXi &m_Labels;
+  std::atomic<long> m_NextBlock;
+  std::atomic<bool> m_ContainsNaN;
+};
+
+mitk::FlatRandomForest::FlatRandomForest()
+  : m_NumberOfFeatures(0),
+  m_IsSampleWeighted(false),
+  m_BlockSize(256),
+  m_NumberOfThreads(0)
+{
+}
+
+void mitk::FlatRandomForest::Initialize(const vigra::RandomForest<int> &forest)
+{
+  this->Clear();
+
+  const int numberOfClasses = forest.ext_param_.class_count_;
+  m_NumberOfFeatures = forest.ext_param_.column_count_;
+  m_IsSampleWeighted = forest.options_.predict_weighted_;
+  for (int c = 0; c < numberOfClasses; ++c)
+  {
+    int label;
+    forest.ext_param_.to_classlabel(c, label);
+    m_ClassLabels.push_back(label);
+  }
+
+  for (int k = 0; k < forest.options_.tree_count_; ++k)
+  {
+    const auto &topology = forest.trees_[k].topology_;
+    const auto &parameters = forest.trees_[k].parameters_;
+
+    // Breadth-first traversal; the first two entries of the topology hold the
+    // number of features and classes, the root node starts at index 2.
+    std::deque<std::pair<int, int> > nodesToVisit;
+    m_TreeRoots.push_back(m_Nodes.size());
+    m_Nodes.push_back(NodeType());
+    nodesToVisit.push_back(std::make_pair(2, m_TreeRoots.back()));
+
+    while (!nodesToVisit.empty())
+    {
+      const int index = nodesToVisit.front().first;
+      const int slot = nodesToVisit.front().second;
+      nodesToVisit.pop_front();
+
+      const int type = topology[index];
+      const int parameterAddress = topology[index + 1];
+      NodeType node;
+      if (type == vigra::e_ConstProbNode)
+      {
+        node.Threshold = 0;
+        node.Feature = -1;
+        node.Child = m_LeafValues.size() / (numberOfClasses + 1);
+        m_LeafValues.insert(m_LeafValues.end(),
+          parameters.begin() + parameterAddress,
+          parameters.begin() + parameterAddress + numberOfClasses + 1);
+      }
+      else if (type == vigra::i_ThresholdNode)
+      {
+        node.Threshold = parameters[parameterAddress + 1];
+        node.Feature = topology[index + 4];
+        node.Child = m_Nodes.size();
+        m_Nodes.push_back(NodeType());
+        m_Nodes.push_back(NodeType());
+        nodesToVisit.push_back(std::make_pair(topology[index + 2], node.Child));
+        nodesToVisit.push_back(std::make_pair(topology[index + 3], node.Child + 1));
+      }
+      else
+      {
+        this->Clear();
+        mitkThrow() << "Cannot compile random forest. Tree " << k << " contains the unsupported node type " << type << ".";
+      }
+      m_Nodes[slot] = node;
+    }
+  }
+}
+
+void mitk::FlatRandomForest::Clear()
+{
+  m_Nodes.clear();
+  m_TreeRoots.clear();
+  m_LeafValues.clear();
+  m_ClassLabels.clear();
+  m_NumberOfFeatures = 0;
+}
+
+bool mitk::FlatRandomForest::IsEmpty() const
+{
+  return m_TreeRoots.empty();
+}
+
+unsigned int mitk::FlatRandomForest::GetNumberOfTrees() const
+{
+  return m_TreeRoots.size();
+}
+
+unsigned int mitk::FlatRandomForest::GetNumberOfClasses() const
+{
+  return m_ClassLabels.size();
+}
+
+const std::vector<mitk::FlatRandomForest::NodeType> &mitk::FlatRandomForest::GetNodes() const
+{
+  return m_Nodes;
+}
+
+void mitk::FlatRandomForest::SetBlockSize(unsigned int blockSize)
+{
+  m_BlockSize = std::max(1u, blockSize);
+}
+
+unsigned int mitk::FlatRandomForest::GetBlockSize() const
+{
+  return m_BlockSize;
+}
+
+void mitk::FlatRandomForest::SetNumberOfThreads(unsigned int numberOfThreads)
+{
+  m_NumberOfThreads = numberOfThreads;
+}
+
+unsigned int mitk::FlatRandomForest::GetNumberOfThreads() const
+{
+  return m_NumberOfThreads;
+}
+
+void mitk::FlatRandomForest::Predict(const Eigen::MatrixXd &X, const Eigen::MatrixXd *treeWeights, bool truncateVotes,
+  Eigen::MatrixXd &probabilities, Eigen::MatrixXi &labels) const
+{
+  if (X.rows() > 0 && X.cols() < m_NumberOfFeatures)
+  {
+    mitkThrow() << "Cannot predict. The forest needs " << m_NumberOfFeatures << " features, but only " << X.cols() << " are given.";
+  }
+  if (treeWeights != nullptr && treeWeights->rows() < static_cast<long>(m_TreeRoots.size()))
+  {
+    mitkThrow() << "Cannot predict. Number of tree weights (" << treeWeights->rows() << ") does not match the number of trees (" << m_TreeRoots.size() << ").";
+  }
+
+  probabilities = Eigen::MatrixXd::Zero(X.rows(), m_ClassLabels.size());
+  labels = Eigen::MatrixXi::Zero(X.rows(), 1);
+  if (X.rows() == 0)
+  {
+    return;
+  }
+
+  PredictionData data(this, X, treeWeights, truncateVotes, probabilities, labels);
+
+  itk::MultiThreader::Pointer threader = itk::MultiThreader::New();
+  if (m_NumberOfThreads > 0)
+  {
+    threader->SetNumberOfThreads(m_NumberOfThreads);
+  }
+  threader->SetSingleMethod(PredictCallback, &data);
+  threader->SingleMethodExecute();
+
+  if (data.m_ContainsNaN)
+  {
+    mitkThrow() << "Cannot predict labels. Feature matrix contains NaN.";
+  }
+}
+
+ITK_THREAD_RETURN_TYPE mitk::FlatRandomForest::PredictCallback(void *arg)
+{
+  typedef itk::MultiThreader::ThreadInfoStruct ThreadInfoType;
+  ThreadInfoType *infoStruct = static_cast<ThreadInfoType *>(arg);
+  PredictionData *data = static_cast<PredictionData *>(infoStruct->UserData);
+
+  const FlatRandomForest *forest = data->m_Forest;
+  const long numberOfSamples = data->m_Feature.rows();
+  const long blockSize = forest->m_BlockSize;
+  std::vector<double> votes(blockSize * forest->m_ClassLabels.size());
+  std::vector<double> totals(blockSize);
+
+  // Blocks are fetched dynamically, so threads that finish early take over the remaining work.
+  for (long block = data->m_NextBlock++; block * blockSize < numberOfSamples; block = data->m_NextBlock++)
+  {
+    const long begin = block * blockSize;
+    forest->PredictBlock(data, begin, std::min(begin + blockSize, numberOfSamples), votes, totals);
+  }
+
+  return ITK_THREAD_RETURN_VALUE;
+}
+
+void mitk::FlatRandomForest::PredictBlock(PredictionData *data, long begin, long end,
+  std::vector<double> &votes, std::vector<double> &totals) const
+{
+  const long numberOfSamples = data->m_Feature.rows();
+  const int numberOfClasses = m_ClassLabels.size();
+  const int isSampleWeighted = m_IsSampleWeighted;
+  const double *features = data->m_Feature.data();
+  const NodeType *nodes = m_Nodes.data();
+
+  std::fill(votes.begin(), votes.end(), 0.0);
+  std::fill(totals.begin(), totals.end(), 0.0);
+
+  for (std::size_t k = 0; k < m_TreeRoots.size(); ++k)
+  {
+    const NodeType *root = nodes + m_TreeRoots[k];
+    const double treeWeight = data->m_TreeWeights ? (*data->m_TreeWeights)(k, 0) : 1.0;
+
+    for (long row = begin; row < end; ++row)
+    {
+      const NodeType *node = root;
+      while (node->Feature >= 0)
+      {
+        const double value = features[node->Feature * numberOfSamples + row];
+        node = nodes + node->Child + ((value < node->Threshold) ? 0 : 1);
+      }
+
+      const double *leaf = m_LeafValues.data() + node->Child * (numberOfClasses + 1);
+      const double leafWeight = isSampleWeighted * leaf[0] + (1 - isSampleWeighted);
+      double *sampleVotes = votes.data() + (row - begin) * numberOfClasses;
+      for (int l = 0; l < numberOfClasses; ++l)
+      {
+        double currentWeight = leaf[l + 1] * leafWeight;
+        if (data->m_TreeWeights)
+        {
+          currentWeight = currentWeight * treeWeight;
+        }
+        sampleVotes[l] += data->m_TruncateVotes ? static_cast<int>(currentWeight) : currentWeight;
+        totals[row - begin] += currentWeight;
+      }
+    }
+  }
+
+  for (long row = begin; row < end; ++row)
+  {
+    const double *sampleVotes = votes.data() + (row - begin) * numberOfClasses;
+
+    if (!data->m_TreeWeights)
+    {
+      // Same handling as vigra: samples with NaN features have no probability.
+      bool containsNaN = false;
+      for (int f = 0; f < m_NumberOfFeatures; ++f)
+      {
+        const double value = features[f * numberOfSamples + row];
+        containsNaN = containsNaN || (value != value);
+      }
+      if (containsNaN)
+      {
+        data->m_ContainsNaN = true;
+        continue;
+      }
+    }
+
+    int maxClass = 0;
+    for (int l = 0; l < numberOfClasses; ++l)
+    {
+      data->m_Probabilities(row, l) = sampleVotes[l] / totals[row - begin];
+      if (data->m_Probabilities(row, l) > data->m_Probabilities(row, maxClass))
+      {
+        maxClass = l;
+      }
+    }
+    data->m_Labels(row, 0) = m_ClassLabels.empty() ? 0 : m_ClassLabels[maxClass];
+  }
+}
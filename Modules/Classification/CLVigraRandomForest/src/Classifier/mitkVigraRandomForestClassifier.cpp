@@ -76,29 +76,9 @@ struct mitk::VigraRandomForestClassifier::TrainingData
   Parameter m_Parameter;
 };
 
-struct mitk::VigraRandomForestClassifier::PredictionData
-{
-  PredictionData(const vigra::RandomForest<int> & refRF,
-    const vigra::MultiArrayView<2, double> refFeature,
-    vigra::MultiArrayView<2, int> refLabel,
-    vigra::MultiArrayView<2, double> refProb,
-    vigra::MultiArrayView<2, double> refTreeWeights)
-    : m_RandomForest(refRF),
-    m_Feature(refFeature),
-    m_Label(refLabel),
-    m_Probabilities(refProb),
-    m_TreeWeights(refTreeWeights)
-  {
-  }
-  const vigra::RandomForest<int> & m_RandomForest;
-  const vigra::MultiArrayView<2, double> m_Feature;
-  vigra::MultiArrayView<2, int> m_Label;
-  vigra::MultiArrayView<2, double> m_Probabilities;
-  vigra::MultiArrayView<2, double> m_TreeWeights;
-};
-
 mitk::VigraRandomForestClassifier::VigraRandomForestClassifier()
-  :m_Parameter(nullptr)
+  :m_Parameter(nullptr),
+  m_FlatRandomForestIsValid(false)
 {
   itk::SimpleMemberCommand<mitk::VigraRandomForestClassifier>::Pointer command = itk::SimpleMemberCommand<mitk::VigraRandomForestClassifier>::New();
   command->SetCallbackFunction(this, &mitk::VigraRandomForestClassifier::ConvertParameter);
@@ -124,6 +104,7 @@ void mitk::VigraRandomForestClassifier::OnlineTrain(const Eigen::MatrixXd & X_in
   vigra::MultiArrayView<2, double> X(vigra::Shape2(X_in.rows(),X_in.cols()),X_in.data());
   vigra::MultiArrayView<2, int> Y(vigra::Shape2(Y_in.rows(),Y_in.cols()),Y_in.data());
   m_RandomForest.onlineLearn(X,Y,0,true);
+  m_FlatRandomForestIsValid = false;
 }
 
 void mitk::VigraRandomForestClassifier::Train(const Eigen::MatrixXd & X_in, const Eigen::MatrixXi &Y_in)
@@ -168,6 +149,7 @@ void mitk::VigraRandomForestClassifier::Train(const Eigen::MatrixXd & X_in, cons
   m_RandomForest.set_options().tree_count(m_Parameter->TreeCount);
   m_RandomForest.ext_param_.class_count_ = data->m_ClassCount;
   m_RandomForest.trees_ = data->trees_;
+  m_FlatRandomForestIsValid = false;
 
   // Set Tree Weights to default
   m_TreeWeights = Eigen::MatrixXd(m_Parameter->TreeCount,1);
@@ -176,68 +158,43 @@ void mitk::VigraRandomForestClassifier::Train(const Eigen::MatrixXd & X_in, cons
 
 Eigen::MatrixXi mitk::VigraRandomForestClassifier::Predict(const Eigen::MatrixXd &X_in)
 {
-  // Initialize output Eigen matrices
-  m_OutProbability = Eigen::MatrixXd(X_in.rows(),m_RandomForest.class_count());
-  m_OutProbability.fill(0);
-  m_OutLabel = Eigen::MatrixXi(X_in.rows(),1);
-  m_OutLabel.fill(0);
-
-  // If no weights provided
-  if(m_TreeWeights.rows() != m_RandomForest.tree_count())
-  {
-    m_TreeWeights = Eigen::MatrixXd(m_RandomForest.tree_count(),1);
-    m_TreeWeights.fill(1);
-  }
+  this->InitializeTreeWeights();
+  this->UpdateFlatRandomForest();
 
+  m_FlatRandomForest.Predict(X_in, nullptr, false, m_OutProbability, m_OutLabel);
 
-  vigra::MultiArrayView<2, double> P(vigra::Shape2(m_OutProbability.rows(),m_OutProbability.cols()),m_OutProbability.data());
-  vigra::MultiArrayView<2, int> Y(vigra::Shape2(m_OutLabel.rows(),m_OutLabel.cols()),m_OutLabel.data());
-  vigra::MultiArrayView<2, double> X(vigra::Shape2(X_in.rows(),X_in.cols()),X_in.data());
-  vigra::MultiArrayView<2, double> TW(vigra::Shape2(m_RandomForest.tree_count(),1),m_TreeWeights.data());
+  m_Probabilities = vigra::MultiArrayView<2, double>(vigra::Shape2(m_OutProbability.rows(),m_OutProbability.cols()),m_OutProbability.data());
+  return m_OutLabel;
+}
 
-  std::unique_ptr<PredictionData> data;
-  data.reset(new PredictionData(m_RandomForest, X, Y, P, TW));
+Eigen::MatrixXi mitk::VigraRandomForestClassifier::PredictWeighted(const Eigen::MatrixXd &X_in)
+{
+  this->InitializeTreeWeights();
+  this->UpdateFlatRandomForest();
 
-  itk::MultiThreader::Pointer threader = itk::MultiThreader::New();
-  threader->SetSingleMethod(this->PredictCallback, data.get());
-  threader->SingleMethodExecute();
+  m_FlatRandomForest.Predict(X_in, &m_TreeWeights, true, m_OutProbability, m_OutLabel);
 
-  m_Probabilities = data->m_Probabilities;
   return m_OutLabel;
 }
 
-Eigen::MatrixXi mitk::VigraRandomForestClassifier::PredictWeighted(const Eigen::MatrixXd &X_in)
+void mitk::VigraRandomForestClassifier::InitializeTreeWeights()
 {
-  // Initialize output Eigen matrices
-  m_OutProbability = Eigen::MatrixXd(X_in.rows(),m_RandomForest.class_count());
-  m_OutProbability.fill(0);
-  m_OutLabel = Eigen::MatrixXi(X_in.rows(),1);
-  m_OutLabel.fill(0);
-
   // If no weights provided
   if(m_TreeWeights.rows() != m_RandomForest.tree_count())
   {
     m_TreeWeights = Eigen::MatrixXd(m_RandomForest.tree_count(),1);
     m_TreeWeights.fill(1);
   }
-
-
-  vigra::MultiArrayView<2, double> P(vigra::Shape2(m_OutProbability.rows(),m_OutProbability.cols()),m_OutProbability.data());
-  vigra::MultiArrayView<2, int> Y(vigra::Shape2(m_OutLabel.rows(),m_OutLabel.cols()),m_OutLabel.data());
-  vigra::MultiArrayView<2, double> X(vigra::Shape2(X_in.rows(),X_in.cols()),X_in.data());
-  vigra::MultiArrayView<2, double> TW(vigra::Shape2(m_RandomForest.tree_count(),1),m_TreeWeights.data());
-
-  std::unique_ptr<PredictionData> data;
-  data.reset( new PredictionData(m_RandomForest,X,Y,P,TW));
-
-  itk::MultiThreader::Pointer threader = itk::MultiThreader::New();
-  threader->SetSingleMethod(this->PredictWeightedCallback,data.get());
-  threader->SingleMethodExecute();
-
-  return m_OutLabel;
 }
 
-
+void mitk::VigraRandomForestClassifier::UpdateFlatRandomForest()
+{
+  if (!m_FlatRandomForestIsValid)
+  {
+    m_FlatRandomForest.Initialize(m_RandomForest);
+    m_FlatRandomForestIsValid = true;
+  }
+}
 
 void mitk::VigraRandomForestClassifier::SetTreeWeights(Eigen::MatrixXd weights)
 {
@@ -297,160 +254,6 @@ ITK_THREAD_RETURN_TYPE mitk::VigraRandomForestClassifier::TrainTreesCallback(voi
 
 }
 
-ITK_THREAD_RETURN_TYPE mitk::VigraRandomForestClassifier::PredictCallback(void * arg)
-{
-  // Get the ThreadInfoStruct
-  typedef itk::MultiThreader::ThreadInfoStruct  ThreadInfoType;
-  ThreadInfoType * infoStruct = static_cast< ThreadInfoType * >( arg );
-  // assigne the thread id
-  const unsigned int threadId = infoStruct->ThreadID;
-
-  // Get the user defined parameters containing all
-  // neccesary informations
-  PredictionData * data = (PredictionData *)(infoStruct->UserData);
-  unsigned int numberOfRowsToCalculate = 0;
-
-  // Get number of rows to calculate
-  numberOfRowsToCalculate = data->m_Feature.shape()[0] / infoStruct->NumberOfThreads;
-
-  unsigned int start_index = numberOfRowsToCalculate * threadId;
-  unsigned int end_index = numberOfRowsToCalculate * (threadId+1);
-
-  // the last thread takes the residuals
-  if(threadId == infoStruct->NumberOfThreads-1) {
-    end_index += data->m_Feature.shape()[0] % infoStruct->NumberOfThreads;
-  }
-
-  vigra::MultiArrayView<2, double> split_features;
-  vigra::MultiArrayView<2, int> split_labels;
-  vigra::MultiArrayView<2, double> split_probability;
-  {
-    vigra::TinyVector<vigra::MultiArrayIndex, 2> lowerBound(start_index,0);
-    vigra::TinyVector<vigra::MultiArrayIndex, 2> upperBound(end_index,data->m_Feature.shape(1));
-    split_features = data->m_Feature.subarray(lowerBound,upperBound);
-  }
-
-  {
-    vigra::TinyVector<vigra::MultiArrayIndex, 2> lowerBound(start_index,0);
-    vigra::TinyVector<vigra::MultiArrayIndex, 2> upperBound(end_index, data->m_Label.shape(1));
-    split_labels = data->m_Label.subarray(lowerBound,upperBound);
-  }
-
-  {
-    vigra::TinyVector<vigra::MultiArrayIndex, 2> lowerBound(start_index,0);
-    vigra::TinyVector<vigra::MultiArrayIndex, 2> upperBound(end_index,data->m_Probabilities.shape(1));
-    split_probability = data->m_Probabilities.subarray(lowerBound,upperBound);
-  }
-
-  data->m_RandomForest.predictLabels(split_features,split_labels);
-  data->m_RandomForest.predictProbabilities(split_features, split_probability);
-
-
-  return 0;
-
-}
-
-ITK_THREAD_RETURN_TYPE mitk::VigraRandomForestClassifier::PredictWeightedCallback(void * arg)
-{
-  // Get the ThreadInfoStruct
-  typedef itk::MultiThreader::ThreadInfoStruct  ThreadInfoType;
-  ThreadInfoType * infoStruct = static_cast< ThreadInfoType * >( arg );
-  // assigne the thread id
-  const unsigned int threadId = infoStruct->ThreadID;
-
-  // Get the user defined parameters containing all
-  // neccesary informations
-  PredictionData * data = (PredictionData *)(infoStruct->UserData);
-  unsigned int numberOfRowsToCalculate = 0;
-
-  // Get number of rows to calculate
-  numberOfRowsToCalculate = data->m_Feature.shape()[0] / infoStruct->NumberOfThreads;
-
-  unsigned int start_index = numberOfRowsToCalculate * threadId;
-  unsigned int end_index = numberOfRowsToCalculate * (threadId+1);
-
-  // the last thread takes the residuals
-  if(threadId == infoStruct->NumberOfThreads-1) {
-    end_index += data->m_Feature.shape()[0] % infoStruct->NumberOfThreads;
-  }
-
-  vigra::MultiArrayView<2, double> split_features;
-  vigra::MultiArrayView<2, int> split_labels;
-  vigra::MultiArrayView<2, double> split_probability;
-  {
-    vigra::TinyVector<vigra::MultiArrayIndex, 2> lowerBound(start_index,0);
-    vigra::TinyVector<vigra::MultiArrayIndex, 2> upperBound(end_index,data->m_Feature.shape(1));
-    split_features = data->m_Feature.subarray(lowerBound,upperBound);
-  }
-
-  {
-    vigra::TinyVector<vigra::MultiArrayIndex, 2> lowerBound(start_index,0);
-    vigra::TinyVector<vigra::MultiArrayIndex, 2> upperBound(end_index, data->m_Label.shape(1));
-    split_labels = data->m_Label.subarray(lowerBound,upperBound);
-  }
-
-  {
-    vigra::TinyVector<vigra::MultiArrayIndex, 2> lowerBound(start_index,0);
-    vigra::TinyVector<vigra::MultiArrayIndex, 2> upperBound(end_index,data->m_Probabilities.shape(1));
-    split_probability = data->m_Probabilities.subarray(lowerBound,upperBound);
-  }
-
-  VigraPredictWeighted(data, split_features,split_labels,split_probability);
-
-  return 0;
-}
-
-
-void mitk::VigraRandomForestClassifier::VigraPredictWeighted(PredictionData * data, vigra::MultiArrayView<2, double> & X, vigra::MultiArrayView<2, int> & Y, vigra::MultiArrayView<2, double> & P)
-{
-
-  int isSampleWeighted = data->m_RandomForest.options_.predict_weighted_;
-//#pragma omp parallel for
-  for(int row=0; row < vigra::rowCount(X); ++row)
-  {
-    vigra::MultiArrayView<2, double, vigra::StridedArrayTag> currentRow(rowVector(X, row));
-
-    vigra::ArrayVector<double>::const_iterator weights;
-
-    //totalWeight == totalVoteCount!
-    double totalWeight = 0.0;
-
-    //Let each tree classify...
-    for(int k=0; k<data->m_RandomForest.options_.tree_count_; ++k)
-    {
-      //get weights predicted by single tree
-      weights = data->m_RandomForest.trees_[k /*tree_indices_[k]*/].predict(currentRow);
-      double numberOfLeafObservations = (*(weights-1));
-
-      //update votecount.
-      for(int l=0; l<data->m_RandomForest.ext_param_.class_count_; ++l)
-      {
-        // Either the original weights are taken or the tree is additional weighted by the number of Observations in the leaf node.
-        double cur_w = weights[l] * (isSampleWeighted * numberOfLeafObservations + (1-isSampleWeighted));
-        cur_w = cur_w * data->m_TreeWeights(k,0);
-        P(row, l) += (int)cur_w;
-        //every weight in totalWeight.
-        totalWeight += cur_w;
-      }
-    }
-
-    //Normalise votes in each row by total VoteCount (totalWeight
-    for(int l=0; l< data->m_RandomForest.ext_param_.class_count_; ++l)
-    {
-      P(row, l) /= vigra::detail::RequiresExplicitCast<double>::cast(totalWeight);
-    }
-    int erg;
-    int maxCol = 0;
-    for (int col=0;col<data->m_RandomForest.class_count();++col)
-    {
-      if (data->m_Probabilities(row,col) > data->m_Probabilities(row, maxCol))
-        maxCol = col;
-    }
-    data->m_RandomForest.ext_param_.to_classlabel(maxCol, erg);
-    Y(row,0) = erg;
-  }
-}
-
 void  mitk::VigraRandomForestClassifier::ConvertParameter()
 {
   if(this->m_Parameter == nullptr)
@@ -585,6 +388,7 @@ void mitk::VigraRandomForestClassifier::SetRandomForest(const vigra::RandomFores
   this->SetSamplesPerTree(rf.options().training_set_proportion_);
   this->UseSampleWithReplacement(rf.options().sample_with_replacement_);
   this->m_RandomForest = rf;
+  this->m_FlatRandomForestIsValid = false;
 }
 
 const vigra::RandomForest<int> & mitk::VigraRandomForestClassifier::GetRandomForest() const
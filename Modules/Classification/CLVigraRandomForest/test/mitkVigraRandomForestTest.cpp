@@ -22,11 +22,16 @@ See LICENSE.txt or http://www.mitk.org for details.
 #include <itkCSVArray2DFileReader.h>
 #include <itkCSVArray2DDataObject.h>
 #include <mitkVigraRandomForestClassifier.h>
+#include <mitkFlatRandomForest.h>
+#include <mitkFeatureMatrixStore.h>
 #include <itkLabelSampler.h>
 #include <itkAddImageFilter.h>
 #include <mitkImageCast.h>
 #include <mitkStandaloneDataStorage.h>
 
+#include <chrono>
+#include <cstdio>
+
 class mitkVigraRandomForestTestSuite : public mitk::TestFixture
 {
   CPPUNIT_TEST_SUITE(mitkVigraRandomForestTestSuite  );
@@ -39,6 +44,8 @@ class mitkVigraRandomForestTestSuite : public mitk::TestFixture
   MITK_TEST(TrainThreadedDecisionForest_MatlabDataSet_shouldReturnTrue);
   MITK_TEST(PredictWeightedDecisionForest_SetWeightsToZero_shouldReturnTrue);
   MITK_TEST(TrainThreadedDecisionForest_BreastCancerDataSet_shouldReturnTrue);
+  MITK_TEST(PredictFlatRandomForest_BreastCancerDataSet_shouldMatchVigra);
+  MITK_TEST(PredictFromStore_BreastCancerDataSet_shouldMatchMatrix);
   CPPUNIT_TEST_SUITE_END();
 
 private:
@@ -176,6 +183,117 @@ public:
   }
 
 
+  // ------------------------------------------------------------------------------------------------------
+  // ------------------------------------------------------------------------------------------------------
+  /*
+  Compare the compiled forest with the prediction of vigra and report the throughput of both.
+  */
+  void PredictFlatRandomForest_BreastCancerDataSet_shouldMatchVigra()
+  {
+    auto & Features_Training = FeatureData_Cancer.first;
+    auto & Features_Testing = FeatureData_Cancer.second;
+    auto & Labels_Training = LabelData_Cancer.first;
+
+    classifier->Train(Features_Training,Labels_Training);
+    Eigen::MatrixXi classes = classifier->Predict(Features_Testing);
+    const vigra::RandomForest<int> & rf = classifier->GetRandomForest();
+
+    // Repeat the test samples to get a measurable amount of work
+    const unsigned int repetitions = 200;
+    MatrixDoubleType X(Features_Testing.rows() * repetitions, Features_Testing.cols());
+    for (unsigned int i = 0; i < repetitions; ++i)
+    {
+      X.block(i * Features_Testing.rows(), 0, Features_Testing.rows(), Features_Testing.cols()) = Features_Testing;
+    }
+
+    MatrixDoubleType vigraProbabilities = MatrixDoubleType::Zero(X.rows(), rf.class_count());
+    MatrixIntType vigraLabels = MatrixIntType::Zero(X.rows(), 1);
+    vigra::MultiArrayView<2, double> vigraX(vigra::Shape2(X.rows(),X.cols()),X.data());
+    vigra::MultiArrayView<2, double> vigraP(vigra::Shape2(vigraProbabilities.rows(),vigraProbabilities.cols()),vigraProbabilities.data());
+    vigra::MultiArrayView<2, int> vigraY(vigra::Shape2(vigraLabels.rows(),vigraLabels.cols()),vigraLabels.data());
+
+    auto start = std::chrono::steady_clock::now();
+    rf.predictProbabilities(vigraX, vigraP);
+    rf.predictLabels(vigraX, vigraY);
+    std::chrono::duration<double> vigraTime = std::chrono::steady_clock::now() - start;
+
+    mitk::FlatRandomForest flatForest;
+    flatForest.Initialize(rf);
+    MatrixDoubleType flatProbabilities;
+    MatrixIntType flatLabels;
+
+    start = std::chrono::steady_clock::now();
+    flatForest.Predict(X, nullptr, false, flatProbabilities, flatLabels);
+    std::chrono::duration<double> flatTime = std::chrono::steady_clock::now() - start;
+
+    MITK_INFO << "Random forest prediction of " << X.rows() << " samples: vigra (single thread) "
+              << X.rows() / vigraTime.count() << " samples/s, compiled forest "
+              << X.rows() / flatTime.count() << " samples/s";
+
+    MITK_TEST_CONDITION(flatForest.GetNumberOfTrees() == rf.tree_count(), "Compiled forest has all trees.");
+    MITK_TEST_CONDITION((flatProbabilities - vigraProbabilities).cwiseAbs().maxCoeff() == 0, "Compiled forest reproduces the probabilities of vigra.");
+    MITK_TEST_CONDITION(flatLabels == vigraLabels, "Compiled forest reproduces the labels of vigra.");
+    MITK_TEST_CONDITION(classes == flatLabels.topRows(Features_Testing.rows()), "Classifier uses the compiled forest.");
+  }
+
+  // ------------------------------------------------------------------------------------------------------
+  // ------------------------------------------------------------------------------------------------------
+  /*
+  Write the dataset of breastcancer patients case by case to a feature store and predict from the store.
+  */
+  void PredictFromStore_BreastCancerDataSet_shouldMatchMatrix()
+  {
+    auto & Features_Training = FeatureData_Cancer.first;
+    auto & Features_Testing = FeatureData_Cancer.second;
+    auto & Labels_Training = LabelData_Cancer.first;
+    auto & Labels_Testing = LabelData_Cancer.second;
+
+    std::string fileName = mitk::IOUtil::CreateTemporaryFile("FeatureStore-XXXXXX.fms");
+    mitk::FeatureMatrixStore::Pointer store = mitk::FeatureMatrixStore::New();
+    store->Create(fileName, Features_Training.cols());
+
+    // Split the training data into two cases, the second one is written feature by feature
+    const unsigned int firstCase = Features_Training.rows() / 2;
+    const unsigned int secondCase = Features_Training.rows() - firstCase;
+    store->AppendCase(Features_Training.topRows(firstCase), Labels_Training.topRows(firstCase));
+    store->BeginCase(Labels_Training.bottomRows(secondCase));
+    for (unsigned int i = 0; i < Features_Training.cols(); ++i)
+    {
+      store->WriteFeature(i, Features_Training.col(i).tail(secondCase));
+    }
+    store->EndCase();
+
+    mitk::FeatureMatrixStore::Pointer testStore = mitk::FeatureMatrixStore::New();
+    testStore->Create(fileName + ".test", Features_Testing.cols());
+    testStore->AppendCase(Features_Testing, Labels_Testing);
+
+    // Reopen the store to test the indexing of the cases
+    store->Close();
+    store->Open(fileName);
+    MITK_TEST_CONDITION(store->GetNumberOfCases() == 2, "Store contains both cases.");
+    MITK_TEST_CONDITION(store->GetNumberOfSamples() == static_cast<unsigned long>(Features_Training.rows()), "Store contains all samples.");
+
+    MatrixDoubleType X;
+    MatrixIntType Y;
+    store->ReadAll(X, Y);
+    MITK_TEST_CONDITION((X - Features_Training.cast<float>().cast<double>()).cwiseAbs().maxCoeff() == 0, "Features are stored with single precision.");
+    MITK_TEST_CONDITION(Y == Labels_Training, "Labels are stored.");
+
+    classifier->Train(X, Y);
+    Eigen::MatrixXi classes = classifier->PredictFromStore(testStore);
+    MatrixDoubleType probabilities = classifier->GetPointWiseProbabilities();
+    MITK_TEST_CONDITION(isIntervall<int>(Labels_Testing,classes,98,99),"Testvalue of cancer data set is in range.");
+
+    Eigen::MatrixXi matrixClasses = classifier->Predict(Features_Testing.cast<float>().cast<double>());
+    MITK_TEST_CONDITION(classes == matrixClasses, "Prediction from store matches prediction from matrix.");
+    MITK_TEST_CONDITION(probabilities == classifier->GetPointWiseProbabilities(), "Probabilities from store match probabilities from matrix.");
+
+    store->Close();
+    testStore->Close();
+    std::remove(fileName.c_str());
+    std::remove((fileName + ".test").c_str());
+  }
+
   // ------------------------------------------------------------------------------------------------------
   // ------------------------------------------------------------------------------------------------------
   /*Reading an file, which includes the trainingdataset and the testdataset, and convert the
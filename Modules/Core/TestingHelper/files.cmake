@@ -3,5 +3,6 @@ file(GLOB_RECURSE H_FILES RELATIVE "${CMAKE_CURRENT_SOURCE_DIR}" "${CMAKE_CURREN
 set(CPP_FILES
   mitkRenderingTestHelper.cpp
   mitkInteractionTestHelper.cpp
+  mitkRenderingBenchmark.cpp
 )
 
@@ -0,0 +1,97 @@
+/*===================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center,
+Division of Medical and Biological Informatics.
+All rights reserved.
+
+This software is distributed WITHOUT ANY WARRANTY; without
+even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE.
+
+See LICENSE.txt or http://www.mitk.org for details.
+
+===================================================================*/
+
+#ifndef mitkRenderingBenchmark_h
+#define mitkRenderingBenchmark_h
+
+#include <mitkDataNode.h>
+#include <mitkRenderingTestHelper.h>
+
+#include <MitkTestingHelperExports.h>
+
+#include <functional>
+#include <string>
+
+namespace mitk
+{
+  /** @brief Measures the rendering performance of the mapper of a single data node.
+   *
+   * The node is rendered offscreen in the render window of a RenderingTestHelper (with a VTK built
+   * against OSMesa no GPU or display is needed). For the node's mapper of the current mapper slot of
+   * the helper (2D or 3D), the benchmark measures
+   *
+   *   - the mean time of Mapper::Update(), i.e. of generating the data for the renderer,
+   *   - the mean time of rendering a frame without any changes,
+   *   - the mean and maximum frame time while scrolling through all slices (2D) or while
+   *     rotating the camera around the scene (3D),
+   *   - the growth of the process memory caused by the first frame.
+   *
+   * Before each measured update the node is invalidated, by default by modifying its data and its property
+   * lists. Mappers that regenerate on other changes (e.g. an update request of the data) need an own
+   * InvalidateFunction. If a GenerateTimeFunction is set, the benchmark counts the measured updates that really
+   * generated the data again (Result::NumberOfRegenerations), so tests can make sure the measured time is not
+   * the one of a mapper that skipped the update. GetRedrawTime() is a generic GenerateTimeFunction for mappers
+   * that pass new data to their VTK mappers when they regenerate.
+   *
+   * All times are in milliseconds. Use Print() to report the result in a format that can be
+   * collected from the test output to track regressions.
+   */
+  class MITKTESTINGHELPER_EXPORT RenderingBenchmark
+  {
+  public:
+    struct Result
+    {
+      std::string Name;
+      double UpdateTime;
+      double RenderTime;
+      double MeanFrameTime;
+      double MaxFrameTime;
+      unsigned int NumberOfFrames;
+      double MemoryUsage;
+      unsigned int NumberOfUpdates;
+      unsigned int NumberOfRegenerations;
+    };
+
+    /** Makes the mapper of the node generate its data again with the next update. */
+    typedef std::function<void(DataNode *node, BaseRenderer *renderer)> InvalidateFunction;
+    /** Returns the time stamp of the last data generation of the mapper for the renderer. It is only called
+     * after updates of the mapper. */
+    typedef std::function<itk::ModifiedTimeType(Mapper *mapper, BaseRenderer *renderer)> GenerateTimeFunction;
+
+    /** @param repetitions Number of measured updates and renderings, also the maximum number of frames while scrolling. */
+    RenderingBenchmark(RenderingTestHelper &renderingTestHelper, unsigned int repetitions = 20);
+
+    /** @brief Adds the node to the data storage of the helper, measures its mapper and removes the node again. */
+    Result Run(const std::string &name, DataNode *node);
+
+    void SetInvalidateFunction(const InvalidateFunction &invalidate);
+    void SetGenerateTimeFunction(const GenerateTimeFunction &generateTime);
+
+    static void Print(const Result &result);
+
+    /** @brief Returns the latest modification time of the VTK actors of a VtkMapper, their VTK mappers and
+     * the input data of these (see vtkProp::GetRedrawMTime()). */
+    static itk::ModifiedTimeType GetRedrawTime(Mapper *mapper, BaseRenderer *renderer);
+
+  private:
+    RenderingTestHelper &m_RenderingTestHelper;
+    unsigned int m_Repetitions;
+    InvalidateFunction m_Invalidate;
+    GenerateTimeFunction m_GenerateTime;
+  };
+}
+
+#endif
@@ -0,0 +1,205 @@
+/*===================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center,
+Division of Medical and Biological Informatics.
+All rights reserved.
+
+This software is distributed WITHOUT ANY WARRANTY; without
+even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE.
+
+See LICENSE.txt or http://www.mitk.org for details.
+
+===================================================================*/
+
+#include <mitkRenderingBenchmark.h>
+
+// MITK
+#include <mitkBaseRenderer.h>
+#include <mitkMapper.h>
+#include <mitkMemoryUtilities.h>
+#include <mitkSliceNavigationController.h>
+#include <mitkVtkMapper.h>
+
+// ITK
+#include <itkTimeProbe.h>
+
+// VTK
+#include <vtkCamera.h>
+#include <vtkProp.h>
+#include <vtkPropCollection.h>
+#include <vtkRenderWindow.h>
+#include <vtkRenderer.h>
+#include <vtkSmartPointer.h>
+
+#include <algorithm>
+
+mitk::RenderingBenchmark::RenderingBenchmark(RenderingTestHelper &renderingTestHelper, unsigned int repetitions)
+  : m_RenderingTestHelper(renderingTestHelper), m_Repetitions(std::max(1u, repetitions))
+{
+  // render into an offscreen buffer, with OSMesa this works without a display
+  m_RenderingTestHelper.GetVtkRenderWindow()->SetOffScreenRendering(1);
+
+  // most mappers check the MTime of the data and of the property lists, not the one of the node
+  m_Invalidate = [](DataNode *node, BaseRenderer *renderer) {
+    if (node->GetData() != nullptr)
+    {
+      node->GetData()->Modified();
+    }
+    node->GetPropertyList()->Modified();
+    node->GetPropertyList(renderer)->Modified();
+  };
+}
+
+void mitk::RenderingBenchmark::SetInvalidateFunction(const InvalidateFunction &invalidate)
+{
+  m_Invalidate = invalidate;
+}
+
+void mitk::RenderingBenchmark::SetGenerateTimeFunction(const GenerateTimeFunction &generateTime)
+{
+  m_GenerateTime = generateTime;
+}
+
+mitk::RenderingBenchmark::Result mitk::RenderingBenchmark::Run(const std::string &name, DataNode *node)
+{
+  Result result;
+  result.Name = name;
+  result.UpdateTime = 0.0;
+  result.RenderTime = 0.0;
+  result.MeanFrameTime = 0.0;
+  result.MaxFrameTime = 0.0;
+  result.NumberOfFrames = 0;
+  result.MemoryUsage = 0.0;
+  result.NumberOfUpdates = 0;
+  result.NumberOfRegenerations = 0;
+
+  BaseRenderer *renderer = BaseRenderer::GetInstance(m_RenderingTestHelper.GetVtkRenderWindow());
+  if (renderer == nullptr || node == nullptr)
+  {
+    MITK_ERROR << "Cannot run rendering benchmark " << name << ": no renderer or no node.";
+    return result;
+  }
+
+  const size_t memoryBefore = MemoryUtilities::GetProcessMemoryUsage();
+  m_RenderingTestHelper.AddNodeToStorage(node);
+  m_RenderingTestHelper.Render();
+  const size_t memoryAfter = MemoryUtilities::GetProcessMemoryUsage();
+  result.MemoryUsage = (static_cast<double>(memoryAfter) - static_cast<double>(memoryBefore)) / (1024.0 * 1024.0);
+
+  // the data of the renderer is generated again, as after changing a property
+  Mapper *mapper = node->GetMapper(renderer->GetMapperID());
+  if (mapper != nullptr)
+  {
+    // the generate time is only queried after updates, querying it may update the mapper (e.g. GetVtkProp())
+    itk::ModifiedTimeType generateTime = m_GenerateTime ? m_GenerateTime(mapper, renderer) : 0;
+
+    itk::TimeProbe updateProbe;
+    for (unsigned int i = 0; i < m_Repetitions; ++i)
+    {
+      if (m_Invalidate)
+      {
+        m_Invalidate(node, renderer);
+      }
+
+      updateProbe.Start();
+      mapper->Update(renderer);
+      updateProbe.Stop();
+
+      ++result.NumberOfUpdates;
+      if (m_GenerateTime)
+      {
+        const itk::ModifiedTimeType updatedGenerateTime = m_GenerateTime(mapper, renderer);
+        if (updatedGenerateTime > generateTime)
+        {
+          ++result.NumberOfRegenerations;
+        }
+        generateTime = updatedGenerateTime;
+      }
+    }
+    result.UpdateTime = 1000.0 * updateProbe.GetMean();
+  }
+
+  // nothing changed, only the frame is drawn again
+  m_RenderingTestHelper.Render();
+  itk::TimeProbe renderProbe;
+  for (unsigned int i = 0; i < m_Repetitions; ++i)
+  {
+    renderProbe.Start();
+    m_RenderingTestHelper.Render();
+    renderProbe.Stop();
+  }
+  result.RenderTime = 1000.0 * renderProbe.GetMean();
+
+  // scroll through the slices in 2D, rotate the camera in 3D
+  const bool render3D = renderer->GetMapperID() == BaseRenderer::Standard3D;
+  Stepper *slice = renderer->GetSliceNavigationController()->GetSlice();
+  unsigned int numberOfFrames = m_Repetitions;
+  if (!render3D)
+  {
+    numberOfFrames = std::min(numberOfFrames, slice->GetSteps());
+  }
+
+  const unsigned int startPosition = slice->GetPos();
+  double totalFrameTime = 0.0;
+  for (unsigned int i = 0; i < numberOfFrames; ++i)
+  {
+    if (render3D)
+    {
+      renderer->GetVtkRenderer()->GetActiveCamera()->Azimuth(360.0 / numberOfFrames);
+    }
+    else
+    {
+      slice->SetPos((startPosition + i + 1) % slice->GetSteps());
+    }
+
+    itk::TimeProbe frameProbe;
+    frameProbe.Start();
+    m_RenderingTestHelper.Render();
+    frameProbe.Stop();
+    const double frameTime = 1000.0 * frameProbe.GetTotal();
+    totalFrameTime += frameTime;
+    result.MaxFrameTime = std::max(result.MaxFrameTime, frameTime);
+  }
+  if (!render3D)
+  {
+    slice->SetPos(startPosition);
+  }
+  result.NumberOfFrames = numberOfFrames;
+  result.MeanFrameTime = numberOfFrames > 0 ? totalFrameTime / numberOfFrames : 0.0;
+
+  m_RenderingTestHelper.GetDataStorage()->Remove(node);
+  return result;
+}
+
+void mitk::RenderingBenchmark::Print(const Result &result)
+{
+  MITK_INFO << "Rendering benchmark " << result.Name << ": update " << result.UpdateTime << " ms ("
+            << result.NumberOfRegenerations << "/" << result.NumberOfUpdates << " regenerated), render "
+            << result.RenderTime << " ms, " << result.NumberOfFrames << " frames " << result.MeanFrameTime
+            << " ms (max " << result.MaxFrameTime << " ms), memory " << result.MemoryUsage << " MB";
+}
+
+itk::ModifiedTimeType mitk::RenderingBenchmark::GetRedrawTime(Mapper *mapper, BaseRenderer *renderer)
+{
+  auto *vtkMapper = dynamic_cast<VtkMapper *>(mapper);
+  vtkProp *prop = vtkMapper != nullptr ? vtkMapper->GetVtkProp(renderer) : nullptr;
+  if (prop == nullptr)
+  {
+    return 0;
+  }
+
+  // the actors of an assembly have to be checked one by one
+  vtkSmartPointer<vtkPropCollection> actors = vtkSmartPointer<vtkPropCollection>::New();
+  prop->GetActors(actors);
+
+  itk::ModifiedTimeType redrawTime = prop->GetRedrawMTime();
+  actors->InitTraversal();
+  for (vtkProp *actor = actors->GetNextProp(); actor != nullptr; actor = actors->GetNextProp())
+  {
+    redrawTime = std::max<itk::ModifiedTimeType>(redrawTime, actor->GetRedrawMTime());
+  }
+  return redrawTime;
+}
@@ -184,6 +184,14 @@ namespace mitk
       /** \brief Timestamp of last update of stored data. */
       itk::TimeStamp m_LastUpdateTime;
 
+      /** \brief Plane, number of thick slices, z spacing and time step of the last thick slab.
+            Used to reslice only the entering slice if the plane moved by one slice. */
+      mitk::PlaneGeometry::Pointer m_ThickSlabPlaneGeometry;
+      int m_ThickSlabNum;
+      double m_ThickSlabZSpacing;
+      int m_ThickSlabTimeStep;
+      itk::TimeStamp m_ThickSlabTime;
+
       /** \brief mmPerPixel relation between pixel and mm. (World spacing).*/
       mitk::ScalarType *m_mmPerPixel;
 
@@ -303,6 +311,19 @@ namespace mitk
       * If the distances have different sign, there is an intersection.
       **/
     bool RenderingGeometryIntersectsImage(const PlaneGeometry *renderingGeometry, SlicedGeometry3D *imageGeometry);
+
+    /**
+      * \brief Returns +1 or -1 if the thick slab of the last update can be shifted by one slice
+      * towards or against the normal of the plane to get the slab of the given plane, 0 otherwise.
+      *
+      * A shift requires that neither the image nor the properties of the node changed since the last
+      * slab and that the plane equals the last plane, except for its origin, which moved by exactly
+      * one slice along the normal.
+      **/
+    int GetThickSlabShift(mitk::BaseRenderer *renderer,
+                          const PlaneGeometry *planeGeometry,
+                          int thickSlicesNum,
+                          double dataZSpacing);
   };
 
 } // namespace mitk
@@ -33,6 +33,7 @@ class vtkGlyphSource2D;
 class vtkGlyph3D;
 class vtkFloatArray;
 class vtkCellArray;
+class vtkTransformFilter;
 
 namespace mitk
 {
@@ -68,6 +69,11 @@ namespace mitk
   * object is returned in GetProp() and so hooked up into the rendering
   * pipeline.
   *
+  * The text actors of labels, distances and angles are kept in pools and
+  * reused when the point set changes. An actor whose text, position and
+  * color stay the same does not render its text texture again, so moving
+  * a single point only updates the texts next to that point.
+  *
   * @section mitkPointSetVtkMapper2D_propertires Applicable Properties
   *
   * Properties that can be set for point sets and influence the PointSetVTKMapper2D are:
@@ -166,6 +172,10 @@ namespace mitk
       vtkSmartPointer<vtkGlyph3D> m_UnselectedGlyph3D;
       vtkSmartPointer<vtkGlyph3D> m_SelectedGlyph3D;
 
+      // transform filters (apply the orientation of the current plane to the glyph shapes)
+      vtkSmartPointer<vtkTransformFilter> m_UnselectedTransformFilter;
+      vtkSmartPointer<vtkTransformFilter> m_SelectedTransformFilter;
+
       // polydata
       vtkSmartPointer<vtkPolyData> m_VtkUnselectedPointListPolyData;
       vtkSmartPointer<vtkPolyData> m_VtkSelectedPointListPolyData;
@@ -177,6 +187,7 @@ namespace mitk
       vtkSmartPointer<vtkActor> m_ContourActor;
       vtkSmartPointer<vtkTextActor> m_VtkTextActor;
 
+      // pools of text actors, the actors which are not needed for the current point set are hidden
       std::vector<vtkSmartPointer<vtkTextActor>> m_VtkTextLabelActors;
       std::vector<vtkSmartPointer<vtkTextActor>> m_VtkTextDistanceActors;
       std::vector<vtkSmartPointer<vtkTextActor>> m_VtkTextAngleActors;
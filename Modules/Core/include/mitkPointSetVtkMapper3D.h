@@ -22,14 +22,19 @@ See LICENSE.txt or http://www.mitk.org for details.
 #include <MitkCoreExports.h>
 #include <vtkSmartPointer.h>
 
+#include <map>
+#include <string>
+
 class vtkActor;
 class vtkCellArray;
+class vtkConeSource;
+class vtkCubeSource;
+class vtkCylinderSource;
+class vtkGlyph3DMapper;
 class vtkPropAssembly;
-class vtkAppendPolyData;
 class vtkPolyData;
-class vtkTubeFilter;
 class vtkPolyDataMapper;
-class vtkTransformPolyDataFilter;
+class vtkSphereSource;
 
 namespace mitk
 {
@@ -42,16 +47,20 @@ namespace mitk
   * and unselected points and the facts, that we also have a contour and
   * labels for the points, the vtk structure is build up the following way:
   *
-  * We have two AppendPolyData, one selected, and one unselected and one
-  * for a contour between the points. Each one is connected to an own
-  * PolyDaraMapper and an Actor. The different color for the unselected and
-  * selected state and for the contour is read from properties.
+  * All points of one selection state are rendered as instances of one
+  * vtkGlyph3DMapper, the glyph shape (sphere, cube, cone, cylinder) is
+  * chosen per point by its point type. The labels of all points are merged
+  * into one polydata per selection state, the text geometry of each label
+  * is generated once and cached. The pipeline is built only once, when the
+  * point set changes only the point coordinates and labels are refilled.
+  * The different color for the unselected and selected state and for the
+  * contour is read from properties.
   *
   * "unselectedcolor", "selectedcolor" and "contourcolor" are the strings,
   * that are looked for. Pointlabels are added besides the selected or the
   * deselected points.
   *
-  * Then the three Actors are combined inside a vtkPropAssembly and this
+  * Then the Actors are combined inside a vtkPropAssembly and this
   * object is returned in GetProp() and so hooked up into the rendering
   * pipeline.
 
@@ -132,25 +141,39 @@ namespace mitk
     /// All connections between two points (used for contour drawing)
     vtkSmartPointer<vtkCellArray> m_PointConnections;
 
-    vtkSmartPointer<vtkAppendPolyData> m_vtkSelectedPointList;
-    vtkSmartPointer<vtkAppendPolyData> m_vtkUnselectedPointList;
-
     vtkSmartPointer<vtkPoints> m_VtkPoints;
     vtkSmartPointer<vtkCellArray> m_VtkPointConnections;
 
-    vtkSmartPointer<vtkTransformPolyDataFilter> m_VtkPointsTransformer;
+    /// Positions and glyph types of the selected and the unselected points, in world coordinates
+    vtkSmartPointer<vtkPolyData> m_VtkSelectedPointsPolyData;
+    vtkSmartPointer<vtkPolyData> m_VtkUnselectedPointsPolyData;
+
+    /// Glyph shapes, indexed by the glyph type of each point
+    vtkSmartPointer<vtkSphereSource> m_SphereSource;
+    vtkSmartPointer<vtkCubeSource> m_CubeSource;
+    vtkSmartPointer<vtkConeSource> m_ConeSource;
+    vtkSmartPointer<vtkCylinderSource> m_CylinderSource;
+    vtkSmartPointer<vtkSphereSource> m_InputDeviceSphereSource;
+
+    vtkSmartPointer<vtkGlyph3DMapper> m_VtkSelectedGlyphMapper;
+    vtkSmartPointer<vtkGlyph3DMapper> m_VtkUnselectedGlyphMapper;
 
-    vtkSmartPointer<vtkPolyDataMapper> m_VtkSelectedPolyDataMapper;
-    vtkSmartPointer<vtkPolyDataMapper> m_VtkUnselectedPolyDataMapper;
+    /// Text geometry of all labels, merged into one polydata per selection state
+    vtkSmartPointer<vtkPolyData> m_VtkSelectedLabelsPolyData;
+    vtkSmartPointer<vtkPolyData> m_VtkUnselectedLabelsPolyData;
+    vtkSmartPointer<vtkPolyDataMapper> m_VtkSelectedLabelsMapper;
+    vtkSmartPointer<vtkPolyDataMapper> m_VtkUnselectedLabelsMapper;
 
     vtkSmartPointer<vtkActor> m_SelectedActor;
     vtkSmartPointer<vtkActor> m_UnselectedActor;
+    vtkSmartPointer<vtkActor> m_SelectedLabelsActor;
+    vtkSmartPointer<vtkActor> m_UnselectedLabelsActor;
     vtkSmartPointer<vtkActor> m_ContourActor;
 
     vtkSmartPointer<vtkPropAssembly> m_PointsAssembly;
 
-    // help for contour between points
-    vtkSmartPointer<vtkAppendPolyData> m_vtkTextList;
+    /// Text geometry of each label text, generated only once
+    std::map<std::string, vtkSmartPointer<vtkPolyData>> m_LabelGeometries;
 
     // variables to be able to log, how many inputs have been added to PolyDatas
     unsigned int m_NumberOfSelectedAdded;
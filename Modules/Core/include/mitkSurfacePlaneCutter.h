@@ -0,0 +1,118 @@
+/*===================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center,
+Division of Medical and Biological Informatics.
+All rights reserved.
+
+This software is distributed WITHOUT ANY WARRANTY; without
+even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE.
+
+See LICENSE.txt or http://www.mitk.org for details.
+
+===================================================================*/
+
+#ifndef mitkSurfacePlaneCutter_h
+#define mitkSurfacePlaneCutter_h
+
+#include <MitkCoreExports.h>
+
+#include <itkMultiThreader.h>
+#include <vtkPolyData.h>
+#include <vtkSmartPointer.h>
+
+#include <list>
+#include <vector>
+
+namespace mitk
+{
+  /**
+   * @brief Cuts a surface with planes, reusing a spatial index of the cells between the cuts.
+   *
+   * The cells of the input are sorted into a bounding volume hierarchy once per modification
+   * of the input. A cut only visits the cells whose bounding boxes intersect the plane; these
+   * cells are cut by vtkCutter (in several threads for large contours), so the result is the
+   * same as cutting the whole surface, including the interpolated point and cell data.
+   *
+   * The last contours are kept in a least recently used cache which is keyed by the plane
+   * (normal and distance to the origin), so scrolling back to a slice or re-rendering a
+   * slice in another render window does not cut again. The cache is cleared whenever the
+   * input changes. Cached contours are shared, they must not be modified by the caller.
+   *
+   * The input is referenced, not copied. The class is not thread safe.
+   */
+  class MITKCORE_EXPORT SurfacePlaneCutter
+  {
+  public:
+    SurfacePlaneCutter();
+    ~SurfacePlaneCutter();
+
+    /** @brief Sets the surface to cut. The index is rebuilt if the input or its MTime differ from the last call. */
+    void SetInput(vtkPolyData *input);
+    vtkPolyData *GetInput() const;
+
+    /** @brief Number of contours that are kept in the cache (default 16, 0 disables the cache). */
+    void SetCacheSize(unsigned int cacheSize);
+    unsigned int GetCacheSize() const;
+
+    /** @brief Number of threads used to cut large contours (default 0, i.e. the ITK default). */
+    void SetNumberOfThreads(unsigned int numberOfThreads);
+    unsigned int GetNumberOfThreads() const;
+
+    /** @brief Returns the contour of the input in the plane through origin with the given normal. */
+    vtkSmartPointer<vtkPolyData> Cut(const double origin[3], const double normal[3]);
+
+    void Clear();
+
+  private:
+    struct Box
+    {
+      float Min[3];
+      float Max[3];
+    };
+
+    struct Node
+    {
+      Box Bounds;
+      /** inner nodes: index of the first child (the second child follows), leaves: -1 */
+      int FirstChild;
+      /** leaves: range of cells in m_CellOrder */
+      unsigned int FirstCell;
+      unsigned int NumCells;
+    };
+
+    struct CacheEntry
+    {
+      double Normal[3];
+      double Distance;
+      vtkSmartPointer<vtkPolyData> Contour;
+    };
+
+    struct CutData;
+
+    void BuildIndex();
+    void BuildNode(int node, unsigned int first, unsigned int count);
+    static bool Intersects(const Box &box, const double normal[3], double distance);
+    void CollectCells(const double normal[3], double distance, std::vector<vtkIdType> &cells) const;
+    vtkSmartPointer<vtkPolyData> CutCells(const vtkIdType *cells, vtkIdType numCells, const double origin[3], const double normal[3]) const;
+    static ITK_THREAD_RETURN_TYPE CutCallback(void *arg);
+
+    SurfacePlaneCutter(const SurfacePlaneCutter &) = delete;
+    SurfacePlaneCutter &operator=(const SurfacePlaneCutter &) = delete;
+
+    vtkSmartPointer<vtkPolyData> m_Input;
+    unsigned long m_InputMTime;
+
+    std::vector<Box> m_CellBounds;
+    std::vector<unsigned int> m_CellOrder;
+    std::vector<Node> m_Nodes;
+
+    std::list<CacheEntry> m_Cache;
+    unsigned int m_CacheSize;
+    unsigned int m_NumberOfThreads;
+  };
+} // namespace mitk
+
+#endif // mitkSurfacePlaneCutter_h
@@ -22,27 +22,31 @@ See LICENSE.txt or http://www.mitk.org for details.
 #include "mitkVtkMapper.h"
 #include <MitkCoreExports.h>
 
+#include <memory>
+
 // VTK
 #include <vtkSmartPointer.h>
 class vtkAssembly;
-class vtkCutter;
-class vtkPlane;
 class vtkLookupTable;
 class vtkGlyph3D;
 class vtkArrowSource;
 class vtkReverseSense;
+class vtkTransformPolyDataFilter;
 
 namespace mitk
 {
   class Surface;
+  class SurfacePlaneCutter;
 
   /**
     * @brief Vtk-based mapper for cutting 2D slices out of Surfaces.
     *
-    * The mapper uses a vtkCutter filter to cut out slices (contours) of the 3D
+    * The mapper uses a SurfacePlaneCutter to cut out slices (contours) of the 3D
     * volume and render these slices as vtkPolyData. The data is transformed
     * according to its geometry before cutting, to support the geometry concept
-    * of MITK.
+    * of MITK. The transformed surface and the spatial index of the cutter are
+    * shared by all render windows and only rebuilt when the surface or its
+    * geometry change; recently cut contours are cached.
     *
     * Properties:
     * \b Surface.2D.Line Width: Thickness of the rendered lines in 2D.
@@ -103,15 +107,6 @@ namespace mitk
          * @brief m_Mapper VTK mapper for all types of 2D polydata e.g. werewolves.
          */
       vtkSmartPointer<vtkPolyDataMapper> m_Mapper;
-      /**
-         * @brief m_Cutter Filter to cut out the 2D slice.
-         */
-      vtkSmartPointer<vtkCutter> m_Cutter;
-      /**
-         * @brief m_CuttingPlane The plane where to cut off the 2D slice.
-         */
-      vtkSmartPointer<vtkPlane> m_CuttingPlane;
-
       /**
        * @brief m_NormalMapper Mapper for the normals.
        */
@@ -151,12 +146,18 @@ namespace mitk
     /** \brief The LocalStorageHandler holds all (three) LocalStorages for the three 2D render windows. */
     mitk::LocalStorageHandler<LocalStorage> m_LSH;
 
+    /** \brief Transforms the surface according to its geometry, shared by all render windows. */
+    vtkSmartPointer<vtkTransformPolyDataFilter> m_TransformFilter;
+
+    /** \brief Cuts the transformed surface, shared by all render windows. */
+    std::unique_ptr<SurfacePlaneCutter> m_PlaneCutter;
+
     /**
      * @brief UpdateVtkTransform Overwrite the method of the base class.
      *
      * The base class transforms the actor according to the respective
      * geometry which is correct for most cases. This mapper, however,
-     * uses a vtkCutter to cut out a contour. To cut out the correct
+     * uses a SurfacePlaneCutter to cut out a contour. To cut out the correct
      * contour, the data has to be transformed beforehand. Else the
      * current plane geometry will point the cutter to en empty location
      * (if the surface does have a geometry, which is a rather rare case).
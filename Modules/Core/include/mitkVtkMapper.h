@@ -35,6 +35,10 @@ See LICENSE.txt or http://www.mitk.org for details.
 #include <vtkPropAssembly.h>
 #include <vtkProperty.h>
 
+#include <functional>
+#include <future>
+#include <set>
+
 class vtkProp;
 class vtkProp3D;
 class vtkActor;
@@ -144,7 +148,38 @@ namespace mitk
     /** virtual destructor in order to derive from this class */
     ~VtkMapper() override;
 
+    /** \brief Returns true if the boolean property "asynchronous update" of the node is set (off by default).
+    *
+    * Mappers which support it generate long-running geometry on a worker thread, see StartAsynchronousUpdate(),
+    * and keep rendering their previous geometry in the meantime.
+    */
+    bool IsAsynchronousUpdateEnabled(mitk::BaseRenderer *renderer) const;
+
+    /** \brief Runs \a job on a worker thread. Returns false if the job of an earlier call is still running.
+    *
+    * The job must only access data it owns, e.g. copies of the input and the object receiving the
+    * generated geometry, captured by value. The mapper swaps the generated geometry in on the main thread
+    * once FinishAsynchronousUpdate() returned true.
+    */
+    bool StartAsynchronousUpdate(std::function<void()> job);
+
+    /** \brief Returns true once the job started by StartAsynchronousUpdate() has finished.
+    *
+    * While the job is running, a timer of the interactor of \a renderer's render window checks it periodically
+    * without rendering, and requests one rendering once the job has finished, so the result is picked up as
+    * soon as it is ready. Exceptions thrown by the job are logged.
+    */
+    bool FinishAsynchronousUpdate(mitk::BaseRenderer *renderer);
+
+    /** \brief Returns true if the job started by StartAsynchronousUpdate() has not been finished yet. */
+    bool IsAsynchronousUpdateRunning() const;
+
   private:
+    /** \brief The job started by StartAsynchronousUpdate(); the destructor waits for it. */
+    std::shared_future<void> m_AsynchronousUpdate;
+    /** \brief Render windows which already poll the running job. */
+    std::set<vtkRenderWindow *> m_PolledRenderWindows;
+
     /** copy constructor */
     VtkMapper(const VtkMapper &);
 
@@ -25,6 +25,7 @@ See LICENSE.txt or http://www.mitk.org for details.
 
 #include <map>
 #include <utility>
+#include <vector>
 
 class vtkRenderWindow;
 class vtkLight;
@@ -32,6 +33,9 @@ class vtkLightKit;
 class vtkWorldPointPicker;
 class vtkPointPicker;
 class vtkCellPicker;
+class vtkCellLocator;
+class vtkDataSet;
+class vtkProp;
 class vtkTextActor;
 class vtkTextProperty;
 class vtkAssemblyPath;
@@ -120,7 +124,8 @@ namespace mitk
     to the selected point should be considered. PointPicking also need a tolerance around the picking
     position to select the closest point in the mesh. The CellPicker performs very well, if the
     foreground surface part (i.e. the surfacepart that is closest to the scene's cameras) needs to be
-    picked. */
+    picked. For larger meshes, the CellPicker intersects the pick ray with a cell locator of each mesh
+    instead of testing all cells, see UpdatePickLocators(). */
     itkSetEnumMacro(PickingMode, PickingMode);
     itkGetEnumMacro(PickingMode, PickingMode);
 
@@ -215,6 +220,24 @@ namespace mitk
     /** \brief Set parallel projection, remove the interactor and the lights of VTK. */
     bool Initialize2DvtkCamera();
 
+    /** \brief Registers a cell locator for the data set of each actor of the given props at the cell picker.
+     *
+     * The locators are built when a data set is picked for the first time and only rebuilt when the
+     * data set has been modified since, so a pick does not have to test every cell of large meshes.
+     * Locators of data sets that are not picked any more are released.
+     */
+    void UpdatePickLocators(const std::vector<vtkProp *> &props) const;
+
+    /** \brief Releases the locators of data sets that are only referenced by their locator any more
+     * (e.g. because a mapper replaced its input), so the cache does not keep them alive.
+     */
+    void ReleaseUnusedPickLocators();
+
+    /** \brief Releases all locators when a node is removed from the data storage, so none of them keeps
+     * a data set of the node alive.
+     */
+    void OnNodeRemoved(const mitk::DataNode *node);
+
     bool m_InitNeeded;
     bool m_ResizeNeeded;
     MapperSlotId m_CameraInitializedForMapperID;
@@ -224,6 +247,9 @@ namespace mitk
     vtkPointPicker *m_PointPicker;
     vtkCellPicker *m_CellPicker;
 
+    typedef std::map<vtkDataSet *, vtkSmartPointer<vtkCellLocator>> PickLocatorMapType;
+    mutable PickLocatorMapType m_PickLocators;
+
     PickingMode m_PickingMode;
 
     // Explicit use of SmartPointer to avoid circular #includes
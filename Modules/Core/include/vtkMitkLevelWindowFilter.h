@@ -23,6 +23,9 @@ class vtkPiecewiseFunction;
 #include <vtkThreadedImageAlgorithm.h>
 
 #include <MitkCoreExports.h>
+
+#include <vector>
+
 /** Documentation
 * \brief Applies the grayvalue or color/opacity level window to scalar or RGB(A) images.
 *
@@ -33,6 +36,12 @@ class vtkPiecewiseFunction;
 *
 * The filter is also able to apply an opacity level window to RGBA images.
 *
+* For scalar images of 8 and 16 bit integer type, the colors of all possible
+* values are computed once per modification of the lookup table (or transfer
+* and opacity function) and the pixels are mapped by a single table access.
+* Other scalar types mapped by a linear vtkLookupTable use a vectorizable loop
+* to compute the table indices. Clipping is resolved per row, not per pixel.
+*
 * \ingroup Renderer
 */
 class MITKCORE_EXPORT vtkMitkLevelWindowFilter : public vtkThreadedImageAlgorithm
@@ -80,6 +89,11 @@ protected:
    */
   void ThreadedExecute(vtkImageData *inData, vtkImageData *outData, int extent[6], int id) override;
 
+  /** \brief Builds the lookup table and the colors of integer images before the threads are started. */
+  int RequestData(vtkInformation *request,
+                  vtkInformationVector **inputVector,
+                  vtkInformationVector *outputVector) override;
+
   //  /** Standard VTK filter method to apply the filter. See VTK documentation.*/
   int RequestInformation(vtkInformation *request,
                          vtkInformationVector **inputVector,
@@ -98,5 +112,16 @@ private:
   double m_MaxOpacity;
 
   double m_ClippingBounds[4];
+
+  /** \brief Computes m_IntegerLookupTable for 8 and 16 bit integer scalar images, clears it for other images. */
+  void UpdateIntegerLookupTable(vtkImageData *inData);
+
+  /** RGBA color (packed as in the output image) of every value of the input scalar type, starting with the smallest value. */
+  std::vector<unsigned int> m_IntegerLookupTable;
+  /** Same as m_IntegerLookupTable for linear vtkLookupTables, but rounded to the nearest table index as done for unclipped extents. */
+  std::vector<unsigned int> m_IntegerFastLookupTable;
+  int m_IntegerLookupTableMinValue;
+  int m_IntegerLookupTableScalarType;
+  vtkMTimeType m_IntegerLookupTableMTime;
 };
 #endif
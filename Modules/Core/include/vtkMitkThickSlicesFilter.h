@@ -29,6 +29,10 @@ See LICENSE.txt or http://www.mitk.org for details.
 
 #include "vtkThreadedImageAlgorithm.h"
 
+#include <vector>
+
+class vtkDataArray;
+
 class MITKCORE_EXPORT vtkMitkThickSlicesFilter : public vtkThreadedImageAlgorithm
 {
 public:
@@ -59,6 +63,22 @@ public:
     MEAN
   };
 
+  // Description:
+  // Get/Set how the slab moved since the last update. With 0 (default) the
+  // input holds all slices of the slab. With +1 or -1 the slab moved by one
+  // slice towards higher or lower z and the input only holds the entering
+  // slice; the slices of the last update are reused and, for integer types,
+  // the sums of SUM and MEAN are updated incrementally. The shift applies to
+  // the next update only.
+  vtkSetClampMacro(SlabShift, int, -1, 1);
+  vtkGetMacro(SlabShift, int);
+
+  // Description:
+  // Returns whether the slab of the last update can be shifted with the given
+  // entering slice, i.e. whether it is a single slice with the same x/y
+  // extent and scalar type.
+  bool CanShiftSlab(vtkImageData *enteringSlice);
+
 protected:
   vtkMitkThickSlicesFilter();
   ~vtkMitkThickSlicesFilter() override{};
@@ -79,8 +99,27 @@ protected:
                            int threadId) override;
 
   int m_CurrentMode;
+  int SlabShift;
 
 private:
+  // Copies the input into the slab, or replaces the leaving slice by the
+  // entering one if the slab is shifted.
+  bool UpdateSlab(vtkImageData *input, vtkDataArray *inputArray);
+
+  // slices of the last update as ring buffer
+  std::vector<char> m_SlabBuffer;
+  int m_SlabFirst;
+  int m_SlabSize;
+  int m_SlabZMin;
+  int m_SlabExtent[4];
+  vtkIdType m_SliceSize;
+  int m_SlabScalarType;
+
+  // running sum of the slab for integer types in SUM and MEAN mode
+  std::vector<double> m_SlabSum;
+  bool m_SlabSumValid;
+  bool m_RecomputeSlabSum;
+
   vtkMitkThickSlicesFilter(const vtkMitkThickSlicesFilter &); // Not implemented.
   void operator=(const vtkMitkThickSlicesFilter &);           // Not implemented.
 
@@ -59,6 +59,8 @@ See LICENSE.txt or http://www.mitk.org for details.
 #include <itkRGBAPixel.h>
 #include <mitkRenderingModeProperty.h>
 
+#include <cmath>
+
 mitk::ImageVtkMapper2D::ImageVtkMapper2D()
 {
 }
@@ -254,24 +256,54 @@ void mitk::ImageVtkMapper2D::GenerateDataForRenderer(mitk::BaseRenderer *rendere
 
     localStorage->m_Reslicer->SetOutputDimensionality(3);
     localStorage->m_Reslicer->SetOutputSpacingZDirection(dataZSpacing);
-    localStorage->m_Reslicer->SetOutputExtentZDirection(-thickSlicesNum, 0 + thickSlicesNum);
 
-    // Do the reslicing. Modified() is called to make sure that the reslicer is
-    // executed even though the input geometry information did not change; this
-    // is necessary when the input /em data, but not the /em geometry changes.
-    localStorage->m_TSFilter->SetThickSliceMode(thickSlicesMode - 1);
-    localStorage->m_TSFilter->SetInputData(localStorage->m_Reslicer->GetVtkOutput());
+    // When scrolling by one slice, only the entering slice is resliced and the
+    // thick slices filter shifts the slab of the last update.
+    int slabShift = 0;
+    if (abstractGeometry == nullptr)
+    {
+      slabShift = this->GetThickSlabShift(renderer, planeGeometry, thickSlicesNum, dataZSpacing);
+    }
+    if (slabShift != 0)
+    {
+      localStorage->m_Reslicer->SetOutputExtentZDirection(slabShift * thickSlicesNum, slabShift * thickSlicesNum);
+      localStorage->m_Reslicer->Modified();
+      localStorage->m_Reslicer->Update();
+      if (!localStorage->m_TSFilter->CanShiftSlab(localStorage->m_Reslicer->GetVtkOutput()))
+      {
+        slabShift = 0;
+      }
+    }
 
-    // vtkFilter=>mitkFilter=>vtkFilter update mechanism will fail without calling manually
-    localStorage->m_Reslicer->Modified();
-    localStorage->m_Reslicer->Update();
+    if (slabShift == 0)
+    {
+      localStorage->m_Reslicer->SetOutputExtentZDirection(-thickSlicesNum, 0 + thickSlicesNum);
+
+      // Do the reslicing. Modified() is called to make sure that the reslicer is
+      // executed even though the input geometry information did not change; this
+      // is necessary when the input /em data, but not the /em geometry changes.
+      // vtkFilter=>mitkFilter=>vtkFilter update mechanism will fail without calling manually
+      localStorage->m_Reslicer->Modified();
+      localStorage->m_Reslicer->Update();
+    }
 
+    localStorage->m_TSFilter->SetThickSliceMode(thickSlicesMode - 1);
+    localStorage->m_TSFilter->SetSlabShift(slabShift);
+    localStorage->m_TSFilter->SetInputData(localStorage->m_Reslicer->GetVtkOutput());
     localStorage->m_TSFilter->Modified();
     localStorage->m_TSFilter->Update();
     localStorage->m_ReslicedImage = localStorage->m_TSFilter->GetOutput();
+
+    localStorage->m_ThickSlabPlaneGeometry = abstractGeometry == nullptr ? planeGeometry->Clone() : nullptr;
+    localStorage->m_ThickSlabNum = thickSlicesNum;
+    localStorage->m_ThickSlabZSpacing = dataZSpacing;
+    localStorage->m_ThickSlabTimeStep = this->GetTimestep();
+    localStorage->m_ThickSlabTime.Modified();
   }
   else
   {
+    localStorage->m_ThickSlabPlaneGeometry = nullptr;
+
     // this is needed when thick mode was enable bevore. These variable have to be reset to default values
     localStorage->m_Reslicer->SetOutputDimensionality(2);
     localStorage->m_Reslicer->SetOutputSpacingZDirection(1.0);
@@ -1071,12 +1103,70 @@ bool mitk::ImageVtkMapper2D::RenderingGeometryIntersectsImage(const PlaneGeometr
   return false;
 }
 
+int mitk::ImageVtkMapper2D::GetThickSlabShift(mitk::BaseRenderer *renderer,
+                                              const PlaneGeometry *planeGeometry,
+                                              int thickSlicesNum,
+                                              double dataZSpacing)
+{
+  LocalStorage *localStorage = m_LSH.GetLocalStorage(renderer);
+  const PlaneGeometry *lastPlaneGeometry = localStorage->m_ThickSlabPlaneGeometry;
+  if (lastPlaneGeometry == nullptr || planeGeometry == nullptr || thickSlicesNum != localStorage->m_ThickSlabNum ||
+      dataZSpacing != localStorage->m_ThickSlabZSpacing || this->GetTimestep() != localStorage->m_ThickSlabTimeStep)
+  {
+    return 0;
+  }
+
+  // the slices of the last slab must still be valid
+  const Image *image = this->GetInput();
+  const DataNode *node = this->GetDataNode();
+  if ((localStorage->m_ThickSlabTime < image->GetPipelineMTime()) ||
+      (localStorage->m_ThickSlabTime <
+       image->GetTimeGeometry()->GetGeometryForTimeStep(this->GetTimestep())->GetMTime()) ||
+      (localStorage->m_ThickSlabTime < node->GetMTime()) ||
+      (localStorage->m_ThickSlabTime < node->GetPropertyList()->GetMTime()) ||
+      (localStorage->m_ThickSlabTime < node->GetPropertyList(renderer)->GetMTime()))
+  {
+    return 0;
+  }
+
+  // in-plane, nothing may have changed
+  if (!Equal(planeGeometry->GetAxisVector(0), lastPlaneGeometry->GetAxisVector(0), eps) ||
+      !Equal(planeGeometry->GetAxisVector(1), lastPlaneGeometry->GetAxisVector(1), eps) ||
+      !Equal(planeGeometry->GetSpacing(), lastPlaneGeometry->GetSpacing(), eps))
+  {
+    return 0;
+  }
+
+  // the origin must have moved by one slice along the normal
+  Vector3D normal = planeGeometry->GetNormal();
+  normal.Normalize();
+  const Vector3D offset = planeGeometry->GetOrigin() - lastPlaneGeometry->GetOrigin();
+  const double alongNormal = offset * normal;
+  const double tolerance = 1e-3 * dataZSpacing;
+  if ((offset - normal * alongNormal).GetNorm() > tolerance)
+  {
+    return 0;
+  }
+  if (std::abs(alongNormal - dataZSpacing) < tolerance)
+  {
+    return 1;
+  }
+  if (std::abs(alongNormal + dataZSpacing) < tolerance)
+  {
+    return -1;
+  }
+  return 0;
+}
+
 mitk::ImageVtkMapper2D::LocalStorage::~LocalStorage()
 {
 }
 
 mitk::ImageVtkMapper2D::LocalStorage::LocalStorage()
-  : m_VectorComponentExtractor(vtkSmartPointer<vtkImageExtractComponents>::New())
+  : m_VectorComponentExtractor(vtkSmartPointer<vtkImageExtractComponents>::New()),
+    m_ThickSlabNum(0),
+    m_ThickSlabZSpacing(0.0),
+    m_ThickSlabTimeStep(-1)
 {
   m_LevelWindowFilter = vtkSmartPointer<vtkMitkLevelWindowFilter>::New();
 
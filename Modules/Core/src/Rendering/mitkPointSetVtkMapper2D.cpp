@@ -66,6 +66,12 @@ mitk::PointSetVtkMapper2D::LocalStorage::LocalStorage()
   m_UnselectedGlyph3D = vtkSmartPointer<vtkGlyph3D>::New();
   m_SelectedGlyph3D = vtkSmartPointer<vtkGlyph3D>::New();
 
+  // transform filters
+  m_UnselectedTransformFilter = vtkSmartPointer<vtkTransformFilter>::New();
+  m_UnselectedTransformFilter->SetInputConnection(m_UnselectedGlyphSource2D->GetOutputPort());
+  m_SelectedTransformFilter = vtkSmartPointer<vtkTransformFilter>::New();
+  m_SelectedTransformFilter->SetInputConnection(m_SelectedGlyphSource2D->GetOutputPort());
+
   // polydata
   m_VtkUnselectedPointListPolyData = vtkSmartPointer<vtkPolyData>::New();
   m_VtkSelectedPointListPolyData = vtkSmartPointer<vtkPolyData>::New();
@@ -156,33 +162,40 @@ static bool makePerpendicularVector2D(const mitk::Vector2D &in, mitk::Vector2D &
     return false;
 }
 
-void mitk::PointSetVtkMapper2D::CreateVTKRenderObjects(mitk::BaseRenderer *renderer)
+// Returns the text actor with the given index from the pool. New actors are only created and
+// added to the propassembly if the pool is too small.
+static vtkTextActor *GetPooledTextActor(std::vector<vtkSmartPointer<vtkTextActor>> &pool,
+                                        unsigned int index,
+                                        vtkPropAssembly *propAssembly)
 {
-  LocalStorage *ls = m_LSH.GetLocalStorage(renderer);
-
-  unsigned i = 0;
-
-  // The vtk text actors need to be removed manually from the propassembly
-  // since the same vtk text actors are not overwriten within this function,
-  // but new actors are added to the propassembly each time this function is executed.
-  // Thus, the actors from the last call must be removed in the beginning.
-  for (i = 0; i < ls->m_VtkTextLabelActors.size(); i++)
+  if (index >= pool.size())
   {
-    if (ls->m_PropAssembly->GetParts()->IsItemPresent(ls->m_VtkTextLabelActors.at(i)))
-      ls->m_PropAssembly->RemovePart(ls->m_VtkTextLabelActors.at(i));
+    vtkSmartPointer<vtkTextActor> textActor = vtkSmartPointer<vtkTextActor>::New();
+    pool.push_back(textActor);
+    propAssembly->AddPart(textActor);
   }
+  pool[index]->VisibilityOn();
+  return pool[index];
+}
 
-  for (i = 0; i < ls->m_VtkTextDistanceActors.size(); i++)
+// hides the text actors of the pool which are not used for the current point set
+static void HideUnusedTextActors(std::vector<vtkSmartPointer<vtkTextActor>> &pool, unsigned int numberOfUsedActors)
+{
+  for (unsigned int i = numberOfUsedActors; i < pool.size(); ++i)
   {
-    if (ls->m_PropAssembly->GetParts()->IsItemPresent(ls->m_VtkTextDistanceActors.at(i)))
-      ls->m_PropAssembly->RemovePart(ls->m_VtkTextDistanceActors.at(i));
+    pool[i]->VisibilityOff();
   }
+}
 
-  for (i = 0; i < ls->m_VtkTextAngleActors.size(); i++)
-  {
-    if (ls->m_PropAssembly->GetParts()->IsItemPresent(ls->m_VtkTextAngleActors.at(i)))
-      ls->m_PropAssembly->RemovePart(ls->m_VtkTextAngleActors.at(i));
-  }
+void mitk::PointSetVtkMapper2D::CreateVTKRenderObjects(mitk::BaseRenderer *renderer)
+{
+  LocalStorage *ls = m_LSH.GetLocalStorage(renderer);
+
+  // The text actors are reused, those which are not needed any more are hidden below.
+  // They are not hidden in advance, toggling the visibility would render all texts again.
+  unsigned int numberOfLabels = 0;
+  unsigned int numberOfDistances = 0;
+  unsigned int numberOfAngles = 0;
 
   // initialize polydata here, otherwise we have update problems when
   // executing this function again
@@ -241,10 +254,6 @@ void mitk::PointSetVtkMapper2D::CreateVTKRenderObjects(mitk::BaseRenderer *rende
 
   ls->m_DistancesBetweenPoints->Reset();
 
-  ls->m_VtkTextLabelActors.clear();
-  ls->m_VtkTextDistanceActors.clear();
-  ls->m_VtkTextAngleActors.clear();
-
   ls->m_UnselectedScales->SetNumberOfComponents(3);
   ls->m_SelectedScales->SetNumberOfComponents(3);
 
@@ -275,6 +284,16 @@ void mitk::PointSetVtkMapper2D::CreateVTKRenderObjects(mitk::BaseRenderer *rende
 
   vtkLinearTransform *dataNodeTransform = input->GetGeometry()->GetVtkTransform();
 
+  // label and color are the same for all points
+  const mitk::StringProperty *labelProperty =
+    dynamic_cast<mitk::StringProperty *>(this->GetDataNode()->GetProperty("label"));
+  float labelColor[4] = {1.0, 1.0, 0.0, 1.0};
+  if (labelProperty != nullptr)
+  {
+    // check if there is a color property
+    GetDataNode()->GetColor(labelColor);
+  }
+
   int count = 0;
 
   for (pointsIter = itkPointSet->GetPoints()->Begin(); pointsIter != itkPointSet->GetPoints()->End(); pointsIter++)
@@ -327,11 +346,9 @@ void mitk::PointSetVtkMapper2D::CreateVTKRenderObjects(mitk::BaseRenderer *rende
 
       //---- LABEL -----//
       // paint label for each point if available
-      if (dynamic_cast<mitk::StringProperty *>(this->GetDataNode()->GetProperty("label")) != nullptr)
+      if (labelProperty != nullptr)
       {
-        const char *pointLabel =
-          dynamic_cast<mitk::StringProperty *>(this->GetDataNode()->GetProperty("label"))->GetValue();
-        std::string l = pointLabel;
+        std::string l = labelProperty->GetValue();
         if (input->GetSize() > 1)
         {
           std::stringstream ss;
@@ -339,20 +356,13 @@ void mitk::PointSetVtkMapper2D::CreateVTKRenderObjects(mitk::BaseRenderer *rende
           l.append(ss.str());
         }
 
-        ls->m_VtkTextActor = vtkSmartPointer<vtkTextActor>::New();
-
-        ls->m_VtkTextActor->SetDisplayPosition(pt2d[0] + text2dDistance, pt2d[1] + text2dDistance);
-        ls->m_VtkTextActor->SetInput(l.c_str());
-        ls->m_VtkTextActor->GetTextProperty()->SetOpacity(100);
-
-        float unselectedColor[4] = {1.0, 1.0, 0.0, 1.0};
-
-        // check if there is a color property
-        GetDataNode()->GetColor(unselectedColor);
-
-        ls->m_VtkTextActor->GetTextProperty()->SetColor(unselectedColor[0], unselectedColor[1], unselectedColor[2]);
-
-        ls->m_VtkTextLabelActors.push_back(ls->m_VtkTextActor);
+        // the setters do not modify the actor if the values did not change
+        vtkTextActor *textActor =
+          GetPooledTextActor(ls->m_VtkTextLabelActors, numberOfLabels++, ls->m_PropAssembly);
+        textActor->SetDisplayPosition(pt2d[0] + text2dDistance, pt2d[1] + text2dDistance);
+        textActor->SetInput(l.c_str());
+        textActor->GetTextProperty()->SetOpacity(100);
+        textActor->GetTextProperty()->SetColor(labelColor[0], labelColor[1], labelColor[2]);
       }
     }
 
@@ -370,17 +380,17 @@ void mitk::PointSetVtkMapper2D::CreateVTKRenderObjects(mitk::BaseRenderer *rende
       // If "show distant lines" is enabled this condition is disregarded.
       if (!pointsOnSameSideOfPlane || m_ShowDistantLines)
       {
-        vtkSmartPointer<vtkLine> line = vtkSmartPointer<vtkLine>::New();
+        vtkIdType line[2];
 
         ls->m_ContourPoints->InsertNextPoint(lastP[0], lastP[1], lastP[2]);
-        line->GetPointIds()->SetId(0, NumberContourPoints);
+        line[0] = NumberContourPoints;
         NumberContourPoints++;
 
         ls->m_ContourPoints->InsertNextPoint(point[0], point[1], point[2]);
-        line->GetPointIds()->SetId(1, NumberContourPoints);
+        line[1] = NumberContourPoints;
         NumberContourPoints++;
 
-        ls->m_ContourLines->InsertNextCell(line);
+        ls->m_ContourLines->InsertNextCell(2, line);
 
         if (m_ShowDistances) // calculate and print distance between adjacent points
         {
@@ -395,13 +405,11 @@ void mitk::PointSetVtkMapper2D::CreateVTKRenderObjects(mitk::BaseRenderer *rende
                                     vec2d); // text is rendered within text2dDistance perpendicular to current line
           Vector2D pos2d = (lastPt2d.GetVectorFromOrigin() + pt2d.GetVectorFromOrigin()) * 0.5 + vec2d * text2dDistance;
 
-          ls->m_VtkTextActor = vtkSmartPointer<vtkTextActor>::New();
-
-          ls->m_VtkTextActor->SetDisplayPosition(pos2d[0], pos2d[1]);
-          ls->m_VtkTextActor->SetInput(buffer.str().c_str());
-          ls->m_VtkTextActor->GetTextProperty()->SetColor(0.0, 1.0, 0.0);
-
-          ls->m_VtkTextDistanceActors.push_back(ls->m_VtkTextActor);
+          vtkTextActor *textActor =
+            GetPooledTextActor(ls->m_VtkTextDistanceActors, numberOfDistances++, ls->m_PropAssembly);
+          textActor->SetDisplayPosition(pos2d[0], pos2d[1]);
+          textActor->SetInput(buffer.str().c_str());
+          textActor->GetTextProperty()->SetColor(0.0, 1.0, 0.0);
         }
 
         if (m_ShowAngles && count > 1) // calculate and print angle between connected lines
@@ -420,13 +428,11 @@ void mitk::PointSetVtkMapper2D::CreateVTKRenderObjects(mitk::BaseRenderer *rende
           // middle between two vectors that enclose the angle
           Vector2D pos2d = lastPt2d.GetVectorFromOrigin() + vec2d * text2dDistance * text2dDistance;
 
-          ls->m_VtkTextActor = vtkSmartPointer<vtkTextActor>::New();
-
-          ls->m_VtkTextActor->SetDisplayPosition(pos2d[0], pos2d[1]);
-          ls->m_VtkTextActor->SetInput(buffer.str().c_str());
-          ls->m_VtkTextActor->GetTextProperty()->SetColor(0.0, 1.0, 0.0);
-
-          ls->m_VtkTextAngleActors.push_back(ls->m_VtkTextActor);
+          vtkTextActor *textActor =
+            GetPooledTextActor(ls->m_VtkTextAngleActors, numberOfAngles++, ls->m_PropAssembly);
+          textActor->SetDisplayPosition(pos2d[0], pos2d[1]);
+          textActor->SetInput(buffer.str().c_str());
+          textActor->GetTextProperty()->SetColor(0.0, 1.0, 0.0);
         }
       }
     }
@@ -438,21 +444,10 @@ void mitk::PointSetVtkMapper2D::CreateVTKRenderObjects(mitk::BaseRenderer *rende
     }
   }
 
-  // add each single text actor to the assembly
-  for (i = 0; i < ls->m_VtkTextLabelActors.size(); i++)
-  {
-    ls->m_PropAssembly->AddPart(ls->m_VtkTextLabelActors.at(i));
-  }
-
-  for (i = 0; i < ls->m_VtkTextDistanceActors.size(); i++)
-  {
-    ls->m_PropAssembly->AddPart(ls->m_VtkTextDistanceActors.at(i));
-  }
-
-  for (i = 0; i < ls->m_VtkTextAngleActors.size(); i++)
-  {
-    ls->m_PropAssembly->AddPart(ls->m_VtkTextAngleActors.at(i));
-  }
+  // hide the text actors which are left over from a larger point set
+  HideUnusedTextActors(ls->m_VtkTextLabelActors, numberOfLabels);
+  HideUnusedTextActors(ls->m_VtkTextDistanceActors, numberOfDistances);
+  HideUnusedTextActors(ls->m_VtkTextAngleActors, numberOfAngles);
 
   //---- CONTOUR -----//
 
@@ -521,15 +516,13 @@ void mitk::PointSetVtkMapper2D::CreateVTKRenderObjects(mitk::BaseRenderer *rende
     ls->m_UnselectedGlyphSource2D->FilledOff();
 
   // apply transform
-  vtkSmartPointer<vtkTransformFilter> transformFilterU = vtkSmartPointer<vtkTransformFilter>::New();
-  transformFilterU->SetInputConnection(ls->m_UnselectedGlyphSource2D->GetOutputPort());
-  transformFilterU->SetTransform(transform);
+  ls->m_UnselectedTransformFilter->SetTransform(transform);
 
   ls->m_VtkUnselectedPointListPolyData->SetPoints(ls->m_UnselectedPoints);
   ls->m_VtkUnselectedPointListPolyData->GetPointData()->SetVectors(ls->m_UnselectedScales);
 
   // apply transform of current plane to glyphs
-  ls->m_UnselectedGlyph3D->SetSourceConnection(transformFilterU->GetOutputPort());
+  ls->m_UnselectedGlyph3D->SetSourceConnection(ls->m_UnselectedTransformFilter->GetOutputPort());
   ls->m_UnselectedGlyph3D->SetInputData(ls->m_VtkUnselectedPointListPolyData);
   ls->m_UnselectedGlyph3D->SetScaleModeToScaleByVector();
   ls->m_UnselectedGlyph3D->SetVectorModeToUseVector();
@@ -547,15 +540,13 @@ void mitk::PointSetVtkMapper2D::CreateVTKRenderObjects(mitk::BaseRenderer *rende
   ls->m_SelectedGlyphSource2D->FilledOff();
 
   // apply transform
-  vtkSmartPointer<vtkTransformFilter> transformFilterS = vtkSmartPointer<vtkTransformFilter>::New();
-  transformFilterS->SetInputConnection(ls->m_SelectedGlyphSource2D->GetOutputPort());
-  transformFilterS->SetTransform(transform);
+  ls->m_SelectedTransformFilter->SetTransform(transform);
 
   ls->m_VtkSelectedPointListPolyData->SetPoints(ls->m_SelectedPoints);
   ls->m_VtkSelectedPointListPolyData->GetPointData()->SetVectors(ls->m_SelectedScales);
 
   // apply transform of current plane to glyphs
-  ls->m_SelectedGlyph3D->SetSourceConnection(transformFilterS->GetOutputPort());
+  ls->m_SelectedGlyph3D->SetSourceConnection(ls->m_SelectedTransformFilter->GetOutputPort());
   ls->m_SelectedGlyph3D->SetInputData(ls->m_VtkSelectedPointListPolyData);
   ls->m_SelectedGlyph3D->SetScaleModeToScaleByVector();
   ls->m_SelectedGlyph3D->SetVectorModeToUseVector();
@@ -27,44 +27,211 @@ See LICENSE.txt or http://www.mitk.org for details.
 #include <vtkConeSource.h>
 #include <vtkCubeSource.h>
 #include <vtkCylinderSource.h>
-#include <vtkPolyDataAlgorithm.h>
+#include <vtkGlyph3DMapper.h>
+#include <vtkPointData.h>
+#include <vtkPolyData.h>
 #include <vtkPolyDataMapper.h>
 #include <vtkPropAssembly.h>
 #include <vtkProperty.h>
 #include <vtkRenderer.h>
 #include <vtkSphereSource.h>
-#include <vtkTransform.h>
-#include <vtkTransformPolyDataFilter.h>
 #include <vtkTubeFilter.h>
+#include <vtkUnsignedCharArray.h>
 #include <vtkVectorText.h>
 
 #include <cstdlib>
+#include <sstream>
+#include <vector>
 
 #include <mitkPropertyObserver.h>
 #include <vtk_glew.h>
 
+namespace
+{
+  typedef std::map<std::string, vtkSmartPointer<vtkPolyData>> LabelGeometryMap;
+
+  const char *const GlyphTypeArrayName = "glyph type";
+
+  // indices of the glyph sources of the glyph mappers
+  enum GlyphType
+  {
+    SphereGlyph = 0,
+    CubeGlyph,
+    ConeGlyph,
+    CylinderGlyph,
+    InputDeviceSphereGlyph,
+    NumberOfGlyphTypes
+  };
+
+  void InitializePolyData(vtkPolyData *polyData, bool withGlyphTypes)
+  {
+    polyData->SetPoints(vtkSmartPointer<vtkPoints>::New());
+    if (withGlyphTypes)
+    {
+      vtkSmartPointer<vtkUnsignedCharArray> glyphTypes = vtkSmartPointer<vtkUnsignedCharArray>::New();
+      glyphTypes->SetName(GlyphTypeArrayName);
+      polyData->GetPointData()->AddArray(glyphTypes);
+    }
+    else
+    {
+      polyData->SetPolys(vtkSmartPointer<vtkCellArray>::New());
+    }
+  }
+
+  void ResetPolyData(vtkPolyData *polyData)
+  {
+    polyData->GetPoints()->Reset();
+    if (vtkDataArray *glyphTypes = polyData->GetPointData()->GetArray(GlyphTypeArrayName))
+      glyphTypes->Reset();
+    else
+      polyData->GetPolys()->Reset();
+  }
+
+  // the arrays are filled in place, so the pipeline has to be told explicitly
+  void FinishPolyData(vtkPolyData *polyData)
+  {
+    polyData->GetPoints()->Modified();
+    if (vtkDataArray *glyphTypes = polyData->GetPointData()->GetArray(GlyphTypeArrayName))
+      glyphTypes->Modified();
+    else
+      polyData->GetPolys()->Modified();
+    polyData->Modified();
+  }
+
+  void AddGlyph(vtkPolyData *polyData, const double position[3], GlyphType glyphType)
+  {
+    polyData->GetPoints()->InsertNextPoint(position);
+    static_cast<vtkUnsignedCharArray *>(polyData->GetPointData()->GetArray(GlyphTypeArrayName))
+      ->InsertNextValue(glyphType);
+  }
+
+  // Returns the text geometry of a label. Geometries still used from the last update are taken over,
+  // only texts which were not shown before are triangulated.
+  vtkPolyData *GetLabelGeometry(const std::string &text,
+                                LabelGeometryMap &labelGeometries,
+                                LabelGeometryMap &previousLabelGeometries)
+  {
+    auto labelIter = labelGeometries.find(text);
+    if (labelIter != labelGeometries.end())
+      return labelIter->second;
+
+    vtkSmartPointer<vtkPolyData> geometry;
+    auto previousIter = previousLabelGeometries.find(text);
+    if (previousIter != previousLabelGeometries.end())
+    {
+      geometry = previousIter->second;
+    }
+    else
+    {
+      vtkSmartPointer<vtkVectorText> label = vtkSmartPointer<vtkVectorText>::New();
+      label->SetText(text.c_str());
+      label->Update();
+      geometry = vtkSmartPointer<vtkPolyData>::New();
+      geometry->ShallowCopy(label->GetOutput());
+    }
+    labelGeometries[text] = geometry;
+    return geometry;
+  }
+
+  // moves the label geometry besides the point and appends it to the label polydata
+  void AddLabel(vtkPolyData *labels, vtkPolyData *labelGeometry, const double position[3])
+  {
+    const double scale = 5.7;
+    vtkPoints *points = labels->GetPoints();
+    const vtkIdType offset = points->GetNumberOfPoints();
+
+    double p[3];
+    for (vtkIdType i = 0; i < labelGeometry->GetNumberOfPoints(); ++i)
+    {
+      labelGeometry->GetPoint(i, p);
+      points->InsertNextPoint(
+        position[0] + 2 + scale * p[0], position[1] + 2 + scale * p[1], position[2] + scale * p[2]);
+    }
+
+    vtkCellArray *labelPolys = labelGeometry->GetPolys();
+    vtkCellArray *polys = labels->GetPolys();
+    std::vector<vtkIdType> cell;
+    vtkIdType numberOfCellPoints;
+    vtkIdType *cellPoints;
+    for (labelPolys->InitTraversal(); labelPolys->GetNextCell(numberOfCellPoints, cellPoints);)
+    {
+      cell.resize(numberOfCellPoints);
+      for (vtkIdType i = 0; i < numberOfCellPoints; ++i)
+        cell[i] = cellPoints[i] + offset;
+      polys->InsertNextCell(numberOfCellPoints, cell.data());
+    }
+  }
+}
+
 const mitk::PointSet *mitk::PointSetVtkMapper3D::GetInput()
 {
   return static_cast<const mitk::PointSet *>(GetDataNode()->GetData());
 }
 
 mitk::PointSetVtkMapper3D::PointSetVtkMapper3D()
-  : m_vtkSelectedPointList(nullptr),
-    m_vtkUnselectedPointList(nullptr),
-    m_VtkSelectedPolyDataMapper(nullptr),
-    m_VtkUnselectedPolyDataMapper(nullptr),
-    m_vtkTextList(nullptr),
-    m_NumberOfSelectedAdded(0),
-    m_NumberOfUnselectedAdded(0),
-    m_PointSize(1.0),
-    m_ContourRadius(0.5)
+  : m_NumberOfSelectedAdded(0), m_NumberOfUnselectedAdded(0), m_PointSize(1.0), m_ContourRadius(0.5)
 {
   // propassembly
   m_PointsAssembly = vtkSmartPointer<vtkPropAssembly>::New();
 
+  // glyph shapes, their size is set in CreateVTKRenderObjects
+  m_SphereSource = vtkSmartPointer<vtkSphereSource>::New();
+  m_SphereSource->SetThetaResolution(20);
+  m_SphereSource->SetPhiResolution(20);
+  m_CubeSource = vtkSmartPointer<vtkCubeSource>::New();
+  m_ConeSource = vtkSmartPointer<vtkConeSource>::New();
+  m_ConeSource->SetResolution(20);
+  m_CylinderSource = vtkSmartPointer<vtkCylinderSource>::New();
+  m_CylinderSource->SetResolution(20);
+  // MouseOrientation Tool (PositionTracker)
+  m_InputDeviceSphereSource = vtkSmartPointer<vtkSphereSource>::New();
+  m_InputDeviceSphereSource->SetThetaResolution(10);
+  m_InputDeviceSphereSource->SetPhiResolution(10);
+
+  m_VtkSelectedPointsPolyData = vtkSmartPointer<vtkPolyData>::New();
+  m_VtkUnselectedPointsPolyData = vtkSmartPointer<vtkPolyData>::New();
+  m_VtkSelectedGlyphMapper = vtkSmartPointer<vtkGlyph3DMapper>::New();
+  m_VtkUnselectedGlyphMapper = vtkSmartPointer<vtkGlyph3DMapper>::New();
+
+  // all points of a selection state are instances of one glyph mapper, the glyph type of a point selects its source
+  vtkPolyData *pointsPolyData[2] = {m_VtkSelectedPointsPolyData, m_VtkUnselectedPointsPolyData};
+  vtkGlyph3DMapper *glyphMappers[2] = {m_VtkSelectedGlyphMapper, m_VtkUnselectedGlyphMapper};
+  for (int i = 0; i < 2; ++i)
+  {
+    InitializePolyData(pointsPolyData[i], true);
+
+    glyphMappers[i]->SetInputData(pointsPolyData[i]);
+    glyphMappers[i]->SetSourceConnection(SphereGlyph, m_SphereSource->GetOutputPort());
+    glyphMappers[i]->SetSourceConnection(CubeGlyph, m_CubeSource->GetOutputPort());
+    glyphMappers[i]->SetSourceConnection(ConeGlyph, m_ConeSource->GetOutputPort());
+    glyphMappers[i]->SetSourceConnection(CylinderGlyph, m_CylinderSource->GetOutputPort());
+    glyphMappers[i]->SetSourceConnection(InputDeviceSphereGlyph, m_InputDeviceSphereSource->GetOutputPort());
+    glyphMappers[i]->SourceIndexingOn();
+    glyphMappers[i]->SetSourceIndexArray(GlyphTypeArrayName);
+    glyphMappers[i]->SetRange(0, NumberOfGlyphTypes);
+    glyphMappers[i]->ScalingOff();
+    glyphMappers[i]->OrientOff();
+    glyphMappers[i]->ScalarVisibilityOff();
+  }
+
+  m_VtkSelectedLabelsPolyData = vtkSmartPointer<vtkPolyData>::New();
+  InitializePolyData(m_VtkSelectedLabelsPolyData, false);
+  m_VtkUnselectedLabelsPolyData = vtkSmartPointer<vtkPolyData>::New();
+  InitializePolyData(m_VtkUnselectedLabelsPolyData, false);
+  m_VtkSelectedLabelsMapper = vtkSmartPointer<vtkPolyDataMapper>::New();
+  m_VtkSelectedLabelsMapper->SetInputData(m_VtkSelectedLabelsPolyData);
+  m_VtkUnselectedLabelsMapper = vtkSmartPointer<vtkPolyDataMapper>::New();
+  m_VtkUnselectedLabelsMapper->SetInputData(m_VtkUnselectedLabelsPolyData);
+
   // creating actors to be able to set transform
   m_SelectedActor = vtkSmartPointer<vtkActor>::New();
+  m_SelectedActor->SetMapper(m_VtkSelectedGlyphMapper);
   m_UnselectedActor = vtkSmartPointer<vtkActor>::New();
+  m_UnselectedActor->SetMapper(m_VtkUnselectedGlyphMapper);
+  m_SelectedLabelsActor = vtkSmartPointer<vtkActor>::New();
+  m_SelectedLabelsActor->SetMapper(m_VtkSelectedLabelsMapper);
+  m_UnselectedLabelsActor = vtkSmartPointer<vtkActor>::New();
+  m_UnselectedLabelsActor->SetMapper(m_VtkUnselectedLabelsMapper);
   m_ContourActor = vtkSmartPointer<vtkActor>::New();
 }
 
@@ -78,6 +245,8 @@ void mitk::PointSetVtkMapper3D::ReleaseGraphicsResources(vtkWindow *renWin)
 
   m_SelectedActor->ReleaseGraphicsResources(renWin);
   m_UnselectedActor->ReleaseGraphicsResources(renWin);
+  m_SelectedLabelsActor->ReleaseGraphicsResources(renWin);
+  m_UnselectedLabelsActor->ReleaseGraphicsResources(renWin);
   m_ContourActor->ReleaseGraphicsResources(renWin);
 }
 
@@ -87,22 +256,22 @@ void mitk::PointSetVtkMapper3D::ReleaseGraphicsResources(mitk::BaseRenderer *ren
 
   m_SelectedActor->ReleaseGraphicsResources(renderer->GetRenderWindow());
   m_UnselectedActor->ReleaseGraphicsResources(renderer->GetRenderWindow());
+  m_SelectedLabelsActor->ReleaseGraphicsResources(renderer->GetRenderWindow());
+  m_UnselectedLabelsActor->ReleaseGraphicsResources(renderer->GetRenderWindow());
   m_ContourActor->ReleaseGraphicsResources(renderer->GetRenderWindow());
 }
 
 void mitk::PointSetVtkMapper3D::CreateVTKRenderObjects()
 {
-  m_vtkSelectedPointList = vtkSmartPointer<vtkAppendPolyData>::New();
-  m_vtkUnselectedPointList = vtkSmartPointer<vtkAppendPolyData>::New();
-
   m_PointsAssembly->VisibilityOn();
 
-  if (m_PointsAssembly->GetParts()->IsItemPresent(m_SelectedActor))
-    m_PointsAssembly->RemovePart(m_SelectedActor);
-  if (m_PointsAssembly->GetParts()->IsItemPresent(m_UnselectedActor))
-    m_PointsAssembly->RemovePart(m_UnselectedActor);
-  if (m_PointsAssembly->GetParts()->IsItemPresent(m_ContourActor))
-    m_PointsAssembly->RemovePart(m_ContourActor);
+  vtkActor *actors[5] = {
+    m_SelectedActor, m_UnselectedActor, m_SelectedLabelsActor, m_UnselectedLabelsActor, m_ContourActor};
+  for (vtkActor *actor : actors)
+  {
+    if (m_PointsAssembly->GetParts()->IsItemPresent(actor))
+      m_PointsAssembly->RemovePart(actor);
+  }
 
   // exceptional displaying for PositionTracker -> MouseOrientationTool
   int mapperID;
@@ -140,6 +309,15 @@ void mitk::PointSetVtkMapper3D::CreateVTKRenderObjects()
   if (pointSizeProp.IsNotNull())
     m_PointSize = pointSizeProp->GetValue();
 
+  // the sources are only executed again if the size has changed
+  m_SphereSource->SetRadius(m_PointSize / 2.0f);
+  m_InputDeviceSphereSource->SetRadius(m_PointSize / 2.0f);
+  m_CubeSource->SetXLength(m_PointSize / 2);
+  m_CubeSource->SetYLength(m_PointSize / 2);
+  m_CubeSource->SetZLength(m_PointSize / 2);
+  m_ConeSource->SetRadius(m_PointSize / 2.0f);
+  m_CylinderSource->SetRadius(m_PointSize / 2.0f);
+
   // get the property for creating a label onto every point only once
   bool showLabel = true;
   this->GetDataNode()->GetBoolProperty("show label", showLabel);
@@ -204,13 +382,23 @@ void mitk::PointSetVtkMapper3D::CreateVTKRenderObjects()
   // inserted manually and can not be visualized according to the PointData (selected/unselected)
   bool pointDataBroken = (itkPointSet->GetPointData()->Size() != itkPointSet->GetPoints()->Size());
 
-  // now add an object for each point in data
+  // the polydata are refilled in place, the glyph mappers and actors stay connected
+  ResetPolyData(m_VtkSelectedPointsPolyData);
+  ResetPolyData(m_VtkUnselectedPointsPolyData);
+  ResetPolyData(m_VtkSelectedLabelsPolyData);
+  ResetPolyData(m_VtkUnselectedLabelsPolyData);
+
+  LabelGeometryMap previousLabelGeometries;
+  previousLabelGeometries.swap(m_LabelGeometries);
+
+  const double origin[3] = {0.0, 0.0, 0.0};
+
+  // now add a glyph for each point in data
   mitk::PointSet::PointDataContainer::Iterator pointDataIter = itkPointSet->GetPointData()->Begin();
   for (ptIdx = 0; ptIdx < nbPoints; ++ptIdx) // pointDataIter moved at end of loop
   {
     double currentPoint[3];
     m_WorldPositions->GetPoint(ptIdx, currentPoint);
-    vtkSmartPointer<vtkPolyDataAlgorithm> source;
 
     // check for the pointtype in data and decide which geom-object to take and then add to the selected or unselected
     // list
@@ -220,123 +408,62 @@ void mitk::PointSetVtkMapper3D::CreateVTKRenderObjects()
     else
       pointType = pointDataIter.Value().pointSpec;
 
+    GlyphType glyphType = SphereGlyph;
+    const double *glyphPosition = currentPoint;
     switch (pointType)
     {
       case mitk::PTUNDEFINED:
-      {
-        vtkSmartPointer<vtkSphereSource> sphere = vtkSmartPointer<vtkSphereSource>::New();
-        sphere->SetRadius(m_PointSize / 2.0f);
-        sphere->SetCenter(currentPoint);
-        // sphere->SetCenter(pointsIter.Value()[0],pointsIter.Value()[1],pointsIter.Value()[2]);
-
         // MouseOrientation Tool (PositionTracker)
-        if (isInputDevice)
-        {
-          sphere->SetThetaResolution(10);
-          sphere->SetPhiResolution(10);
-        }
-        else
-        {
-          sphere->SetThetaResolution(20);
-          sphere->SetPhiResolution(20);
-        }
-        source = sphere;
-      }
-      break;
+        glyphType = isInputDevice ? InputDeviceSphereGlyph : SphereGlyph;
+        break;
       case mitk::PTSTART:
-      {
-        vtkSmartPointer<vtkCubeSource> cube = vtkSmartPointer<vtkCubeSource>::New();
-        cube->SetXLength(m_PointSize / 2);
-        cube->SetYLength(m_PointSize / 2);
-        cube->SetZLength(m_PointSize / 2);
-        cube->SetCenter(currentPoint);
-        source = cube;
-      }
-      break;
+        glyphType = CubeGlyph;
+        break;
       case mitk::PTCORNER:
-      {
-        vtkSmartPointer<vtkConeSource> cone = vtkSmartPointer<vtkConeSource>::New();
-        cone->SetRadius(m_PointSize / 2.0f);
-        cone->SetCenter(currentPoint);
-        cone->SetResolution(20);
-        source = cone;
-      }
-      break;
+        glyphType = ConeGlyph;
+        break;
       case mitk::PTEDGE:
-      {
-        vtkSmartPointer<vtkCylinderSource> cylinder = vtkSmartPointer<vtkCylinderSource>::New();
-        cylinder->SetRadius(m_PointSize / 2.0f);
-        cylinder->SetCenter(currentPoint);
-        cylinder->SetResolution(20);
-        source = cylinder;
-      }
-      break;
+        glyphType = CylinderGlyph;
+        break;
       case mitk::PTEND:
-      {
-        vtkSmartPointer<vtkSphereSource> sphere = vtkSmartPointer<vtkSphereSource>::New();
-        sphere->SetRadius(m_PointSize / 2.0f);
         // no SetCenter?? this functionality should be explained!
         // otherwise: join with default block!
-        sphere->SetThetaResolution(20);
-        sphere->SetPhiResolution(20);
-        source = sphere;
-      }
-      break;
+        glyphPosition = origin;
+        break;
       default:
-      {
-        vtkSmartPointer<vtkSphereSource> sphere = vtkSmartPointer<vtkSphereSource>::New();
-        sphere->SetRadius(m_PointSize / 2.0f);
-        sphere->SetCenter(currentPoint);
-        sphere->SetThetaResolution(20);
-        sphere->SetPhiResolution(20);
-        source = sphere;
-      }
-      break;
+        break;
     }
 
-    if (pointDataIter.Value().selected && !pointDataBroken)
+    if (!pointDataBroken && pointDataIter.Value().selected)
     {
-      m_vtkSelectedPointList->AddInputConnection(source->GetOutputPort());
+      AddGlyph(m_VtkSelectedPointsPolyData, glyphPosition, glyphType);
       ++m_NumberOfSelectedAdded;
     }
     else
     {
-      m_vtkUnselectedPointList->AddInputConnection(source->GetOutputPort());
+      AddGlyph(m_VtkUnselectedPointsPolyData, glyphPosition, glyphType);
       ++m_NumberOfUnselectedAdded;
     }
     if (showLabel)
     {
-      char buffer[20];
       std::string l = pointLabel;
       if (input->GetSize() > 1)
       {
-        sprintf(buffer, "%d", ptIdx + 1);
-        l.append(buffer);
+        std::ostringstream buffer;
+        buffer << ptIdx + 1;
+        l.append(buffer.str());
       }
-      // Define the text for the label
-      vtkSmartPointer<vtkVectorText> label = vtkSmartPointer<vtkVectorText>::New();
-      label->SetText(l.c_str());
-
-      //# Set up a transform to move the label to a new position.
-      vtkSmartPointer<vtkTransform> aLabelTransform = vtkSmartPointer<vtkTransform>::New();
-      aLabelTransform->Identity();
-      aLabelTransform->Translate(currentPoint[0] + 2, currentPoint[1] + 2, currentPoint[2]);
-      aLabelTransform->Scale(5.7, 5.7, 5.7);
-
-      //# Move the label to a new position.
-      vtkSmartPointer<vtkTransformPolyDataFilter> labelTransform = vtkSmartPointer<vtkTransformPolyDataFilter>::New();
-      labelTransform->SetTransform(aLabelTransform);
-      labelTransform->SetInputConnection(label->GetOutputPort());
+      vtkPolyData *labelGeometry = GetLabelGeometry(l, m_LabelGeometries, previousLabelGeometries);
 
       // add it to the wright PointList
       if (pointType)
       {
-        m_vtkSelectedPointList->AddInputConnection(labelTransform->GetOutputPort());
+        AddLabel(m_VtkSelectedLabelsPolyData, labelGeometry, currentPoint);
         ++m_NumberOfSelectedAdded;
       }
       else
       {
-        m_vtkUnselectedPointList->AddInputConnection(labelTransform->GetOutputPort());
+        AddLabel(m_VtkUnselectedLabelsPolyData, labelGeometry, currentPoint);
         ++m_NumberOfUnselectedAdded;
       }
     }
@@ -345,30 +472,20 @@ void mitk::PointSetVtkMapper3D::CreateVTKRenderObjects()
       pointDataIter++;
   } // end FOR
 
-  // now according to number of elements added to selected or unselected, build up the rendering pipeline
-  if (m_NumberOfSelectedAdded > 0)
-  {
-    m_VtkSelectedPolyDataMapper = vtkSmartPointer<vtkPolyDataMapper>::New();
-    m_VtkSelectedPolyDataMapper->SetInputConnection(m_vtkSelectedPointList->GetOutputPort());
-
-    // create a new instance of the actor
-    m_SelectedActor = vtkSmartPointer<vtkActor>::New();
+  FinishPolyData(m_VtkSelectedPointsPolyData);
+  FinishPolyData(m_VtkUnselectedPointsPolyData);
+  FinishPolyData(m_VtkSelectedLabelsPolyData);
+  FinishPolyData(m_VtkUnselectedLabelsPolyData);
 
-    m_SelectedActor->SetMapper(m_VtkSelectedPolyDataMapper);
+  // only actors with something to render are added to the assembly
+  if (m_VtkSelectedPointsPolyData->GetNumberOfPoints() > 0)
     m_PointsAssembly->AddPart(m_SelectedActor);
-  }
-
-  if (m_NumberOfUnselectedAdded > 0)
-  {
-    m_VtkUnselectedPolyDataMapper = vtkSmartPointer<vtkPolyDataMapper>::New();
-    m_VtkUnselectedPolyDataMapper->SetInputConnection(m_vtkUnselectedPointList->GetOutputPort());
-
-    // create a new instance of the actor
-    m_UnselectedActor = vtkSmartPointer<vtkActor>::New();
-
-    m_UnselectedActor->SetMapper(m_VtkUnselectedPolyDataMapper);
+  if (m_VtkUnselectedPointsPolyData->GetNumberOfPoints() > 0)
     m_PointsAssembly->AddPart(m_UnselectedActor);
-  }
+  if (m_VtkSelectedLabelsPolyData->GetNumberOfPoints() > 0)
+    m_PointsAssembly->AddPart(m_SelectedLabelsActor);
+  if (m_VtkUnselectedLabelsPolyData->GetNumberOfPoints() > 0)
+    m_PointsAssembly->AddPart(m_UnselectedLabelsActor);
 }
 
 void mitk::PointSetVtkMapper3D::GenerateDataForRenderer(mitk::BaseRenderer *renderer)
@@ -379,6 +496,8 @@ void mitk::PointSetVtkMapper3D::GenerateDataForRenderer(mitk::BaseRenderer *rend
   {
     m_UnselectedActor->VisibilityOff();
     m_SelectedActor->VisibilityOff();
+    m_UnselectedLabelsActor->VisibilityOff();
+    m_SelectedLabelsActor->VisibilityOff();
     m_ContourActor->VisibilityOff();
     return;
   }
@@ -409,6 +528,8 @@ void mitk::PointSetVtkMapper3D::GenerateDataForRenderer(mitk::BaseRenderer *rend
 
   m_UnselectedActor->SetVisibility(showPoints);
   m_SelectedActor->SetVisibility(showPoints);
+  m_UnselectedLabelsActor->SetVisibility(showPoints);
+  m_SelectedLabelsActor->SetVisibility(showPoints);
 
   if (false && dynamic_cast<mitk::FloatProperty *>(this->GetDataNode()->GetProperty("opacity")) != nullptr)
   {
@@ -567,6 +688,13 @@ void mitk::PointSetVtkMapper3D::ApplyAllProperties(mitk::BaseRenderer *renderer,
 
   m_UnselectedActor->GetProperty()->SetColor(unselectedColor);
   m_UnselectedActor->GetProperty()->SetOpacity(opacity);
+
+  // the labels are colored like the points they belong to
+  m_SelectedLabelsActor->GetProperty()->SetColor(selectedColor);
+  m_SelectedLabelsActor->GetProperty()->SetOpacity(opacity);
+
+  m_UnselectedLabelsActor->GetProperty()->SetColor(unselectedColor);
+  m_UnselectedLabelsActor->GetProperty()->SetOpacity(opacity);
 }
 
 void mitk::PointSetVtkMapper3D::CreateContour(vtkPoints *points, vtkCellArray *m_PointConnections)
@@ -0,0 +1,391 @@
+/*===================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center,
+Division of Medical and Biological Informatics.
+All rights reserved.
+
+This software is distributed WITHOUT ANY WARRANTY; without
+even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE.
+
+See LICENSE.txt or http://www.mitk.org for details.
+
+===================================================================*/
+
+#include "mitkSurfacePlaneCutter.h"
+
+// VTK includes
+#include <vtkAppendPolyData.h>
+#include <vtkCellData.h>
+#include <vtkCutter.h>
+#include <vtkPlane.h>
+#include <vtkPointData.h>
+#include <vtkPoints.h>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <unordered_map>
+
+namespace
+{
+  const unsigned int MaxCellsPerLeaf = 8;
+  // contours with fewer candidate cells per thread are cut in a single thread
+  const vtkIdType MinCellsPerThread = 4096;
+}
+
+struct mitk::SurfacePlaneCutter::CutData
+{
+  const SurfacePlaneCutter *m_Cutter;
+  const std::vector<vtkIdType> *m_Cells;
+  const double *m_Origin;
+  const double *m_Normal;
+  std::vector<vtkSmartPointer<vtkPolyData>> m_Contours;
+};
+
+mitk::SurfacePlaneCutter::SurfacePlaneCutter() : m_InputMTime(0), m_CacheSize(16), m_NumberOfThreads(0)
+{
+}
+
+mitk::SurfacePlaneCutter::~SurfacePlaneCutter()
+{
+}
+
+void mitk::SurfacePlaneCutter::SetInput(vtkPolyData *input)
+{
+  if (input == m_Input && (input == nullptr || input->GetMTime() == m_InputMTime))
+    return;
+
+  this->Clear();
+  m_Input = input;
+  if (m_Input != nullptr)
+  {
+    this->BuildIndex();
+    m_InputMTime = m_Input->GetMTime();
+  }
+}
+
+vtkPolyData *mitk::SurfacePlaneCutter::GetInput() const
+{
+  return m_Input;
+}
+
+void mitk::SurfacePlaneCutter::SetCacheSize(unsigned int cacheSize)
+{
+  m_CacheSize = cacheSize;
+  while (m_Cache.size() > m_CacheSize)
+    m_Cache.pop_back();
+}
+
+unsigned int mitk::SurfacePlaneCutter::GetCacheSize() const
+{
+  return m_CacheSize;
+}
+
+void mitk::SurfacePlaneCutter::SetNumberOfThreads(unsigned int numberOfThreads)
+{
+  m_NumberOfThreads = numberOfThreads;
+}
+
+unsigned int mitk::SurfacePlaneCutter::GetNumberOfThreads() const
+{
+  return m_NumberOfThreads;
+}
+
+void mitk::SurfacePlaneCutter::Clear()
+{
+  m_Input = nullptr;
+  m_InputMTime = 0;
+  m_CellBounds.clear();
+  m_CellOrder.clear();
+  m_Nodes.clear();
+  m_Cache.clear();
+}
+
+void mitk::SurfacePlaneCutter::BuildIndex()
+{
+  const vtkIdType numCells = m_Input->GetNumberOfCells();
+  vtkPoints *points = m_Input->GetPoints();
+  if (numCells == 0 || points == nullptr)
+    return;
+
+  // builds the cell links once, so the cells can be read concurrently while cutting
+  m_Input->BuildCells();
+
+  m_CellBounds.resize(numCells);
+  m_CellOrder.resize(numCells);
+  for (vtkIdType cellId = 0; cellId < numCells; ++cellId)
+  {
+    Box &box = m_CellBounds[cellId];
+    for (int d = 0; d < 3; ++d)
+    {
+      box.Min[d] = std::numeric_limits<float>::max();
+      box.Max[d] = std::numeric_limits<float>::lowest();
+    }
+
+    vtkIdType numPoints(0);
+    vtkIdType *pointIds(nullptr);
+    m_Input->GetCellPoints(cellId, numPoints, pointIds);
+    for (vtkIdType k = 0; k < numPoints; ++k)
+    {
+      double p[3];
+      points->GetPoint(pointIds[k], p);
+      for (int d = 0; d < 3; ++d)
+      {
+        box.Min[d] = std::min(box.Min[d], static_cast<float>(p[d]));
+        box.Max[d] = std::max(box.Max[d], static_cast<float>(p[d]));
+      }
+    }
+    m_CellOrder[cellId] = cellId;
+  }
+
+  m_Nodes.reserve(2 * numCells / MaxCellsPerLeaf + 1);
+  m_Nodes.push_back(Node());
+  this->BuildNode(0, 0, numCells);
+}
+
+void mitk::SurfacePlaneCutter::BuildNode(int node, unsigned int first, unsigned int count)
+{
+  Box bounds;
+  for (int d = 0; d < 3; ++d)
+  {
+    bounds.Min[d] = std::numeric_limits<float>::max();
+    bounds.Max[d] = std::numeric_limits<float>::lowest();
+  }
+  for (unsigned int i = first; i < first + count; ++i)
+  {
+    const Box &box = m_CellBounds[m_CellOrder[i]];
+    for (int d = 0; d < 3; ++d)
+    {
+      bounds.Min[d] = std::min(bounds.Min[d], box.Min[d]);
+      bounds.Max[d] = std::max(bounds.Max[d], box.Max[d]);
+    }
+  }
+
+  m_Nodes[node].Bounds = bounds;
+  m_Nodes[node].FirstChild = -1;
+  m_Nodes[node].FirstCell = first;
+  m_Nodes[node].NumCells = count;
+  if (count <= MaxCellsPerLeaf)
+    return;
+
+  // split at the median of the cell centers along the longest axis
+  int axis = 0;
+  for (int d = 1; d < 3; ++d)
+  {
+    if (bounds.Max[d] - bounds.Min[d] > bounds.Max[axis] - bounds.Min[axis])
+      axis = d;
+  }
+  unsigned int half = count / 2;
+  std::nth_element(m_CellOrder.begin() + first,
+                   m_CellOrder.begin() + first + half,
+                   m_CellOrder.begin() + first + count,
+                   [this, axis](unsigned int a, unsigned int b) {
+                     return m_CellBounds[a].Min[axis] + m_CellBounds[a].Max[axis] <
+                            m_CellBounds[b].Min[axis] + m_CellBounds[b].Max[axis];
+                   });
+
+  int firstChild = m_Nodes.size();
+  m_Nodes.push_back(Node());
+  m_Nodes.push_back(Node());
+  m_Nodes[node].FirstChild = firstChild;
+  this->BuildNode(firstChild, first, half);
+  this->BuildNode(firstChild + 1, first + half, count - half);
+}
+
+bool mitk::SurfacePlaneCutter::Intersects(const Box &box, const double normal[3], double distance)
+{
+  // interval covered by the projection of the box onto the normal
+  double center = 0;
+  double radius = 0;
+  for (int d = 0; d < 3; ++d)
+  {
+    center += normal[d] * 0.5 * (box.Min[d] + box.Max[d]);
+    radius += std::abs(normal[d]) * 0.5 * (box.Max[d] - box.Min[d]);
+  }
+  // the boxes are stored in single precision, so the test is widened slightly
+  const double tolerance = 1e-6 * (std::abs(center) + radius) + 1e-9;
+  return center + radius >= distance - tolerance && center - radius <= distance + tolerance;
+}
+
+void mitk::SurfacePlaneCutter::CollectCells(const double normal[3], double distance, std::vector<vtkIdType> &cells) const
+{
+  if (m_Nodes.empty())
+    return;
+
+  std::vector<int> stack;
+  stack.push_back(0);
+  while (!stack.empty())
+  {
+    const Node &node = m_Nodes[stack.back()];
+    stack.pop_back();
+    if (!Intersects(node.Bounds, normal, distance))
+      continue;
+
+    if (node.FirstChild >= 0)
+    {
+      stack.push_back(node.FirstChild);
+      stack.push_back(node.FirstChild + 1);
+      continue;
+    }
+
+    for (unsigned int i = node.FirstCell; i < node.FirstCell + node.NumCells; ++i)
+    {
+      if (Intersects(m_CellBounds[m_CellOrder[i]], normal, distance))
+        cells.push_back(m_CellOrder[i]);
+    }
+  }
+
+  // keep the order of the input, so the contour does not depend on the tree layout
+  std::sort(cells.begin(), cells.end());
+}
+
+vtkSmartPointer<vtkPolyData> mitk::SurfacePlaneCutter::Cut(const double origin[3], const double normal[3])
+{
+  const double distance = normal[0] * origin[0] + normal[1] * origin[1] + normal[2] * origin[2];
+
+  for (auto it = m_Cache.begin(); it != m_Cache.end(); ++it)
+  {
+    if (it->Distance == distance && it->Normal[0] == normal[0] && it->Normal[1] == normal[1] &&
+        it->Normal[2] == normal[2])
+    {
+      m_Cache.splice(m_Cache.begin(), m_Cache, it);
+      return m_Cache.front().Contour;
+    }
+  }
+
+  std::vector<vtkIdType> cells;
+  this->CollectCells(normal, distance, cells);
+
+  vtkSmartPointer<vtkPolyData> contour;
+  unsigned int numberOfThreads =
+    m_NumberOfThreads > 0 ? m_NumberOfThreads : itk::MultiThreader::GetGlobalDefaultNumberOfThreads();
+  numberOfThreads = std::min<vtkIdType>(numberOfThreads, cells.size() / MinCellsPerThread);
+
+  if (numberOfThreads <= 1)
+  {
+    contour = this->CutCells(cells.data(), cells.size(), origin, normal);
+  }
+  else
+  {
+    CutData data;
+    data.m_Cutter = this;
+    data.m_Cells = &cells;
+    data.m_Origin = origin;
+    data.m_Normal = normal;
+    data.m_Contours.resize(numberOfThreads);
+
+    itk::MultiThreader::Pointer threader = itk::MultiThreader::New();
+    threader->SetNumberOfThreads(numberOfThreads);
+    threader->SetSingleMethod(CutCallback, &data);
+    threader->SingleMethodExecute();
+
+    vtkSmartPointer<vtkAppendPolyData> append = vtkSmartPointer<vtkAppendPolyData>::New();
+    for (const auto &part : data.m_Contours)
+    {
+      if (part != nullptr)
+        append->AddInputData(part);
+    }
+    append->Update();
+    contour = vtkSmartPointer<vtkPolyData>::New();
+    contour->ShallowCopy(append->GetOutput());
+  }
+
+  if (m_CacheSize > 0)
+  {
+    CacheEntry entry;
+    std::copy(normal, normal + 3, entry.Normal);
+    entry.Distance = distance;
+    entry.Contour = contour;
+    m_Cache.push_front(entry);
+    if (m_Cache.size() > m_CacheSize)
+      m_Cache.pop_back();
+  }
+  return contour;
+}
+
+ITK_THREAD_RETURN_TYPE mitk::SurfacePlaneCutter::CutCallback(void *arg)
+{
+  typedef itk::MultiThreader::ThreadInfoStruct ThreadInfoType;
+  ThreadInfoType *infoStruct = static_cast<ThreadInfoType *>(arg);
+  CutData *data = static_cast<CutData *>(infoStruct->UserData);
+
+  const vtkIdType numCells = data->m_Cells->size();
+  const vtkIdType numParts = data->m_Contours.size();
+  const vtkIdType part = infoStruct->ThreadID;
+  if (part >= numParts)
+    return ITK_THREAD_RETURN_VALUE;
+
+  const vtkIdType begin = numCells * part / numParts;
+  const vtkIdType end = numCells * (part + 1) / numParts;
+  data->m_Contours[part] =
+    data->m_Cutter->CutCells(data->m_Cells->data() + begin, end - begin, data->m_Origin, data->m_Normal);
+
+  return ITK_THREAD_RETURN_VALUE;
+}
+
+vtkSmartPointer<vtkPolyData> mitk::SurfacePlaneCutter::CutCells(const vtkIdType *cells,
+                                                                vtkIdType numCells,
+                                                                const double origin[3],
+                                                                const double normal[3]) const
+{
+  vtkSmartPointer<vtkPolyData> contour = vtkSmartPointer<vtkPolyData>::New();
+  if (numCells == 0)
+  {
+    contour->SetPoints(vtkSmartPointer<vtkPoints>::New());
+    return contour;
+  }
+
+  // copy the candidate cells (and only the points they use) into a small polydata
+  vtkPoints *points = m_Input->GetPoints();
+  vtkPointData *pointData = m_Input->GetPointData();
+  vtkCellData *cellData = m_Input->GetCellData();
+
+  vtkSmartPointer<vtkPolyData> subset = vtkSmartPointer<vtkPolyData>::New();
+  vtkSmartPointer<vtkPoints> subsetPoints = vtkSmartPointer<vtkPoints>::New();
+  subsetPoints->SetDataType(points->GetDataType());
+  subset->SetPoints(subsetPoints);
+  subset->Allocate(numCells);
+  subset->GetPointData()->CopyAllocate(pointData);
+  subset->GetCellData()->CopyAllocate(cellData, numCells);
+
+  std::unordered_map<vtkIdType, vtkIdType> pointMap;
+  pointMap.reserve(3 * numCells);
+  std::vector<vtkIdType> newIds;
+  for (vtkIdType i = 0; i < numCells; ++i)
+  {
+    vtkIdType numPoints(0);
+    vtkIdType *pointIds(nullptr);
+    m_Input->GetCellPoints(cells[i], numPoints, pointIds);
+
+    newIds.resize(numPoints);
+    for (vtkIdType k = 0; k < numPoints; ++k)
+    {
+      auto inserted = pointMap.insert(std::make_pair(pointIds[k], subsetPoints->GetNumberOfPoints()));
+      if (inserted.second)
+      {
+        double p[3];
+        points->GetPoint(pointIds[k], p);
+        subsetPoints->InsertNextPoint(p);
+        subset->GetPointData()->CopyData(pointData, pointIds[k], inserted.first->second);
+      }
+      newIds[k] = inserted.first->second;
+    }
+    vtkIdType newCellId = subset->InsertNextCell(m_Input->GetCellType(cells[i]), numPoints, newIds.data());
+    subset->GetCellData()->CopyData(cellData, cells[i], newCellId);
+  }
+
+  vtkSmartPointer<vtkPlane> plane = vtkSmartPointer<vtkPlane>::New();
+  plane->SetOrigin(origin[0], origin[1], origin[2]);
+  plane->SetNormal(normal[0], normal[1], normal[2]);
+
+  vtkSmartPointer<vtkCutter> cutter = vtkSmartPointer<vtkCutter>::New();
+  cutter->SetCutFunction(plane);
+  cutter->SetInputData(subset);
+  cutter->Update();
+
+  contour->ShallowCopy(cutter->GetOutput());
+  return contour;
+}
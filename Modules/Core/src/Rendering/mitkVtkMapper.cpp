@@ -15,6 +15,69 @@ See LICENSE.txt or http://www.mitk.org for details.
 ===================================================================*/
 
 #include "mitkVtkMapper.h"
+#include "mitkRenderingManager.h"
+
+#include <vtkCommand.h>
+#include <vtkRenderWindow.h>
+#include <vtkRenderWindowInteractor.h>
+#include <vtkSmartPointer.h>
+
+#include <chrono>
+
+namespace
+{
+  // interval in ms in which a running asynchronous update is checked, without rendering
+  const unsigned long AsynchronousUpdatePollInterval = 100;
+
+  /** Checks with a one-shot timer of the render window interactor whether an asynchronous update has
+   * finished, and requests a single rendering once it has. The timer is rearmed as long as the update runs,
+   * so the render window is not redrawn while waiting. The command only holds a shared state of the update,
+   * so it stays valid when the mapper is deleted.
+   */
+  class AsynchronousUpdatePollCommand : public vtkCommand
+  {
+  public:
+    static AsynchronousUpdatePollCommand *New() { return new AsynchronousUpdatePollCommand; }
+
+    bool Start(vtkRenderWindowInteractor *interactor, const std::shared_future<void> &update)
+    {
+      m_Update = update;
+      m_TimerId = interactor->CreateOneShotTimer(AsynchronousUpdatePollInterval);
+      if (m_TimerId == 0)
+        return false;
+
+      interactor->AddObserver(vtkCommand::TimerEvent, this);
+      return true;
+    }
+
+    void Execute(vtkObject *caller, unsigned long, void *callData) override
+    {
+      auto *interactor = static_cast<vtkRenderWindowInteractor *>(caller);
+      if (callData == nullptr || *static_cast<int *>(callData) != m_TimerId)
+        return;
+
+      if (m_Update.wait_for(std::chrono::seconds(0)) != std::future_status::ready)
+      {
+        m_TimerId = interactor->CreateOneShotTimer(AsynchronousUpdatePollInterval);
+        if (m_TimerId != 0)
+          return;
+      }
+
+      // finished (or the timer could not be rearmed): the next rendering picks the result up
+      vtkRenderWindow *renderWindow = interactor->GetRenderWindow();
+      interactor->RemoveObserver(this);
+      mitk::BaseRenderer *renderer = mitk::BaseRenderer::GetInstance(renderWindow);
+      if (renderer != nullptr)
+        renderer->GetRenderingManager()->RequestUpdate(renderWindow);
+    }
+
+  private:
+    AsynchronousUpdatePollCommand() : m_TimerId(0) {}
+
+    std::shared_future<void> m_Update;
+    int m_TimerId;
+  };
+}
 
 mitk::VtkMapper::VtkMapper()
 {
@@ -22,6 +85,8 @@ mitk::VtkMapper::VtkMapper()
 
 mitk::VtkMapper::~VtkMapper()
 {
+  if (m_AsynchronousUpdate.valid())
+    m_AsynchronousUpdate.wait();
 }
 
 void mitk::VtkMapper::MitkRender(mitk::BaseRenderer *renderer, mitk::VtkPropRenderer::RenderType type)
@@ -132,3 +197,65 @@ void mitk::VtkMapper::ApplyColorAndOpacityProperties(BaseRenderer *renderer, vtk
   actor->GetProperty()->SetColor(drgba);
   actor->GetProperty()->SetOpacity(drgba[3]);
 }
+
+bool mitk::VtkMapper::IsAsynchronousUpdateEnabled(mitk::BaseRenderer *renderer) const
+{
+  bool asynchronous = false;
+  DataNode *node = this->GetDataNode();
+  if (node != nullptr)
+    node->GetBoolProperty("asynchronous update", asynchronous, renderer);
+  return asynchronous;
+}
+
+bool mitk::VtkMapper::StartAsynchronousUpdate(std::function<void()> job)
+{
+  if (this->IsAsynchronousUpdateRunning())
+    return false;
+
+  m_AsynchronousUpdate = std::async(std::launch::async, std::move(job)).share();
+  m_PolledRenderWindows.clear();
+  return true;
+}
+
+bool mitk::VtkMapper::FinishAsynchronousUpdate(mitk::BaseRenderer *renderer)
+{
+  if (!m_AsynchronousUpdate.valid())
+    return false;
+
+  if (m_AsynchronousUpdate.wait_for(std::chrono::seconds(0)) != std::future_status::ready)
+  {
+    // one poll per render window and update, it requests a rendering once the update has finished
+    vtkRenderWindow *renderWindow = renderer != nullptr ? renderer->GetRenderWindow() : nullptr;
+    vtkRenderWindowInteractor *interactor = renderWindow != nullptr ? renderWindow->GetInteractor() : nullptr;
+    if (interactor != nullptr && m_PolledRenderWindows.insert(renderWindow).second)
+    {
+      vtkSmartPointer<AsynchronousUpdatePollCommand> command = vtkSmartPointer<AsynchronousUpdatePollCommand>::New();
+      if (!command->Start(interactor, m_AsynchronousUpdate))
+        MITK_WARN << "Cannot poll asynchronous update of " << this->GetNameOfClass()
+                  << ". The result is shown with the next rendering.";
+    }
+    return false;
+  }
+
+  std::shared_future<void> update = m_AsynchronousUpdate;
+  m_AsynchronousUpdate = std::shared_future<void>();
+  m_PolledRenderWindows.clear();
+  try
+  {
+    update.get();
+  }
+  catch (const std::exception &e)
+  {
+    MITK_ERROR << "Asynchronous update of " << this->GetNameOfClass() << " failed: " << e.what();
+  }
+  catch (...)
+  {
+    MITK_ERROR << "Asynchronous update of " << this->GetNameOfClass() << " failed with an unknown exception.";
+  }
+  return true;
+}
+
+bool mitk::VtkMapper::IsAsynchronousUpdateRunning() const
+{
+  return m_AsynchronousUpdate.valid();
+}
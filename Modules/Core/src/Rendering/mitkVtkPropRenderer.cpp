@@ -35,10 +35,13 @@ See LICENSE.txt or http://www.mitk.org for details.
 #include <mitkVtkInteractorStyle.h>
 
 // VTK
+#include <vtkActor.h>
 #include <vtkAssemblyNode.h>
 #include <vtkAssemblyPath.h>
 #include <vtkCamera.h>
+#include <vtkCellLocator.h>
 #include <vtkCellPicker.h>
+#include <vtkDataSet.h>
 #include <vtkInteractorStyleTrackballCamera.h>
 #include <vtkLight.h>
 #include <vtkLightKit.h>
@@ -56,6 +59,12 @@ See LICENSE.txt or http://www.mitk.org for details.
 #include <vtkTransform.h>
 #include <vtkWorldPointPicker.h>
 
+namespace
+{
+  // for smaller data sets, testing all cells is faster than building a locator
+  const vtkIdType MinimumNumberOfCellsForPickLocator = 1000;
+}
+
 mitk::VtkPropRenderer::VtkPropRenderer(const char *name,
                                        vtkRenderWindow *renWin,
                                        mitk::RenderingManager *rm,
@@ -119,6 +128,12 @@ mitk::VtkPropRenderer::~VtkPropRenderer()
     m_CellPicker->Delete();
   if (m_TextRenderer != nullptr)
     m_TextRenderer->Delete();
+
+  if (m_DataStorage.IsNotNull())
+  {
+    m_DataStorage->RemoveNodeEvent.RemoveListener(
+      MessageDelegate1<VtkPropRenderer, const DataNode *>(this, &VtkPropRenderer::OnNodeRemoved));
+  }
 }
 
 void mitk::VtkPropRenderer::SetDataStorage(mitk::DataStorage *storage)
@@ -126,8 +141,19 @@ void mitk::VtkPropRenderer::SetDataStorage(mitk::DataStorage *storage)
   if (storage == nullptr || storage == m_DataStorage)
     return;
 
+  if (m_DataStorage.IsNotNull())
+  {
+    m_DataStorage->RemoveNodeEvent.RemoveListener(
+      MessageDelegate1<VtkPropRenderer, const DataNode *>(this, &VtkPropRenderer::OnNodeRemoved));
+  }
+  m_PickLocators.clear();
+  m_CellPicker->RemoveAllLocators();
+
   BaseRenderer::SetDataStorage(storage);
 
+  m_DataStorage->RemoveNodeEvent.AddListener(
+    MessageDelegate1<VtkPropRenderer, const DataNode *>(this, &VtkPropRenderer::OnNodeRemoved));
+
   static_cast<mitk::PlaneGeometryDataVtkMapper3D *>(m_CurrentWorldPlaneGeometryMapper.GetPointer())
     ->SetDataStorageForTexture(m_DataStorage.GetPointer());
 
@@ -223,6 +249,8 @@ void mitk::VtkPropRenderer::PrepareMapperQueue()
   // clear priority_queue
   m_MappersMap.clear();
 
+  this->ReleaseUnusedPickLocators();
+
   int mapperNo = 0;
 
   // DataStorage
@@ -418,6 +446,19 @@ void mitk::VtkPropRenderer::PickWorldPoint(const mitk::Point2D &displayPoint, mi
     }
     case (CellPicking):
     {
+      std::vector<vtkProp *> props;
+      for (auto it = m_MappersMap.cbegin(); it != m_MappersMap.cend(); ++it)
+      {
+        auto *vtkmapper = dynamic_cast<VtkMapper *>(it->second);
+        if (vtkmapper == nullptr)
+          continue;
+
+        vtkProp *prop = vtkmapper->GetVtkProp(const_cast<mitk::VtkPropRenderer *>(this));
+        if (prop != nullptr && prop->GetVisibility())
+          props.push_back(prop);
+      }
+      this->UpdatePickLocators(props);
+
       m_CellPicker->Pick(displayPoint[0], displayPoint[1], 0, m_VtkRenderer);
       vtk2itk(m_CellPicker->GetPickPosition(), worldPoint);
       break;
@@ -430,6 +471,7 @@ void mitk::VtkPropRenderer::PickWorldPoint(const mitk::Point2D &displayPoint, mi
 mitk::DataNode *mitk::VtkPropRenderer::PickObject(const Point2D &displayPosition, Point3D &worldPosition) const
 {
   m_CellPicker->InitializePickList();
+  std::vector<vtkProp *> props;
 
   // Iterate over all DataStorage objects to determine all vtkProps intended
   // for picking
@@ -454,7 +496,9 @@ mitk::DataNode *mitk::VtkPropRenderer::PickObject(const Point2D &displayPosition
       continue;
 
     m_CellPicker->AddPickList(prop);
+    props.push_back(prop);
   }
+  this->UpdatePickLocators(props);
 
   // Do the picking and retrieve the picked vtkProp (if any)
   m_CellPicker->PickFromListOn();
@@ -497,6 +541,71 @@ mitk::DataNode *mitk::VtkPropRenderer::PickObject(const Point2D &displayPosition
 // todo: is this 2D renderwindow picking?
 //    return Superclass::PickObject( displayPosition, worldPosition );
 
+void mitk::VtkPropRenderer::UpdatePickLocators(const std::vector<vtkProp *> &props) const
+{
+  m_CellPicker->RemoveAllLocators();
+
+  PickLocatorMapType usedLocators;
+
+  for (vtkProp *prop : props)
+  {
+    prop->InitPathTraversal();
+    while (vtkAssemblyPath *path = prop->GetNextPath())
+    {
+      auto *actor = vtkActor::SafeDownCast(path->GetLastNode()->GetViewProp());
+      if (actor == nullptr || actor->GetMapper() == nullptr)
+        continue;
+
+      vtkDataSet *dataSet = actor->GetMapper()->GetInput();
+      if (dataSet == nullptr || dataSet->GetNumberOfCells() < MinimumNumberOfCellsForPickLocator)
+        continue;
+
+      vtkSmartPointer<vtkCellLocator> &locator = usedLocators[dataSet];
+      if (locator != nullptr)
+        continue;
+
+      auto cached = m_PickLocators.find(dataSet);
+      if (cached != m_PickLocators.end())
+      {
+        locator = cached->second;
+      }
+      else
+      {
+        locator = vtkSmartPointer<vtkCellLocator>::New();
+        locator->SetDataSet(dataSet);
+      }
+      // only rebuilds the locator if the data set has been modified since the last build
+      locator->Update();
+      m_CellPicker->AddLocator(locator);
+    }
+  }
+
+  // the locators of data sets which are not picked any more are released
+  m_PickLocators.swap(usedLocators);
+}
+
+void mitk::VtkPropRenderer::ReleaseUnusedPickLocators()
+{
+  for (auto it = m_PickLocators.begin(); it != m_PickLocators.end();)
+  {
+    if (it->first->GetReferenceCount() <= 1)
+    {
+      m_CellPicker->RemoveLocator(it->second);
+      it = m_PickLocators.erase(it);
+    }
+    else
+      ++it;
+  }
+}
+
+void mitk::VtkPropRenderer::OnNodeRemoved(const mitk::DataNode *)
+{
+  // nodes are rarely removed, so instead of looking up the data sets of the node all locators
+  // are released; they are rebuilt with the next pick
+  m_PickLocators.clear();
+  m_CellPicker->RemoveAllLocators();
+}
+
 vtkTextProperty *mitk::VtkPropRenderer::GetTextLabelProperty(int text_id)
 {
   return this->m_TextCollection[text_id]->GetTextProperty();
@@ -29,6 +29,8 @@ See LICENSE.txt or http://www.mitk.org for details.
 // used for acos etc.
 #include <cmath>
 
+#include <algorithm>
+
 // used for PI
 #include <itkMath.h>
 
@@ -39,7 +41,13 @@ static const double PI = itk::Math::pi;
 vtkStandardNewMacro(vtkMitkLevelWindowFilter);
 
 vtkMitkLevelWindowFilter::vtkMitkLevelWindowFilter()
-  : m_LookupTable(nullptr), m_OpacityFunction(nullptr), m_MinOpacity(0.0), m_MaxOpacity(255.0)
+  : m_LookupTable(nullptr),
+    m_OpacityFunction(nullptr),
+    m_MinOpacity(0.0),
+    m_MaxOpacity(255.0),
+    m_IntegerLookupTableMinValue(0),
+    m_IntegerLookupTableScalarType(VTK_VOID),
+    m_IntegerLookupTableMTime(0)
 {
   // MITK_INFO << "mitk level/window filter uses " << GetNumberOfThreads() << " thread(s)";
 }
@@ -277,54 +285,134 @@ void vtkApplyLookupTableOnRGBA(vtkMitkLevelWindowFilter *self,
   }
 }
 
+// Internal method which should never be used anywhere else and should not be in th header.
+// Computes the pixel range [begin, end) of an output row (relative to outExt[0]) that lies
+// within the horizontal clipping bounds, so the pixel loops do not have to test every pixel.
+static void vtkClipRow(const int outExt[6], const double *clippingBounds, int &begin, int &end)
+{
+  // x >= bound and x < bound are equivalent to x >= ceil(bound) and x < ceil(bound) for integer x
+  const double width = outExt[1] - outExt[0] + 1;
+  const double first = std::min(std::max(std::ceil(clippingBounds[0]) - outExt[0], 0.0), width);
+  const double last = std::min(std::max(std::ceil(clippingBounds[1]) - outExt[0], first), width);
+  begin = static_cast<int>(first);
+  end = static_cast<int>(last);
+}
+
 // Internal method which should never be used anywhere else and should not be in th header.
 //----------------------------------------------------------------------------
-// This templated function executes the filter for any type of data.
+// Applies a precomputed RGBA table which holds one color for every value of an 8 or 16 bit
+// integer type. table[0] is the color of minValue.
 template <class T>
-void vtkApplyLookupTableOnScalarsFast(
-  vtkMitkLevelWindowFilter *self, vtkImageData *inData, vtkImageData *outData, int outExt[6], T *)
+void vtkApplyIntegerLookupTable(const unsigned int *table,
+                                int minValue,
+                                vtkImageData *inData,
+                                vtkImageData *outData,
+                                int outExt[6],
+                                double *clippingBounds,
+                                T *)
 {
   vtkImageIterator<T> inputIt(inData, outExt);
   vtkImageIterator<unsigned char> outputIt(outData, outExt);
 
+  int begin, end;
+  vtkClipRow(outExt, clippingBounds, begin, end);
+  const int width = outExt[1] - outExt[0] + 1;
+
+  int y = outExt[2];
+
+  // Loop through ouput pixels
+  while (!outputIt.IsAtEnd())
+  {
+    auto *outputSI = reinterpret_cast<unsigned int *>(outputIt.BeginSpan());
+    const T *inputSI = inputIt.BeginSpan();
+
+    // do we iterate over the inner vertical clipping bounds
+    if (y >= clippingBounds[2] && y < clippingBounds[3])
+    {
+      // outer horizontal clipping bounds - write transparent RGBA pixels
+      std::fill(outputSI, outputSI + begin, 0u);
+      for (int x = begin; x < end; ++x)
+      {
+        outputSI[x] = table[static_cast<int>(inputSI[x]) - minValue];
+      }
+      std::fill(outputSI + end, outputSI + width, 0u);
+    }
+    else
+    {
+      // outer vertical clipping bounds - write a transparent RGBA line
+      std::fill(outputSI, outputSI + width, 0u);
+    }
+
+    inputIt.NextSpan();
+    outputIt.NextSpan();
+    y++;
+  }
+}
+
+// Internal method which should never be used anywhere else and should not be in th header.
+// Parameters to map a value to an index of a vtkLookupTable with linear scale:
+// index = clamp(int(value * scale + bias), 0, maxIndex)
+static void vtkGetLinearLookupTableParameters(vtkLookupTable *lookupTable, float &scale, float &bias, int &maxIndex)
+{
   double tableRange[2];
+  lookupTable->GetTableRange(tableRange);
+  maxIndex = lookupTable->GetNumberOfColors() - 1;
+
+  scale = (tableRange[1] - tableRange[0] > 0 ? (maxIndex + 1) / (tableRange[1] - tableRange[0]) : 0.0);
+  // ensuring that starting point is zero
+  bias = -tableRange[0] * scale;
+  // due to later conversion to int for rounding
+  bias += 0.5f;
+}
+
+// Internal method which should never be used anywhere else and should not be in th header.
+//----------------------------------------------------------------------------
+// Applies a vtkLookupTable with linear scale to an unclipped extent. The table indices of a
+// row are computed in a separate, branch free loop which the compiler vectorizes; the colors
+// are fetched afterwards.
+template <class T>
+void vtkApplyLookupTableOnScalarsFast(
+  vtkMitkLevelWindowFilter *self, vtkImageData *inData, vtkImageData *outData, int outExt[6], T *)
+{
+  vtkImageIterator<T> inputIt(inData, outExt);
+  vtkImageIterator<unsigned char> outputIt(outData, outExt);
 
   // access vtkLookupTable
   auto *lookupTable = dynamic_cast<vtkLookupTable *>(self->GetLookupTable());
-  lookupTable->GetTableRange(tableRange);
 
   // access elements of the vtkLookupTable
-  const int *realLookupTable = reinterpret_cast<int *>(lookupTable->GetTable()->GetPointer(0));
-  int maxIndex = lookupTable->GetNumberOfColors() - 1;
+  const auto *realLookupTable = reinterpret_cast<unsigned int *>(lookupTable->GetTable()->GetPointer(0));
 
-  const float scale = (tableRange[1] - tableRange[0] > 0 ? (maxIndex + 1) / (tableRange[1] - tableRange[0]) : 0.0);
-  // ensuring that starting point is zero
-  float bias = -tableRange[0] * scale;
-  // due to later conversion to int for rounding
-  bias += 0.5f;
+  float scale, bias;
+  int maxIndex;
+  vtkGetLinearLookupTableParameters(lookupTable, scale, bias, maxIndex);
+
+  // the index is computed in the precision of value * scale, clamping before the conversion
+  // to int maps NaN to 0
+  typedef decltype(T() * scale) ComputeType;
+  const ComputeType lower = 0;
+  const ComputeType upper = maxIndex;
+
+  const int width = outExt[1] - outExt[0] + 1;
+  std::vector<int> indices(width);
+  int *index = indices.data();
 
   // Loop through ouput pixels
   while (!outputIt.IsAtEnd())
   {
-    unsigned char *outputSI = outputIt.BeginSpan();
-    unsigned char *outputSIEnd = outputIt.EndSpan();
+    auto *outputSI = reinterpret_cast<unsigned int *>(outputIt.BeginSpan());
+    const T *inputSI = inputIt.BeginSpan();
 
-    T *inputSI = inputIt.BeginSpan();
-
-    while (outputSI != outputSIEnd)
+    // map to an index
+    for (int x = 0; x < width; ++x)
     {
-      // map to an index
-      auto idx = static_cast<int>(*inputSI * scale + bias);
-
-      if (idx < 0)
-        idx = 0;
-      else if (idx > maxIndex)
-        idx = maxIndex;
-
-      *reinterpret_cast<int *>(outputSI) = realLookupTable[idx];
+      const ComputeType value = inputSI[x] * scale + bias;
+      index[x] = static_cast<int>(std::max(lower, std::min(value, upper)));
+    }
 
-      inputSI++;
-      outputSI += 4;
+    for (int x = 0; x < width; ++x)
+    {
+      outputSI[x] = realLookupTable[index[x]];
     }
 
     inputIt.NextSpan();
@@ -347,50 +435,34 @@ void vtkApplyLookupTableOnScalars(vtkMitkLevelWindowFilter *self,
   vtkImageIterator<unsigned char> outputIt(outData, outExt);
   vtkScalarsToColors *lookupTable = self->GetLookupTable();
 
+  int begin, end;
+  vtkClipRow(outExt, clippingBounds, begin, end);
+  const int width = outExt[1] - outExt[0] + 1;
+
   int y = outExt[2];
 
   // Loop through ouput pixels
   while (!outputIt.IsAtEnd())
   {
-    unsigned char *outputSI = outputIt.BeginSpan();
-    unsigned char *outputSIEnd = outputIt.EndSpan();
+    auto *outputSI = reinterpret_cast<unsigned int *>(outputIt.BeginSpan());
+    const T *inputSI = inputIt.BeginSpan();
 
     // do we iterate over the inner vertical clipping bounds
     if (y >= clippingBounds[2] && y < clippingBounds[3])
     {
-      T *inputSI = inputIt.BeginSpan();
-
-      int x = outExt[0];
-
-      while (outputSI != outputSIEnd)
+      // outer horizontal clipping bounds - write transparent RGBA pixels
+      std::fill(outputSI, outputSI + begin, 0u);
+      for (int x = begin; x < end; ++x)
       {
-        // is this pixel within horizontal clipping bounds
-        if (x >= clippingBounds[0] && x < clippingBounds[1])
-        {
-          // fetching original value
-          auto grayValue = static_cast<double>(*inputSI);
-          // applying lookuptable - copy the 4 (RGBA) chars as a single int
-          *reinterpret_cast<int *>(outputSI) = *reinterpret_cast<int *>(lookupTable->MapValue(grayValue));
-        }
-        else
-        {
-          // outer horizontal clipping bounds - write a transparent RGBA pixel as a single int
-          *reinterpret_cast<int *>(outputSI) = 0;
-        }
-
-        inputSI++;
-        outputSI += 4;
-        x++;
+        // applying lookuptable - copy the 4 (RGBA) chars as a single int
+        outputSI[x] = *reinterpret_cast<unsigned int *>(lookupTable->MapValue(static_cast<double>(inputSI[x])));
       }
+      std::fill(outputSI + end, outputSI + width, 0u);
     }
     else
     {
-      // outer vertical clipping bounds - write a transparent RGBA line as ints
-      while (outputSI != outputSIEnd)
-      {
-        *reinterpret_cast<int *>(outputSI) = 0;
-        outputSI += 4;
-      }
+      // outer vertical clipping bounds - write a transparent RGBA line
+      std::fill(outputSI, outputSI + width, 0u);
     }
 
     inputIt.NextSpan();
@@ -399,6 +471,28 @@ void vtkApplyLookupTableOnScalars(vtkMitkLevelWindowFilter *self,
   }
 }
 
+// Internal method which should never be used anywhere else and should not be in th header.
+// Maps a value by a color transfer function and an optional opacity function to a RGBA pixel.
+// vtkColorTransferFunction::MapValue is not threadsafe, thus the colors are computed directly.
+static unsigned int vtkMapValueByTransferFunction(vtkColorTransferFunction *lookupTable,
+                                                  vtkPiecewiseFunction *opacityFunction,
+                                                  double value)
+{
+  double rgba[4];
+  lookupTable->GetColor(value, rgba); // RGB mapping
+  rgba[3] = 1.0;
+  if (opacityFunction)
+    rgba[3] = opacityFunction->GetValue(value); // Alpha mapping
+
+  unsigned int pixel;
+  auto *bytes = reinterpret_cast<unsigned char *>(&pixel);
+  for (int i = 0; i < 4; ++i)
+  {
+    bytes[i] = static_cast<unsigned char>(255.0 * rgba[i] + 0.5);
+  }
+  return pixel;
+}
+
 // Internal method which should never be used anywhere else and should not be in th header.
 //----------------------------------------------------------------------------
 // This templated function executes the filter for any type of data.
@@ -415,61 +509,33 @@ void vtkApplyLookupTableOnScalarsCTF(vtkMitkLevelWindowFilter *self,
   auto *lookupTable = dynamic_cast<vtkColorTransferFunction *>(self->GetLookupTable());
   vtkPiecewiseFunction *opacityFunction = self->GetOpacityPiecewiseFunction();
 
+  int begin, end;
+  vtkClipRow(outExt, clippingBounds, begin, end);
+  const int width = outExt[1] - outExt[0] + 1;
+
   int y = outExt[2];
 
   // Loop through ouput pixels
   while (!outputIt.IsAtEnd())
   {
-    unsigned char *outputSI = outputIt.BeginSpan();
-    unsigned char *outputSIEnd = outputIt.EndSpan();
+    auto *outputSI = reinterpret_cast<unsigned int *>(outputIt.BeginSpan());
+    const T *inputSI = inputIt.BeginSpan();
 
     // do we iterate over the inner vertical clipping bounds
     if (y >= clippingBounds[2] && y < clippingBounds[3])
     {
-      T *inputSI = inputIt.BeginSpan();
-
-      int x = outExt[0];
-
-      while (outputSI != outputSIEnd)
+      // outer horizontal clipping bounds - write transparent RGBA pixels
+      std::fill(outputSI, outputSI + begin, 0u);
+      for (int x = begin; x < end; ++x)
       {
-        // is this pixel within horizontal clipping bounds
-        if (x >= clippingBounds[0] && x < clippingBounds[1])
-        {
-          // fetching original value
-          auto grayValue = static_cast<double>(*inputSI);
-
-          // applying directly colortransferfunction
-          // because vtkColorTransferFunction::MapValue is not threadsafe
-          double rgba[4];
-          lookupTable->GetColor(grayValue, rgba); // RGB mapping
-          rgba[3] = 1.0;
-          if (opacityFunction)
-            rgba[3] = opacityFunction->GetValue(grayValue); // Alpha mapping
-
-          for (int i = 0; i < 4; ++i)
-          {
-            outputSI[i] = static_cast<unsigned char>(255.0 * rgba[i] + 0.5);
-          }
-        }
-        else
-        {
-          // outer horizontal clipping bounds - write a transparent RGBA pixel as a single int
-          *reinterpret_cast<int *>(outputSI) = 0;
-        }
-
-        inputSI++;
-        outputSI += 4;
-        x++;
+        outputSI[x] = vtkMapValueByTransferFunction(lookupTable, opacityFunction, static_cast<double>(inputSI[x]));
       }
+      std::fill(outputSI + end, outputSI + width, 0u);
     }
     else
     {
-      // outer vertical clipping bounds - write a transparent RGBA line as ints
-      while (outputSI != outputSIEnd)
-      {
-        *reinterpret_cast<int *>(outputSI) = 0;
-        outputSI += 4;
-      }
+      // outer vertical clipping bounds - write a transparent RGBA line
+      std::fill(outputSI, outputSI + width, 0u);
     }
 
     inputIt.NextSpan();
@@ -492,6 +558,110 @@ int vtkMitkLevelWindowFilter::RequestInformation(vtkInformation *request,
   return 1;
 }
 
+int vtkMitkLevelWindowFilter::RequestData(vtkInformation *request,
+                                          vtkInformationVector **inputVector,
+                                          vtkInformationVector *outputVector)
+{
+  // Building the lookup table is not thread safe, thus it is done before the threads are started.
+  if (this->GetLookupTable())
+    this->GetLookupTable()->Build();
+
+  this->UpdateIntegerLookupTable(vtkImageData::GetData(inputVector[0]));
+
+  return Superclass::RequestData(request, inputVector, outputVector);
+}
+
+void vtkMitkLevelWindowFilter::UpdateIntegerLookupTable(vtkImageData *inData)
+{
+  int scalarType = VTK_VOID;
+  int minValue = 0;
+  int numberOfValues = 0;
+  if (inData != nullptr && inData->GetNumberOfScalarComponents() <= 2 && this->GetLookupTable() != nullptr)
+  {
+    scalarType = inData->GetScalarType();
+    switch (scalarType)
+    {
+      case VTK_CHAR:
+        minValue = VTK_CHAR_MIN;
+        numberOfValues = VTK_CHAR_MAX - VTK_CHAR_MIN + 1;
+        break;
+      case VTK_SIGNED_CHAR:
+        minValue = VTK_SIGNED_CHAR_MIN;
+        numberOfValues = VTK_SIGNED_CHAR_MAX - VTK_SIGNED_CHAR_MIN + 1;
+        break;
+      case VTK_UNSIGNED_CHAR:
+        minValue = VTK_UNSIGNED_CHAR_MIN;
+        numberOfValues = VTK_UNSIGNED_CHAR_MAX - VTK_UNSIGNED_CHAR_MIN + 1;
+        break;
+      case VTK_SHORT:
+        minValue = VTK_SHORT_MIN;
+        numberOfValues = VTK_SHORT_MAX - VTK_SHORT_MIN + 1;
+        break;
+      case VTK_UNSIGNED_SHORT:
+        minValue = VTK_UNSIGNED_SHORT_MIN;
+        numberOfValues = VTK_UNSIGNED_SHORT_MAX - VTK_UNSIGNED_SHORT_MIN + 1;
+        break;
+      default:
+        break;
+    }
+  }
+
+  if (numberOfValues == 0)
+  {
+    m_IntegerLookupTable.clear();
+    m_IntegerFastLookupTable.clear();
+    m_IntegerLookupTableScalarType = VTK_VOID;
+    return;
+  }
+
+  // this->GetMTime() covers the lookup table and the replacement of the opacity function
+  vtkMTimeType mTime = this->GetMTime();
+  if (m_OpacityFunction != nullptr)
+    mTime = std::max(mTime, m_OpacityFunction->GetMTime());
+
+  if (scalarType == m_IntegerLookupTableScalarType && mTime == m_IntegerLookupTableMTime)
+    return;
+
+  m_IntegerLookupTable.resize(numberOfValues);
+  auto *ctf = dynamic_cast<vtkColorTransferFunction *>(this->GetLookupTable());
+  for (int i = 0; i < numberOfValues; ++i)
+  {
+    const double value = minValue + i;
+    if (ctf)
+    {
+      m_IntegerLookupTable[i] = vtkMapValueByTransferFunction(ctf, m_OpacityFunction, value);
+    }
+    else
+    {
+      m_IntegerLookupTable[i] = *reinterpret_cast<unsigned int *>(this->GetLookupTable()->MapValue(value));
+    }
+  }
+
+  // Linear lookup tables are applied to unclipped extents by rounding to the nearest index
+  // (see vtkApplyLookupTableOnScalarsFast), which is precomputed as well.
+  m_IntegerFastLookupTable.clear();
+  auto *vlt = dynamic_cast<vtkLookupTable *>(this->GetLookupTable());
+  if (vlt && vlt->GetScale() == VTK_SCALE_LINEAR)
+  {
+    const auto *realLookupTable = reinterpret_cast<unsigned int *>(vlt->GetTable()->GetPointer(0));
+    float scale, bias;
+    int maxIndex;
+    vtkGetLinearLookupTableParameters(vlt, scale, bias, maxIndex);
+
+    m_IntegerFastLookupTable.resize(numberOfValues);
+    for (int i = 0; i < numberOfValues; ++i)
+    {
+      const int value = minValue + i;
+      auto idx = static_cast<int>(value * scale + bias);
+      idx = std::min(std::max(idx, 0), maxIndex);
+      m_IntegerFastLookupTable[i] = realLookupTable[idx];
+    }
+  }
+  m_IntegerLookupTableMinValue = minValue;
+  m_IntegerLookupTableScalarType = scalarType;
+  m_IntegerLookupTableMTime = mTime;
+}
+
 // Method to run the filter in different threads.
 void vtkMitkLevelWindowFilter::ThreadedExecute(vtkImageData *inData, vtkImageData *outData, int extent[6], int /*id*/)
 {
@@ -511,9 +681,6 @@ void vtkMitkLevelWindowFilter::ThreadedExecute(vtkImageData *inData, vtkImageDat
     bool dontClip = extent[2] >= m_ClippingBounds[2] && extent[3] <= m_ClippingBounds[3] &&
                     extent[0] >= m_ClippingBounds[0] && extent[1] <= m_ClippingBounds[1];
 
-    if (this->GetLookupTable())
-      this->GetLookupTable()->Build();
-
     auto *vlt = dynamic_cast<vtkLookupTable *>(this->GetLookupTable());
     auto *ctf = dynamic_cast<vtkColorTransferFunction *>(this->GetLookupTable());
 
@@ -521,7 +688,27 @@ void vtkMitkLevelWindowFilter::ThreadedExecute(vtkImageData *inData, vtkImageDat
 
     bool useFast = dontClip && linearLookupTable;
 
-    if (ctf)
+    // 8 and 16 bit integer images use the colors precomputed in RequestData()
+    if (!m_IntegerLookupTable.empty() && inData->GetScalarType() == m_IntegerLookupTableScalarType)
+    {
+      const std::vector<unsigned int> &table =
+        (useFast && !ctf && !m_IntegerFastLookupTable.empty()) ? m_IntegerFastLookupTable : m_IntegerLookupTable;
+
+      switch (inData->GetScalarType())
+      {
+        vtkTemplateMacro(vtkApplyIntegerLookupTable(table.data(),
+                                                    m_IntegerLookupTableMinValue,
+                                                    inData,
+                                                    outData,
+                                                    extent,
+                                                    m_ClippingBounds,
+                                                    static_cast<VTK_TT *>(nullptr)));
+        default:
+          vtkErrorMacro(<< "Execute: Unknown ScalarType");
+          return;
+      }
+    }
+    else if (ctf)
     {
       switch (inData->GetScalarType())
       {
@@ -24,8 +24,10 @@ See LICENSE.txt or http://www.mitk.org for details.
 #include "vtkPointData.h"
 #include "vtkStreamingDemandDrivenPipeline.h"
 
+#include <algorithm>
 #include <cmath>
 #include <sstream>
+#include <vector>
 
 vtkStandardNewMacro(vtkMitkThickSlicesFilter);
 
@@ -38,6 +40,17 @@ vtkMitkThickSlicesFilter::vtkMitkThickSlicesFilter()
 
   this->m_CurrentMode = MIP;
 
+  this->SlabShift = 0;
+  this->m_SlabFirst = 0;
+  this->m_SlabSize = 0;
+  this->m_SlabZMin = 0;
+  for (int i = 0; i < 4; ++i)
+    this->m_SlabExtent[i] = 0;
+  this->m_SliceSize = 0;
+  this->m_SlabScalarType = VTK_VOID;
+  this->m_SlabSumValid = false;
+  this->m_RecomputeSlabSum = true;
+
   // by default process active point scalars
   this->SetInputArrayToProcess(0, 0, 0, vtkDataObject::FIELD_ASSOCIATION_POINTS, vtkDataSetAttributes::SCALARS);
 }
@@ -48,6 +61,7 @@ void vtkMitkThickSlicesFilter::PrintSelf(ostream &os, vtkIndent indent)
   this->Superclass::PrintSelf(os, indent);
   os << indent << "HandleBoundaries: " << this->HandleBoundaries << "\n";
   os << indent << "Dimensionality: " << this->Dimensionality << "\n";
+  os << indent << "SlabShift: " << this->SlabShift << "\n";
 }
 
 //----------------------------------------------------------------------------
@@ -109,247 +123,299 @@ int vtkMitkThickSlicesFilter::RequestUpdateExtent(vtkInformation *,
 }
 
 //----------------------------------------------------------------------------
-// This execute method handles boundaries.
-// it handles boundaries. Pixels are just replicated to get values
-// out of extent.
-template <class T>
-void vtkMitkThickSlicesFilterExecute(vtkMitkThickSlicesFilter *self,
-                                     vtkImageData *inData,
-                                     T *inPtr,
-                                     vtkImageData *outData,
-                                     T *outPtr,
-                                     int outExt[6],
-                                     int /*id*/)
+// The slices of the last update, see vtkMitkThickSlicesFilter::UpdateSlab().
+struct vtkMitkThickSlab
 {
-  int idxX, idxY;
-  int maxX, maxY;
-  vtkIdType inIncX, inIncY, inIncZ;
-  vtkIdType outIncX, outIncY, outIncZ;
-  // int axesNum;
-  int *inExt = inData->GetExtent();
-  int *wholeExtent;
-  vtkIdType *inIncs;
-  // int useYMin, useYMax, useXMin, useXMax;
-
-  // find the region to loop over
-  maxX = outExt[1] - outExt[0];
-  maxY = outExt[3] - outExt[2];
+  const void *Buffer;
+  // ring buffer index of the slice with the lowest z
+  int First;
+  int NumberOfSlices;
+  // z extent of the slab as given by the full input
+  int ZMin;
+  // x/y extent of the slices
+  int Extent[4];
+  vtkIdType SliceSize;
+  // running sum of all slices (integer types in SUM and MEAN mode), otherwise nullptr
+  double *Sum;
+  bool RecomputeSum;
+};
 
-  //  maxZ = outExt[5] - outExt[4];
+//----------------------------------------------------------------------------
+// Adds the entering and subtracts the leaving slice from the running sum of a slab.
+template <class T>
+void vtkMitkThickSlicesFilterShiftSum(const T *entering, const T *leaving, double *sum, vtkIdType size)
+{
+  for (vtkIdType i = 0; i < size; ++i)
+  {
+    sum[i] += static_cast<double>(entering[i]) - static_cast<double>(leaving[i]);
+  }
+}
 
-  // Get the dimensionality of the gradient.
-  // axesNum = self->GetDimensionality();
+//----------------------------------------------------------------------------
+// Adds the rows at offset of all slices to sum.
+template <class T>
+void vtkMitkThickSlicesFilterSumRows(const std::vector<const T *> &slices, vtkIdType offset, int width, double *sum)
+{
+  std::fill(sum, sum + width, 0.0);
+  for (const T *slice : slices)
+  {
+    const T *row = slice + offset;
+    for (int x = 0; x < width; ++x)
+    {
+      sum[x] += row[x];
+    }
+  }
+}
 
-  // Get increments to march through data
-  inData->GetContinuousIncrements(outExt, inIncX, inIncY, inIncZ);
+//----------------------------------------------------------------------------
+// Projects the slices of the slab row by row. All inner loops run over
+// contiguous rows, so the compiler vectorizes them.
+template <class T>
+void vtkMitkThickSlicesFilterExecute(
+  vtkMitkThickSlicesFilter *self, const vtkMitkThickSlab &slab, vtkImageData *outData, T *outPtr, int outExt[6])
+{
+  vtkIdType outIncX, outIncY, outIncZ;
   outData->GetContinuousIncrements(outExt, outIncX, outIncY, outIncZ);
-  /*
-// The data spacing is important for computing the gradient.
-// central differences (2 * ratio).
-// Negative because below we have (min - max) for dx ...
-inData->GetSpacing(r);
-r[0] = -0.5 / r[0];
-r[1] = -0.5 / r[1];
-r[2] = -0.5 / r[2];
-    */
-  // get some other info we need
-  inIncs = inData->GetIncrements();
-  wholeExtent = inData->GetExtent();
-
-  // Move the pointer to the correct starting position.
-  inPtr += (outExt[0] - inExt[0]) * inIncs[0] + (outExt[2] - inExt[2]) * inIncs[1] + (outExt[4] - inExt[4]) * inIncs[2];
 
-  // Loop through ouput pixels
-
-  int _minZ = /*-5 + outExt[4];  if( _minZ  < wholeExtent[4]) _minZ=*/wholeExtent[4];
-  int _maxZ = /* 5 + outExt[4];  if( _maxZ  > wholeExtent[5]) _maxZ=*/wholeExtent[5];
+  const int width = outExt[1] - outExt[0] + 1;
+  const int _minZ = slab.ZMin;
+  const int _maxZ = slab.ZMin + slab.NumberOfSlices - 1;
 
   if (_maxZ < _minZ)
     return;
 
+  // slices ordered by z
+  std::vector<const T *> slices(slab.NumberOfSlices);
+  for (int z = 0; z < slab.NumberOfSlices; ++z)
+  {
+    slices[z] = static_cast<const T *>(slab.Buffer) + ((slab.First + z) % slab.NumberOfSlices) * slab.SliceSize;
+  }
+
   double invNum = 1.0 / (_maxZ - _minZ + 1);
+  std::vector<double> rowSum(width);
 
-  switch (self->GetThickSliceMode())
+  std::vector<double> weights;
+  if (self->GetThickSliceMode() == vtkMitkThickSlicesFilter::WEIGHTED)
   {
-    default:
-    case vtkMitkThickSlicesFilter::MIP:
+    const int size = _maxZ - _minZ;
+    weights.resize(size);
+    double mean = 0.5 * double(_minZ + _maxZ);
+    double sigma_sq = double(size) / 6.0;
+    sigma_sq *= sigma_sq;
+    double sum = 0;
+    int i = 0;
+    for (int z = _minZ + 1; z <= _maxZ; z++)
     {
-      // MIP
-      for (idxY = 0; idxY <= maxY; idxY++)
-      {
-        // useYMin = ((idxY + outExt[2]) <= wholeExtent[2]) ? 0 : -inIncs[1];
-        // useYMax = ((idxY + outExt[2]) >= wholeExtent[3]) ? 0 : inIncs[1];
-        for (idxX = 0; idxX <= maxX; idxX++)
-        {
-          // useXMin = ((idxX + outExt[0]) <= wholeExtent[0]) ? 0 : -inIncs[0];
-          // useXMax = ((idxX + outExt[0]) >= wholeExtent[1]) ? 0 : inIncs[0];
+      double val = exp(-(((double)z - mean) / sigma_sq));
+      weights[i++] = val;
+      sum += val;
+    }
+    for (i = 0; i < size; i++)
+    {
+      weights[i] /= sum;
+    }
+  }
 
-          T mip = inPtr[_minZ * inIncs[2]];
+  for (int y = outExt[2]; y <= outExt[3]; ++y)
+  {
+    const vtkIdType offset =
+      static_cast<vtkIdType>(y - slab.Extent[2]) * (slab.Extent[1] - slab.Extent[0] + 1) + (outExt[0] - slab.Extent[0]);
 
-          for (int z = _minZ + 1; z <= _maxZ; z++)
+    switch (self->GetThickSliceMode())
+    {
+      default:
+      case vtkMitkThickSlicesFilter::MIP:
+      {
+        std::copy(slices[0] + offset, slices[0] + offset + width, outPtr);
+        for (int z = 1; z < slab.NumberOfSlices; ++z)
+        {
+          const T *row = slices[z] + offset;
+          for (int x = 0; x < width; ++x)
           {
-            T value = inPtr[z * inIncs[2]];
-            if (value > mip)
-              mip = value;
+            outPtr[x] = row[x] > outPtr[x] ? row[x] : outPtr[x];
           }
-
-          // do X axis
-          *outPtr = mip;
-          outPtr++;
-          inPtr++;
         }
-        outPtr += outIncY;
-        inPtr += inIncY;
       }
-    }
-    break;
+      break;
 
-    case vtkMitkThickSlicesFilter::SUM:
-    {
-      // MIP
-      for (idxY = 0; idxY <= maxY; idxY++)
+      case vtkMitkThickSlicesFilter::MINIP:
       {
-        // useYMin = ((idxY + outExt[2]) <= wholeExtent[2]) ? 0 : -inIncs[1];
-        // useYMax = ((idxY + outExt[2]) >= wholeExtent[3]) ? 0 : inIncs[1];
-        for (idxX = 0; idxX <= maxX; idxX++)
+        std::copy(slices[0] + offset, slices[0] + offset + width, outPtr);
+        for (int z = 1; z < slab.NumberOfSlices; ++z)
         {
-          // useXMin = ((idxX + outExt[0]) <= wholeExtent[0]) ? 0 : -inIncs[0];
-          // useXMax = ((idxX + outExt[0]) >= wholeExtent[1]) ? 0 : inIncs[0];
-
-          double sum = 0;
-
-          for (int z = _minZ; z <= _maxZ; z++)
+          const T *row = slices[z] + offset;
+          for (int x = 0; x < width; ++x)
           {
-            T value = inPtr[z * inIncs[2]];
-            sum += value;
+            outPtr[x] = row[x] < outPtr[x] ? row[x] : outPtr[x];
           }
-
-          // do X axis
-          *outPtr = static_cast<T>(invNum * sum);
-          outPtr++;
-          inPtr++;
         }
-        outPtr += outIncY;
-        inPtr += inIncY;
-      }
-    }
-    break;
-
-    case vtkMitkThickSlicesFilter::WEIGHTED:
-    {
-      const int size = _maxZ - _minZ;
-      std::vector<double> weights(size);
-      double mean = 0.5 * double(_minZ + _maxZ);
-      double sigma_sq = double(size) / 6.0;
-      sigma_sq *= sigma_sq;
-      double sum = 0;
-      int i = 0;
-      for (int z = _minZ + 1; z <= _maxZ; z++)
-      {
-        double val = exp(-(((double)z - mean) / sigma_sq));
-        weights[i++] = val;
-        sum += val;
-      }
-      for (i = 0; i < size; i++)
-      {
-        weights[i] /= sum;
       }
+      break;
 
-      for (idxY = 0; idxY <= maxY; idxY++)
+      case vtkMitkThickSlicesFilter::SUM:
+      case vtkMitkThickSlicesFilter::MEAN:
       {
-        // useYMin = ((idxY + outExt[2]) <= wholeExtent[2]) ? 0 : -inIncs[1];
-        // useYMax = ((idxY + outExt[2]) >= wholeExtent[3]) ? 0 : inIncs[1];
-        for (idxX = 0; idxX <= maxX; idxX++)
+        double *sum = rowSum.data();
+        if (slab.Sum != nullptr)
         {
-          // useXMin = ((idxX + outExt[0]) <= wholeExtent[0]) ? 0 : -inIncs[0];
-          // useXMax = ((idxX + outExt[0]) >= wholeExtent[1]) ? 0 : inIncs[0];
+          sum = slab.Sum + offset;
+        }
+        if (slab.Sum == nullptr || slab.RecomputeSum)
+        {
+          vtkMitkThickSlicesFilterSumRows(slices, offset, width, sum);
+        }
 
-          T mip = inPtr[_minZ * inIncs[2]];
-          i = 0;
-          double mymip = 0;
-          for (int z = _minZ + 1; z <= _maxZ; z++)
+        if (self->GetThickSliceMode() == vtkMitkThickSlicesFilter::SUM)
+        {
+          for (int x = 0; x < width; ++x)
           {
-            double value = inPtr[z * inIncs[2]];
-            mymip += value * weights[i++];
+            outPtr[x] = static_cast<T>(invNum * sum[x]);
+          }
+        }
+        else
+        {
+          // MEAN divides by one slice less than there are slices
+          const double size = std::max(_maxZ - _minZ, 1);
+          for (int x = 0; x < width; ++x)
+          {
+            outPtr[x] = static_cast<T>(sum[x] / size);
           }
-          mip = static_cast<T>(mymip);
-          // do X axis
-          *outPtr = mip;
-          outPtr++;
-          inPtr++;
         }
-        outPtr += outIncY;
-        inPtr += inIncY;
       }
-    }
-    break;
+      break;
 
-    case vtkMitkThickSlicesFilter::MINIP:
-    {
-      for (idxY = 0; idxY <= maxY; idxY++)
+      case vtkMitkThickSlicesFilter::WEIGHTED:
       {
-        for (idxX = 0; idxX <= maxX; idxX++)
+        double *sum = rowSum.data();
+        std::fill(sum, sum + width, 0.0);
+        for (int z = 1; z < slab.NumberOfSlices; ++z)
         {
-          T mip = inPtr[_minZ * inIncs[2]];
-
-          for (int z = _minZ + 1; z <= _maxZ; z++)
+          const T *row = slices[z] + offset;
+          const double weight = weights[z - 1];
+          for (int x = 0; x < width; ++x)
           {
-            T value = inPtr[z * inIncs[2]];
-            if (value < mip)
-              mip = value;
+            sum[x] += row[x] * weight;
           }
-
-          // do X axis
-          *outPtr = mip;
-          outPtr++;
-          inPtr++;
         }
-        outPtr += outIncY;
-        inPtr += inIncY;
+        for (int x = 0; x < width; ++x)
+        {
+          outPtr[x] = static_cast<T>(sum[x]);
+        }
       }
+      break;
     }
-    break;
 
-    case vtkMitkThickSlicesFilter::MEAN:
-    {
-      const int size = _maxZ - _minZ;
+    outPtr += width + outIncY;
+  }
+}
 
-      // MEAN
-      for (idxY = 0; idxY <= maxY; idxY++)
-      {
-        for (idxX = 0; idxX <= maxX; idxX++)
-        {
-          long double sum = 0;
-          for (int z = _minZ; z <= _maxZ; z++)
-          {
-            T value = inPtr[z * inIncs[2]];
-            sum += value;
-          }
+bool vtkMitkThickSlicesFilter::CanShiftSlab(vtkImageData *enteringSlice)
+{
+  if (m_SlabBuffer.empty() || enteringSlice == nullptr)
+    return false;
+
+  vtkDataArray *scalars = enteringSlice->GetPointData()->GetScalars();
+  int *extent = enteringSlice->GetExtent();
+  return scalars != nullptr && scalars->GetNumberOfComponents() == 1 && scalars->GetDataType() == m_SlabScalarType &&
+         extent[4] == extent[5] && extent[0] == m_SlabExtent[0] && extent[1] == m_SlabExtent[1] &&
+         extent[2] == m_SlabExtent[2] && extent[3] == m_SlabExtent[3];
+}
+
+bool vtkMitkThickSlicesFilter::UpdateSlab(vtkImageData *input, vtkDataArray *inputArray)
+{
+  const int *extent = input->GetExtent();
+  const int typeSize = inputArray->GetDataTypeSize();
+  const auto *data = static_cast<const char *>(inputArray->GetVoidPointer(0));
 
-          T mip = static_cast<T>(sum / size);
+  const bool integerType = inputArray->GetDataType() != VTK_FLOAT && inputArray->GetDataType() != VTK_DOUBLE;
+  const bool keepSum = integerType && (m_CurrentMode == SUM || m_CurrentMode == MEAN);
 
-          // do X axis
-          *outPtr = mip;
-          outPtr++;
-          inPtr++;
-        }
-        outPtr += outIncY;
-        inPtr += inIncY;
+  if (this->SlabShift != 0)
+  {
+    if (!this->CanShiftSlab(input))
+    {
+      vtkErrorMacro("Cannot shift the slab. The input is not a single slice matching the slab of the last update.");
+      return false;
+    }
+
+    // the entering slice replaces the leaving slice in the ring buffer
+    const int slot = this->SlabShift > 0 ? m_SlabFirst : (m_SlabFirst + m_SlabSize - 1) % m_SlabSize;
+    char *leaving = m_SlabBuffer.data() + slot * m_SliceSize * typeSize;
+
+    if (keepSum && m_SlabSumValid)
+    {
+      switch (m_SlabScalarType)
+      {
+        vtkTemplateMacro(vtkMitkThickSlicesFilterShiftSum(static_cast<const VTK_TT *>(static_cast<const void *>(data)),
+                                                          static_cast<const VTK_TT *>(static_cast<void *>(leaving)),
+                                                          m_SlabSum.data(),
+                                                          m_SliceSize));
       }
+      m_RecomputeSlabSum = false;
+    }
+    else
+    {
+      m_RecomputeSlabSum = true;
     }
-    break;
+
+    std::copy(data, data + m_SliceSize * typeSize, leaving);
+    m_SlabFirst = this->SlabShift > 0 ? (slot + 1) % m_SlabSize : slot;
+  }
+  else
+  {
+    m_SlabSize = extent[5] - extent[4] + 1;
+    m_SlabZMin = extent[4];
+    for (int i = 0; i < 4; ++i)
+      m_SlabExtent[i] = extent[i];
+    m_SliceSize = static_cast<vtkIdType>(extent[1] - extent[0] + 1) * (extent[3] - extent[2] + 1);
+    m_SlabScalarType = inputArray->GetDataType();
+    m_SlabFirst = 0;
+
+    m_SlabBuffer.assign(data, data + m_SlabSize * m_SliceSize * typeSize);
+    m_RecomputeSlabSum = true;
   }
+
+  if (keepSum)
+  {
+    m_SlabSum.resize(m_SliceSize);
+  }
+  else
+  {
+    m_SlabSum.clear();
+  }
+  m_SlabSumValid = false;
+  return true;
 }
 
 int vtkMitkThickSlicesFilter::RequestData(vtkInformation *request,
                                           vtkInformationVector **inputVector,
                                           vtkInformationVector *outputVector)
 {
+  vtkImageData *input = vtkImageData::GetData(inputVector[0]);
+  vtkDataArray *inputArray = this->GetInputArrayToProcess(0, inputVector);
+  if (input != nullptr && inputArray != nullptr && inputArray->GetNumberOfComponents() == 1)
+  {
+    const bool slabUpdated = this->UpdateSlab(input, inputArray);
+
+    // the shift only applies to this update
+    this->SlabShift = 0;
+    if (!slabUpdated)
+    {
+      return 0;
+    }
+  }
+
   if (!this->Superclass::RequestData(request, inputVector, outputVector))
   {
     return 0;
   }
   vtkImageData *output = vtkImageData::GetData(outputVector);
+
+  // the running sum is complete only if all rows of the slab were projected
+  const int *outExt = output->GetExtent();
+  m_SlabSumValid = !m_SlabSum.empty() && outExt[0] == m_SlabExtent[0] && outExt[1] == m_SlabExtent[1] &&
+                   outExt[2] == m_SlabExtent[2] && outExt[3] == m_SlabExtent[3];
+
   vtkDataArray *outArray = output->GetPointData()->GetScalars();
   std::ostringstream newname;
   newname << (outArray->GetName() ? outArray->GetName() : "") << "Gradient";
@@ -372,21 +438,12 @@ void vtkMitkThickSlicesFilter::ThreadedRequestData(vtkInformation *,
                                                    vtkImageData ***inData,
                                                    vtkImageData **outData,
                                                    int outExt[6],
-                                                   int threadId)
+                                                   int /*threadId*/)
 {
   // Get the input and output data objects.
   vtkImageData *input = inData[0][0];
   vtkImageData *output = outData[0];
 
-  // The ouptut scalar type must be double to store proper gradients.
-  /*
-    if(output->GetScalarType() != VTK_DOUBLE)
-      {
-      vtkErrorMacro("Execute: output ScalarType is "
-                    << output->GetScalarType() << "but must be double.");
-      return;
-      }
-    */
   vtkDataArray *inputArray = this->GetInputArrayToProcess(0, inputVector);
   if (!inputArray)
   {
@@ -406,13 +463,25 @@ void vtkMitkThickSlicesFilter::ThreadedRequestData(vtkInformation *,
     return;
   }
 
-  void *inPtr = inputArray->GetVoidPointer(0);
+  // The projection reads the slices from the slab (see UpdateSlab()), not from the input,
+  // which only holds the entering slice if the slab was shifted.
+  vtkMitkThickSlab slab;
+  slab.Buffer = m_SlabBuffer.data();
+  slab.First = m_SlabFirst;
+  slab.NumberOfSlices = m_SlabSize;
+  slab.ZMin = m_SlabZMin;
+  for (int i = 0; i < 4; ++i)
+    slab.Extent[i] = m_SlabExtent[i];
+  slab.SliceSize = m_SliceSize;
+  slab.Sum = m_SlabSum.empty() ? nullptr : m_SlabSum.data();
+  slab.RecomputeSum = m_RecomputeSlabSum;
+
   void *outPtr = output->GetScalarPointerForExtent(outExt);
 
-  switch (inputArray->GetDataType())
+  switch (m_SlabScalarType)
   {
-    vtkTemplateMacro(vtkMitkThickSlicesFilterExecute(
-      this, input, static_cast<VTK_TT *>(inPtr), output, static_cast<VTK_TT *>(outPtr), outExt, threadId));
+    vtkTemplateMacro(
+      vtkMitkThickSlicesFilterExecute(this, slab, output, static_cast<VTK_TT *>(outPtr), outExt));
     default:
       vtkErrorMacro("Execute: Unknown ScalarType " << input->GetScalarType());
       return;
@@ -0,0 +1,149 @@
+/*===================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center,
+Division of Medical and Biological Informatics.
+All rights reserved.
+
+This software is distributed WITHOUT ANY WARRANTY; without
+even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE.
+
+See LICENSE.txt or http://www.mitk.org for details.
+
+===================================================================*/
+
+// MITK
+#include <mitkIOUtil.h>
+#include <mitkImageGenerator.h>
+#include <mitkPointSet.h>
+#include <mitkRenderingBenchmark.h>
+#include <mitkRenderingTestHelper.h>
+#include <mitkSurface.h>
+#include <mitkTestFixture.h>
+#include <mitkTestingMacros.h>
+
+// VTK
+#include <vtkSphereSource.h>
+
+#include <cmath>
+
+/**
+ * @brief Rendering benchmarks of the core mappers.
+ *
+ * The mappers of synthetic data and of sample data are rendered offscreen, see mitk::RenderingBenchmark.
+ * The timings are printed to the test output; the tests only fail if nothing could be rendered.
+ */
+class mitkRenderingBenchmarkTestSuite : public mitk::TestFixture
+{
+  CPPUNIT_TEST_SUITE(mitkRenderingBenchmarkTestSuite);
+  MITK_TEST(ImageVtkMapper2D_SyntheticImage);
+  MITK_TEST(ImageVtkMapper2D_Pic3D);
+  MITK_TEST(SurfaceVtkMapper2D_Sphere);
+  MITK_TEST(SurfaceVtkMapper3D_Sphere);
+  MITK_TEST(PointSetVtkMapper2D_SyntheticPointSet);
+  MITK_TEST(PointSetVtkMapper3D_SyntheticPointSet);
+  MITK_TEST(PointSetVtkMapper3D_SyntheticPointSetWithLabels);
+  CPPUNIT_TEST_SUITE_END();
+
+private:
+  mitk::DataNode::Pointer CreateNode(mitk::BaseData *data)
+  {
+    mitk::DataNode::Pointer node = mitk::DataNode::New();
+    node->SetData(data);
+    return node;
+  }
+
+  mitk::Surface::Pointer CreateSphere()
+  {
+    vtkSmartPointer<vtkSphereSource> sphereSource = vtkSmartPointer<vtkSphereSource>::New();
+    sphereSource->SetRadius(100.0);
+    sphereSource->SetThetaResolution(500);
+    sphereSource->SetPhiResolution(500);
+    sphereSource->Update();
+
+    mitk::Surface::Pointer surface = mitk::Surface::New();
+    surface->SetVtkPolyData(sphereSource->GetOutput());
+    return surface;
+  }
+
+  mitk::PointSet::Pointer CreateHelix(int numberOfPoints)
+  {
+    // points on a helix, so every slice shows a few of them
+    mitk::PointSet::Pointer pointSet = mitk::PointSet::New();
+    for (int i = 0; i < numberOfPoints; ++i)
+    {
+      mitk::Point3D point;
+      point[0] = 100.0 * std::cos(0.01 * i);
+      point[1] = 100.0 * std::sin(0.01 * i);
+      point[2] = 0.05 * i;
+      pointSet->InsertPoint(i, point);
+    }
+    return pointSet;
+  }
+
+  void Run2D(const std::string &name, mitk::DataNode *node)
+  {
+    mitk::RenderingTestHelper renderingHelper(640, 480);
+    renderingHelper.SetMapperIDToRender2D();
+    mitk::RenderingBenchmark benchmark(renderingHelper);
+
+    mitk::RenderingBenchmark::Result result = benchmark.Run(name, node);
+    mitk::RenderingBenchmark::Print(result);
+    CPPUNIT_ASSERT(result.NumberOfFrames > 0);
+  }
+
+  void Run3D(const std::string &name, mitk::DataNode *node)
+  {
+    mitk::RenderingTestHelper renderingHelper(640, 480);
+    mitk::RenderingBenchmark benchmark(renderingHelper);
+    renderingHelper.SetMapperIDToRender3D();
+
+    mitk::RenderingBenchmark::Result result = benchmark.Run(name, node);
+    mitk::RenderingBenchmark::Print(result);
+    CPPUNIT_ASSERT(result.NumberOfFrames > 0);
+  }
+
+public:
+  void ImageVtkMapper2D_SyntheticImage()
+  {
+    mitk::Image::Pointer image = mitk::ImageGenerator::GenerateRandomImage<short>(512, 512, 128, 1, 0.5, 0.5, 1.0);
+    this->Run2D("ImageVtkMapper2D 512x512x128 short", this->CreateNode(image));
+  }
+
+  void ImageVtkMapper2D_Pic3D()
+  {
+    mitk::Image::Pointer image = mitk::IOUtil::Load<mitk::Image>(GetTestDataFilePath("Pic3D.nrrd"));
+    this->Run2D("ImageVtkMapper2D Pic3D", this->CreateNode(image));
+  }
+
+  void SurfaceVtkMapper2D_Sphere()
+  {
+    this->Run2D("SurfaceVtkMapper2D sphere", this->CreateNode(this->CreateSphere()));
+  }
+
+  void SurfaceVtkMapper3D_Sphere()
+  {
+    this->Run3D("SurfaceVtkMapper3D sphere", this->CreateNode(this->CreateSphere()));
+  }
+
+  void PointSetVtkMapper2D_SyntheticPointSet()
+  {
+    this->Run2D("PointSetVtkMapper2D 5000 points", this->CreateNode(this->CreateHelix(5000)));
+  }
+
+  void PointSetVtkMapper3D_SyntheticPointSet()
+  {
+    this->Run3D("PointSetVtkMapper3D 20000 points", this->CreateNode(this->CreateHelix(20000)));
+  }
+
+  void PointSetVtkMapper3D_SyntheticPointSetWithLabels()
+  {
+    mitk::DataNode::Pointer node = this->CreateNode(this->CreateHelix(5000));
+    node->SetStringProperty("label", "P");
+    this->Run3D("PointSetVtkMapper3D 5000 labeled points", node);
+  }
+};
+
+MITK_TEST_SUITE_REGISTRATION(mitkRenderingBenchmark)
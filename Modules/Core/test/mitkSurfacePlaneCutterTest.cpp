@@ -0,0 +1,172 @@
+/*===================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center,
+Division of Medical and Biological Informatics.
+All rights reserved.
+
+This software is distributed WITHOUT ANY WARRANTY; without
+even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE.
+
+See LICENSE.txt or http://www.mitk.org for details.
+
+===================================================================*/
+
+#include "mitkSurfacePlaneCutter.h"
+#include "mitkTestFixture.h"
+#include "mitkTestingMacros.h"
+
+#include <vtkCutter.h>
+#include <vtkPlane.h>
+#include <vtkPlaneSource.h>
+#include <vtkPolyData.h>
+#include <vtkSmartPointer.h>
+#include <vtkSphereSource.h>
+
+class mitkSurfacePlaneCutterTestSuite : public mitk::TestFixture
+{
+  CPPUNIT_TEST_SUITE(mitkSurfacePlaneCutterTestSuite);
+  MITK_TEST(Cut_Sphere_EqualsVtkCutter);
+  MITK_TEST(Cut_ObliquePlane_EqualsVtkCutter);
+  MITK_TEST(Cut_PlaneOutsideOfSurface_ReturnsEmptyContour);
+  MITK_TEST(Cut_SamePlaneTwice_ReturnsCachedContour);
+  MITK_TEST(Cut_ModifiedInput_CutsAgain);
+  MITK_TEST(Cut_MultipleThreads_EqualsVtkCutter);
+  CPPUNIT_TEST_SUITE_END();
+
+private:
+  vtkSmartPointer<vtkPolyData> m_Sphere;
+
+  vtkSmartPointer<vtkPolyData> CutWithVtkCutter(vtkPolyData *input, const double origin[3], const double normal[3])
+  {
+    vtkSmartPointer<vtkPlane> plane = vtkSmartPointer<vtkPlane>::New();
+    plane->SetOrigin(origin[0], origin[1], origin[2]);
+    plane->SetNormal(normal[0], normal[1], normal[2]);
+    vtkSmartPointer<vtkCutter> cutter = vtkSmartPointer<vtkCutter>::New();
+    cutter->SetCutFunction(plane);
+    cutter->SetInputData(input);
+    cutter->Update();
+    return cutter->GetOutput();
+  }
+
+  void AssertEqualContours(vtkPolyData *expected, vtkPolyData *actual)
+  {
+    CPPUNIT_ASSERT_EQUAL(expected->GetNumberOfLines(), actual->GetNumberOfLines());
+    double expectedBounds[6];
+    double actualBounds[6];
+    expected->GetBounds(expectedBounds);
+    actual->GetBounds(actualBounds);
+    for (int i = 0; i < 6; ++i)
+      CPPUNIT_ASSERT_DOUBLES_EQUAL(expectedBounds[i], actualBounds[i], 1e-6);
+  }
+
+public:
+  void setUp() override
+  {
+    vtkSmartPointer<vtkSphereSource> sphereSource = vtkSmartPointer<vtkSphereSource>::New();
+    sphereSource->SetRadius(10.0);
+    sphereSource->SetThetaResolution(100);
+    sphereSource->SetPhiResolution(100);
+    sphereSource->Update();
+    m_Sphere = sphereSource->GetOutput();
+  }
+
+  void tearDown() override { m_Sphere = nullptr; }
+
+  void Cut_Sphere_EqualsVtkCutter()
+  {
+    mitk::SurfacePlaneCutter cutter;
+    cutter.SetInput(m_Sphere);
+
+    const double origin[3] = {0.0, 0.0, 3.3};
+    const double normal[3] = {0.0, 0.0, 1.0};
+    this->AssertEqualContours(this->CutWithVtkCutter(m_Sphere, origin, normal), cutter.Cut(origin, normal));
+  }
+
+  void Cut_ObliquePlane_EqualsVtkCutter()
+  {
+    mitk::SurfacePlaneCutter cutter;
+    cutter.SetInput(m_Sphere);
+
+    const double origin[3] = {1.0, -2.0, 0.5};
+    const double normal[3] = {0.6, 0.0, 0.8};
+    this->AssertEqualContours(this->CutWithVtkCutter(m_Sphere, origin, normal), cutter.Cut(origin, normal));
+  }
+
+  void Cut_PlaneOutsideOfSurface_ReturnsEmptyContour()
+  {
+    mitk::SurfacePlaneCutter cutter;
+    cutter.SetInput(m_Sphere);
+
+    const double origin[3] = {0.0, 20.0, 0.0};
+    const double normal[3] = {0.0, 1.0, 0.0};
+    CPPUNIT_ASSERT_EQUAL(vtkIdType(0), cutter.Cut(origin, normal)->GetNumberOfLines());
+  }
+
+  void Cut_SamePlaneTwice_ReturnsCachedContour()
+  {
+    mitk::SurfacePlaneCutter cutter;
+    cutter.SetInput(m_Sphere);
+
+    const double normal[3] = {0.0, 0.0, 1.0};
+    const double origin[3] = {0.0, 0.0, 1.0};
+    // another origin in the same plane
+    const double otherOrigin[3] = {5.0, -5.0, 1.0};
+    vtkSmartPointer<vtkPolyData> contour = cutter.Cut(origin, normal);
+    CPPUNIT_ASSERT(contour == cutter.Cut(otherOrigin, normal));
+
+    cutter.SetCacheSize(0);
+    CPPUNIT_ASSERT(contour != cutter.Cut(origin, normal));
+  }
+
+  void Cut_ModifiedInput_CutsAgain()
+  {
+    mitk::SurfacePlaneCutter cutter;
+    cutter.SetInput(m_Sphere);
+
+    const double origin[3] = {0.0, 0.0, 0.0};
+    const double normal[3] = {1.0, 0.0, 0.0};
+    vtkSmartPointer<vtkPolyData> contour = cutter.Cut(origin, normal);
+
+    // move the sphere, the old contour must not be returned from the cache
+    for (vtkIdType i = 0; i < m_Sphere->GetNumberOfPoints(); ++i)
+    {
+      double p[3];
+      m_Sphere->GetPoint(i, p);
+      p[0] += 5.0;
+      m_Sphere->GetPoints()->SetPoint(i, p);
+    }
+    m_Sphere->GetPoints()->Modified();
+    cutter.SetInput(m_Sphere);
+
+    vtkSmartPointer<vtkPolyData> movedContour = cutter.Cut(origin, normal);
+    CPPUNIT_ASSERT(contour != movedContour);
+    this->AssertEqualContours(this->CutWithVtkCutter(m_Sphere, origin, normal), movedContour);
+  }
+
+  void Cut_MultipleThreads_EqualsVtkCutter()
+  {
+    // a long, narrow strip of quads, all of them are cut by the plane z = 0.5
+    vtkSmartPointer<vtkPlaneSource> planeSource = vtkSmartPointer<vtkPlaneSource>::New();
+    planeSource->SetOrigin(0.0, 0.0, 0.0);
+    planeSource->SetPoint1(100.0, 0.0, 0.0);
+    planeSource->SetPoint2(0.0, 0.0, 1.0);
+    planeSource->SetResolution(20000, 1);
+    planeSource->Update();
+    vtkSmartPointer<vtkPolyData> strip = planeSource->GetOutput();
+
+    mitk::SurfacePlaneCutter cutter;
+    cutter.SetNumberOfThreads(4);
+    cutter.SetInput(strip);
+
+    const double origin[3] = {0.0, 0.0, 0.5};
+    const double normal[3] = {0.0, 0.0, 1.0};
+    vtkSmartPointer<vtkPolyData> contour = cutter.Cut(origin, normal);
+    CPPUNIT_ASSERT_EQUAL(vtkIdType(20000), contour->GetNumberOfLines());
+    this->AssertEqualContours(this->CutWithVtkCutter(strip, origin, normal), contour);
+  }
+};
+
+MITK_TEST_SUITE_REGISTRATION(mitkSurfacePlaneCutter)
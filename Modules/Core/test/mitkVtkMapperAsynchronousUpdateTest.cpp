@@ -0,0 +1,148 @@
+/*===================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center,
+Division of Medical and Biological Informatics.
+All rights reserved.
+
+This software is distributed WITHOUT ANY WARRANTY; without
+even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE.
+
+See LICENSE.txt or http://www.mitk.org for details.
+
+===================================================================*/
+
+// MITK
+#include <mitkDataNode.h>
+#include <mitkTestFixture.h>
+#include <mitkTestingMacros.h>
+#include <mitkVtkMapper.h>
+
+// VTK
+#include <vtkActor.h>
+#include <vtkSmartPointer.h>
+
+#include <chrono>
+#include <future>
+#include <stdexcept>
+#include <thread>
+
+namespace
+{
+  /** Exposes the asynchronous update of mitk::VtkMapper. */
+  class AsynchronousTestMapper : public mitk::VtkMapper
+  {
+  public:
+    mitkClassMacro(AsynchronousTestMapper, mitk::VtkMapper);
+    itkFactorylessNewMacro(Self);
+
+    vtkProp *GetVtkProp(mitk::BaseRenderer *) override { return m_Actor; }
+
+    using Superclass::FinishAsynchronousUpdate;
+    using Superclass::IsAsynchronousUpdateEnabled;
+    using Superclass::IsAsynchronousUpdateRunning;
+    using Superclass::StartAsynchronousUpdate;
+
+  protected:
+    AsynchronousTestMapper() : m_Actor(vtkSmartPointer<vtkActor>::New()) {}
+
+  private:
+    vtkSmartPointer<vtkActor> m_Actor;
+  };
+}
+
+/**
+ * @brief Tests the opt-in asynchronous update of mitk::VtkMapper without rendering.
+ */
+class mitkVtkMapperAsynchronousUpdateTestSuite : public mitk::TestFixture
+{
+  CPPUNIT_TEST_SUITE(mitkVtkMapperAsynchronousUpdateTestSuite);
+  MITK_TEST(IsAsynchronousUpdateEnabled_ReadsNodeProperty);
+  MITK_TEST(FinishAsynchronousUpdate_WaitsForJob);
+  MITK_TEST(FinishAsynchronousUpdate_CatchesException);
+  MITK_TEST(FinishAsynchronousUpdate_CatchesUnknownException);
+  CPPUNIT_TEST_SUITE_END();
+
+private:
+  mitk::DataNode::Pointer m_Node;
+  AsynchronousTestMapper::Pointer m_Mapper;
+
+  // polls like the mapper does with each rendering
+  bool WaitForFinish()
+  {
+    for (int i = 0; i < 1000; ++i)
+    {
+      if (m_Mapper->FinishAsynchronousUpdate(nullptr))
+        return true;
+      std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    return false;
+  }
+
+public:
+  void setUp() override
+  {
+    m_Node = mitk::DataNode::New();
+    m_Mapper = AsynchronousTestMapper::New();
+    m_Mapper->SetDataNode(m_Node);
+  }
+
+  void tearDown() override
+  {
+    m_Mapper = nullptr;
+    m_Node = nullptr;
+  }
+
+  void IsAsynchronousUpdateEnabled_ReadsNodeProperty()
+  {
+    CPPUNIT_ASSERT(!m_Mapper->IsAsynchronousUpdateEnabled(nullptr));
+    m_Node->SetBoolProperty("asynchronous update", true);
+    CPPUNIT_ASSERT(m_Mapper->IsAsynchronousUpdateEnabled(nullptr));
+  }
+
+  void FinishAsynchronousUpdate_WaitsForJob()
+  {
+    CPPUNIT_ASSERT(!m_Mapper->FinishAsynchronousUpdate(nullptr));
+
+    std::promise<void> release;
+    std::shared_future<void> released = release.get_future().share();
+    bool done = false;
+    CPPUNIT_ASSERT(m_Mapper->StartAsynchronousUpdate([released, &done]() {
+      released.wait();
+      done = true;
+    }));
+
+    // the job is blocked, so it can neither be finished nor started again
+    CPPUNIT_ASSERT(m_Mapper->IsAsynchronousUpdateRunning());
+    CPPUNIT_ASSERT(!m_Mapper->FinishAsynchronousUpdate(nullptr));
+    CPPUNIT_ASSERT(!m_Mapper->StartAsynchronousUpdate([]() {}));
+
+    release.set_value();
+    CPPUNIT_ASSERT(this->WaitForFinish());
+    CPPUNIT_ASSERT(done);
+    CPPUNIT_ASSERT(!m_Mapper->IsAsynchronousUpdateRunning());
+    CPPUNIT_ASSERT(!m_Mapper->FinishAsynchronousUpdate(nullptr));
+  }
+
+  void FinishAsynchronousUpdate_CatchesException()
+  {
+    CPPUNIT_ASSERT(m_Mapper->StartAsynchronousUpdate([]() { throw std::runtime_error("test"); }));
+    CPPUNIT_ASSERT(this->WaitForFinish());
+    CPPUNIT_ASSERT(!m_Mapper->IsAsynchronousUpdateRunning());
+
+    // a new job can be started afterwards
+    CPPUNIT_ASSERT(m_Mapper->StartAsynchronousUpdate([]() {}));
+    CPPUNIT_ASSERT(this->WaitForFinish());
+  }
+
+  void FinishAsynchronousUpdate_CatchesUnknownException()
+  {
+    CPPUNIT_ASSERT(m_Mapper->StartAsynchronousUpdate([]() { throw 42; }));
+    CPPUNIT_ASSERT(this->WaitForFinish());
+    CPPUNIT_ASSERT(!m_Mapper->IsAsynchronousUpdateRunning());
+  }
+};
+
+MITK_TEST_SUITE_REGISTRATION(mitkVtkMapperAsynchronousUpdate)
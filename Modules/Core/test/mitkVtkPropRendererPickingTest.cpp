@@ -0,0 +1,146 @@
+/*===================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center,
+Division of Medical and Biological Informatics.
+All rights reserved.
+
+This software is distributed WITHOUT ANY WARRANTY; without
+even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE.
+
+See LICENSE.txt or http://www.mitk.org for details.
+
+===================================================================*/
+
+// MITK
+#include <mitkRenderingTestHelper.h>
+#include <mitkSurface.h>
+#include <mitkTestFixture.h>
+#include <mitkTestingMacros.h>
+#include <mitkVtkPropRenderer.h>
+
+// VTK
+#include <vtkPoints.h>
+#include <vtkPolyData.h>
+#include <vtkSphereSource.h>
+
+/**
+ * @brief Tests the cell picking of mitk::VtkPropRenderer on a mesh which is large enough to be picked via a cell
+ * locator. The sphere is centered in the view, so the center of the display hits its front side.
+ */
+class mitkVtkPropRendererPickingTestSuite : public mitk::TestFixture
+{
+  CPPUNIT_TEST_SUITE(mitkVtkPropRendererPickingTestSuite);
+  MITK_TEST(PickWorldPoint_CellPicking_HitsSphere);
+  MITK_TEST(PickWorldPoint_CellPicking_ModifiedSphere);
+  MITK_TEST(PickObject_ReturnsSphereNode);
+  CPPUNIT_TEST_SUITE_END();
+
+private:
+  mitk::Surface::Pointer m_Sphere;
+  mitk::DataNode::Pointer m_Node;
+  mitk::Point2D m_DisplayCenter;
+
+  double PickDistanceToCenter(mitk::VtkPropRenderer *renderer)
+  {
+    mitk::Point3D worldPoint;
+    worldPoint.Fill(0.0);
+    renderer->PickWorldPoint(m_DisplayCenter, worldPoint);
+    return worldPoint.GetVectorFromOrigin().GetNorm();
+  }
+
+public:
+  void setUp() override
+  {
+    vtkSmartPointer<vtkSphereSource> sphereSource = vtkSmartPointer<vtkSphereSource>::New();
+    sphereSource->SetRadius(100.0);
+    sphereSource->SetThetaResolution(200);
+    sphereSource->SetPhiResolution(200);
+    sphereSource->Update();
+
+    m_Sphere = mitk::Surface::New();
+    m_Sphere->SetVtkPolyData(sphereSource->GetOutput());
+
+    m_Node = mitk::DataNode::New();
+    m_Node->SetData(m_Sphere);
+    m_Node->SetBoolProperty("pickable", true);
+
+    m_DisplayCenter[0] = 320;
+    m_DisplayCenter[1] = 240;
+  }
+
+  void tearDown() override
+  {
+    m_Node = nullptr;
+    m_Sphere = nullptr;
+  }
+
+  void PickWorldPoint_CellPicking_HitsSphere()
+  {
+    mitk::RenderingTestHelper renderingHelper(640, 480);
+    renderingHelper.AddNodeToStorage(m_Node);
+    renderingHelper.SetMapperIDToRender3D();
+    renderingHelper.Render();
+
+    auto *renderer =
+      dynamic_cast<mitk::VtkPropRenderer *>(mitk::BaseRenderer::GetInstance(renderingHelper.GetVtkRenderWindow()));
+    CPPUNIT_ASSERT(renderer != nullptr);
+    renderer->SetPickingMode(mitk::VtkPropRenderer::CellPicking);
+
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(100.0, this->PickDistanceToCenter(renderer), 1.0);
+    // the second pick uses the locator built by the first one
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(100.0, this->PickDistanceToCenter(renderer), 1.0);
+  }
+
+  void PickWorldPoint_CellPicking_ModifiedSphere()
+  {
+    mitk::RenderingTestHelper renderingHelper(640, 480);
+    renderingHelper.AddNodeToStorage(m_Node);
+    renderingHelper.SetMapperIDToRender3D();
+    renderingHelper.Render();
+
+    auto *renderer =
+      dynamic_cast<mitk::VtkPropRenderer *>(mitk::BaseRenderer::GetInstance(renderingHelper.GetVtkRenderWindow()));
+    CPPUNIT_ASSERT(renderer != nullptr);
+    renderer->SetPickingMode(mitk::VtkPropRenderer::CellPicking);
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(100.0, this->PickDistanceToCenter(renderer), 1.0);
+
+    // shrink the sphere, the locator has to be built again
+    vtkPoints *points = m_Sphere->GetVtkPolyData()->GetPoints();
+    double point[3];
+    for (vtkIdType i = 0; i < points->GetNumberOfPoints(); ++i)
+    {
+      points->GetPoint(i, point);
+      points->SetPoint(i, 0.5 * point[0], 0.5 * point[1], 0.5 * point[2]);
+    }
+    points->Modified();
+    m_Sphere->GetVtkPolyData()->Modified();
+    m_Sphere->Modified();
+    renderingHelper.Render();
+
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(50.0, this->PickDistanceToCenter(renderer), 1.0);
+  }
+
+  void PickObject_ReturnsSphereNode()
+  {
+    mitk::RenderingTestHelper renderingHelper(640, 480);
+    renderingHelper.AddNodeToStorage(m_Node);
+    renderingHelper.SetMapperIDToRender3D();
+    renderingHelper.Render();
+
+    mitk::BaseRenderer *renderer = mitk::BaseRenderer::GetInstance(renderingHelper.GetVtkRenderWindow());
+    mitk::Point3D worldPoint;
+    CPPUNIT_ASSERT(renderer->PickObject(m_DisplayCenter, worldPoint) == m_Node.GetPointer());
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(100.0, worldPoint.GetVectorFromOrigin().GetNorm(), 1.0);
+
+    // nothing is picked beside the sphere
+    mitk::Point2D corner;
+    corner[0] = 1;
+    corner[1] = 1;
+    CPPUNIT_ASSERT(renderer->PickObject(corner, worldPoint) == nullptr);
+  }
+};
+
+MITK_TEST_SUITE_REGISTRATION(mitkVtkPropRendererPicking)
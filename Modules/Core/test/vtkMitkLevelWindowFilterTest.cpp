@@ -0,0 +1,265 @@
+/*===================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center,
+Division of Medical and Biological Informatics.
+All rights reserved.
+
+This software is distributed WITHOUT ANY WARRANTY; without
+even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE.
+
+See LICENSE.txt or http://www.mitk.org for details.
+
+===================================================================*/
+
+#include "mitkTestFixture.h"
+#include "mitkTestingMacros.h"
+
+#include <vtkMitkLevelWindowFilter.h>
+
+#include <itkTimeProbe.h>
+
+#include <vtkColorTransferFunction.h>
+#include <vtkImageData.h>
+#include <vtkLookupTable.h>
+#include <vtkPiecewiseFunction.h>
+#include <vtkSmartPointer.h>
+
+#include <algorithm>
+#include <cstring>
+
+class vtkMitkLevelWindowFilterTestSuite : public mitk::TestFixture
+{
+  CPPUNIT_TEST_SUITE(vtkMitkLevelWindowFilterTestSuite);
+  MITK_TEST(Update_ShortImageClipped_EqualsLookupTable);
+  MITK_TEST(Update_ShortImageUnclipped_RoundsToNearestColor);
+  MITK_TEST(Update_FloatImageUnclipped_RoundsToNearestColor);
+  MITK_TEST(Update_UnsignedCharImageTransferFunction_EqualsTransferFunction);
+  MITK_TEST(Update_ModifiedLookupTable_UpdatesColors);
+  MITK_TEST(Update_1024x1024Slices_Benchmark);
+  CPPUNIT_TEST_SUITE_END();
+
+private:
+  vtkSmartPointer<vtkLookupTable> m_LookupTable;
+  vtkSmartPointer<vtkMitkLevelWindowFilter> m_Filter;
+
+  template <class T>
+  vtkSmartPointer<vtkImageData> CreateImage(int scalarType, int size, double minValue, double maxValue)
+  {
+    vtkSmartPointer<vtkImageData> image = vtkSmartPointer<vtkImageData>::New();
+    image->SetDimensions(size, size, 1);
+    image->AllocateScalars(scalarType, 1);
+    auto *pixels = static_cast<T *>(image->GetScalarPointer());
+    for (int i = 0; i < size * size; ++i)
+    {
+      pixels[i] = static_cast<T>(minValue + (maxValue - minValue) * ((i * 7919) % 1000) / 999.0);
+    }
+    return image;
+  }
+
+  void SetClippingBounds(double xMin, double xMax, double yMin, double yMax)
+  {
+    double bounds[4] = {xMin, xMax, yMin, yMax};
+    m_Filter->SetClippingBounds(bounds);
+  }
+
+  unsigned int GetPixel(int x, int y)
+  {
+    unsigned int pixel;
+    std::memcpy(&pixel, m_Filter->GetOutput()->GetScalarPointer(x, y, 0), sizeof(pixel));
+    return pixel;
+  }
+
+  unsigned int MapValue(vtkScalarsToColors *lookupTable, double value)
+  {
+    unsigned int pixel;
+    std::memcpy(&pixel, lookupTable->MapValue(value), sizeof(pixel));
+    return pixel;
+  }
+
+  /** Mapping of linear lookup tables to unclipped extents, i.e. rounding to the nearest table index. */
+  unsigned int MapValueRounded(double value)
+  {
+    double tableRange[2];
+    m_LookupTable->GetTableRange(tableRange);
+    const int maxIndex = m_LookupTable->GetNumberOfColors() - 1;
+    const float scale = (maxIndex + 1) / (tableRange[1] - tableRange[0]);
+    const float bias = -tableRange[0] * scale + 0.5f;
+    int index = static_cast<int>(static_cast<float>(value) * scale + bias);
+    index = std::min(std::max(index, 0), maxIndex);
+
+    unsigned int pixel;
+    std::memcpy(&pixel, m_LookupTable->GetPointer(index), sizeof(pixel));
+    return pixel;
+  }
+
+public:
+  void setUp() override
+  {
+    m_LookupTable = vtkSmartPointer<vtkLookupTable>::New();
+    m_LookupTable->SetTableRange(-100.0, 400.0);
+    m_LookupTable->SetSaturationRange(0.0, 0.0);
+    m_LookupTable->SetHueRange(0.0, 0.0);
+    m_LookupTable->SetValueRange(0.0, 1.0);
+    m_LookupTable->SetAlphaRange(0.5, 1.0);
+    m_LookupTable->Build();
+
+    m_Filter = vtkSmartPointer<vtkMitkLevelWindowFilter>::New();
+    m_Filter->SetLookupTable(m_LookupTable);
+    this->SetClippingBounds(0.0, 1e6, 0.0, 1e6);
+  }
+
+  void tearDown() override
+  {
+    m_Filter = nullptr;
+    m_LookupTable = nullptr;
+  }
+
+  void Update_ShortImageClipped_EqualsLookupTable()
+  {
+    vtkSmartPointer<vtkImageData> image = this->CreateImage<short>(VTK_SHORT, 64, -1000.0, 1000.0);
+    m_Filter->SetInputData(image);
+    this->SetClippingBounds(10.0, 50.5, 5.0, 60.0);
+    m_Filter->Update();
+
+    for (int y = 0; y < 64; ++y)
+    {
+      for (int x = 0; x < 64; ++x)
+      {
+        const bool inside = x >= 10 && x <= 50 && y >= 5 && y < 60;
+        const unsigned int expected =
+          inside ? this->MapValue(m_LookupTable, *static_cast<short *>(image->GetScalarPointer(x, y, 0))) : 0u;
+        CPPUNIT_ASSERT_EQUAL(expected, this->GetPixel(x, y));
+      }
+    }
+  }
+
+  void Update_ShortImageUnclipped_RoundsToNearestColor()
+  {
+    vtkSmartPointer<vtkImageData> image = this->CreateImage<short>(VTK_SHORT, 64, -1000.0, 1000.0);
+    m_Filter->SetInputData(image);
+    m_Filter->Update();
+
+    for (int y = 0; y < 64; ++y)
+    {
+      for (int x = 0; x < 64; ++x)
+      {
+        const unsigned int expected = this->MapValueRounded(*static_cast<short *>(image->GetScalarPointer(x, y, 0)));
+        CPPUNIT_ASSERT_EQUAL(expected, this->GetPixel(x, y));
+      }
+    }
+  }
+
+  void Update_FloatImageUnclipped_RoundsToNearestColor()
+  {
+    vtkSmartPointer<vtkImageData> image = this->CreateImage<float>(VTK_FLOAT, 64, -1000.0, 1000.0);
+    m_Filter->SetInputData(image);
+    m_Filter->Update();
+
+    for (int y = 0; y < 64; ++y)
+    {
+      for (int x = 0; x < 64; ++x)
+      {
+        const unsigned int expected = this->MapValueRounded(*static_cast<float *>(image->GetScalarPointer(x, y, 0)));
+        CPPUNIT_ASSERT_EQUAL(expected, this->GetPixel(x, y));
+      }
+    }
+  }
+
+  void Update_UnsignedCharImageTransferFunction_EqualsTransferFunction()
+  {
+    vtkSmartPointer<vtkColorTransferFunction> transferFunction = vtkSmartPointer<vtkColorTransferFunction>::New();
+    transferFunction->AddRGBPoint(0.0, 0.0, 0.0, 1.0);
+    transferFunction->AddRGBPoint(255.0, 1.0, 0.5, 0.0);
+    vtkSmartPointer<vtkPiecewiseFunction> opacityFunction = vtkSmartPointer<vtkPiecewiseFunction>::New();
+    opacityFunction->AddPoint(0.0, 0.0);
+    opacityFunction->AddPoint(255.0, 1.0);
+
+    vtkSmartPointer<vtkImageData> image = this->CreateImage<unsigned char>(VTK_UNSIGNED_CHAR, 32, 0.0, 255.0);
+    m_Filter->SetLookupTable(transferFunction);
+    m_Filter->SetOpacityPiecewiseFunction(opacityFunction);
+    m_Filter->SetInputData(image);
+    m_Filter->Update();
+
+    for (int y = 0; y < 32; ++y)
+    {
+      for (int x = 0; x < 32; ++x)
+      {
+        const double value = *static_cast<unsigned char *>(image->GetScalarPointer(x, y, 0));
+        double rgba[4];
+        transferFunction->GetColor(value, rgba);
+        rgba[3] = opacityFunction->GetValue(value);
+
+        const auto *pixel = static_cast<unsigned char *>(m_Filter->GetOutput()->GetScalarPointer(x, y, 0));
+        for (int c = 0; c < 4; ++c)
+          CPPUNIT_ASSERT_EQUAL(static_cast<unsigned char>(255.0 * rgba[c] + 0.5), pixel[c]);
+      }
+    }
+  }
+
+  void Update_ModifiedLookupTable_UpdatesColors()
+  {
+    vtkSmartPointer<vtkImageData> image = this->CreateImage<short>(VTK_SHORT, 16, 0.0, 300.0);
+    m_Filter->SetInputData(image);
+    m_Filter->Update();
+
+    m_LookupTable->SetTableRange(200.0, 300.0);
+    m_LookupTable->Build();
+    m_Filter->Update();
+
+    for (int x = 0; x < 16; ++x)
+    {
+      const unsigned int expected = this->MapValueRounded(*static_cast<short *>(image->GetScalarPointer(x, 0, 0)));
+      CPPUNIT_ASSERT_EQUAL(expected, this->GetPixel(x, 0));
+    }
+  }
+
+  void Update_1024x1024Slices_Benchmark()
+  {
+    const int size = 1024;
+    const int repetitions = 20;
+
+    vtkSmartPointer<vtkColorTransferFunction> transferFunction = vtkSmartPointer<vtkColorTransferFunction>::New();
+    transferFunction->AddRGBPoint(-1000.0, 0.0, 0.0, 0.0);
+    transferFunction->AddRGBPoint(0.0, 0.8, 0.2, 0.2);
+    transferFunction->AddRGBPoint(1000.0, 1.0, 1.0, 1.0);
+
+    vtkSmartPointer<vtkImageData> images[] = {this->CreateImage<unsigned char>(VTK_UNSIGNED_CHAR, size, 0.0, 255.0),
+                                              this->CreateImage<short>(VTK_SHORT, size, -1000.0, 1000.0),
+                                              this->CreateImage<float>(VTK_FLOAT, size, -1000.0, 1000.0)};
+    vtkScalarsToColors *lookupTables[] = {m_LookupTable, transferFunction};
+    const char *clipping[] = {"unclipped", "clipped"};
+
+    for (auto &image : images)
+    {
+      for (auto *lookupTable : lookupTables)
+      {
+        for (int clipped = 0; clipped < 2; ++clipped)
+        {
+          m_Filter->SetInputData(image);
+          m_Filter->SetLookupTable(lookupTable);
+          this->SetClippingBounds(clipped ? 1.0 : 0.0, size, 0.0, size);
+
+          itk::TimeProbe probe;
+          for (int i = 0; i < repetitions; ++i)
+          {
+            // a new slice is resliced for every render
+            image->Modified();
+            probe.Start();
+            m_Filter->Update();
+            probe.Stop();
+          }
+
+          MITK_INFO << "vtkMitkLevelWindowFilter " << size << "x" << size << " " << image->GetScalarTypeAsString()
+                    << ", " << lookupTable->GetClassName() << ", " << clipping[clipped] << ": "
+                    << 1000.0 * probe.GetMean() << " ms per slice";
+          CPPUNIT_ASSERT_EQUAL(size * size, static_cast<int>(m_Filter->GetOutput()->GetNumberOfPoints()));
+        }
+      }
+    }
+  }
+};
+
+MITK_TEST_SUITE_REGISTRATION(vtkMitkLevelWindowFilter)
@@ -153,6 +153,42 @@ int vtkMitkThickSlicesFilterTest(int, char *[])
   thickSliceFilter->Update();
   vtkMitkThickSlicesFilterTestHelper::EvaluateResult(6, thickSliceFilter->GetOutput(), "Mean");
 
+  //////////////////////////////////////////////////////////////////////////
+  // Shift the slab by one slice, the input only holds the entering slice.
+  // Slab looks like:
+  // 444444444
+  // ...
+  // 999999999
+  thickSliceFilter->SetThickSliceMode(1);
+  thickSliceFilter->Modified();
+  thickSliceFilter->Update();
+
+  mitk::Image::Pointer enteringSlice9 = vtkMitkThickSlicesFilterTestHelper::CreateTestImage(9, 9);
+  MITK_TEST_CONDITION_REQUIRED(thickSliceFilter->CanShiftSlab(enteringSlice9->GetVtkImageData()),
+                               "Slab can be shifted by a single slice");
+  thickSliceFilter->SetSlabShift(1);
+  thickSliceFilter->SetInputData(enteringSlice9->GetVtkImageData());
+  thickSliceFilter->Modified();
+  thickSliceFilter->Update();
+  vtkMitkThickSlicesFilterTestHelper::EvaluateResult(6, thickSliceFilter->GetOutput(), "Sum (shifted up)");
+  MITK_TEST_CONDITION_REQUIRED(thickSliceFilter->GetSlabShift() == 0, "Slab shift is reset after the update");
+
+  // Back to the slab of testImage2
+  mitk::Image::Pointer enteringSlice3 = vtkMitkThickSlicesFilterTestHelper::CreateTestImage(3, 3);
+  thickSliceFilter->SetThickSliceMode(4);
+  thickSliceFilter->SetSlabShift(-1);
+  thickSliceFilter->SetInputData(enteringSlice3->GetVtkImageData());
+  thickSliceFilter->Modified();
+  thickSliceFilter->Update();
+  vtkMitkThickSlicesFilterTestHelper::EvaluateResult(6, thickSliceFilter->GetOutput(), "Mean (shifted down)");
+
+  thickSliceFilter->SetThickSliceMode(0);
+  thickSliceFilter->SetSlabShift(1);
+  thickSliceFilter->SetInputData(enteringSlice9->GetVtkImageData());
+  thickSliceFilter->Modified();
+  thickSliceFilter->Update();
+  vtkMitkThickSlicesFilterTestHelper::EvaluateResult(9, thickSliceFilter->GetOutput(), "MaxIP (shifted up)");
+
   thickSliceFilter->Delete();
 
   MITK_TEST_END()
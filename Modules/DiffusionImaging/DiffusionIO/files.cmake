@@ -27,6 +27,7 @@ set(CPP_FILES
   mitkFiberBundleVtkWriter.cpp
   mitkFiberBundleSerializer.cpp
   mitkFiberBundleMapper2D.cpp
+  mitkFiberBundleSegmentTree.cpp
   mitkFiberBundleMapper3D.cpp
   mitkPeakImageMapper2D.cpp
   mitkPeakImageMapper3D.cpp
@@ -154,7 +154,8 @@ void mitk::FiberBundleMapper2D::Update(mitk::BaseRenderer * renderer)
   vtkProperty *property = localStorage->m_Actor->GetProperty();
   property->SetLighting(false);
 
-  if ( localStorage->m_LastUpdateTime<renderer->GetCurrentWorldPlaneGeometryUpdateTime() || localStorage->m_LastUpdateTime<fiberBundle->GetUpdateTime2D() )
+  if ( localStorage->m_LastUpdateTime<renderer->GetCurrentWorldPlaneGeometryUpdateTime() || localStorage->m_LastUpdateTime<fiberBundle->GetUpdateTime2D()
+       || localStorage->m_SlabThickness!=thickness )
   {
     this->UpdateShaderParameter(renderer);
     this->GenerateDataForRenderer( renderer );
@@ -182,69 +183,98 @@ void mitk::FiberBundleMapper2D::GenerateDataForRenderer(mitk::BaseRenderer *rend
   if (fiberPolyData == nullptr)
     return;
 
-  fiberPolyData->GetPointData()->AddArray(fiberBundle->GetFiberColors());
+  // the tree is shared by all 2D render windows
+  if (m_SegmentTreeUpdateTime.GetMTime() < fiberBundle->GetUpdateTime2D().GetMTime())
+  {
+    fiberPolyData->GetPointData()->AddArray(fiberBundle->GetFiberColors());
+    m_SegmentTree.Build(fiberPolyData);
+    m_SegmentTreeUpdateTime.Modified();
+  }
+
+  // same plane equation as in the shader (vtkShaderCallback)
+  mitk::PlaneGeometry::ConstPointer planeGeo = renderer->GetSliceNavigationController()->GetCurrentPlaneGeometry();
+  double planeNormal[3];
+  double planeDistance = 0;
+  for (int i = 0; i < 3; ++i)
+  {
+    planeNormal[i] = planeGeo->GetNormal()[i];
+    planeDistance += planeGeo->GetOrigin()[i] * planeNormal[i];
+  }
+
+  float thickness = 2.0;
+  node->GetFloatProperty("Fiber2DSliceThickness", thickness);
+  localStorage->m_SlabThickness = thickness;
+
+  // small margin, the shader computes the distance in single precision
+  vtkSmartPointer<vtkPolyData> slabPolyData = m_SegmentTree.ExtractSlab(planeNormal, planeDistance, thickness*1.01 + 0.001);
+
   localStorage->m_Mapper->ScalarVisibilityOn();
   localStorage->m_Mapper->SetScalarModeToUsePointFieldData();
   localStorage->m_Mapper->SetLookupTable(m_lut);  //apply the properties after the slice was set
   localStorage->m_Actor->GetProperty()->SetOpacity(0.999);
   localStorage->m_Mapper->SelectColorArray("FIBER_COLORS");
-  localStorage->m_Mapper->SetInputData(fiberPolyData);
-
-  localStorage->m_Mapper->SetVertexShaderCode(
-        "//VTK::System::Dec\n"
-        "attribute vec4 vertexMC;\n"
-
-        "//VTK::Normal::Dec\n"
-        "uniform mat4 MCDCMatrix;\n"
-
-        "//VTK::Color::Dec\n"
-
-        "varying vec4 positionWorld;\n"
-        "varying vec4 colorVertex;\n"
-
-        "void main(void)\n"
-        "{\n"
-        "  colorVertex = scalarColor;\n"
-        "  positionWorld = vertexMC;\n"
-        "  gl_Position = MCDCMatrix * vertexMC;\n"
-        "}\n"
-        );
-
-  localStorage->m_Mapper->SetFragmentShaderCode(
-        "//VTK::System::Dec\n"  // always start with this line
-        "//VTK::Output::Dec\n"  // always have this line in your FS
-        "uniform vec4 slicingPlane;\n"
-        "uniform float fiberThickness;\n"
-        "uniform int fiberFadingON;\n"
-        "uniform float fiberOpacity;\n"
-
-        "varying vec4 positionWorld;\n"
-        "varying vec4 colorVertex;\n"
-        "out vec4 out_Color;\n"
-
-        "void main(void)\n"
-        "{\n"
-        "  float r1 = dot(positionWorld.xyz, slicingPlane.xyz) - slicingPlane.w;\n"
-
-        "  if (abs(r1) >= fiberThickness)\n"
-        "    discard;\n"
-
-        "  if (fiberFadingON != 0)\n"
-        "  {\n"
-        "    float x = (r1 + fiberThickness) / (fiberThickness*2.0);\n"
-        "    x = 1.0 - x;\n"
-        "    out_Color = vec4(colorVertex.xyz*x, fiberOpacity);\n"
-        "  }\n"
-        "  else{\n"
-        "    out_Color = vec4(colorVertex.xyz, fiberOpacity);\n"
-        "  }\n"
-        "}\n"
-        );
-
-  vtkSmartPointer<vtkShaderCallback> myCallback = vtkSmartPointer<vtkShaderCallback>::New();
-  myCallback->renderer = renderer;
-  myCallback->node = this->GetDataNode();
-  localStorage->m_Mapper->AddObserver(vtkCommand::UpdateShaderEvent,myCallback);
+  localStorage->m_Mapper->SetInputData(slabPolyData);
+
+  // the shaders and the callback for their uniforms are set up once per render window
+  if (localStorage->m_ShaderCallback == nullptr)
+  {
+    localStorage->m_Mapper->SetVertexShaderCode(
+          "//VTK::System::Dec\n"
+          "attribute vec4 vertexMC;\n"
+
+          "//VTK::Normal::Dec\n"
+          "uniform mat4 MCDCMatrix;\n"
+
+          "//VTK::Color::Dec\n"
+
+          "varying vec4 positionWorld;\n"
+          "varying vec4 colorVertex;\n"
+
+          "void main(void)\n"
+          "{\n"
+          "  colorVertex = scalarColor;\n"
+          "  positionWorld = vertexMC;\n"
+          "  gl_Position = MCDCMatrix * vertexMC;\n"
+          "}\n"
+          );
+
+    localStorage->m_Mapper->SetFragmentShaderCode(
+          "//VTK::System::Dec\n"  // always start with this line
+          "//VTK::Output::Dec\n"  // always have this line in your FS
+          "uniform vec4 slicingPlane;\n"
+          "uniform float fiberThickness;\n"
+          "uniform int fiberFadingON;\n"
+          "uniform float fiberOpacity;\n"
+
+          "varying vec4 positionWorld;\n"
+          "varying vec4 colorVertex;\n"
+          "out vec4 out_Color;\n"
+
+          "void main(void)\n"
+          "{\n"
+          "  float r1 = dot(positionWorld.xyz, slicingPlane.xyz) - slicingPlane.w;\n"
+
+          "  if (abs(r1) >= fiberThickness)\n"
+          "    discard;\n"
+
+          "  if (fiberFadingON != 0)\n"
+          "  {\n"
+          "    float x = (r1 + fiberThickness) / (fiberThickness*2.0);\n"
+          "    x = 1.0 - x;\n"
+          "    out_Color = vec4(colorVertex.xyz*x, fiberOpacity);\n"
+          "  }\n"
+          "  else{\n"
+          "    out_Color = vec4(colorVertex.xyz, fiberOpacity);\n"
+          "  }\n"
+          "}\n"
+          );
+
+    vtkSmartPointer<vtkShaderCallback> myCallback = vtkSmartPointer<vtkShaderCallback>::New();
+    myCallback->renderer = renderer;
+    myCallback->node = this->GetDataNode();
+    localStorage->m_Mapper->AddObserver(vtkCommand::UpdateShaderEvent,myCallback);
+    localStorage->m_ShaderCallback = myCallback;
+  }
 
   localStorage->m_Actor->SetMapper(localStorage->m_Mapper);
   localStorage->m_Actor->GetProperty()->SetLineWidth(m_LineWidth);
@@ -277,4 +307,5 @@ mitk::FiberBundleMapper2D::FBXLocalStorage::FBXLocalStorage()
 {
   m_Actor = vtkSmartPointer<vtkActor>::New();
   m_Mapper = vtkSmartPointer<MITKFIBERBUNDLEMAPPER2D_POLYDATAMAPPER>::New();
+  m_SlabThickness = 0;
 }
@@ -22,6 +22,7 @@ See LICENSE.txt or http://www.mitk.org for details.
 #include <mitkVtkMapper.h>
 #include <mitkFiberBundle.h>
 #include <vtkSmartPointer.h>
+#include "mitkFiberBundleSegmentTree.h"
 
 #define MITKFIBERBUNDLEMAPPER2D_POLYDATAMAPPER vtkOpenGLPolyDataMapper
 
@@ -31,11 +32,19 @@ class MITKFIBERBUNDLEMAPPER2D_POLYDATAMAPPER;
 class vtkCutter;
 class vtkPlane;
 class vtkPolyData;
+class vtkCommand;
 
 namespace mitk {
 
 struct IShaderRepository;
 
+/**
+* \brief Mapper for FiberBundle in 2D render windows.
+*
+* Only the fibers close to the current plane (distance below "Fiber2DSliceThickness") are shown. They are taken
+* from a FiberBundleSegmentTree, which is built once per update of the bundle, so each render window only uploads
+* the fiber pieces near its plane. The exact clipping and fading is done in the fragment shader.
+*/
 class FiberBundleMapper2D : public VtkMapper
 {
 
@@ -54,7 +63,9 @@ public:
   public:
     vtkSmartPointer<vtkActor> m_Actor;
     vtkSmartPointer<MITKFIBERBUNDLEMAPPER2D_POLYDATAMAPPER> m_Mapper;
+    vtkSmartPointer<vtkCommand> m_ShaderCallback;
     itk::TimeStamp m_LastUpdateTime;
+    float m_SlabThickness;
     FBXLocalStorage();
 
     ~FBXLocalStorage() override
@@ -78,6 +89,9 @@ private:
   vtkSmartPointer<vtkLookupTable> m_lut;
 
   int     m_LineWidth;
+
+  FiberBundleSegmentTree m_SegmentTree;
+  itk::TimeStamp m_SegmentTreeUpdateTime;
 };
 
 
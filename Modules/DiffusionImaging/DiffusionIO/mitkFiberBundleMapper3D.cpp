@@ -30,12 +30,22 @@ See LICENSE.txt or http://www.mitk.org for details.
 #include <vtkShaderProgram.h>
 #include <mitkVectorProperty.h>
 #include <vtkPlane.h>
+#include <vtkRenderer.h>
 #include <mitkClippingProperty.h>
+#include <mitkRenderingManager.h>
+
+#include <algorithm>
+#include <limits>
 
 mitk::FiberBundleMapper3D::FiberBundleMapper3D()
   : m_TubeRadius(0.0)
   , m_TubeSides(15)
   , m_LineWidth(1)
+  , m_RibbonWidth(0.0)
+  , m_UseLOD(true)
+  , m_LODFibers(20000)
+  , m_LevelsUpdateTime(0)
+  , m_PendingUpdateTime(0)
 {
   m_lut = vtkSmartPointer<vtkLookupTable>::New();
   m_lut->Build();
@@ -60,26 +70,28 @@ const mitk::FiberBundle* mitk::FiberBundleMapper3D::GetInput()
  */
 void mitk::FiberBundleMapper3D::InternalGenerateData(mitk::BaseRenderer *renderer)
 {
-  m_FiberPolyData->GetPointData()->AddArray(m_FiberBundle->GetFiberColors());
   LocalStorage3D *localStorage = m_LocalStorageHandler.GetLocalStorage(renderer);
 
-  if (m_TubeRadius>0.0f)
-  {
-    vtkSmartPointer<vtkTubeFilter> tubeFilter = vtkSmartPointer<vtkTubeFilter>::New();
-    tubeFilter->SetInputData(m_FiberPolyData);
-    tubeFilter->SetNumberOfSides(m_TubeSides);
-    tubeFilter->SetRadius(m_TubeRadius);
-    tubeFilter->Update();
-    m_FiberPolyData = tubeFilter->GetOutput();
-  }
-  else if (m_RibbonWidth>0.0f)
+  // the shaped fibers and the levels of detail are shared by all renderers
+  if (m_LevelsUpdateTime < m_FiberBundle->GetUpdateTime3D().GetMTime())
   {
-    vtkSmartPointer<vtkRibbonFilter> tubeFilter = vtkSmartPointer<vtkRibbonFilter>::New();
-    tubeFilter->SetInputData(m_FiberPolyData);
-    tubeFilter->SetWidth(m_RibbonWidth);
-    tubeFilter->Update();
-    m_FiberPolyData = tubeFilter->GetOutput();
+    if (this->IsAsynchronousUpdateEnabled(renderer))
+    {
+      // the previous fibers are rendered until the worker thread is done
+      if (!this->UpdateRepresentationAsynchronously(renderer))
+        return;
+    }
+    else
+    {
+      m_FiberPolyData->GetPointData()->AddArray(m_FiberBundle->GetFiberColors());
+      ShapeParameters parameters = { m_TubeRadius, m_TubeSides, m_RibbonWidth, m_UseLOD, m_LODFibers };
+      Representation representation;
+      GenerateRepresentation(m_FiberPolyData, parameters, representation);
+      this->SetRepresentation(representation, m_FiberBundle->GetUpdateTime3D().GetMTime());
+    }
   }
+  if (m_ShapedPolyData == nullptr)
+    return;
 
 //  if (tmpopa<1)
 //  {
@@ -93,14 +105,27 @@ void mitk::FiberBundleMapper3D::InternalGenerateData(mitk::BaseRenderer *rendere
 //  }
 //  else
 //  {
-    localStorage->m_FiberMapper->SetInputData(m_FiberPolyData);
+    localStorage->m_FiberMapper->SetInputData(m_ShapedPolyData);
 //  }
 
-  localStorage->m_FiberMapper->SelectColorArray("FIBER_COLORS");
-  localStorage->m_FiberMapper->ScalarVisibilityOn();
-  localStorage->m_FiberMapper->SetScalarModeToUsePointFieldData();
+  localStorage->m_LevelMappers.resize(m_Levels.size());
+  for (unsigned int i=0; i<m_Levels.size(); ++i)
+  {
+    if (localStorage->m_LevelMappers[i] == nullptr)
+      localStorage->m_LevelMappers[i] = vtkSmartPointer<vtkOpenGLPolyDataMapper>::New();
+    localStorage->m_LevelMappers[i]->SetInputData(m_Levels[i]);
+  }
+
+  std::vector< vtkOpenGLPolyDataMapper* > mappers(localStorage->m_LevelMappers.begin(), localStorage->m_LevelMappers.end());
+  mappers.push_back(localStorage->m_FiberMapper);
+  for (auto mapper : mappers)
+  {
+    mapper->SelectColorArray("FIBER_COLORS");
+    mapper->ScalarVisibilityOn();
+    mapper->SetScalarModeToUsePointFieldData();
+    mapper->SetLookupTable(m_lut);
+  }
   localStorage->m_FiberActor->SetMapper(localStorage->m_FiberMapper);
-  localStorage->m_FiberMapper->SetLookupTable(m_lut);
   localStorage->m_FiberActor->GetProperty()->SetLineWidth(m_LineWidth);
   localStorage->m_FiberAssembly->AddPart(localStorage->m_FiberActor);
 
@@ -127,14 +152,212 @@ void mitk::FiberBundleMapper3D::InternalGenerateData(mitk::BaseRenderer *rendere
   plane->SetOrigin(vp);
   plane->SetNormal(vnormal);
 
-  localStorage->m_FiberMapper->RemoveAllClippingPlanes();
-  if (plane_normal.GetNorm() > 0.0)
-    localStorage->m_FiberMapper->AddClippingPlane(plane);
+  for (auto mapper : mappers)
+  {
+    mapper->RemoveAllClippingPlanes();
+    if (plane_normal.GetNorm() > 0.0)
+      mapper->AddClippingPlane(plane);
+  }
+
+  // a representation which was outdated when it was swapped in is replaced by the next one
+  if (m_LevelsUpdateTime >= m_FiberBundle->GetUpdateTime3D().GetMTime())
+    localStorage->m_LastUpdateTime.Modified();
+}
+
+void mitk::FiberBundleMapper3D::GenerateRepresentation(vtkPolyData* fibers, const ShapeParameters& parameters, Representation& representation)
+{
+  representation.ShapedPolyData = GenerateShape(fibers, parameters);
+  GenerateLevelsOfDetail(fibers, parameters, representation);
+}
+
+vtkSmartPointer<vtkPolyData> mitk::FiberBundleMapper3D::GenerateShape(vtkPolyData* fibers, const ShapeParameters& parameters)
+{
+  if (parameters.TubeRadius>0.0f)
+  {
+    vtkSmartPointer<vtkTubeFilter> tubeFilter = vtkSmartPointer<vtkTubeFilter>::New();
+    tubeFilter->SetInputData(fibers);
+    tubeFilter->SetNumberOfSides(parameters.TubeSides);
+    tubeFilter->SetRadius(parameters.TubeRadius);
+    tubeFilter->Update();
+    return tubeFilter->GetOutput();
+  }
+  else if (parameters.RibbonWidth>0.0f)
+  {
+    vtkSmartPointer<vtkRibbonFilter> tubeFilter = vtkSmartPointer<vtkRibbonFilter>::New();
+    tubeFilter->SetInputData(fibers);
+    tubeFilter->SetWidth(parameters.RibbonWidth);
+    tubeFilter->Update();
+    return tubeFilter->GetOutput();
+  }
+  return fibers;
+}
+
+void mitk::FiberBundleMapper3D::GenerateLevelsOfDetail(vtkPolyData* fibers, const ShapeParameters& parameters, Representation& representation)
+{
+  representation.Levels.clear();
+  representation.LevelNumFibers.clear();
+
+  unsigned int numFibers = fibers->GetNumberOfLines();
+  if (!parameters.UseLOD || parameters.LODFibers<=0 || numFibers<=static_cast<unsigned int>(parameters.LODFibers))
+    return;
+
+  // the coarsest level has about LODFibers fibers, each further level four times as many
+  unsigned int fiberStep = (numFibers + parameters.LODFibers - 1) / parameters.LODFibers;
+  while (fiberStep > 1)
+  {
+    unsigned int pointStep = fiberStep>=16 ? 4 : 2;
+    vtkSmartPointer<vtkPolyData> level = SubsampleFibers(fibers, fiberStep, pointStep);
+    representation.LevelNumFibers.push_back(level->GetNumberOfLines());
+    representation.Levels.push_back(GenerateShape(level, parameters));
+    fiberStep /= 4;
+  }
+}
+
+void mitk::FiberBundleMapper3D::SetRepresentation(Representation& representation, itk::ModifiedTimeType updateTime)
+{
+  m_ShapedPolyData = representation.ShapedPolyData;
+  m_Levels.swap(representation.Levels);
+  m_LevelNumFibers.swap(representation.LevelNumFibers);
+  m_LevelsUpdateTime = updateTime;
+}
+
+bool mitk::FiberBundleMapper3D::UpdateRepresentationAsynchronously(mitk::BaseRenderer* renderer)
+{
+  bool swapped = false;
+  if (this->FinishAsynchronousUpdate(renderer))
+  {
+    // a synchronous update (in a renderer without "asynchronous update") may already have generated newer fibers
+    if (m_PendingUpdateTime > m_LevelsUpdateTime)
+    {
+      // the representation stays empty if the generation failed; the previous one is kept then
+      if (m_PendingRepresentation->ShapedPolyData != nullptr)
+        this->SetRepresentation(*m_PendingRepresentation, m_PendingUpdateTime);
+      else
+        m_LevelsUpdateTime = m_PendingUpdateTime;
+      swapped = true;
+    }
+    m_PendingRepresentation.reset();
+
+    // the bundle was modified while the worker thread was running: start the follow-up right away,
+    // the poll of the worker thread requests the rendering which picks it up
+    if (m_LevelsUpdateTime >= m_FiberBundle->GetUpdateTime3D().GetMTime())
+      return swapped;
+  }
 
-  localStorage->m_LastUpdateTime.Modified();
+  if (!this->IsAsynchronousUpdateRunning())
+  {
+    // the worker thread gets its own copy of the fibers, the bundle may change while it is running
+    m_FiberPolyData->GetPointData()->AddArray(m_FiberBundle->GetFiberColors());
+    vtkSmartPointer<vtkPolyData> fibers = vtkSmartPointer<vtkPolyData>::New();
+    fibers->DeepCopy(m_FiberPolyData);
+
+    ShapeParameters parameters = { m_TubeRadius, m_TubeSides, m_RibbonWidth, m_UseLOD, m_LODFibers };
+    std::shared_ptr<Representation> representation = std::make_shared<Representation>();
+    m_PendingRepresentation = representation;
+    m_PendingUpdateTime = m_FiberBundle->GetUpdateTime3D().GetMTime();
+
+    this->StartAsynchronousUpdate([fibers, parameters, representation]() {
+      GenerateRepresentation(fibers, parameters, *representation);
+    });
+    // polls the worker thread, which requests the next rendering
+    return this->UpdateRepresentationAsynchronously(renderer) || swapped;
+  }
+  return swapped;
 }
 
+vtkSmartPointer<vtkPolyData> mitk::FiberBundleMapper3D::SubsampleFibers(vtkPolyData* fibers, unsigned int fiberStep, unsigned int pointStep)
+{
+  vtkPoints* points = fibers->GetPoints();
+  vtkDataArray* colors = fibers->GetPointData()->GetArray("FIBER_COLORS");
+
+  vtkSmartPointer<vtkPoints> newPoints = vtkSmartPointer<vtkPoints>::New();
+  vtkSmartPointer<vtkCellArray> newLines = vtkSmartPointer<vtkCellArray>::New();
+  vtkSmartPointer<vtkDataArray> newColors;
+  if (colors!=nullptr)
+  {
+    newColors.TakeReference(colors->NewInstance());
+    newColors->SetName(colors->GetName());
+    newColors->SetNumberOfComponents(colors->GetNumberOfComponents());
+  }
+
+  vtkCellArray* lines = fibers->GetLines();
+  vtkIdType numPoints(0);
+  vtkIdType* pointIds(nullptr);
+  unsigned int fiber = 0;
+  for (lines->InitTraversal(); lines->GetNextCell(numPoints, pointIds); ++fiber)
+  {
+    if (fiber%fiberStep!=0 || numPoints<=0)
+      continue;
+
+    newLines->InsertNextCell(static_cast<int>((numPoints - 1 + pointStep - 1)/pointStep + 1));
+    for (vtkIdType j=0; j<numPoints; ++j)
+    {
+      if (j%pointStep!=0 && j!=numPoints-1)
+        continue;
+      vtkIdType id = newPoints->InsertNextPoint(points->GetPoint(pointIds[j]));
+      if (newColors!=nullptr)
+        newColors->InsertNextTuple(pointIds[j], colors);
+      newLines->InsertCellPoint(id);
+    }
+  }
+
+  vtkSmartPointer<vtkPolyData> level = vtkSmartPointer<vtkPolyData>::New();
+  level->SetPoints(newPoints);
+  level->SetLines(newLines);
+  if (newColors!=nullptr)
+    level->GetPointData()->AddArray(newColors);
+  return level;
+}
 
+void mitk::FiberBundleMapper3D::SelectLevelOfDetail(mitk::BaseRenderer* renderer)
+{
+  LocalStorage3D* localStorage = m_LocalStorageHandler.GetLocalStorage(renderer);
+  vtkOpenGLPolyDataMapper* mapper = localStorage->m_FiberMapper;
+
+  if (this->IsLODEnabled(renderer) && localStorage->m_LevelMappers.size()==m_Levels.size()
+      && renderer->GetRenderingManager()->GetNextLOD(renderer)==0)
+  {
+    // size of the projected bounding box of the bundle relative to the viewport
+    vtkRenderer* vtkRen = renderer->GetVtkRenderer();
+    double bounds[6];
+    m_FiberPolyData->GetBounds(bounds);
+    double displayMin[2] = { std::numeric_limits<double>::max(), std::numeric_limits<double>::max() };
+    double displayMax[2] = { std::numeric_limits<double>::lowest(), std::numeric_limits<double>::lowest() };
+    for (int corner=0; corner<8; ++corner)
+    {
+      vtkRen->SetWorldPoint(bounds[corner&1], bounds[2+((corner>>1)&1)], bounds[4+((corner>>2)&1)], 1.0);
+      vtkRen->WorldToDisplay();
+      double* displayPoint = vtkRen->GetDisplayPoint();
+      for (int d=0; d<2; ++d)
+      {
+        displayMin[d] = std::min(displayMin[d], displayPoint[d]);
+        displayMax[d] = std::max(displayMax[d], displayPoint[d]);
+      }
+    }
+    int* size = vtkRen->GetSize();
+    double viewportArea = std::max(1.0, static_cast<double>(size[0])*size[1]);
+    double bundleArea = (displayMax[0]-displayMin[0])*(displayMax[1]-displayMin[1]);
+
+    // a bundle that is zoomed into needs more fibers to look the same, a small one less
+    double requiredFibers = m_LODFibers * std::min(16.0, std::max(0.25, bundleArea/viewportArea));
+    for (unsigned int i=0; i<m_Levels.size(); ++i)
+    {
+      if (m_LevelNumFibers[i]>=requiredFibers)
+      {
+        mapper = localStorage->m_LevelMappers[i];
+        break;
+      }
+    }
+  }
+
+  if (localStorage->m_FiberActor->GetMapper()!=mapper)
+    localStorage->m_FiberActor->SetMapper(mapper);
+}
+
+bool mitk::FiberBundleMapper3D::IsLODEnabled(mitk::BaseRenderer* ) const
+{
+  return m_UseLOD && !m_Levels.empty();
+}
 
 void mitk::FiberBundleMapper3D::GenerateDataForRenderer( mitk::BaseRenderer *renderer )
 {
@@ -182,6 +405,22 @@ void mitk::FiberBundleMapper3D::GenerateDataForRenderer( mitk::BaseRenderer *ren
     m_FiberBundle->RequestUpdate3D();
   }
 
+  bool useLOD = true;
+  node->GetBoolProperty("shape.lod", useLOD);
+  if (m_UseLOD!=useLOD)
+  {
+    m_UseLOD = useLOD;
+    m_FiberBundle->RequestUpdate3D();
+  }
+
+  int lodFibers = 20000;
+  node->GetIntProperty("shape.lod.fibers", lodFibers);
+  if (m_LODFibers!=lodFibers)
+  {
+    m_LODFibers = lodFibers;
+    m_FiberBundle->RequestUpdate3D();
+  }
+
   float opacity;
   this->GetDataNode()->GetOpacity(opacity, nullptr);
   vtkProperty *property = localStorage->m_FiberActor->GetProperty();
@@ -202,13 +441,15 @@ void mitk::FiberBundleMapper3D::GenerateDataForRenderer( mitk::BaseRenderer *ren
   property->SetLighting(true);
   property->SetOpacity(opacity);
 
-  if (localStorage->m_LastUpdateTime>=m_FiberBundle->GetUpdateTime3D())
-    return;
+  if (localStorage->m_LastUpdateTime.GetMTime() < m_FiberBundle->GetUpdateTime3D().GetMTime())
+  {
+    // Calculate time step of the input data for the specified renderer (integer value)
+    // this method is implemented in mitkMapper
+    this->CalculateTimeStep( renderer );
+    this->InternalGenerateData(renderer);
+  }
 
-  // Calculate time step of the input data for the specified renderer (integer value)
-  // this method is implemented in mitkMapper
-  this->CalculateTimeStep( renderer );
-  this->InternalGenerateData(renderer);
+  this->SelectLevelOfDetail(renderer);
 }
 
 void mitk::FiberBundleMapper3D::UpdateShaderParameter(mitk::BaseRenderer * )
@@ -234,6 +475,9 @@ void mitk::FiberBundleMapper3D::SetDefaultProperties(mitk::DataNode* node, mitk:
   node->AddProperty( "shape.tuberadius",mitk::FloatProperty::New( 0.0 ), renderer, overwrite);
   node->AddProperty( "shape.tubesides",mitk::IntProperty::New( 15 ), renderer, overwrite);
   node->AddProperty( "shape.ribbonwidth", mitk::FloatProperty::New( 0.0 ), renderer, overwrite);
+  node->AddProperty( "shape.lod", mitk::BoolProperty::New( true ), renderer, overwrite);
+  node->AddProperty( "shape.lod.fibers", mitk::IntProperty::New( 20000 ), renderer, overwrite);
+  node->AddProperty( "asynchronous update", mitk::BoolProperty::New( false ), renderer, overwrite);
 
   node->AddProperty( "light.ambient", mitk::FloatProperty::New( 0.05 ), renderer, overwrite);
   node->AddProperty( "light.diffuse", mitk::FloatProperty::New( 0.9 ), renderer, overwrite);
@@ -22,6 +22,8 @@ See LICENSE.txt or http://www.mitk.org for details.
 #include <mitkFiberBundle.h>
 #include <vtkOpenGLPolyDataMapper.h>
 #include <vtkSmartPointer.h>
+#include <memory>
+#include <vector>
 class vtkPropAssembly;
 class vtkPolyDataMapper;
 class vtkLookupTable;
@@ -31,6 +33,15 @@ namespace mitk {
 
 //##Documentation
 //## @brief Mapper for FiberBundle
+//##
+//## Large bundles are rendered with levels of detail (property "shape.lod", enabled by default). Each coarse
+//## level contains a subset of the fibers with fewer points per fiber and is built once per update of the bundle.
+//## While the user interacts, the level is chosen by the screen size of the bundle so that roughly
+//## "shape.lod.fibers" fibers are visible. The full bundle is rendered once the RenderingManager requests the
+//## high resolution rendering, i.e. when the camera settles.
+//##
+//## If the property "asynchronous update" is set, the shaped fibers and the levels of detail are generated on a
+//## worker thread and the previous fibers are rendered until they are ready.
 //## @ingroup Mapper
 
 class FiberBundleMapper3D : public VtkMapper
@@ -45,6 +56,7 @@ public:
   vtkProp *GetVtkProp(mitk::BaseRenderer *renderer) override; //looks like depricated.. should be replaced bz GetViewProp()
   static void SetDefaultProperties(DataNode* node, BaseRenderer* renderer = nullptr, bool overwrite = false );
   void GenerateDataForRenderer(mitk::BaseRenderer* renderer) override;
+  bool IsLODEnabled(mitk::BaseRenderer* renderer) const override;
 
   class  LocalStorage3D : public mitk::Mapper::BaseLocalStorage
   {
@@ -52,6 +64,8 @@ public:
     vtkSmartPointer<vtkActor> m_FiberActor;
     vtkSmartPointer<vtkOpenGLPolyDataMapper> m_FiberMapper;
     vtkSmartPointer<vtkPropAssembly> m_FiberAssembly;
+    /** \brief One mapper per coarse level, so switching the level does not upload the data again. */
+    std::vector< vtkSmartPointer<vtkOpenGLPolyDataMapper> > m_LevelMappers;
 
     itk::TimeStamp m_LastUpdateTime;
     LocalStorage3D();
@@ -73,14 +87,65 @@ protected:
 
   void UpdateShaderParameter(mitk::BaseRenderer*);
 
+  /** \brief Parameters of the shaped fibers and of the levels of detail. */
+  struct ShapeParameters
+  {
+    float TubeRadius;
+    int   TubeSides;
+    float RibbonWidth;
+    bool  UseLOD;
+    int   LODFibers;
+  };
+
+  /** \brief Shaped full resolution fibers and levels of detail, which are generated together. */
+  struct Representation
+  {
+    vtkSmartPointer<vtkPolyData> ShapedPolyData;
+    std::vector< vtkSmartPointer<vtkPolyData> > Levels;
+    std::vector< unsigned int > LevelNumFibers;
+  };
+
+  /** \brief Generates the representation of the fibers. Does not access the mapper, so it may run on a worker thread. */
+  static void GenerateRepresentation(vtkPolyData* fibers, const ShapeParameters& parameters, Representation& representation);
+  /** \brief Applies the tube or ribbon filter (if requested) to the fibers. */
+  static vtkSmartPointer<vtkPolyData> GenerateShape(vtkPolyData* fibers, const ShapeParameters& parameters);
+  /** \brief Creates the coarse levels of detail. */
+  static void GenerateLevelsOfDetail(vtkPolyData* fibers, const ShapeParameters& parameters, Representation& representation);
+  /** \brief Copies every fiberStep-th fiber; of each copied fiber every pointStep-th point and the last point are kept. */
+  static vtkSmartPointer<vtkPolyData> SubsampleFibers(vtkPolyData* fibers, unsigned int fiberStep, unsigned int pointStep);
+  /** \brief Swaps the generated representation in; it belongs to the given update time of the bundle. */
+  void SetRepresentation(Representation& representation, itk::ModifiedTimeType updateTime);
+  /** \brief Polls or starts the generation on a worker thread. Returns true once a new representation was swapped in.
+   *
+   * Results which are older than the current representation are dropped. If the bundle was modified while the worker
+   * thread was running, the next generation is started as soon as the previous one is finished.
+   */
+  bool UpdateRepresentationAsynchronously(mitk::BaseRenderer* renderer);
+  /** \brief Selects the full bundle or a coarse level for the current view. */
+  void SelectLevelOfDetail(mitk::BaseRenderer* renderer);
+
 private:
   vtkSmartPointer<vtkLookupTable> m_lut;
   float   m_TubeRadius;
   int     m_TubeSides;
   int     m_LineWidth;
   float   m_RibbonWidth;
+  bool    m_UseLOD;
+  int     m_LODFibers;
   vtkSmartPointer<vtkPolyData> m_FiberPolyData;
   mitk::FiberBundle* m_FiberBundle;
+
+  /** \brief Coarse levels of detail, ordered from coarse to fine, and their number of fibers. */
+  std::vector< vtkSmartPointer<vtkPolyData> > m_Levels;
+  std::vector< unsigned int > m_LevelNumFibers;
+  /** \brief Shaped (tubes or ribbons) full resolution fibers. */
+  vtkSmartPointer<vtkPolyData> m_ShapedPolyData;
+  /** \brief Update time of the bundle the shaped fibers and the levels of detail were generated for. */
+  itk::ModifiedTimeType m_LevelsUpdateTime;
+
+  /** \brief Representation generated by the worker thread and the update time of the bundle it belongs to. */
+  std::shared_ptr<Representation> m_PendingRepresentation;
+  itk::ModifiedTimeType m_PendingUpdateTime;
 };
 
 } // end namespace mitk
@@ -0,0 +1,219 @@
+/*===================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center,
+Division of Medical and Biological Informatics.
+All rights reserved.
+
+This software is distributed WITHOUT ANY WARRANTY; without
+even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE.
+
+See LICENSE.txt or http://www.mitk.org for details.
+
+===================================================================*/
+
+#include "mitkFiberBundleSegmentTree.h"
+#include <vtkCellArray.h>
+#include <vtkPointData.h>
+#include <vtkPoints.h>
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace
+{
+  const unsigned int MaxPiecesPerLeaf = 8;
+}
+
+mitk::FiberBundleSegmentTree::FiberBundleSegmentTree()
+{
+}
+
+void mitk::FiberBundleSegmentTree::Clear()
+{
+  m_Fibers = nullptr;
+  m_PointIds.clear();
+  m_Pieces.clear();
+  m_PieceOrder.clear();
+  m_Nodes.clear();
+}
+
+bool mitk::FiberBundleSegmentTree::IsEmpty() const
+{
+  return m_Nodes.empty();
+}
+
+void mitk::FiberBundleSegmentTree::Build(vtkPolyData* fibers, unsigned int segmentsPerPiece)
+{
+  this->Clear();
+  if (fibers==nullptr || fibers->GetPoints()==nullptr || fibers->GetLines()==nullptr)
+    return;
+
+  m_Fibers = fibers;
+  vtkPoints* points = fibers->GetPoints();
+  vtkIdType segments = std::max(1u, segmentsPerPiece);
+
+  vtkCellArray* lines = fibers->GetLines();
+  m_PointIds.reserve(lines->GetNumberOfConnectivityEntries());
+  vtkIdType numPoints(0);
+  vtkIdType* pointIds(nullptr);
+  for (lines->InitTraversal(); lines->GetNextCell(numPoints, pointIds);)
+  {
+    if (numPoints<=0)
+      continue;
+
+    vtkIdType offset = m_PointIds.size();
+    m_PointIds.insert(m_PointIds.end(), pointIds, pointIds+numPoints);
+
+    // consecutive pieces share their end point, so the extracted fibers have no gaps
+    for (vtkIdType start=0; start==0 || start<numPoints-1; start+=segments)
+    {
+      Piece piece;
+      piece.FirstPointId = offset + start;
+      piece.NumPoints = std::min(segments, numPoints-1-start) + 1;
+      if (numPoints==1)
+        piece.NumPoints = 1;
+
+      for (int d=0; d<3; ++d)
+      {
+        piece.Bounds.Min[d] = std::numeric_limits<float>::max();
+        piece.Bounds.Max[d] = std::numeric_limits<float>::lowest();
+      }
+      for (vtkIdType k=0; k<piece.NumPoints; ++k)
+      {
+        double* p = points->GetPoint(m_PointIds[piece.FirstPointId+k]);
+        for (int d=0; d<3; ++d)
+        {
+          piece.Bounds.Min[d] = std::min(piece.Bounds.Min[d], static_cast<float>(p[d]));
+          piece.Bounds.Max[d] = std::max(piece.Bounds.Max[d], static_cast<float>(p[d]));
+        }
+      }
+      m_Pieces.push_back(piece);
+    }
+  }
+
+  if (m_Pieces.empty())
+    return;
+
+  m_PieceOrder.resize(m_Pieces.size());
+  for (unsigned int i=0; i<m_PieceOrder.size(); ++i)
+    m_PieceOrder[i] = i;
+
+  m_Nodes.reserve(2*m_Pieces.size()/MaxPiecesPerLeaf + 1);
+  m_Nodes.push_back(Node());
+  this->BuildNode(0, 0, m_Pieces.size());
+}
+
+void mitk::FiberBundleSegmentTree::BuildNode(int node, unsigned int first, unsigned int count)
+{
+  Box bounds;
+  for (int d=0; d<3; ++d)
+  {
+    bounds.Min[d] = std::numeric_limits<float>::max();
+    bounds.Max[d] = std::numeric_limits<float>::lowest();
+  }
+  for (unsigned int i=first; i<first+count; ++i)
+  {
+    const Box& box = m_Pieces[m_PieceOrder[i]].Bounds;
+    for (int d=0; d<3; ++d)
+    {
+      bounds.Min[d] = std::min(bounds.Min[d], box.Min[d]);
+      bounds.Max[d] = std::max(bounds.Max[d], box.Max[d]);
+    }
+  }
+
+  m_Nodes[node].Bounds = bounds;
+  m_Nodes[node].FirstChild = -1;
+  m_Nodes[node].FirstPiece = first;
+  m_Nodes[node].NumPieces = count;
+  if (count<=MaxPiecesPerLeaf)
+    return;
+
+  // split at the median of the piece centers along the longest axis
+  int axis = 0;
+  for (int d=1; d<3; ++d)
+  {
+    if (bounds.Max[d]-bounds.Min[d] > bounds.Max[axis]-bounds.Min[axis])
+      axis = d;
+  }
+  unsigned int half = count/2;
+  std::nth_element(m_PieceOrder.begin()+first, m_PieceOrder.begin()+first+half, m_PieceOrder.begin()+first+count,
+                   [this, axis](unsigned int a, unsigned int b)
+  {
+    return m_Pieces[a].Bounds.Min[axis]+m_Pieces[a].Bounds.Max[axis] < m_Pieces[b].Bounds.Min[axis]+m_Pieces[b].Bounds.Max[axis];
+  });
+
+  int firstChild = m_Nodes.size();
+  m_Nodes.push_back(Node());
+  m_Nodes.push_back(Node());
+  m_Nodes[node].FirstChild = firstChild;
+  this->BuildNode(firstChild, first, half);
+  this->BuildNode(firstChild+1, first+half, count-half);
+}
+
+bool mitk::FiberBundleSegmentTree::Intersects(const Box& box, const double normal[3], double distance, double thickness) const
+{
+  // interval covered by the projection of the box onto the normal
+  double center = 0;
+  double radius = 0;
+  for (int d=0; d<3; ++d)
+  {
+    center += normal[d] * 0.5 * (box.Min[d] + box.Max[d]);
+    radius += std::abs(normal[d]) * 0.5 * (box.Max[d] - box.Min[d]);
+  }
+  return center+radius >= distance-thickness && center-radius <= distance+thickness;
+}
+
+vtkSmartPointer<vtkPolyData> mitk::FiberBundleSegmentTree::ExtractSlab(const double normal[3], double distance, double thickness) const
+{
+  vtkSmartPointer<vtkPolyData> slab = vtkSmartPointer<vtkPolyData>::New();
+  vtkSmartPointer<vtkPoints> newPoints = vtkSmartPointer<vtkPoints>::New();
+  vtkSmartPointer<vtkCellArray> newLines = vtkSmartPointer<vtkCellArray>::New();
+  slab->SetPoints(newPoints);
+  slab->SetLines(newLines);
+  if (this->IsEmpty())
+    return slab;
+
+  vtkPoints* points = m_Fibers->GetPoints();
+  vtkPointData* pointData = m_Fibers->GetPointData();
+  vtkPointData* newPointData = slab->GetPointData();
+  newPointData->CopyAllocate(pointData);
+
+  std::vector<int> stack;
+  stack.push_back(0);
+  while (!stack.empty())
+  {
+    const Node& node = m_Nodes[stack.back()];
+    stack.pop_back();
+    if (!this->Intersects(node.Bounds, normal, distance, thickness))
+      continue;
+
+    if (node.FirstChild>=0)
+    {
+      stack.push_back(node.FirstChild);
+      stack.push_back(node.FirstChild+1);
+      continue;
+    }
+
+    for (unsigned int i=node.FirstPiece; i<node.FirstPiece+node.NumPieces; ++i)
+    {
+      const Piece& piece = m_Pieces[m_PieceOrder[i]];
+      if (!this->Intersects(piece.Bounds, normal, distance, thickness))
+        continue;
+
+      newLines->InsertNextCell(piece.NumPoints);
+      for (vtkIdType k=0; k<piece.NumPoints; ++k)
+      {
+        vtkIdType id = m_PointIds[piece.FirstPointId+k];
+        vtkIdType newId = newPoints->InsertNextPoint(points->GetPoint(id));
+        newPointData->CopyData(pointData, id, newId);
+        newLines->InsertCellPoint(newId);
+      }
+    }
+  }
+
+  newPointData->Squeeze();
+  return slab;
+}
@@ -0,0 +1,86 @@
+/*===================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center,
+Division of Medical and Biological Informatics.
+All rights reserved.
+
+This software is distributed WITHOUT ANY WARRANTY; without
+even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE.
+
+See LICENSE.txt or http://www.mitk.org for details.
+
+===================================================================*/
+
+#ifndef FiberBundleSegmentTree_H_HEADER_INCLUDED
+#define FiberBundleSegmentTree_H_HEADER_INCLUDED
+
+#include <vtkSmartPointer.h>
+#include <vtkPolyData.h>
+#include <vector>
+
+namespace mitk {
+
+/**
+* \brief Bounding volume hierarchy over the fibers of a bundle, used to extract the fibers close to a plane.
+*
+* The fibers are cut into pieces of a few segments. Each piece has an axis aligned bounding box and the pieces
+* are sorted into a binary tree of bounding boxes. ExtractSlab() returns the pieces that intersect the slab
+* |normal*x - distance| <= thickness, independent of the orientation of the plane. The point data arrays of
+* the fibers (e.g. the colors) are copied to the extracted pieces.
+*/
+class FiberBundleSegmentTree
+{
+public:
+
+  FiberBundleSegmentTree();
+
+  /** \brief Builds the tree. The fibers are referenced, not copied. */
+  void Build(vtkPolyData* fibers, unsigned int segmentsPerPiece = 16);
+  void Clear();
+  bool IsEmpty() const;
+
+  /** \brief Copies all pieces that intersect the slab |normal*x - distance| <= thickness into a new polydata. */
+  vtkSmartPointer<vtkPolyData> ExtractSlab(const double normal[3], double distance, double thickness) const;
+
+private:
+
+  struct Box
+  {
+    float Min[3];
+    float Max[3];
+  };
+
+  struct Node
+  {
+    Box Bounds;
+    /** inner nodes: index of the first child (the second child follows), leaves: -1 */
+    int FirstChild;
+    /** leaves: range of pieces in m_PieceOrder */
+    unsigned int FirstPiece;
+    unsigned int NumPieces;
+  };
+
+  struct Piece
+  {
+    Box Bounds;
+    /** range in m_PointIds */
+    vtkIdType FirstPointId;
+    vtkIdType NumPoints;
+  };
+
+  void BuildNode(int node, unsigned int first, unsigned int count);
+  bool Intersects(const Box& box, const double normal[3], double distance, double thickness) const;
+
+  vtkSmartPointer<vtkPolyData> m_Fibers;
+  std::vector< vtkIdType > m_PointIds;
+  std::vector< Piece > m_Pieces;
+  std::vector< unsigned int > m_PieceOrder;
+  std::vector< Node > m_Nodes;
+};
+
+}
+
+#endif
@@ -11,6 +11,7 @@ SET(MODULE_CUSTOM_TESTS
   mitkFiberProcessingTest.cpp
   mitkFiberFitTest.cpp
   mitkFiberMapper3DTest.cpp
+  mitkFiberMapperBenchmarkTest.cpp
   mitkPeakShImageReaderTest.cpp
 )
 
@@ -39,6 +39,7 @@ class mitkFiberMapper3DTestSuite : public mitk::TestFixture
   MITK_TEST(Ribbon3D);
   MITK_TEST(Tubes3D);
   MITK_TEST(Default2D);
+  MITK_TEST(AsynchronousColor3D);
   CPPUNIT_TEST_SUITE_END();
 
   typedef itk::Image<float, 3> ItkFloatImgType;
@@ -160,6 +161,33 @@ public:
     mitk::Image::Pointer ref_image = mitk::IOUtil::Load<mitk::Image>(GetTestDataFilePath("DiffusionImaging/Rendering/fib_color_3D.png"));
     MITK_ASSERT_EQUAL(test_image, ref_image, "Check if images are equal.");
   }
+
+  void AsynchronousColor3D()
+  {
+    node->SetBoolProperty("asynchronous update", true);
+
+    mitk::RenderingTestHelper renderingHelper(640, 480);
+    renderingHelper.AddNodeToStorage(node);
+    renderingHelper.SetMapperIDToRender3D();
+
+    // starts the generation of the fibers on the worker thread
+    renderingHelper.Render();
+
+    // modified while the worker thread is running, its result is outdated
+    mitk::FiberBundle::Pointer fib = dynamic_cast<mitk::FiberBundle*>(node->GetData());
+    fib->SetFiberColors(255, 255, 255);
+
+    // swaps the outdated fibers in and starts the generation of the modified ones right away
+    std::this_thread::sleep_for(std::chrono::seconds(1));
+    renderingHelper.Render();
+
+    // the next rendering has to show the modified fibers
+    std::this_thread::sleep_for(std::chrono::seconds(1));
+    renderingHelper.SaveReferenceScreenShot(mitk::IOUtil::GetTempPath()+"fib_async_color_3D.png");
+    mitk::Image::Pointer test_image = mitk::IOUtil::Load<mitk::Image>(mitk::IOUtil::GetTempPath()+"fib_async_color_3D.png");
+    mitk::Image::Pointer ref_image = mitk::IOUtil::Load<mitk::Image>(GetTestDataFilePath("DiffusionImaging/Rendering/fib_color_3D.png"));
+    MITK_ASSERT_EQUAL(test_image, ref_image, "Check if images are equal.");
+  }
 };
 
 MITK_TEST_SUITE_REGISTRATION(mitkFiberMapper3D)
@@ -0,0 +1,121 @@
+/*===================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center,
+Division of Medical and Biological Informatics.
+All rights reserved.
+
+This software is distributed WITHOUT ANY WARRANTY; without
+even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE.
+
+See LICENSE.txt or http://www.mitk.org for details.
+
+===================================================================*/
+
+#include <mitkFiberBundle.h>
+#include <mitkIOUtil.h>
+#include <mitkRenderingBenchmark.h>
+#include <mitkRenderingTestHelper.h>
+#include <mitkTestFixture.h>
+#include <mitkTestingMacros.h>
+
+#include <vtkCellArray.h>
+#include <vtkPoints.h>
+#include <vtkPolyData.h>
+#include <vtkSmartPointer.h>
+
+#include <cmath>
+
+/**
+ * @brief Rendering benchmarks of the fiber bundle mappers, see mitk::RenderingBenchmark.
+ */
+class mitkFiberMapperBenchmarkTestSuite : public mitk::TestFixture
+{
+  CPPUNIT_TEST_SUITE(mitkFiberMapperBenchmarkTestSuite);
+  MITK_TEST(FiberBundleMapper2D_TestFibers);
+  MITK_TEST(FiberBundleMapper3D_TestFibers);
+  MITK_TEST(FiberBundleMapper2D_SyntheticFibers);
+  MITK_TEST(FiberBundleMapper3D_SyntheticFibers);
+  CPPUNIT_TEST_SUITE_END();
+
+private:
+  mitk::FiberBundle::Pointer m_TestFibers;
+  mitk::FiberBundle::Pointer m_SyntheticFibers;
+
+  void Run(const std::string &name, mitk::FiberBundle *fibers, bool render3D)
+  {
+    mitk::DataNode::Pointer node = mitk::DataNode::New();
+    node->SetData(fibers);
+
+    mitk::RenderingTestHelper renderingHelper(640, 480);
+    mitk::RenderingBenchmark benchmark(renderingHelper);
+    if (render3D)
+      renderingHelper.SetMapperIDToRender3D();
+    else
+      renderingHelper.SetMapperIDToRender2D();
+
+    // the fiber mappers regenerate on update requests of the bundle, not on its MTime
+    benchmark.SetInvalidateFunction([fibers, render3D](mitk::DataNode *, mitk::BaseRenderer *) {
+      if (render3D)
+        fibers->RequestUpdate3D();
+      else
+        fibers->RequestUpdate2D();
+    });
+    benchmark.SetGenerateTimeFunction(&mitk::RenderingBenchmark::GetRedrawTime);
+
+    mitk::RenderingBenchmark::Result result = benchmark.Run(name, node);
+    mitk::RenderingBenchmark::Print(result);
+    CPPUNIT_ASSERT(result.NumberOfFrames > 0);
+    // every measured update has to generate the fibers again
+    CPPUNIT_ASSERT(result.NumberOfUpdates > 0);
+    CPPUNIT_ASSERT_EQUAL(result.NumberOfUpdates, result.NumberOfRegenerations);
+  }
+
+public:
+  void setUp() override
+  {
+    m_TestFibers = mitk::IOUtil::Load<mitk::FiberBundle>(GetTestDataFilePath("DiffusionImaging/Rendering/test_fibers.fib"));
+
+    // 20000 helical fibers with 100 points each
+    vtkSmartPointer<vtkPoints> points = vtkSmartPointer<vtkPoints>::New();
+    vtkSmartPointer<vtkCellArray> lines = vtkSmartPointer<vtkCellArray>::New();
+    for (int fiber = 0; fiber < 20000; ++fiber)
+    {
+      const double x = fiber % 200;
+      const double y = fiber / 200;
+      lines->InsertNextCell(100);
+      for (int i = 0; i < 100; ++i)
+      {
+        lines->InsertCellPoint(points->InsertNextPoint(x + std::cos(0.1 * i), y + std::sin(0.1 * i), i));
+      }
+    }
+    vtkSmartPointer<vtkPolyData> polyData = vtkSmartPointer<vtkPolyData>::New();
+    polyData->SetPoints(points);
+    polyData->SetLines(lines);
+    m_SyntheticFibers = mitk::FiberBundle::New(polyData);
+  }
+
+  void tearDown() override
+  {
+    m_TestFibers = nullptr;
+    m_SyntheticFibers = nullptr;
+  }
+
+  void FiberBundleMapper2D_TestFibers() { this->Run("FiberBundleMapper2D test fibers", m_TestFibers, false); }
+
+  void FiberBundleMapper3D_TestFibers() { this->Run("FiberBundleMapper3D test fibers", m_TestFibers, true); }
+
+  void FiberBundleMapper2D_SyntheticFibers()
+  {
+    this->Run("FiberBundleMapper2D 20000 fibers", m_SyntheticFibers, false);
+  }
+
+  void FiberBundleMapper3D_SyntheticFibers()
+  {
+    this->Run("FiberBundleMapper3D 20000 fibers", m_SyntheticFibers, true);
+  }
+};
+
+MITK_TEST_SUITE_REGISTRATION(mitkFiberMapperBenchmark)
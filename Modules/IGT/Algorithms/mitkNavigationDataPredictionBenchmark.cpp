@@ -0,0 +1,205 @@
+/*===================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center,
+Division of Medical and Biological Informatics.
+All rights reserved.
+
+This software is distributed WITHOUT ANY WARRANTY; without
+even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE.
+
+See LICENSE.txt or http://www.mitk.org for details.
+
+===================================================================*/
+
+#include "mitkNavigationDataPredictionBenchmark.h"
+#include <mitkExceptionMacro.h>
+
+#include <vnl/vnl_math.h>
+
+#include <algorithm>
+#include <cmath>
+#include <iomanip>
+
+mitk::NavigationDataPredictionBenchmark::NavigationDataPredictionBenchmark()
+  : m_PredictionFilter(mitk::NavigationDataPredictionFilter::New())
+{
+}
+
+mitk::NavigationDataPredictionBenchmark::~NavigationDataPredictionBenchmark()
+{
+}
+
+std::vector<mitk::NavigationDataPredictionBenchmark::Result> mitk::NavigationDataPredictionBenchmark::Evaluate(
+  const mitk::NavigationDataSet* recording, unsigned int toolIndex, const std::vector<double>& latencies)
+{
+  if (recording == nullptr || recording->Size() == 0)
+  {
+    mitkThrow() << "Cannot evaluate the prediction without recorded navigation data.";
+  }
+  if (toolIndex >= recording->GetNumberOfTools())
+  {
+    mitkThrow() << "Tool index " << toolIndex << " is invalid, the recording contains " << recording->GetNumberOfTools() << " tools.";
+  }
+  if (m_PredictionFilter.IsNull())
+  {
+    m_PredictionFilter = mitk::NavigationDataPredictionFilter::New();
+  }
+
+  std::vector<mitk::NavigationData::Pointer> stream;
+  stream.reserve(recording->Size());
+  for (unsigned int i = 0; i < recording->Size(); ++i)
+  {
+    mitk::NavigationData::Pointer nd = recording->GetNavigationDataForIndex(i, toolIndex);
+    if (nd.IsNotNull() && nd->IsDataValid())
+    {
+      stream.push_back(nd);
+    }
+  }
+
+  mitk::NavigationData::Pointer replayedData = mitk::NavigationData::New();
+  m_PredictionFilter->SetInput(0, replayedData);
+  m_PredictionFilter->SetUseIGTTimeStamp(false);
+
+  std::vector<Result> results;
+  results.reserve(latencies.size());
+  for (double latency : latencies)
+  {
+    Result result;
+    result.Latency = latency;
+    result.NumberOfSamples = 0;
+    result.MeanPositionError = 0.0;
+    result.RMSPositionError = 0.0;
+    result.MaxPositionError = 0.0;
+    result.MeanOrientationError = 0.0;
+    result.MaxOrientationError = 0.0;
+    result.MeanUncompensatedPositionError = 0.0;
+    result.MeanUncompensatedOrientationError = 0.0;
+
+    m_PredictionFilter->ResetState();
+    m_PredictionFilter->SetPredictionHorizon(latency);
+
+    for (const auto& sample : stream)
+    {
+      replayedData->Graft(sample);
+      m_PredictionFilter->Modified();
+      m_PredictionFilter->Update();
+
+      mitk::Point3D truePosition;
+      mitk::Quaternion trueOrientation;
+      if (!InterpolatePose(stream, sample->GetIGTTimeStamp() + latency, truePosition, trueOrientation))
+      {
+        continue;
+      }
+
+      const mitk::NavigationData* predicted = m_PredictionFilter->GetOutput(0);
+      const double positionError = predicted->GetPosition().EuclideanDistanceTo(truePosition);
+      const double orientationError = GetOrientationDifference(predicted->GetOrientation(), trueOrientation);
+
+      ++result.NumberOfSamples;
+      result.MeanPositionError += positionError;
+      result.RMSPositionError += positionError * positionError;
+      result.MaxPositionError = std::max(result.MaxPositionError, positionError);
+      result.MeanOrientationError += orientationError;
+      result.MaxOrientationError = std::max(result.MaxOrientationError, orientationError);
+      result.MeanUncompensatedPositionError += sample->GetPosition().EuclideanDistanceTo(truePosition);
+      result.MeanUncompensatedOrientationError += GetOrientationDifference(sample->GetOrientation(), trueOrientation);
+    }
+
+    if (result.NumberOfSamples > 0)
+    {
+      const double n = result.NumberOfSamples;
+      result.MeanPositionError /= n;
+      result.RMSPositionError = std::sqrt(result.RMSPositionError / n);
+      result.MeanOrientationError /= n;
+      result.MeanUncompensatedPositionError /= n;
+      result.MeanUncompensatedOrientationError /= n;
+    }
+    results.push_back(result);
+  }
+
+  return results;
+}
+
+void mitk::NavigationDataPredictionBenchmark::PrintResults(const std::vector<Result>& results, std::ostream& stream)
+{
+  stream << "latency [ms]; samples; mean position error [mm]; RMS position error [mm]; max position error [mm]; "
+    << "mean orientation error [deg]; max orientation error [deg]; "
+    << "mean uncompensated position error [mm]; mean uncompensated orientation error [deg]" << std::endl;
+
+  const double toDegree = 180.0 / vnl_math::pi;
+  for (const auto& result : results)
+  {
+    stream << std::fixed << std::setprecision(3)
+      << result.Latency << "; "
+      << result.NumberOfSamples << "; "
+      << result.MeanPositionError << "; "
+      << result.RMSPositionError << "; "
+      << result.MaxPositionError << "; "
+      << result.MeanOrientationError * toDegree << "; "
+      << result.MaxOrientationError * toDegree << "; "
+      << result.MeanUncompensatedPositionError << "; "
+      << result.MeanUncompensatedOrientationError * toDegree << std::endl;
+  }
+}
+
+bool mitk::NavigationDataPredictionBenchmark::InterpolatePose(const std::vector<mitk::NavigationData::Pointer>& stream, double time,
+  mitk::Point3D& position, mitk::Quaternion& orientation)
+{
+  if (stream.empty() || time < stream.front()->GetIGTTimeStamp() || time > stream.back()->GetIGTTimeStamp())
+  {
+    return false;
+  }
+
+  // first sample which is not earlier than the requested time
+  auto next = std::lower_bound(stream.begin(), stream.end(), time,
+    [](const mitk::NavigationData::Pointer& nd, double t) { return nd->GetIGTTimeStamp() < t; });
+  if (next == stream.begin())
+  {
+    position = (*next)->GetPosition();
+    orientation = (*next)->GetOrientation();
+    return true;
+  }
+  auto previous = next - 1;
+
+  const double t0 = (*previous)->GetIGTTimeStamp();
+  const double t1 = (*next)->GetIGTTimeStamp();
+  const double weight = (t1 > t0) ? (time - t0) / (t1 - t0) : 0.0;
+
+  const mitk::Point3D p0 = (*previous)->GetPosition();
+  const mitk::Point3D p1 = (*next)->GetPosition();
+  for (unsigned int i = 0; i < 3; ++i)
+  {
+    position[i] = p0[i] + weight * (p1[i] - p0[i]);
+  }
+
+  // normalized linear interpolation, sufficient for the small rotations between two samples
+  mitk::Quaternion q0 = (*previous)->GetOrientation();
+  mitk::Quaternion q1 = (*next)->GetOrientation();
+  if (dot_product(q0, q1) < 0)
+  {
+    q1 *= -1;
+  }
+  for (unsigned int i = 0; i < 4; ++i)
+  {
+    orientation[i] = q0[i] + weight * (q1[i] - q0[i]);
+  }
+  if (orientation.magnitude() > 0)
+  {
+    orientation.normalize();
+  }
+  return true;
+}
+
+double mitk::NavigationDataPredictionBenchmark::GetOrientationDifference(const mitk::Quaternion& a, const mitk::Quaternion& b)
+{
+  const double magnitudes = a.magnitude() * b.magnitude();
+  if (magnitudes <= 0)
+  {
+    return 0.0;
+  }
+  const double cosHalfAngle = std::min(std::fabs(dot_product(a, b)) / magnitudes, 1.0);
+  return 2.0 * std::acos(cosHalfAngle);
+}
@@ -0,0 +1,94 @@
+/*===================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center,
+Division of Medical and Biological Informatics.
+All rights reserved.
+
+This software is distributed WITHOUT ANY WARRANTY; without
+even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE.
+
+See LICENSE.txt or http://www.mitk.org for details.
+
+===================================================================*/
+
+
+#ifndef MITKNavigationDataPredictionBenchmark_H_HEADER_INCLUDED_
+#define MITKNavigationDataPredictionBenchmark_H_HEADER_INCLUDED_
+
+#include "MitkIGTExports.h"
+#include "mitkNavigationDataPredictionFilter.h"
+#include <mitkNavigationDataSet.h>
+
+#include <itkObject.h>
+
+#include <ostream>
+#include <vector>
+
+namespace mitk {
+
+  /**Documentation
+  * \brief Replays recorded navigation data through a mitk::NavigationDataPredictionFilter and reports the
+  *        prediction error for a list of latencies.
+  *
+  * For every latency L the recorded stream of one tool is replayed sample by sample with a prediction horizon of L.
+  * The output for a sample recorded at time t is compared with the recorded pose at time t+L, which is linearly
+  * interpolated between the neighbouring samples. Samples for which t+L lies behind the end of the recording are
+  * skipped. As reference, the error of the uncompensated data (the pose at t displayed at t+L) is reported, too.
+  *
+  * The filter passed to SetPredictionFilter() defines the noise parameters. Its state and horizon are changed
+  * during Evaluate(); UseIGTTimeStamp is disabled because the recording carries its own time stamps.
+  *
+  * \ingroup IGT
+  */
+  class MITKIGT_EXPORT NavigationDataPredictionBenchmark : public itk::Object
+  {
+  public:
+    mitkClassMacroItkParent(NavigationDataPredictionBenchmark, itk::Object);
+    itkFactorylessNewMacro(Self);
+
+    /** @brief Errors for one latency. Positions in mm, orientations in rad. */
+    struct Result
+    {
+      double Latency;
+      unsigned int NumberOfSamples;
+      double MeanPositionError;
+      double RMSPositionError;
+      double MaxPositionError;
+      double MeanOrientationError;
+      double MaxOrientationError;
+      double MeanUncompensatedPositionError;
+      double MeanUncompensatedOrientationError;
+    };
+
+    itkSetObjectMacro(PredictionFilter, NavigationDataPredictionFilter);
+    itkGetObjectMacro(PredictionFilter, NavigationDataPredictionFilter);
+
+    /**
+    * \brief Replays the data of the given tool for every latency (in ms).
+    * \return One result per latency, in the order of the given latencies.
+    * \throws mitk::Exception if the set is empty or the tool index is invalid
+    */
+    std::vector<Result> Evaluate(const mitk::NavigationDataSet* recording, unsigned int toolIndex, const std::vector<double>& latencies);
+
+    /** @brief Writes the results as a table, one line per latency. */
+    static void PrintResults(const std::vector<Result>& results, std::ostream& stream);
+
+  protected:
+    NavigationDataPredictionBenchmark();
+    ~NavigationDataPredictionBenchmark() override;
+
+    /** @brief Interpolates the recorded pose at the given time. Returns false if the time is outside of the recording. */
+    static bool InterpolatePose(const std::vector<mitk::NavigationData::Pointer>& stream, double time,
+      mitk::Point3D& position, mitk::Quaternion& orientation);
+
+    /** @return Returns the angle of the rotation between both orientations in rad. */
+    static double GetOrientationDifference(const mitk::Quaternion& a, const mitk::Quaternion& b);
+
+    NavigationDataPredictionFilter::Pointer m_PredictionFilter;
+  };
+} // namespace mitk
+
+#endif /* MITKNavigationDataPredictionBenchmark_H_HEADER_INCLUDED_ */
@@ -0,0 +1,232 @@
+/*===================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center,
+Division of Medical and Biological Informatics.
+All rights reserved.
+
+This software is distributed WITHOUT ANY WARRANTY; without
+even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE.
+
+See LICENSE.txt or http://www.mitk.org for details.
+
+===================================================================*/
+
+#include "mitkNavigationDataPredictionFilter.h"
+#include "mitkIGTTimeStamp.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace
+{
+  // variance of the velocity of a newly detected tool in (mm/ms)^2, i.e. +-1 m/s
+  const double s_InitialVelocityVariance = 1.0;
+}
+
+mitk::NavigationDataPredictionFilter::NavigationDataPredictionFilter()
+  : mitk::NavigationDataToNavigationDataFilter(),
+    m_PredictionHorizon(0.0),
+    m_MaximumPredictionTime(200.0),
+    m_UseIGTTimeStamp(false),
+    m_MeasurementNoise(0.25),
+    m_ProcessNoise(1e-4),
+    m_AngularVelocitySmoothing(0.5)
+{
+}
+
+mitk::NavigationDataPredictionFilter::~NavigationDataPredictionFilter()
+{
+}
+
+void mitk::NavigationDataPredictionFilter::ResetState()
+{
+  for (auto& state : m_States)
+  {
+    state.Initialized = false;
+  }
+  this->Modified();
+}
+
+mitk::Vector3D mitk::NavigationDataPredictionFilter::GetVelocity(unsigned int input) const
+{
+  mitk::Vector3D velocity;
+  velocity.Fill(0);
+  if (input < m_States.size() && m_States[input].Initialized)
+  {
+    velocity = m_States[input].Velocity;
+  }
+  return velocity;
+}
+
+mitk::Vector3D mitk::NavigationDataPredictionFilter::GetAngularVelocity(unsigned int input) const
+{
+  mitk::Vector3D angularVelocity;
+  angularVelocity.Fill(0);
+  if (input < m_States.size() && m_States[input].Initialized)
+  {
+    angularVelocity = m_States[input].AngularVelocity;
+  }
+  return angularVelocity;
+}
+
+void mitk::NavigationDataPredictionFilter::GenerateData()
+{
+  DataObjectPointerArraySizeType numberOfInputs = this->GetNumberOfInputs();
+
+  if ( numberOfInputs == 0 ) return;
+
+  this->CreateOutputsForAllInputs();
+
+  if ( m_States.size() != numberOfInputs )
+  {
+    ToolState emptyState;
+    emptyState.Initialized = false;
+    m_States.resize(numberOfInputs, emptyState);
+  }
+
+  double currentTime = -1.0;
+  if (m_UseIGTTimeStamp)
+  {
+    // negative if the time stamp was not started, the input time stamps are used then
+    currentTime = mitk::IGTTimeStamp::GetInstance()->GetElapsed();
+  }
+
+  for (unsigned int i = 0; i < numberOfInputs; ++i)
+  {
+    const mitk::NavigationData* nd = this->GetInput(i);
+    assert(nd);
+
+    mitk::NavigationData* output = this->GetOutput(i);
+    assert(output);
+
+    output->Graft(nd); // copy all information from input to output
+
+    ToolState& state = m_States[i];
+    if (!nd->IsDataValid() || !nd->GetHasPosition())
+    {
+      state.Initialized = false;
+      continue;
+    }
+
+    if (!state.Initialized || nd->GetIGTTimeStamp() < state.TimeStamp)
+    {
+      this->InitializeState(state, nd);
+    }
+    else if (nd->GetIGTTimeStamp() > state.TimeStamp)
+    {
+      this->UpdateState(state, nd);
+    }
+    // an equal time stamp is the same sample again, the state is only extrapolated further then
+
+    double targetTime = (currentTime >= 0.0) ? currentTime : nd->GetIGTTimeStamp();
+    targetTime += m_PredictionHorizon;
+    double dt = std::min(std::max(targetTime - state.TimeStamp, 0.0), m_MaximumPredictionTime);
+
+    mitk::Point3D position;
+    mitk::Quaternion orientation;
+    this->PredictPose(state, dt, position, orientation);
+
+    output->SetPosition(position);
+    if (state.HasOrientation)
+    {
+      output->SetOrientation(orientation);
+    }
+  }
+}
+
+void mitk::NavigationDataPredictionFilter::InitializeState(ToolState& state, const mitk::NavigationData* nd)
+{
+  state.Initialized = true;
+  state.TimeStamp = nd->GetIGTTimeStamp();
+  state.Position = nd->GetPosition();
+  state.Velocity.Fill(0);
+  state.PositionVariance = m_MeasurementNoise;
+  state.PositionVelocityCovariance = 0.0;
+  state.VelocityVariance = s_InitialVelocityVariance;
+  state.HasOrientation = nd->GetHasOrientation();
+  state.Orientation = nd->GetOrientation();
+  state.AngularVelocity.Fill(0);
+}
+
+void mitk::NavigationDataPredictionFilter::UpdateState(ToolState& state, const mitk::NavigationData* nd)
+{
+  const double dt = nd->GetIGTTimeStamp() - state.TimeStamp;
+
+  // prediction step of the constant velocity model with white noise acceleration
+  const double p00 = state.PositionVariance + 2.0 * dt * state.PositionVelocityCovariance + dt * dt * state.VelocityVariance
+    + m_ProcessNoise * dt * dt * dt / 3.0;
+  const double p01 = state.PositionVelocityCovariance + dt * state.VelocityVariance + m_ProcessNoise * dt * dt / 2.0;
+  const double p11 = state.VelocityVariance + m_ProcessNoise * dt;
+
+  // correction step, the covariance is the same for all axes
+  const double innovationVariance = p00 + m_MeasurementNoise;
+  const double positionGain = p00 / innovationVariance;
+  const double velocityGain = p01 / innovationVariance;
+
+  const mitk::Point3D measurement = nd->GetPosition();
+  for (unsigned int axis = 0; axis < 3; ++axis)
+  {
+    const double predicted = state.Position[axis] + dt * state.Velocity[axis];
+    const double residual = measurement[axis] - predicted;
+    state.Position[axis] = predicted + positionGain * residual;
+    state.Velocity[axis] += velocityGain * residual;
+  }
+  state.PositionVariance = (1.0 - positionGain) * p00;
+  state.PositionVelocityCovariance = (1.0 - positionGain) * p01;
+  state.VelocityVariance = p11 - velocityGain * p01;
+  state.TimeStamp = nd->GetIGTTimeStamp();
+
+  // orientation: angular velocity from the relative rotation since the last sample
+  if (!nd->GetHasOrientation())
+  {
+    state.HasOrientation = false;
+    return;
+  }
+  const mitk::Quaternion orientation = nd->GetOrientation();
+  if (state.HasOrientation)
+  {
+    mitk::Quaternion delta = orientation * state.Orientation.inverse();
+    if (delta.real() < 0)
+    {
+      delta *= -1; // shortest rotation
+    }
+    const vnl_vector_fixed<mitk::ScalarType, 3> imaginary = delta.imaginary();
+    const double sinHalfAngle = imaginary.magnitude();
+    mitk::Vector3D measuredAngularVelocity;
+    measuredAngularVelocity.Fill(0);
+    if (sinHalfAngle > 0)
+    {
+      const double angle = 2.0 * std::atan2(sinHalfAngle, delta.real());
+      for (unsigned int axis = 0; axis < 3; ++axis)
+      {
+        measuredAngularVelocity[axis] = imaginary[axis] / sinHalfAngle * angle / dt;
+      }
+    }
+    state.AngularVelocity = measuredAngularVelocity * m_AngularVelocitySmoothing
+      + state.AngularVelocity * (1.0 - m_AngularVelocitySmoothing);
+  }
+  state.HasOrientation = true;
+  state.Orientation = orientation;
+}
+
+void mitk::NavigationDataPredictionFilter::PredictPose(const ToolState& state, double dt, mitk::Point3D& position, mitk::Quaternion& orientation) const
+{
+  position = state.Position + state.Velocity * dt;
+  orientation = state.Orientation;
+
+  const double angularSpeed = state.AngularVelocity.GetNorm();
+  if (state.HasOrientation && angularSpeed > 0 && dt > 0)
+  {
+    vnl_vector_fixed<mitk::ScalarType, 3> axis;
+    for (unsigned int i = 0; i < 3; ++i)
+    {
+      axis[i] = state.AngularVelocity[i] / angularSpeed;
+    }
+    mitk::Quaternion rotation(axis, angularSpeed * dt);
+    orientation = rotation * state.Orientation;
+    orientation.normalize();
+  }
+}
@@ -0,0 +1,130 @@
+/*===================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center,
+Division of Medical and Biological Informatics.
+All rights reserved.
+
+This software is distributed WITHOUT ANY WARRANTY; without
+even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE.
+
+See LICENSE.txt or http://www.mitk.org for details.
+
+===================================================================*/
+
+
+#ifndef MITKNavigationDataPredictionFilter_H_HEADER_INCLUDED_
+#define MITKNavigationDataPredictionFilter_H_HEADER_INCLUDED_
+
+#include <mitkNavigationDataToNavigationDataFilter.h>
+#include "MitkIGTExports.h"
+
+#include <vector>
+
+namespace mitk {
+
+  /**Documentation
+  * \brief This filter compensates the latency between tracking and display by predicting the pose of
+  *        every tool to a point in time in the future.
+  *
+  * For every input a constant velocity Kalman filter estimates position and velocity of the tool from the
+  * measured positions and their IGT time stamps. The angular velocity is estimated from the relative rotation
+  * between two consecutive orientations and smoothed exponentially. The output is the state extrapolated
+  * by the prediction horizon:
+  *
+  * - if UseIGTTimeStamp is off, the prediction target is the time stamp of the input plus the horizon, which
+  *   is the mode for recorded data and for pipelines which are updated once per tracking sample.
+  * - if UseIGTTimeStamp is on, the prediction target is the current time of mitk::IGTTimeStamp plus the horizon.
+  *   In this mode the horizon is the latency from the update of the pipeline to the display, so calling Update()
+  *   right before rendering predicts to the render time even if no new tracking sample arrived in between.
+  *
+  * The prediction is never extrapolated further than MaximumPredictionTime. Invalid inputs and time stamps
+  * which run backwards (e.g. a restarted player) reset the state of the affected tool.
+  *
+  * @ingroup Navigation
+  */
+  class MITKIGT_EXPORT NavigationDataPredictionFilter : public NavigationDataToNavigationDataFilter
+  {
+  public:
+    mitkClassMacro(NavigationDataPredictionFilter, NavigationDataToNavigationDataFilter);
+
+    itkNewMacro(Self);
+
+    /** @brief Sets the time in ms by which the navigation data are predicted into the future. Default: 0 */
+    itkSetMacro(PredictionHorizon, double);
+    itkGetConstMacro(PredictionHorizon, double);
+
+    /** @brief Sets the maximum time in ms a tool state is extrapolated. Default: 200 */
+    itkSetMacro(MaximumPredictionTime, double);
+    itkGetConstMacro(MaximumPredictionTime, double);
+
+    /** @brief If set, the prediction target is derived from mitk::IGTTimeStamp instead of the input time stamp. Default: false */
+    itkSetMacro(UseIGTTimeStamp, bool);
+    itkGetConstMacro(UseIGTTimeStamp, bool);
+    itkBooleanMacro(UseIGTTimeStamp);
+
+    /** @brief Sets the variance of the measured positions in mm^2. Default: 0.25 */
+    itkSetMacro(MeasurementNoise, double);
+    itkGetConstMacro(MeasurementNoise, double);
+
+    /** @brief Sets the spectral density of the acceleration noise in mm^2/ms^3. Larger values follow
+     *         fast motions more closely, smaller values smooth more. Default: 1e-4 */
+    itkSetMacro(ProcessNoise, double);
+    itkGetConstMacro(ProcessNoise, double);
+
+    /** @brief Sets the weight (0..1] of a new angular velocity measurement for the exponential smoothing. Default: 0.5 */
+    itkSetClampMacro(AngularVelocitySmoothing, double, 0.0, 1.0);
+    itkGetConstMacro(AngularVelocitySmoothing, double);
+
+    /** @brief Resets the state of all tools. The next valid input of every tool starts a new estimation. */
+    void ResetState();
+
+    /** @return Returns the estimated velocity of the specified input in mm/ms. */
+    mitk::Vector3D GetVelocity(unsigned int input) const;
+
+    /** @return Returns the estimated angular velocity of the specified input in rad/ms (axis times angular speed). */
+    mitk::Vector3D GetAngularVelocity(unsigned int input) const;
+
+  protected:
+    NavigationDataPredictionFilter();
+    ~NavigationDataPredictionFilter() override;
+
+    void GenerateData() override;
+
+    /** @brief Estimated state of one tool */
+    struct ToolState
+    {
+      bool Initialized;
+      double TimeStamp;            ///< IGT time stamp of the last measurement in ms
+      mitk::Point3D Position;      ///< filtered position at TimeStamp
+      mitk::Vector3D Velocity;     ///< in mm/ms
+      double PositionVariance;     ///< covariance of position and velocity, equal for all three axes
+      double PositionVelocityCovariance;
+      double VelocityVariance;
+      bool HasOrientation;
+      mitk::Quaternion Orientation;
+      mitk::Vector3D AngularVelocity; ///< in rad/ms
+    };
+
+    void InitializeState(ToolState& state, const mitk::NavigationData* nd);
+
+    /** @brief Propagates the state to the time stamp of nd and fuses the measurement into it. */
+    void UpdateState(ToolState& state, const mitk::NavigationData* nd);
+
+    /** @brief Extrapolates position and orientation of the state by dt milliseconds. */
+    void PredictPose(const ToolState& state, double dt, mitk::Point3D& position, mitk::Quaternion& orientation) const;
+
+    std::vector<ToolState> m_States;
+
+    double m_PredictionHorizon;
+    double m_MaximumPredictionTime;
+    bool m_UseIGTTimeStamp;
+    double m_MeasurementNoise;
+    double m_ProcessNoise;
+    double m_AngularVelocitySmoothing;
+  };
+} // namespace mitk
+
+#endif /* MITKNavigationDataPredictionFilter_H_HEADER_INCLUDED_ */
@@ -15,12 +15,26 @@ See LICENSE.txt or http://www.mitk.org for details.
 ===================================================================*/
 
 #include "mitkPivotCalibration.h"
+#include "mitkNavigationDataSet.h"
 #include "vnl/algo/vnl_svd.h"
 #include "vnl/vnl_matrix.h"
 #include "vnl/vnl_vector.h"
 #include <vtkMatrix4x4.h>
 
-mitk::PivotCalibration::PivotCalibration() : m_NavigationDatas(std::vector<mitk::NavigationData::Pointer>()), m_ResultPivotPoint(mitk::Point3D(0.0))
+#include <algorithm>
+#include <cmath>
+#include <random>
+
+namespace
+{
+  // singular values of the system matrix below this value are treated as zero
+  const double s_SingularValueThreshold = 1e-1;
+}
+
+mitk::PivotCalibration::PivotCalibration() : m_NavigationDatas(std::vector<mitk::NavigationData::Pointer>()), m_ResultPivotPoint(mitk::Point3D(0.0)),
+  m_ResultPivotPointInReference(mitk::Point3D(0.0)), m_ResultRMSError(0.0), m_ResultNumberOfInliers(0),
+  m_UseOutlierRejection(false), m_InlierThreshold(1.0), m_NumberOfRANSACIterations(200),
+  m_AtA(6, 6, 0.0), m_Atb(6, 0.0), m_btb(0.0), m_NumberOfValidPoses(0)
 {
 
 
@@ -34,6 +48,21 @@ mitk::PivotCalibration::~PivotCalibration()
 void mitk::PivotCalibration::AddNavigationData(mitk::NavigationData::Pointer data)
 {
   m_NavigationDatas.push_back(data);
+
+  if (data.IsNotNull() && data->IsDataValid())
+  {
+    AddToNormalEquations(ToPose(data), m_AtA, m_Atb, m_btb);
+    ++m_NumberOfValidPoses;
+  }
+}
+
+void mitk::PivotCalibration::ClearNavigationData()
+{
+  m_NavigationDatas.clear();
+  m_AtA.fill(0.0);
+  m_Atb.fill(0.0);
+  m_btb = 0.0;
+  m_NumberOfValidPoses = 0;
 }
 
 bool mitk::PivotCalibration::ComputePivotResult()
@@ -43,9 +72,7 @@ bool mitk::PivotCalibration::ComputePivotResult()
 
 bool mitk::PivotCalibration::ComputePivotPoint()
 {
-  double defaultThreshold = 1e-1;
-
-  std::vector<mitk::NavigationData::Pointer> _CheckedTransforms;
+  std::vector<Pose> _CheckedTransforms;
   for (size_t i = 0; i < m_NavigationDatas.size(); ++i)
   {
     if (!m_NavigationDatas.at(i)->IsDataValid())
@@ -53,7 +80,7 @@ bool mitk::PivotCalibration::ComputePivotPoint()
       MITK_WARN << "Skipping invalid transform " << i << ".";
       continue;
     }
-    _CheckedTransforms.push_back(m_NavigationDatas.at(i));
+    _CheckedTransforms.push_back(ToPose(m_NavigationDatas.at(i)));
   }
 
   if (_CheckedTransforms.empty())
@@ -62,11 +89,130 @@ bool mitk::PivotCalibration::ComputePivotPoint()
     return false;
   }
 
-  unsigned int rows = 3 * _CheckedTransforms.size();
+  PivotResult result = CalibratePoses(_CheckedTransforms);
+  if (!result.Valid)
+  {
+    return false;
+  }
+
+  m_ResultPivotPoint = result.PivotPoint;
+  m_ResultPivotPointInReference = result.PivotPointInReference;
+  m_ResultRMSError = result.RMSError;
+  m_ResultNumberOfInliers = result.NumberOfInliers;
+  return true;
+}
+
+bool mitk::PivotCalibration::ComputeIncrementalPivotResult()
+{
+  if (m_NumberOfValidPoses == 0)
+  {
+    MITK_WARN << "Checked Transforms are empty";
+    return false;
+  }
+
+  // the singular values of A^T*A are the squares of the singular values of A
+  vnl_svd<double> svdAtA(m_AtA);
+  svdAtA.zero_out_absolute(s_SingularValueThreshold * s_SingularValueThreshold);
+  if (svdAtA.rank() < 6)
+  {
+    MITK_WARN << "svdA.rank() < 6";
+    return false;
+  }
+
+  vnl_vector<double> x = svdAtA.solve(m_Atb);
+
+  // |Ax-b|^2 = x^T*A^T*A*x - 2*x^T*A^T*b + b^T*b
+  double squaredError = dot_product(x, m_AtA * x) - 2.0 * dot_product(x, m_Atb) + m_btb;
+  m_ResultRMSError = std::sqrt(std::max(squaredError, 0.0) / (3.0 * m_NumberOfValidPoses));
+
+  for (unsigned int i = 0; i < 3; ++i)
+  {
+    m_ResultPivotPoint[i] = x[i];
+    m_ResultPivotPointInReference[i] = x[i + 3];
+  }
+  m_ResultNumberOfInliers = m_NumberOfValidPoses;
+  return true;
+}
+
+std::vector<mitk::PivotCalibration::PivotResult> mitk::PivotCalibration::ComputePivotResults(const mitk::NavigationDataSet* navigationDatas) const
+{
+  std::vector<PivotResult> results;
+  if (navigationDatas == nullptr)
+  {
+    return results;
+  }
+
+  PivotResult invalidResult;
+  invalidResult.Valid = false;
+  invalidResult.PivotPoint.Fill(0.0);
+  invalidResult.PivotPointInReference.Fill(0.0);
+  invalidResult.RMSError = 0.0;
+  invalidResult.NumberOfInliers = 0;
+  results.resize(navigationDatas->GetNumberOfTools(), invalidResult);
+
+  const int numberOfTools = static_cast<int>(navigationDatas->GetNumberOfTools());
+#pragma omp parallel for schedule(dynamic)
+  for (int tool = 0; tool < numberOfTools; ++tool)
+  {
+    std::vector<Pose> poses;
+    poses.reserve(navigationDatas->Size());
+    for (unsigned int i = 0; i < navigationDatas->Size(); ++i)
+    {
+      mitk::NavigationData::Pointer data = navigationDatas->GetNavigationDataForIndex(i, tool);
+      if (data.IsNotNull() && data->IsDataValid())
+      {
+        poses.push_back(ToPose(data));
+      }
+    }
+    if (!poses.empty())
+    {
+      results[tool] = CalibratePoses(poses);
+    }
+  }
+
+  return results;
+}
+
+mitk::PivotCalibration::PivotResult mitk::PivotCalibration::CalibratePoses(const std::vector<Pose>& poses) const
+{
+  PivotResult result;
+  result.Valid = false;
+  result.PivotPoint.Fill(0.0);
+  result.PivotPointInReference.Fill(0.0);
+  result.RMSError = 0.0;
+  result.NumberOfInliers = 0;
+
+  vnl_vector<double> x(6);
+  if (m_UseOutlierRejection)
+  {
+    std::vector<Pose> inliers = FindInliers(poses);
+    result.Valid = SolvePoses(inliers, x, result.RMSError);
+    result.NumberOfInliers = inliers.size();
+  }
+  else
+  {
+    result.Valid = SolvePoses(poses, x, result.RMSError);
+    result.NumberOfInliers = poses.size();
+  }
+
+  if (result.Valid)
+  {
+    for (unsigned int i = 0; i < 3; ++i)
+    {
+      result.PivotPoint[i] = x[i];
+      result.PivotPointInReference[i] = x[i + 3];
+    }
+  }
+  return result;
+}
+
+bool mitk::PivotCalibration::SolvePoses(const std::vector<Pose>& poses, vnl_vector<double>& x, double& rmsError) const
+{
+  unsigned int rows = 3 * poses.size();
   unsigned int columns = 6;
 
-  vnl_matrix< double > A(rows, columns), minusI(3, 3, 0), R(3, 3);
-  vnl_vector< double > b(rows), x(columns), t(3);
+  vnl_matrix< double > A(rows, columns), minusI(3, 3, 0);
+  vnl_vector< double > b(rows), t(3);
 
   minusI(0, 0) = -1;
   minusI(1, 1) = -1;
@@ -76,18 +222,17 @@ bool mitk::PivotCalibration::ComputePivotPoint()
   unsigned int currentRow = 0;
 
 
-  for (size_t i = 0; i < _CheckedTransforms.size(); ++i)
+  for (size_t i = 0; i < poses.size(); ++i)
   {
-    t = _CheckedTransforms.at(i)->GetPosition().GetVnlVector();// t = the current position of the tracked sensor
+    t = poses.at(i).Translation.as_vector();// t = the current position of the tracked sensor
     t *= -1;
-    b.update(t, currentRow); //b = combines the position for each collected transform in one column vector 
-    R = _CheckedTransforms.at(i)->GetOrientation().rotation_matrix_transpose().transpose(); // R = the current rotation of the tracked sensor, *rotation_matrix_transpose().transpose() is used to obtain original matrix
-    A.update(R, currentRow, 0); //A = the matrix which stores the rotations for each collected transform and -I
+    b.update(t, currentRow); //b = combines the position for each collected transform in one column vector
+    A.update(poses.at(i).Rotation.as_matrix(), currentRow, 0); //A = the matrix which stores the rotations for each collected transform and -I
     A.update(minusI, currentRow, 3);
     currentRow += 3;
   }
   vnl_svd<double> svdA(A); //The singular value decomposition of matrix A
-  svdA.zero_out_absolute(defaultThreshold);
+  svdA.zero_out_absolute(s_SingularValueThreshold);
 
   //there is a solution only if rank(A)=6 (columns are linearly
   //independent)
@@ -96,19 +241,139 @@ bool mitk::PivotCalibration::ComputePivotPoint()
     MITK_WARN << "svdA.rank() < 6";
     return false;
   }
-  else
+
+  x = svdA.solve(b); //x = the resulting pivot point
+  rmsError = (A * x - b).rms();  //the root mean sqaure error of the computation
+  return true;
+}
+
+std::vector<mitk::PivotCalibration::Pose> mitk::PivotCalibration::FindInliers(const std::vector<Pose>& poses) const
+{
+  // three poses are the minimum for a unique pivot point, two rotations always share an axis
+  const unsigned int minimalSetSize = 3;
+  if (poses.size() <= minimalSetSize)
   {
-    x = svdA.solve(b); //x = the resulting pivot point
+    return poses;
+  }
 
-    m_ResultRMSError = (A * x - b).rms();  //the root mean sqaure error of the computation 
+  // fixed seed, the calibration of the same poses must be reproducible
+  std::mt19937 randomGenerator(5489u);
+  std::uniform_int_distribution<size_t> randomIndex(0, poses.size() - 1);
 
-    //sets the Pivot Point
-    m_ResultPivotPoint[0] = x[0];
-    m_ResultPivotPoint[1] = x[1];
-    m_ResultPivotPoint[2] = x[2];
+  std::vector<unsigned char> bestInliers;
+  unsigned int bestNumberOfInliers = 0;
+  std::vector<unsigned char> currentInliers(poses.size());
 
+  vnl_matrix<double> AtA(6, 6);
+  vnl_vector<double> Atb(6);
+  for (unsigned int iteration = 0; iteration < m_NumberOfRANSACIterations; ++iteration)
+  {
+    size_t sample[minimalSetSize];
+    for (unsigned int i = 0; i < minimalSetSize; ++i)
+    {
+      bool unique;
+      do
+      {
+        sample[i] = randomIndex(randomGenerator);
+        unique = std::find(sample, sample + i, sample[i]) == sample + i;
+      } while (!unique);
+    }
+
+    AtA.fill(0.0);
+    Atb.fill(0.0);
+    double btb = 0.0;
+    for (unsigned int i = 0; i < minimalSetSize; ++i)
+    {
+      AddToNormalEquations(poses[sample[i]], AtA, Atb, btb);
+    }
+    vnl_svd<double> svdAtA(AtA);
+    svdAtA.zero_out_absolute(s_SingularValueThreshold * s_SingularValueThreshold);
+    if (svdAtA.rank() < 6)
+    {
+      continue; // degenerated sample, e.g. rotations around one axis only
+    }
+    const vnl_vector<double> x = svdAtA.solve(Atb);
 
+    unsigned int numberOfInliers = 0;
+    for (size_t i = 0; i < poses.size(); ++i)
+    {
+      currentInliers[i] = GetResidual(poses[i], x) <= m_InlierThreshold;
+      numberOfInliers += currentInliers[i];
+    }
+    if (numberOfInliers > bestNumberOfInliers)
+    {
+      bestNumberOfInliers = numberOfInliers;
+      bestInliers = currentInliers;
+      if (bestNumberOfInliers == poses.size())
+      {
+        break;
+      }
+    }
   }
-  return true;
 
+  if (bestNumberOfInliers < minimalSetSize)
+  {
+    MITK_WARN << "No consistent set of poses found, using all poses.";
+    return poses;
+  }
+
+  std::vector<Pose> inliers;
+  inliers.reserve(bestNumberOfInliers);
+  for (size_t i = 0; i < poses.size(); ++i)
+  {
+    if (bestInliers[i])
+    {
+      inliers.push_back(poses[i]);
+    }
+  }
+  return inliers;
+}
+
+mitk::PivotCalibration::Pose mitk::PivotCalibration::ToPose(const mitk::NavigationData* data)
+{
+  Pose pose;
+  // *rotation_matrix_transpose().transpose() is used to obtain original matrix
+  pose.Rotation = data->GetOrientation().rotation_matrix_transpose().transpose();
+  for (unsigned int i = 0; i < 3; ++i)
+  {
+    pose.Translation[i] = data->GetPosition()[i];
+  }
+  return pose;
+}
+
+void mitk::PivotCalibration::AddToNormalEquations(const Pose& pose, vnl_matrix<double>& AtA, vnl_vector<double>& Atb, double& btb)
+{
+  // rows of one pose: A_i = [R -I], b_i = -t
+  // A_i^T*A_i = [R^T*R -R^T; -R I] = [I -R^T; -R I], A_i^T*b_i = [-R^T*t; t]
+  const vnl_matrix_fixed<double, 3, 3>& R = pose.Rotation;
+  const vnl_vector_fixed<double, 3>& t = pose.Translation;
+  for (unsigned int row = 0; row < 3; ++row)
+  {
+    AtA(row, row) += 1.0;
+    AtA(row + 3, row + 3) += 1.0;
+    for (unsigned int column = 0; column < 3; ++column)
+    {
+      AtA(row, column + 3) -= R(column, row);
+      AtA(row + 3, column) -= R(row, column);
+      Atb[row] -= R(column, row) * t[column];
+    }
+    Atb[row + 3] += t[row];
+  }
+  btb += dot_product(t, t);
+}
+
+double mitk::PivotCalibration::GetResidual(const Pose& pose, const vnl_vector<double>& x)
+{
+  // distance between the transformed tool tip and the pivot point
+  double squaredDistance = 0.0;
+  for (unsigned int row = 0; row < 3; ++row)
+  {
+    double difference = pose.Translation[row] - x[row + 3];
+    for (unsigned int column = 0; column < 3; ++column)
+    {
+      difference += pose.Rotation(row, column) * x[column];
+    }
+    squaredDistance += difference * difference;
+  }
+  return std::sqrt(squaredDistance);
 }
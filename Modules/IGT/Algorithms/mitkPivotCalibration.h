@@ -24,12 +24,31 @@ See LICENSE.txt or http://www.mitk.org for details.
 #include <mitkCommon.h>
 #include <mitkVector.h>
 #include <mitkNavigationData.h>
+#include <vnl/vnl_matrix.h>
+#include <vnl/vnl_matrix_fixed.h>
+#include <vnl/vnl_vector.h>
+#include <vnl/vnl_vector_fixed.h>
 #include <vector>
 
 
 namespace mitk {
+  class NavigationDataSet;
+
     /**Documentation
     * \brief Class for performing a pivot calibration out of a set of navigation datas
+    *
+    * Every pose (R,t) of the tracked tool contributes the equations R*p + t = P, where p is the pivot point
+    * in tool coordinates (the tool tip) and P the pivot point in tracking coordinates. Three ways to solve them
+    * are provided:
+    *
+    * - ComputePivotResult() solves the least squares system of all poses at once. If outlier rejection is
+    *   enabled, the solution is searched with RANSAC on minimal sets of three poses first and only the inliers
+    *   are used for the final solution.
+    * - ComputeIncrementalPivotResult() solves the normal equations, which are updated by every call of
+    *   AddNavigationData(). The costs do not depend on the number of poses, so the result can be refined
+    *   while poses are streaming in.
+    * - ComputePivotResults() calibrates all tools of a mitk::NavigationDataSet in parallel.
+    *
     * \ingroup IGT
     */
   class MITKIGT_EXPORT PivotCalibration : public itk::Object
@@ -37,28 +56,102 @@ namespace mitk {
     public:
       mitkClassMacroItkParent(PivotCalibration, itk::Object);
       itkNewMacro(Self);
+
+      /** @brief Result of the calibration of one tool, used by ComputePivotResults(). */
+      struct PivotResult
+      {
+        bool Valid;
+        mitk::Point3D PivotPoint;             ///< pivot point in tool coordinates
+        mitk::Point3D PivotPointInReference;  ///< pivot point in tracking coordinates
+        double RMSError;
+        unsigned int NumberOfInliers;
+      };
+
       void AddNavigationData(mitk::NavigationData::Pointer data);
+
+      /** @brief Removes all navigation datas and resets the incremental solution. */
+      void ClearNavigationData();
+
       /** @brief Computes the pivot point and rotation/axis on the given
         *        navigation datas. You can get the results afterwards.
         * @return Returns true if the computation was successfull, false if not.
         */
       bool ComputePivotResult();
 
+      /** @brief Computes the pivot point from the normal equations of all navigation datas added so far.
+        *        Outlier rejection is not applied.
+        * @return Returns true if the computation was successfull, false if not.
+        */
+      bool ComputeIncrementalPivotResult();
+
+      /** @brief Calibrates every tool of the given set with the settings of this object. The tools are
+        *        processed in parallel, the navigation datas of this object are not changed.
+        * @return Returns one result per tool.
+        */
+      std::vector<PivotResult> ComputePivotResults(const mitk::NavigationDataSet* navigationDatas) const;
+
       itkGetMacro(ResultPivotPoint,mitk::Point3D);
+      itkGetMacro(ResultPivotPointInReference,mitk::Point3D);
       itkGetMacro(ResultRMSError,double);
+      /** @brief Returns the number of poses used for the last result. */
+      itkGetMacro(ResultNumberOfInliers,unsigned int);
 
+      /** @brief Enables RANSAC based outlier rejection for ComputePivotResult(). Default: false */
+      itkSetMacro(UseOutlierRejection,bool);
+      itkGetMacro(UseOutlierRejection,bool);
+      itkBooleanMacro(UseOutlierRejection);
+
+      /** @brief Sets the maximum distance in mm between the transformed tool tip and the pivot point of an inlier. Default: 1 */
+      itkSetMacro(InlierThreshold,double);
+      itkGetMacro(InlierThreshold,double);
+
+      /** @brief Sets the number of random minimal sets tested by RANSAC. Default: 200 */
+      itkSetMacro(NumberOfRANSACIterations,unsigned int);
+      itkGetMacro(NumberOfRANSACIterations,unsigned int);
 
     protected:
       PivotCalibration();
       ~PivotCalibration() override;
 
+      /** @brief Rotation and translation of one valid navigation data */
+      struct Pose
+      {
+        vnl_matrix_fixed<double,3,3> Rotation;
+        vnl_vector_fixed<double,3> Translation;
+      };
+
       std::vector<mitk::NavigationData::Pointer> m_NavigationDatas;
 
       bool ComputePivotPoint();
       bool ComputePivotAxis();
 
+      /** @brief Calibrates the given poses, applies outlier rejection if enabled. */
+      PivotResult CalibratePoses(const std::vector<Pose>& poses) const;
+
+      /** @brief Solves the least squares system of the given poses with a SVD of the full system matrix. */
+      bool SolvePoses(const std::vector<Pose>& poses, vnl_vector<double>& x, double& rmsError) const;
+
+      /** @brief Searches the largest set of poses consistent with one pivot point. */
+      std::vector<Pose> FindInliers(const std::vector<Pose>& poses) const;
+
+      static Pose ToPose(const mitk::NavigationData* data);
+      static void AddToNormalEquations(const Pose& pose, vnl_matrix<double>& AtA, vnl_vector<double>& Atb, double& btb);
+      static double GetResidual(const Pose& pose, const vnl_vector<double>& x);
+
       mitk::Point3D m_ResultPivotPoint;
+      mitk::Point3D m_ResultPivotPointInReference;
       double m_ResultRMSError;
+      unsigned int m_ResultNumberOfInliers;
+
+      bool m_UseOutlierRejection;
+      double m_InlierThreshold;
+      unsigned int m_NumberOfRANSACIterations;
+
+      // normal equations of all valid navigation datas, updated incrementally
+      vnl_matrix<double> m_AtA;
+      vnl_vector<double> m_Atb;
+      double m_btb;
+      unsigned int m_NumberOfValidPoses;
 
     };
 } // Ende Namespace
@@ -0,0 +1,143 @@
+/*===================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center,
+Division of Medical and Biological Informatics.
+All rights reserved.
+
+This software is distributed WITHOUT ANY WARRANTY; without
+even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE.
+
+See LICENSE.txt or http://www.mitk.org for details.
+
+===================================================================*/
+
+#include "mitkNavigationDataPredictionFilter.h"
+#include "mitkNavigationDataPredictionBenchmark.h"
+#include "mitkNavigationData.h"
+#include "mitkNavigationDataSet.h"
+
+#include "mitkTestingMacros.h"
+
+#include <sstream>
+
+class mitkNavigationDataPredictionFilterTestClass
+{
+public:
+
+  /** @brief Pose of a tool moving with 0.1 mm/ms along x and rotating with 0.001 rad/ms around z. */
+  static mitk::NavigationData::Pointer CreateSample(double time, bool valid = true)
+  {
+    mitk::NavigationData::Pointer nd = mitk::NavigationData::New();
+    mitk::Point3D position;
+    mitk::FillVector3D(position, 10.0 + 0.1 * time, 20.0, -30.0);
+    vnl_vector_fixed<mitk::ScalarType, 3> axis(0.0, 0.0, 1.0);
+    mitk::Quaternion orientation(axis, 0.001 * time);
+    nd->SetPosition(position);
+    nd->SetOrientation(orientation);
+    nd->SetIGTTimeStamp(time);
+    nd->SetDataValid(valid);
+    return nd;
+  }
+
+  static void TestInstantiation()
+  {
+    mitk::NavigationDataPredictionFilter::Pointer filter = mitk::NavigationDataPredictionFilter::New();
+    MITK_TEST_CONDITION_REQUIRED(filter.IsNotNull(), "Testing instantiation");
+    MITK_TEST_CONDITION(filter->GetPredictionHorizon() == 0.0, "Testing default prediction horizon");
+    MITK_TEST_CONDITION(!filter->GetUseIGTTimeStamp(), "Testing default of UseIGTTimeStamp");
+  }
+
+  static void TestPrediction()
+  {
+    mitk::NavigationDataPredictionFilter::Pointer filter = mitk::NavigationDataPredictionFilter::New();
+    filter->SetPredictionHorizon(60.0);
+
+    mitk::NavigationData::Pointer input = mitk::NavigationData::New();
+    filter->SetInput(input);
+
+    double time = 0.0;
+    for (; time < 2000.0; time += 20.0)
+    {
+      input->Graft(CreateSample(time));
+      filter->Modified();
+      filter->Update();
+    }
+    time -= 20.0;
+
+    mitk::NavigationData::Pointer expected = CreateSample(time + 60.0);
+    mitk::NavigationData* output = filter->GetOutput();
+    MITK_TEST_CONDITION(output->GetPosition().EuclideanDistanceTo(expected->GetPosition()) < 0.1,
+      "Testing predicted position of linear motion");
+    MITK_TEST_CONDITION(std::fabs(filter->GetVelocity(0)[0] - 0.1) < 1e-3, "Testing estimated velocity");
+    MITK_TEST_CONDITION(std::fabs(filter->GetAngularVelocity(0)[2] - 0.001) < 1e-5, "Testing estimated angular velocity");
+
+    double dot = std::fabs(dot_product(output->GetOrientation(), expected->GetOrientation()));
+    MITK_TEST_CONDITION(dot > std::cos(0.0005), "Testing predicted orientation");
+    MITK_TEST_CONDITION(output->GetIGTTimeStamp() == time, "Testing that the time stamp is not changed");
+
+    // invalid data are passed through and reset the estimation
+    input->Graft(CreateSample(time + 20.0, false));
+    filter->Modified();
+    filter->Update();
+    MITK_TEST_CONDITION(!output->IsDataValid(), "Testing invalid input");
+    MITK_TEST_CONDITION(filter->GetVelocity(0).GetNorm() == 0.0, "Testing reset of the estimation after invalid input");
+
+    input->Graft(CreateSample(time + 40.0));
+    filter->Modified();
+    filter->Update();
+    MITK_TEST_CONDITION(output->GetPosition() == input->GetPosition(), "Testing first sample after reset is not extrapolated");
+  }
+
+  static void TestBenchmark()
+  {
+    mitk::NavigationDataSet::Pointer recording = mitk::NavigationDataSet::New(1);
+    for (double time = 0.0; time < 3000.0; time += 20.0)
+    {
+      std::vector<mitk::NavigationData::Pointer> sample;
+      sample.push_back(CreateSample(time));
+      recording->AddNavigationDatas(sample);
+    }
+
+    std::vector<double> latencies;
+    latencies.push_back(0.0);
+    latencies.push_back(50.0);
+    latencies.push_back(100.0);
+
+    mitk::NavigationDataPredictionBenchmark::Pointer benchmark = mitk::NavigationDataPredictionBenchmark::New();
+    std::vector<mitk::NavigationDataPredictionBenchmark::Result> results = benchmark->Evaluate(recording, 0, latencies);
+    MITK_TEST_CONDITION_REQUIRED(results.size() == latencies.size(), "Testing number of benchmark results");
+
+    MITK_TEST_CONDITION(results[0].MeanUncompensatedPositionError < 1e-9, "Testing uncompensated error without latency");
+    for (unsigned int i = 1; i < results.size(); ++i)
+    {
+      MITK_TEST_CONDITION(results[i].NumberOfSamples > 0, "Testing number of evaluated samples");
+      MITK_TEST_CONDITION(results[i].MeanPositionError < results[i].MeanUncompensatedPositionError,
+        "Testing that the prediction reduces the position error");
+      MITK_TEST_CONDITION(results[i].MeanOrientationError < results[i].MeanUncompensatedOrientationError,
+        "Testing that the prediction reduces the orientation error");
+    }
+
+    std::stringstream table;
+    mitk::NavigationDataPredictionBenchmark::PrintResults(results, table);
+    MITK_TEST_CONDITION(!table.str().empty(), "Testing output of the results");
+
+    MITK_TEST_FOR_EXCEPTION(mitk::Exception, benchmark->Evaluate(recording, 1, latencies));
+  }
+};
+
+/**Documentation
+ *  test for the class "NavigationDataPredictionFilter".
+ */
+int mitkNavigationDataPredictionFilterTest(int /* argc */, char* /*argv*/[])
+{
+  MITK_TEST_BEGIN("NavigationDataPredictionFilter")
+
+  mitkNavigationDataPredictionFilterTestClass::TestInstantiation();
+  mitkNavigationDataPredictionFilterTestClass::TestPrediction();
+  mitkNavigationDataPredictionFilterTestClass::TestBenchmark();
+
+  MITK_TEST_END()
+}
@@ -0,0 +1,136 @@
+/*===================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center,
+Division of Medical and Biological Informatics.
+All rights reserved.
+
+This software is distributed WITHOUT ANY WARRANTY; without
+even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE.
+
+See LICENSE.txt or http://www.mitk.org for details.
+
+===================================================================*/
+
+#include "mitkPivotCalibration.h"
+#include "mitkNavigationData.h"
+#include "mitkNavigationDataSet.h"
+
+#include "mitkTestingMacros.h"
+
+class mitkPivotCalibrationTestClass
+{
+public:
+
+  /** @brief Pose of a tool with the given tip offset pivoting around the given point. */
+  static mitk::NavigationData::Pointer CreatePose(unsigned int index, const mitk::Point3D& tip, const mitk::Point3D& pivot)
+  {
+    vnl_vector_fixed<mitk::ScalarType, 3> axis(std::cos(0.7 * index), std::sin(0.7 * index), 0.5);
+    axis.normalize();
+    mitk::Quaternion orientation(axis, 0.1 + 0.05 * (index % 7));
+
+    vnl_matrix_fixed<mitk::ScalarType, 3, 3> rotation = orientation.rotation_matrix_transpose().transpose();
+    vnl_vector_fixed<mitk::ScalarType, 3> rotatedTip = rotation * tip.GetVnlVector();
+
+    mitk::Point3D position;
+    for (unsigned int i = 0; i < 3; ++i)
+    {
+      position[i] = pivot[i] - rotatedTip[i];
+    }
+
+    mitk::NavigationData::Pointer nd = mitk::NavigationData::New();
+    nd->SetPosition(position);
+    nd->SetOrientation(orientation);
+    nd->SetDataValid(true);
+    return nd;
+  }
+
+  static void TestPivotCalibration()
+  {
+    mitk::Point3D tip;
+    mitk::FillVector3D(tip, 1.0, -2.0, 150.0);
+    mitk::Point3D pivot;
+    mitk::FillVector3D(pivot, 100.0, 50.0, -1500.0);
+
+    mitk::PivotCalibration::Pointer calibration = mitk::PivotCalibration::New();
+    for (unsigned int i = 0; i < 30; ++i)
+    {
+      calibration->AddNavigationData(CreatePose(i, tip, pivot));
+    }
+
+    MITK_TEST_CONDITION_REQUIRED(calibration->ComputePivotResult(), "Testing pivot calibration");
+    MITK_TEST_CONDITION(calibration->GetResultPivotPoint().EuclideanDistanceTo(tip) < 1e-6, "Testing pivot point");
+    MITK_TEST_CONDITION(calibration->GetResultPivotPointInReference().EuclideanDistanceTo(pivot) < 1e-6, "Testing pivot point in reference");
+    MITK_TEST_CONDITION(calibration->GetResultRMSError() < 1e-6, "Testing RMS error");
+
+    MITK_TEST_CONDITION_REQUIRED(calibration->ComputeIncrementalPivotResult(), "Testing incremental pivot calibration");
+    MITK_TEST_CONDITION(calibration->GetResultPivotPoint().EuclideanDistanceTo(tip) < 1e-6, "Testing incremental pivot point");
+    MITK_TEST_CONDITION(calibration->GetResultRMSError() < 1e-3, "Testing incremental RMS error");
+
+    // outliers are only rejected if enabled
+    mitk::Point3D wrongPivot;
+    mitk::FillVector3D(wrongPivot, 110.0, 50.0, -1500.0);
+    for (unsigned int i = 30; i < 36; ++i)
+    {
+      calibration->AddNavigationData(CreatePose(i, tip, wrongPivot));
+    }
+    MITK_TEST_CONDITION_REQUIRED(calibration->ComputePivotResult(), "Testing pivot calibration with outliers");
+    MITK_TEST_CONDITION(calibration->GetResultPivotPoint().EuclideanDistanceTo(tip) > 1e-3, "Testing that outliers disturb the least squares result");
+
+    calibration->UseOutlierRejectionOn();
+    MITK_TEST_CONDITION_REQUIRED(calibration->ComputePivotResult(), "Testing pivot calibration with outlier rejection");
+    MITK_TEST_CONDITION(calibration->GetResultPivotPoint().EuclideanDistanceTo(tip) < 1e-6, "Testing pivot point with outlier rejection");
+    MITK_TEST_CONDITION(calibration->GetResultNumberOfInliers() == 30, "Testing number of inliers");
+
+    calibration->ClearNavigationData();
+    MITK_TEST_CONDITION(!calibration->ComputeIncrementalPivotResult(), "Testing incremental calibration without data");
+  }
+
+  static void TestBatchCalibration()
+  {
+    mitk::Point3D pivot;
+    mitk::FillVector3D(pivot, -20.0, 30.0, -1000.0);
+
+    const unsigned int numberOfTools = 4;
+    std::vector<mitk::Point3D> tips(numberOfTools);
+    for (unsigned int tool = 0; tool < numberOfTools; ++tool)
+    {
+      mitk::FillVector3D(tips[tool], 0.5 * tool, 0.0, 100.0 + 10.0 * tool);
+    }
+
+    mitk::NavigationDataSet::Pointer navigationDatas = mitk::NavigationDataSet::New(numberOfTools);
+    for (unsigned int i = 0; i < 20; ++i)
+    {
+      std::vector<mitk::NavigationData::Pointer> timeStep;
+      for (unsigned int tool = 0; tool < numberOfTools; ++tool)
+      {
+        timeStep.push_back(CreatePose(i + tool, tips[tool], pivot));
+      }
+      navigationDatas->AddNavigationDatas(timeStep);
+    }
+
+    mitk::PivotCalibration::Pointer calibration = mitk::PivotCalibration::New();
+    std::vector<mitk::PivotCalibration::PivotResult> results = calibration->ComputePivotResults(navigationDatas);
+    MITK_TEST_CONDITION_REQUIRED(results.size() == numberOfTools, "Testing number of results of batch calibration");
+    for (unsigned int tool = 0; tool < numberOfTools; ++tool)
+    {
+      MITK_TEST_CONDITION(results[tool].Valid, "Testing batch calibration of tool " << tool);
+      MITK_TEST_CONDITION(results[tool].PivotPoint.EuclideanDistanceTo(tips[tool]) < 1e-6, "Testing pivot point of tool " << tool);
+    }
+  }
+};
+
+/**Documentation
+ *  test for the class "PivotCalibration".
+ */
+int mitkPivotCalibrationTest(int /* argc */, char* /*argv*/[])
+{
+  MITK_TEST_BEGIN("PivotCalibration")
+
+  mitkPivotCalibrationTestClass::TestPivotCalibration();
+  mitkPivotCalibrationTestClass::TestBatchCalibration();
+
+  MITK_TEST_END()
+}
@@ -7,6 +7,8 @@ set(CPP_FILES
   Algorithms/mitkNavigationDataEvaluationFilter.cpp
   Algorithms/mitkNavigationDataLandmarkTransformFilter.cpp
   Algorithms/mitkNavigationDataPassThroughFilter.cpp
+  Algorithms/mitkNavigationDataPredictionBenchmark.cpp
+  Algorithms/mitkNavigationDataPredictionFilter.cpp
   Algorithms/mitkNavigationDataReferenceTransformFilter.cpp
   Algorithms/mitkNavigationDataSmoothingFilter.cpp
   Algorithms/mitkNavigationDataToMessageFilter.cpp
@@ -4,6 +4,7 @@ set(CPP_FILES
   Common/mitkExtractTimeGrid.cpp
   Common/mitkTimeGridHelper.cpp
   Common/mitkMaskedDynamicImageStatisticsGenerator.cpp
+  Common/mitkMaskedVoxelList.cpp
   Common/mitkModelFitConstants.cpp
   Common/mitkModelFitParameter.cpp
   Common/mitkModelFitCmdAppsHelper.cpp
@@ -64,6 +64,10 @@ namespace mitk
 
     virtual ParameterNamesType GetCriterionNames() const;
 
+    /** Creates a workspace that keeps the optimizer and the cost function, so consecutive fits of a thread
+     * only reconfigure them with the new model and signal.*/
+    virtual std::unique_ptr<FitWorkspace> CreateWorkspace() const;
+
   protected:
 
     typedef Superclass::ParametersType ParametersType;
@@ -77,6 +81,24 @@ namespace mitk
                                       const ModelBase::ParametersType& initialParameters,
                                       DebugParameterMapType& debugParameters) const;
 
+    virtual ParametersType DoModelFitInWorkspace(const SignalType& value, const ModelBase* model,
+                                      const ModelBase::ParametersType& initialParameters,
+                                      DebugParameterMapType& debugParameters, FitWorkspace* workspace) const;
+
+    /** Optimizer and cost function of the fits of one thread.*/
+    class LevenbergMarquardtFitWorkspace : public FitWorkspace
+    {
+    public:
+      LevenbergMarquardtFitWorkspace();
+
+      /** Cost function generated by GenerateCostFunction() for the first fit.*/
+      MVModelFitCostFunction::Pointer m_CostFunction;
+      ::itk::LevenbergMarquardtOptimizer::Pointer m_Optimizer;
+      /** Dimensions of the cost function the optimizer was set up for.*/
+      unsigned int m_NumberOfParameters;
+      unsigned int m_NumberOfValues;
+    };
+
     virtual OutputPixelArrayType GetCriteria(const ModelBase* model, const ParametersType& parameters,
         const SignalType& sample) const;
 
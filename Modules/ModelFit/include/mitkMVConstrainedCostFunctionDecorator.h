@@ -78,6 +78,10 @@ public:
 
     /**Returns the index of the first (in terms of index position) failed parameter in the last failed evaluation.*/
     ParametersType::size_type GetFailedParameter() const;
+
+    /**Resets the evaluation statistics (count, ratios and failed parameter), e.g. if the instance is reused
+     for another fit.*/
+    void ResetEvaluationStatistics();
 protected:
 
     virtual MeasureType CalcMeasure(const ParametersType &parameters, const SignalType& signal) const;
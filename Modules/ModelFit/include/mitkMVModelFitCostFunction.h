@@ -30,6 +30,8 @@ namespace mitk
 /** Base class for all model fit cost function that return a multiple cost value
  * It offers also a default implementation for the numerical computation of the
  * derivatives. Normaly you just have to (re)implement CalcMeasure().
+ * If the model provides analytical signal derivatives (ModelBase::GetSignalDerivatives()) and the cost
+ * function implements CalcMeasureSignalDerivative(), the derivatives are computed analytically instead.
 */
 class MITKMODELFIT_EXPORT MVModelFitCostFunction : public itk::MultipleValuedCostFunction, public ModelFitCostFunctionInterface
 {
@@ -62,6 +64,14 @@ protected:
 
     virtual MeasureType CalcMeasure(const ParametersType &parameters, const SignalType& signal) const = 0;
 
+    /** Indicates if CalcMeasureSignalDerivative() is implemented. Default implementation returns false.*/
+    virtual bool HasMeasureSignalDerivative() const;
+
+    /** Computes the derivative of each measure value with respect to the signal value of the same index.
+     * Only possible for cost functions where measure value j depends only on signal value j.
+     * @remark Default implementation throws; reimplement together with HasMeasureSignalDerivative().*/
+    virtual MeasureType CalcMeasureSignalDerivative(const ParametersType &parameters, const SignalType& signal) const;
+
     MVModelFitCostFunction() : m_DerivativeStepLength(1e-5)
     {
     }
@@ -19,6 +19,8 @@
 
 #include <mitkImage.h>
 
+#include "mitkMaskedVoxelList.h"
+
 #include "MitkModelFitExports.h"
 
 namespace mitk
@@ -30,7 +32,11 @@ namespace mitk
  * *only* the first time step will be used as mask.\n
  * If the input image has multiple time steps, the statistics will be calculated for each time
  * step. This the result arrays will always have as many values as the input image
- * has time steps.*/
+ * has time steps.\n
+ * If UseVoxelList is set, the masked voxels are collected once in a MaskedVoxelList (reused as long as
+ * the mask is unchanged) and the statistics of all time steps are computed directly from the buffer of the
+ * dynamic image. The list is split into equally sized chunks, one per thread, so all threads get the same
+ * amount of work independent of the position of the mask.*/
 class MITKMODELFIT_EXPORT MaskedDynamicImageStatisticsGenerator : public itk::Object
 {
 public:
@@ -46,6 +52,11 @@ public:
     itkSetConstObjectMacro(Mask, Image);
     itkGetConstObjectMacro(Mask, Image);
 
+    /** Activates the voxel list mode (see class description). Default: false.*/
+    itkSetMacro(UseVoxelList, bool);
+    itkGetConstMacro(UseVoxelList, bool);
+    itkBooleanMacro(UseVoxelList);
+
     const ResultType& GetMaximum();
     const ResultType& GetMinimum();
     const ResultType& GetMean();
@@ -62,6 +73,9 @@ protected:
     template <typename TPixel, unsigned int VDim>
     void DoCalculateStatistics(const itk::Image<TPixel, VDim>* image);
 
+    template <typename TPixel, unsigned int VDim>
+    void DoCalculateStatisticsByVoxelList(const itk::Image<TPixel, VDim>* image);
+
     virtual void CheckValidInputs() const;
 
     bool HasOutdatedResults() const;
@@ -75,6 +89,11 @@ private:
     typedef itk::Image<unsigned short, 3> InternalMaskType;
     InternalMaskType::ConstPointer m_InternalMask;
 
+    bool m_UseVoxelList;
+    MaskedVoxelList::Pointer m_VoxelList;
+    /** Mask m_VoxelList was generated from (null if it contains all voxels).*/
+    Image::ConstPointer m_VoxelListMask;
+
     ResultType m_Maximum;
     ResultType m_Minimum;
     ResultType m_Mean;
@@ -0,0 +1,123 @@
+/*===================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center,
+Division of Medical and Biological Informatics.
+All rights reserved.
+
+This software is distributed WITHOUT ANY WARRANTY; without
+even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE.
+
+See LICENSE.txt or http://www.mitk.org for details.
+
+===================================================================*/
+
+#ifndef __MITK_MASKED_VOXEL_LIST_H_
+#define __MITK_MASKED_VOXEL_LIST_H_
+
+#include <algorithm>
+#include <vector>
+
+#include <itkObject.h>
+
+#include <mitkCommon.h>
+
+#include "MitkModelFitExports.h"
+
+namespace mitk
+{
+  /** Compact list of the voxels of a (3D) mask that are not zero.
+   * The voxels are stored as ascending linear offsets into the buffer of an image with the region of the mask.
+   * Generators use the list to visit only the voxels of interest instead of iterating the whole image region
+   * and testing the mask per voxel. Because the list only contains voxels of interest, splitting it into
+   * equally sized chunks (see GetChunk()) distributes the work evenly over threads, regardless of where the
+   * ROI lies in the image.*/
+  class MITKMODELFIT_EXPORT MaskedVoxelList : public ::itk::Object
+  {
+  public:
+    mitkClassMacroItkParent(MaskedVoxelList, ::itk::Object);
+    itkFactorylessNewMacro(Self);
+
+    typedef size_t VoxelOffsetType;
+    typedef std::vector<VoxelOffsetType> VoxelOffsetVectorType;
+
+    /** Collects all voxels of the mask buffer that are not zero.
+     * @param maskBuffer Buffer of the mask. If it is null, all voxels are added.
+     * @param numberOfVoxels Number of voxels of the (mask) region.*/
+    template <typename TMaskPixel>
+    void Initialize(const TMaskPixel* maskBuffer, VoxelOffsetType numberOfVoxels)
+    {
+      m_Offsets.clear();
+      m_NumberOfRegionVoxels = numberOfVoxels;
+
+      if (maskBuffer)
+      {
+        for (VoxelOffsetType offset = 0; offset < numberOfVoxels; ++offset)
+        {
+          if (maskBuffer[offset] != 0)
+          {
+            m_Offsets.push_back(offset);
+          }
+        }
+      }
+      else
+      {
+        m_Offsets.resize(numberOfVoxels);
+        for (VoxelOffsetType offset = 0; offset < numberOfVoxels; ++offset)
+        {
+          m_Offsets[offset] = offset;
+        }
+      }
+
+      this->Modified();
+    };
+
+    /** Offsets of the voxels of the list.*/
+    itkGetConstReferenceMacro(Offsets, VoxelOffsetVectorType);
+
+    /** Number of voxels of the region the list was generated from.*/
+    itkGetConstMacro(NumberOfRegionVoxels, VoxelOffsetType);
+
+    /** Number of voxels in the list.*/
+    VoxelOffsetType GetNumberOfVoxels() const;
+
+    /** Computes the range [begin, end) of list positions of chunk i if the list is split into
+     * numberOfChunks chunks. The sizes of the chunks differ by at most one voxel.*/
+    void GetChunk(unsigned int chunk, unsigned int numberOfChunks, VoxelOffsetType& begin, VoxelOffsetType& end) const;
+
+    /** Scatters values given per list voxel into a dense buffer of the region; voxels not in the list
+     * are set to the default value.*/
+    template <typename TValue, typename TDenseValue>
+    void Densify(const std::vector<TValue>& sparseValues, TDenseValue* denseBuffer, TDenseValue defaultValue = 0) const
+    {
+      if (sparseValues.size() != m_Offsets.size())
+      {
+        itkExceptionMacro("Cannot densify values. Number of values does not match the voxel list. Number of values: "
+                          << sparseValues.size() << "; number of voxels: " << m_Offsets.size());
+      }
+
+      std::fill(denseBuffer, denseBuffer + m_NumberOfRegionVoxels, defaultValue);
+      for (VoxelOffsetType pos = 0; pos < m_Offsets.size(); ++pos)
+      {
+        denseBuffer[m_Offsets[pos]] = static_cast<TDenseValue>(sparseValues[pos]);
+      }
+    };
+
+  protected:
+    MaskedVoxelList();
+    ~MaskedVoxelList() override;
+
+    void PrintSelf(std::ostream& os, ::itk::Indent indent) const override;
+
+  private:
+    VoxelOffsetVectorType m_Offsets;
+    VoxelOffsetType m_NumberOfRegionVoxels;
+
+    MaskedVoxelList(const Self& source);
+    void operator=(const Self&);  //purposely not implemented
+  };
+}
+
+#endif
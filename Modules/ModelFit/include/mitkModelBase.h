@@ -64,6 +64,8 @@ namespace mitk
     /** Type defining the time grid used be models.
      * @remark the model time grid has a resolution in sec and not like the time geometry which uses ms.*/
     typedef itk::Array<double> TimeGridType;
+    /** Partial derivatives of the signal; element [i][j] is the derivative of signal value j with respect to parameter i.*/
+    typedef itk::Array2D<double> SignalDerivativeType;
     typedef ModelTraitsInterface::ParameterNameType ParameterNameType;
     typedef ModelTraitsInterface::ParameterNamesType ParameterNamesType;
     typedef ModelTraitsInterface::ParametersSizeType ParametersSizeType;
@@ -172,10 +174,25 @@ namespace mitk
 
     ModelResultType GetSignal(const ParametersType& parameters) const;
 
+    /** Computes the signal and its partial derivatives with respect to the parameters, if the model
+     * implements them analytically (see ComputeModelfunctionDerivatives()).
+     * @param [out] signal The signal for the passed parameters.
+     * @param [out] derivatives Partial derivatives of the signal, see SignalDerivativeType.
+     * @return Returns false if the model does not provide analytical derivatives; then the derivatives
+     * have to be computed numerically by the caller.*/
+    bool GetSignalDerivatives(const ParametersType& parameters, ModelResultType& signal,
+                              SignalDerivativeType& derivatives) const;
+
   protected:
 
     virtual ModelResultType ComputeModelfunction(const ParametersType& parameters) const = 0;
 
+    /** Helper function called by GetSignalDerivatives(). Reimplement in derived classes that can compute
+     * the derivatives of the signal analytically and return true.
+     * @remark Default implementation returns false (no analytical derivatives).*/
+    virtual bool ComputeModelfunctionDerivatives(const ParametersType& parameters, ModelResultType& signal,
+                                                 SignalDerivativeType& derivatives) const;
+
     /** Member is called by GetSignal() before ComputeModelfunction(). It indicates if model is in a valid state and
      * ready to compute the signal. The default implementation checks nothing and always returns true.
      * Reimplement to realize special behavior for derived classes.
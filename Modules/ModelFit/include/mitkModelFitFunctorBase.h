@@ -21,6 +21,8 @@ See LICENSE.txt or http://www.mitk.org for details.
 
 #include <mitkVector.h>
 
+#include <memory>
+
 #include "mitkModelBase.h"
 #include "mitkSVModelFitCostFunction.h"
 
@@ -58,6 +60,23 @@ namespace mitk
     OutputPixelArrayType Compute(const InputPixelArrayType& value, const ModelBase* model,
                                  const ModelBase::ParametersType& initialParameters) const;
 
+    /** State of a fit functor that can be reused by consecutive fits of one thread (e.g. optimizer and cost function).
+     * A workspace is created by CreateWorkspace() and must not be shared between threads.*/
+    class MITKMODELFIT_EXPORT FitWorkspace
+    {
+    public:
+      virtual ~FitWorkspace();
+    };
+
+    /** Creates a workspace for Compute(). The default implementation returns a workspace without state,
+     * so every fit creates its optimizer anew.*/
+    virtual std::unique_ptr<FitWorkspace> CreateWorkspace() const;
+
+    /** Same as Compute() above, but the fit reuses the state stored in the passed workspace of the calling thread.
+     * @param workspace Workspace created by CreateWorkspace() of this functor. If it is null, nothing is reused.*/
+    OutputPixelArrayType Compute(const InputPixelArrayType& value, const ModelBase* model,
+                                 const ModelBase::ParametersType& initialParameters, FitWorkspace* workspace) const;
+
     /** Returns the number of outputs the fit functor will return if compute is called.
      * The number depends in parts on the passed model.
      * @exception Exception will be thrown if no valid model is passed.*/
@@ -123,6 +142,12 @@ namespace mitk
                                       const ModelBase::ParametersType& initialParameters,
                                       DebugParameterMapType& debugParameters) const = 0;
 
+    /** Internal Method called by Compute() if a workspace is passed. Same as DoModelFit(), but may reuse the state
+    stored in the workspace. The default implementation ignores the workspace and calls DoModelFit().*/
+    virtual ParametersType DoModelFitInWorkspace(const SignalType& value, const ModelBase* model,
+                                      const ModelBase::ParametersType& initialParameters,
+                                      DebugParameterMapType& debugParameters, FitWorkspace* workspace) const;
+
     /** Returns names of the depug parameters generated by the functor. Will be called by GetDebugParameterNames,
     if debug is activated. */
     virtual ParameterNamesType DefineDebugParameterNames()const = 0;
@@ -21,6 +21,7 @@
 
 #include <mitkImage.h>
 
+#include "mitkMaskedVoxelList.h"
 #include "mitkModelParameterizerBase.h"
 #include "mitkModelFitFunctorBase.h"
 #include "mitkParameterFitImageGeneratorBase.h"
@@ -40,6 +41,20 @@ namespace mitk
    * - criterion images: Images that encode the criterion value of the fitting strategy for the fitted parameters
    * - evaluation parameter images: Images that encode measures of additional evaluation cost functions defined by the user. (These were not part of the fitting strategy)
    * .
+   * Two execution modes are available:
+   * - default: The fit is done by an itk::MultiOutputNaryFunctorImageFilter that generates a model instance
+   * for every voxel.
+   * - batch fitting (see SetUseBatchFitting()): The voxels are fitted in blocks of consecutive voxels. The signals of
+   * a block are gathered from the dynamic image in one sweep over the time frames, every thread reuses one model
+   * instance, its work buffers and the fit functor workspace (e.g. optimizer and cost function, see
+   * ModelFitFunctorBase::CreateWorkspace()) for all voxels it fits, and the blocks are distributed dynamically over the threads.
+   * Optionally the fit of a voxel can be warm started with the result of its predecessor in the block.
+   * - voxel list (see SetUseVoxelList()): Like batch fitting, but the blocks are built from a precomputed list of
+   * the masked voxels (see MaskedVoxelList) instead of the whole image region. Every block contains only voxels that
+   * are fitted, so no thread idles on parts of the image outside the mask. The results are stored sparse (one value
+   * per masked voxel, see GetSparseResults()) and only converted into images if DensifyResults is set or
+   * GetDenseResultImage() is called.
+   * .
    */
 class MITKMODELFIT_EXPORT PixelBasedParameterFitImageGenerator: public ParameterFitImageGeneratorBase
 {
@@ -75,6 +90,55 @@ public:
     itkGetMacro(TimeGridByParameterizer, bool);
     itkBooleanMacro(TimeGridByParameterizer);
 
+    /** Activates the batch fitting mode (see class description). Default: false.*/
+    itkSetMacro(UseBatchFitting, bool);
+    itkGetConstMacro(UseBatchFitting, bool);
+    itkBooleanMacro(UseBatchFitting);
+
+    /** Number of consecutive voxels that are fitted together in the batch fitting mode. Default: 256.*/
+    itkSetMacro(BatchSize, unsigned int);
+    itkGetConstMacro(BatchSize, unsigned int);
+
+    /** If set in the batch fitting mode, the fit of a voxel starts at the fitted parameters of the preceding
+    voxel of the block instead of the initial parameterization of the parameterizer. Neighbouring voxels have
+    similar parameters in general, so less iterations are needed. Results may differ from the default mode if the
+    cost function has several local minima. Default: false.*/
+    itkSetMacro(WarmStart, bool);
+    itkGetConstMacro(WarmStart, bool);
+    itkBooleanMacro(WarmStart);
+
+    /** Activates the voxel list mode (see class description). The batch size and warm start settings are used
+    as in the batch fitting mode. Default: false.*/
+    itkSetMacro(UseVoxelList, bool);
+    itkGetConstMacro(UseVoxelList, bool);
+    itkBooleanMacro(UseVoxelList);
+
+    /** Only relevant in the voxel list mode. If set, the sparse results are converted into the result images
+    after the fit. If not set, the result image maps stay empty and images of single results can be generated on
+    demand via GetDenseResultImage(). Default: true.*/
+    itkSetMacro(DensifyResults, bool);
+    itkGetConstMacro(DensifyResults, bool);
+    itkBooleanMacro(DensifyResults);
+
+    using SparseResultMapType = std::map<ParameterNameType, std::vector<ParameterImagePixelType> >;
+
+    /** Returns the results of the last fit in the voxel list mode. The values of every result are ordered like the
+    voxels of GetVoxelList().*/
+    const SparseResultMapType& GetSparseResults() const
+    {
+      return m_SparseResults;
+    };
+
+    /** Returns the list of masked voxels used by the last fit in the voxel list mode.*/
+    itkGetConstObjectMacro(VoxelList, MaskedVoxelList);
+
+    /** Generates the image of a result (parameter, derived parameter, criterion or evaluation parameter) of the
+    last fit in the voxel list mode. Voxels outside the mask are 0.*/
+    Image::Pointer GetDenseResultImage(const ParameterNameType& name) const;
+
+    /** Returns the number of fitted voxels per second of the last fit.*/
+    itkGetConstMacro(VoxelsPerSecond, double);
+
     virtual double GetProgress() const override;
 
     virtual ParameterNamesType GetParameterNames() const override;
@@ -86,7 +150,8 @@ public:
     virtual ParameterNamesType GetEvaluationParameterNames() const override;
 
 protected:
-  PixelBasedParameterFitImageGenerator() : m_Progress(0), m_TimeGridByParameterizer(false)
+  PixelBasedParameterFitImageGenerator() : m_Progress(0), m_TimeGridByParameterizer(false), m_UseBatchFitting(false),
+    m_BatchSize(256), m_WarmStart(false), m_VoxelsPerSecond(0), m_UseVoxelList(false), m_DensifyResults(true)
   {
     m_InternalMask = nullptr;
     m_Mask = nullptr;
@@ -98,9 +163,18 @@ protected:
     template <typename TPixel, unsigned int VDim>
     void DoParameterFit(itk::Image<TPixel, VDim>* image);
 
+    template <typename TPixel, unsigned int VDim>
+    void DoBatchParameterFit(itk::Image<TPixel, VDim>* image);
+
     template <typename TPixel, unsigned int VDim>
     void DoPrepareMask(itk::Image<TPixel, VDim>* image);
 
+    /** Generates the voxel list for the passed mask buffer, if the current list is outdated.*/
+    void PrepareVoxelList(const unsigned char* maskBuffer, size_t numberOfVoxels);
+
+    /** Sets the default time grid of the parameterizer or checks it against the dynamic image.*/
+    void PrepareTimeGrid();
+
     void onFitProgressEvent(::itk::Object* caller, const ::itk::EventObject& eventObject);
 
     virtual bool HasOutdatedResult() const;
@@ -127,6 +201,22 @@ private:
     /**Indicates if the time grid defined in the parameterizer should be used (True)
     or if the filter should extract the time grid from the input image (False).*/
     bool m_TimeGridByParameterizer;
+
+    bool m_UseBatchFitting;
+    unsigned int m_BatchSize;
+    bool m_WarmStart;
+    double m_VoxelsPerSecond;
+
+    bool m_UseVoxelList;
+    bool m_DensifyResults;
+    MaskedVoxelList::Pointer m_VoxelList;
+    /** Mask m_VoxelList was generated from (null if it contains all voxels).*/
+    Image::ConstPointer m_VoxelListMask;
+
+    using SparseResultReferenceImageType = itk::Image<ParameterImagePixelType, 3>;
+    /** Geometry of the dense result images (not allocated).*/
+    SparseResultReferenceImageType::Pointer m_SparseResultReference;
+    SparseResultMapType m_SparseResults;
 };
 
 }
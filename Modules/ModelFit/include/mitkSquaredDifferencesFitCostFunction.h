@@ -43,6 +43,9 @@ public:
 protected:
 
     virtual MeasureType CalcMeasure(const ParametersType &parameters, const SignalType& signal) const;
+
+    virtual bool HasMeasureSignalDerivative() const override;
+    virtual MeasureType CalcMeasureSignalDerivative(const ParametersType &parameters, const SignalType& signal) const override;
 	
     SquaredDifferencesFitCostFunction()
     {
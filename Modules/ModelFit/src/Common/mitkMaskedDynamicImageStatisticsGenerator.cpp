@@ -21,7 +21,14 @@ See LICENSE.txt or http://www.mitk.org for details.
 #include "mitkImageCast.h"
 #include "itkMaskedNaryStatisticsImageFilter.h"
 
-mitk::MaskedDynamicImageStatisticsGenerator::MaskedDynamicImageStatisticsGenerator()
+#include <algorithm>
+#include <cmath>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+mitk::MaskedDynamicImageStatisticsGenerator::MaskedDynamicImageStatisticsGenerator() : m_UseVoxelList(false)
 {
   m_Mask = NULL;
   m_DynamicImage = NULL;
@@ -141,6 +148,140 @@ void mitk::MaskedDynamicImageStatisticsGenerator::DoCalculateStatistics(const it
   this->m_GenerationTimeStamp.Modified();
 }
 
+template <typename TPixel, unsigned int VDim>
+void mitk::MaskedDynamicImageStatisticsGenerator::DoCalculateStatisticsByVoxelList(const itk::Image<TPixel, VDim>* image)
+{
+  typedef itk::NumericTraits<TPixel> PixelTraits;
+
+  const typename itk::Image<TPixel, VDim>::SizeType imageSize = image->GetBufferedRegion().GetSize();
+  const unsigned int timeSteps = imageSize[VDim - 1];
+  size_t numberOfVoxels = 1;
+  for (unsigned int i = 0; i < VDim - 1; ++i)
+  {
+    numberOfVoxels *= imageSize[i];
+  }
+
+  const unsigned short* maskBuffer = nullptr;
+  if (this->m_InternalMask.IsNotNull())
+  {
+    const InternalMaskType::SizeType maskSize = this->m_InternalMask->GetBufferedRegion().GetSize();
+    for (unsigned int i = 0; i < VDim - 1; ++i)
+    {
+      if (maskSize[i] != imageSize[i])
+      {
+        mitkThrow() << "Cannot generate statistics by voxel list. Mask does not cover the dynamic image. Mask size: " << maskSize << "; image size: " << imageSize;
+      }
+    }
+    maskBuffer = this->m_InternalMask->GetBufferPointer();
+  }
+
+  //the list only depends on the mask, so it is reused as long as the mask is unchanged
+  if (this->m_VoxelList.IsNull() || this->m_VoxelList->GetNumberOfRegionVoxels() != numberOfVoxels
+    || this->m_VoxelListMask.GetPointer() != this->m_Mask.GetPointer()
+    || (this->m_Mask.IsNotNull() && this->m_Mask->GetMTime() > this->m_VoxelList->GetMTime()))
+  {
+    this->m_VoxelList = MaskedVoxelList::New();
+    this->m_VoxelList->Initialize(maskBuffer, numberOfVoxels);
+    this->m_VoxelListMask = this->m_Mask;
+  }
+
+  const MaskedVoxelList::VoxelOffsetVectorType& offsets = this->m_VoxelList->GetOffsets();
+
+  if (offsets.empty())
+  {
+    //no voxel is masked; report zeros instead of dividing by the voxel count
+    MITK_WARN << "Mask of the dynamic image statistics is empty. All statistics are set to 0.";
+    m_Maximum.SetSize(timeSteps);
+    m_Maximum.Fill(0);
+    m_Minimum.SetSize(timeSteps);
+    m_Minimum.Fill(0);
+    m_Mean.SetSize(timeSteps);
+    m_Mean.Fill(0);
+    m_Sigma.SetSize(timeSteps);
+    m_Sigma.Fill(0);
+    m_Variance.SetSize(timeSteps);
+    m_Variance.Fill(0);
+    m_Sum.SetSize(timeSteps);
+    m_Sum.Fill(0);
+
+    this->m_GenerationTimeStamp.Modified();
+    return;
+  }
+
+  const TPixel* dynamicBuffer = image->GetBufferPointer();
+
+  std::vector<double> sum(timeSteps, 0.0);
+  std::vector<double> sumOfSquares(timeSteps, 0.0);
+  std::vector<TPixel> minimum(timeSteps, PixelTraits::max());
+  std::vector<TPixel> maximum(timeSteps, PixelTraits::NonpositiveMin());
+
+#pragma omp parallel
+  {
+    MaskedVoxelList::VoxelOffsetType chunkBegin = 0;
+    MaskedVoxelList::VoxelOffsetType chunkEnd = 0;
+#ifdef _OPENMP
+    this->m_VoxelList->GetChunk(omp_get_thread_num(), omp_get_num_threads(), chunkBegin, chunkEnd);
+#else
+    this->m_VoxelList->GetChunk(0, 1, chunkBegin, chunkEnd);
+#endif
+
+    std::vector<double> threadSum(timeSteps, 0.0);
+    std::vector<double> threadSumOfSquares(timeSteps, 0.0);
+    std::vector<TPixel> threadMinimum(timeSteps, PixelTraits::max());
+    std::vector<TPixel> threadMaximum(timeSteps, PixelTraits::NonpositiveMin());
+
+    //voxel v of frame t is stored at t*numberOfVoxels+v
+    for (unsigned int t = 0; t < timeSteps; ++t)
+    {
+      const TPixel* frameValues = dynamicBuffer + t * numberOfVoxels;
+      for (MaskedVoxelList::VoxelOffsetType pos = chunkBegin; pos < chunkEnd; ++pos)
+      {
+        const TPixel value = frameValues[offsets[pos]];
+        const double realValue = static_cast<double>(value);
+        threadSum[t] += realValue;
+        threadSumOfSquares[t] += realValue * realValue;
+        threadMinimum[t] = std::min(threadMinimum[t], value);
+        threadMaximum[t] = std::max(threadMaximum[t], value);
+      }
+    }
+
+#pragma omp critical
+    {
+      for (unsigned int t = 0; t < timeSteps; ++t)
+      {
+        sum[t] += threadSum[t];
+        sumOfSquares[t] += threadSumOfSquares[t];
+        minimum[t] = std::min(minimum[t], threadMinimum[t]);
+        maximum[t] = std::max(maximum[t], threadMaximum[t]);
+      }
+    }
+  }
+
+  m_Maximum.SetSize(timeSteps);
+  m_Minimum.SetSize(timeSteps);
+  m_Mean.SetSize(timeSteps);
+  m_Sigma.SetSize(timeSteps);
+  m_Variance.SetSize(timeSteps);
+  m_Sum.SetSize(timeSteps);
+
+  //same estimators as itk::MaskedStatisticsImageFilter
+  const double count = static_cast<double>(offsets.size());
+  for (unsigned int t = 0; t < timeSteps; ++t)
+  {
+    //a single voxel has no spread
+    const double variance = count > 1 ? (sumOfSquares[t] - (sum[t] * sum[t] / count)) / (count - 1) : 0.0;
+
+    m_Maximum.SetElement(t, maximum[t]);
+    m_Minimum.SetElement(t, minimum[t]);
+    m_Mean.SetElement(t, sum[t] / count);
+    m_Sigma.SetElement(t, std::sqrt(variance));
+    m_Variance.SetElement(t, variance);
+    m_Sum.SetElement(t, sum[t]);
+  }
+
+  this->m_GenerationTimeStamp.Modified();
+}
+
 void mitk::MaskedDynamicImageStatisticsGenerator::Generate()
 {
   if(this->m_Mask.IsNotNull())
@@ -159,7 +300,14 @@ void mitk::MaskedDynamicImageStatisticsGenerator::Generate()
     this->m_InternalMask = NULL;
   }
 
-  AccessFixedDimensionByItk(m_DynamicImage, mitk::MaskedDynamicImageStatisticsGenerator::DoCalculateStatistics, 4);
+  if (this->m_UseVoxelList)
+  {
+    AccessFixedDimensionByItk(m_DynamicImage, mitk::MaskedDynamicImageStatisticsGenerator::DoCalculateStatisticsByVoxelList, 4);
+  }
+  else
+  {
+    AccessFixedDimensionByItk(m_DynamicImage, mitk::MaskedDynamicImageStatisticsGenerator::DoCalculateStatistics, 4);
+  }
 }
 
 void
@@ -0,0 +1,54 @@
+/*===================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center,
+Division of Medical and Biological Informatics.
+All rights reserved.
+
+This software is distributed WITHOUT ANY WARRANTY; without
+even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE.
+
+See LICENSE.txt or http://www.mitk.org for details.
+
+===================================================================*/
+
+#include "mitkMaskedVoxelList.h"
+
+mitk::MaskedVoxelList::MaskedVoxelList() : m_NumberOfRegionVoxels(0)
+{
+}
+
+mitk::MaskedVoxelList::~MaskedVoxelList()
+{
+}
+
+mitk::MaskedVoxelList::VoxelOffsetType mitk::MaskedVoxelList::GetNumberOfVoxels() const
+{
+  return m_Offsets.size();
+}
+
+void mitk::MaskedVoxelList::GetChunk(unsigned int chunk, unsigned int numberOfChunks, VoxelOffsetType& begin,
+  VoxelOffsetType& end) const
+{
+  if (numberOfChunks == 0 || chunk >= numberOfChunks)
+  {
+    itkExceptionMacro("Invalid chunk requested. Chunk: " << chunk << "; number of chunks: " << numberOfChunks);
+  }
+
+  const VoxelOffsetType size = m_Offsets.size() / numberOfChunks;
+  const VoxelOffsetType remainder = m_Offsets.size() % numberOfChunks;
+
+  //the first (remainder) chunks get one additional voxel
+  begin = chunk * size + std::min<VoxelOffsetType>(chunk, remainder);
+  end = begin + size + (chunk < remainder ? 1 : 0);
+}
+
+void mitk::MaskedVoxelList::PrintSelf(std::ostream& os, ::itk::Indent indent) const
+{
+  Superclass::PrintSelf(os, indent);
+
+  os << indent << "Number of voxels: " << m_Offsets.size() << std::endl;
+  os << indent << "Number of region voxels: " << m_NumberOfRegionVoxels << std::endl;
+}
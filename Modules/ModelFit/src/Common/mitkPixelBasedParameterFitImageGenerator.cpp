@@ -25,6 +25,15 @@ See LICENSE.txt or http://www.mitk.org for details.
 
 #include "mitkExtractTimeGrid.h"
 
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
 void
   mitk::PixelBasedParameterFitImageGenerator::
   onFitProgressEvent(::itk::Object* caller, const ::itk::EventObject& /*eventObject*/)
@@ -112,19 +121,7 @@ void
     fitFilter->SetInput(i,frameImage);
   }
 
-  ModelBaseType::TimeGridType timeGrid = ExtractTimeGrid(m_DynamicImage);
-  if (m_TimeGridByParameterizer)
-  {
-    if (timeGrid.GetSize() != m_ModelParameterizer->GetDefaultTimeGrid().GetSize())
-    {
-      mitkThrow() << "Cannot do fitting. Filter is set to use default time grid of the parameterizer, but grid size does not match the number of input image frames. Grid size: " << m_ModelParameterizer->GetDefaultTimeGrid().GetSize() << "; frame count: " << timeGrid.GetSize();
-    }
-
-  }
-  else
-  {
-    this->m_ModelParameterizer->SetDefaultTimeGrid(timeGrid);
-  }
+  this->PrepareTimeGrid();
 
   ModelFitFunctorPolicy functor;
 
@@ -137,7 +134,18 @@ void
   }
 
   //generate the fits
+  const auto startTime = std::chrono::steady_clock::now();
   fitFilter->Update();
+  const std::chrono::duration<double> fitDuration = std::chrono::steady_clock::now() - startTime;
+
+  size_t numberOfFittedVoxels = fitFilter->GetOutput()->GetLargestPossibleRegion().GetNumberOfPixels();
+  if (this->m_InternalMask.IsNotNull())
+  {
+    const unsigned char* maskBuffer = this->m_InternalMask->GetBufferPointer();
+    const size_t numberOfMaskVoxels = this->m_InternalMask->GetBufferedRegion().GetNumberOfPixels();
+    numberOfFittedVoxels = numberOfMaskVoxels - std::count(maskBuffer, maskBuffer + numberOfMaskVoxels, 0);
+  }
+  this->m_VoxelsPerSecond = fitDuration.count() > 0 ? numberOfFittedVoxels / fitDuration.count() : 0;
 
   //convert the outputs into mitk images and fill the parameter image map
   ModelBaseType::Pointer refModel = this->m_ModelParameterizer->GenerateParameterizedModel();
@@ -162,6 +170,339 @@ void
   this->m_TempEvaluationResultMap.insert(debugMap.begin(), debugMap.end());
 }
 
+template <typename TPixel, unsigned int VDim>
+void
+  mitk::PixelBasedParameterFitImageGenerator::DoBatchParameterFit(itk::Image<TPixel, VDim>* image)
+{
+  using InputFrameImageType = itk::Image<TPixel, VDim-1>;
+  using ParameterImageType = itk::Image<ScalarType, VDim-1>;
+
+  this->PrepareTimeGrid();
+
+  //the outputs get the geometry of the first frame, like in the default mode
+  typename InputFrameImageType::Pointer frameImage;
+  mitk::ImageTimeSelector::Pointer imageTimeSelector = mitk::ImageTimeSelector::New();
+  imageTimeSelector->SetInput(this->m_DynamicImage);
+  imageTimeSelector->SetTimeNr(0);
+  imageTimeSelector->UpdateLargestPossibleRegion();
+  mitk::CastToItkImage(imageTimeSelector->GetOutput(), frameImage);
+
+  const typename InputFrameImageType::RegionType frameRegion = frameImage->GetLargestPossibleRegion();
+  const size_t numberOfVoxels = frameRegion.GetNumberOfPixels();
+  const size_t numberOfFrames = this->m_DynamicImage->GetTimeSteps();
+
+  if (image->GetBufferedRegion().GetNumberOfPixels() != numberOfVoxels * numberOfFrames)
+  {
+    mitkThrow() << "Cannot do batch fitting. Buffered region of the dynamic image does not match its frames. Buffered region: " << image->GetBufferedRegion();
+  }
+  //voxel v of frame t is stored at t*numberOfVoxels+v
+  const TPixel* dynamicBuffer = image->GetBufferPointer();
+
+  const unsigned char* maskBuffer = nullptr;
+  if (this->m_InternalMask.IsNotNull())
+  {
+    if (this->m_InternalMask->GetBufferedRegion().GetSize() != frameRegion.GetSize())
+    {
+      mitkThrow() << "Cannot do batch fitting. Mask is set but does not cover the dynamic image. Mask region: " << this->m_InternalMask->GetBufferedRegion() << "; frame region: " << frameRegion;
+    }
+    maskBuffer = this->m_InternalMask->GetBufferPointer();
+  }
+
+  //in the voxel list mode the tasks are the positions in the list of masked voxels, otherwise all voxels of the frame
+  const MaskedVoxelList::VoxelOffsetType* voxelOffsets = nullptr;
+  size_t numberOfTasks = numberOfVoxels;
+  if (this->m_UseVoxelList)
+  {
+    this->PrepareVoxelList(maskBuffer, numberOfVoxels);
+    voxelOffsets = this->m_VoxelList->GetOffsets().data();
+    numberOfTasks = this->m_VoxelList->GetNumberOfVoxels();
+    maskBuffer = nullptr; //all voxels of the list are masked
+  }
+
+  ModelBaseType::Pointer refModel = this->m_ModelParameterizer->GenerateParameterizedModel();
+  const unsigned int numberOfOutputs = this->m_FitFunctor->GetNumberOfOutputs(refModel);
+  const unsigned int numberOfParameters = refModel->GetNumberOfParameters();
+
+  //dense outputs are indexed by voxel offset, sparse outputs (voxel list mode) by list position
+  std::vector<typename ParameterImageType::Pointer> outputImages;
+  std::vector<std::vector<ScalarType> > sparseOutputs;
+  std::vector<ScalarType*> outputBuffers(numberOfOutputs);
+  if (this->m_UseVoxelList)
+  {
+    sparseOutputs.resize(numberOfOutputs, std::vector<ScalarType>(numberOfTasks, 0.0));
+    for (unsigned int i = 0; i < numberOfOutputs; ++i)
+    {
+      outputBuffers[i] = sparseOutputs[i].data();
+    }
+  }
+  else
+  {
+    outputImages.resize(numberOfOutputs);
+    for (unsigned int i = 0; i < numberOfOutputs; ++i)
+    {
+      outputImages[i] = ParameterImageType::New();
+      outputImages[i]->CopyInformation(frameImage);
+      outputImages[i]->SetRegions(frameRegion);
+      outputImages[i]->Allocate();
+      outputImages[i]->FillBuffer(0.0);
+      outputBuffers[i] = outputImages[i]->GetBufferPointer();
+    }
+  }
+
+  const ParameterizerType* parameterizer = this->m_ModelParameterizer;
+  const FitFunctorType* fitFunctor = this->m_FitFunctor;
+  const size_t batchSize = std::max<size_t>(this->m_BatchSize, 1);
+  const long numberOfBlocks = static_cast<long>((numberOfTasks + batchSize - 1) / batchSize);
+  const bool warmStart = this->m_WarmStart;
+
+  std::atomic<size_t> processedVoxels(0);
+  std::atomic<bool> failed(false);
+  std::string errorMessage;
+  long numberOfFittedVoxels = 0;
+
+  const auto startTime = std::chrono::steady_clock::now();
+
+#pragma omp parallel reduction(+:numberOfFittedVoxels)
+  {
+    //work space of the thread, reused for all its blocks
+    ModelBaseType::Pointer model;
+    std::vector<ScalarType> blockSignals(batchSize * numberOfFrames);
+    FitFunctorType::InputPixelArrayType signal(numberOfFrames);
+    ModelBaseType::ParametersType initialParameters;
+    const std::unique_ptr<FitFunctorType::FitWorkspace> fitWorkspace = fitFunctor->CreateWorkspace();
+
+#pragma omp for schedule(dynamic)
+    for (long block = 0; block < numberOfBlocks; ++block)
+    {
+      if (failed)
+      {
+        continue; //exceptions must not leave the parallel region, skip the remaining blocks
+      }
+
+      try
+      {
+        const size_t blockBegin = block * batchSize;
+        const size_t blockEnd = std::min(blockBegin + batchSize, numberOfTasks);
+
+        //gather the signals of the block, each frame is read in ascending voxel order
+        for (size_t t = 0; t < numberOfFrames; ++t)
+        {
+          const TPixel* frameValues = dynamicBuffer + t * numberOfVoxels;
+          for (size_t task = blockBegin; task < blockEnd; ++task)
+          {
+            const size_t v = voxelOffsets ? voxelOffsets[task] : task;
+            blockSignals[(task - blockBegin) * numberOfFrames + t] = frameValues[v];
+          }
+        }
+
+        bool hasPredecessor = false;
+        for (size_t task = blockBegin; task < blockEnd; ++task)
+        {
+          const size_t v = voxelOffsets ? voxelOffsets[task] : task;
+          if (maskBuffer && maskBuffer[v] == 0)
+          {
+            hasPredecessor = false;
+            continue;
+          }
+
+          const ParameterizerType::IndexType index = frameImage->ComputeIndex(v);
+          if (model.IsNull())
+          {
+            model = parameterizer->GenerateParameterizedModel(index);
+          }
+          else
+          {
+            //global static parameters and time grid are the same for all voxels, only update local ones
+            const ParameterizerType::StaticParameterMapType localParameters = parameterizer->GetLocalStaticParameters(index);
+            if (!localParameters.empty())
+            {
+              model->SetStaticParameters(localParameters, false);
+            }
+          }
+
+          if (!(warmStart && hasPredecessor))
+          {
+            initialParameters = parameterizer->GetInitialParameterization(index);
+          }
+
+          std::copy(blockSignals.begin() + (task - blockBegin) * numberOfFrames,
+            blockSignals.begin() + (task - blockBegin + 1) * numberOfFrames, signal.begin());
+
+          const FitFunctorType::OutputPixelArrayType result = fitFunctor->Compute(signal, model, initialParameters, fitWorkspace.get());
+
+          if (result.size() != numberOfOutputs)
+          {
+            mitkThrow() << "Error. Number of fit results do not equal number of outputs. Number of results: " << result.size() << "; needed output number:" << numberOfOutputs;
+          }
+
+          for (unsigned int i = 0; i < numberOfOutputs; ++i)
+          {
+            outputBuffers[i][task] = result[i];
+          }
+
+          if (warmStart)
+          {
+            hasPredecessor = true;
+            for (unsigned int i = 0; i < numberOfParameters; ++i)
+            {
+              hasPredecessor = hasPredecessor && std::isfinite(result[i]);
+              initialParameters[i] = result[i];
+            }
+          }
+          ++numberOfFittedVoxels;
+        }
+
+        const size_t processed = processedVoxels += (blockEnd - blockBegin);
+#ifdef _OPENMP
+        if (omp_get_thread_num() == 0)
+#endif
+        {
+          this->m_Progress = static_cast<double>(processed) / numberOfTasks;
+          this->InvokeEvent(::itk::ProgressEvent());
+        }
+      }
+      catch (const std::exception& e)
+      {
+#pragma omp critical
+        {
+          errorMessage = e.what();
+        }
+        failed = true;
+      }
+    }
+  }
+
+  if (failed)
+  {
+    mitkThrow() << "Error while batch fitting the dynamic image: " << errorMessage;
+  }
+
+  const std::chrono::duration<double> fitDuration = std::chrono::steady_clock::now() - startTime;
+  this->m_VoxelsPerSecond = fitDuration.count() > 0 ? numberOfFittedVoxels / fitDuration.count() : 0;
+  this->m_Progress = 1.0;
+  this->InvokeEvent(::itk::ProgressEvent());
+
+  //store the outputs in the same order as the default mode
+  ModelFitFunctorBase::ParameterNamesType paramNames = refModel->GetParameterNames();
+  ModelFitFunctorBase::ParameterNamesType derivedParamNames = refModel->GetDerivedParameterNames();
+  ModelFitFunctorBase::ParameterNamesType criterionNames = this->m_FitFunctor->GetCriterionNames();
+  ModelFitFunctorBase::ParameterNamesType evaluationParamNames = this->m_FitFunctor->GetEvaluationParameterNames();
+  ModelFitFunctorBase::ParameterNamesType debugParamNames = this->m_FitFunctor->GetDebugParameterNames();
+
+  if (numberOfOutputs != (paramNames.size() + derivedParamNames.size() + criterionNames.size() + evaluationParamNames.size() + debugParamNames.size()))
+  {
+    mitkThrow() << "Error while generating fitted parameter images. Number of fit outputs does not match expected parameter number. Output size: " << numberOfOutputs;
+  }
+
+  if (this->m_UseVoxelList)
+  {
+    //keep the results sparse; images are only generated if requested
+    this->m_SparseResults.clear();
+    this->m_SparseResultReference = SparseResultReferenceImageType::New();
+    this->m_SparseResultReference->CopyInformation(frameImage);
+    this->m_SparseResultReference->SetRegions(frameRegion);
+
+    size_t pos = 0;
+    for (const auto* names : { &paramNames, &derivedParamNames, &criterionNames, &evaluationParamNames, &debugParamNames })
+    {
+      for (const auto& name : *names)
+      {
+        this->m_SparseResults[name].swap(sparseOutputs[pos++]);
+      }
+    }
+  }
+
+  auto storeImages = [this, &outputImages](const ModelFitFunctorBase::ParameterNamesType& names, size_t& pos)
+  {
+    ParameterImageMapType result;
+    for (const auto& name : names)
+    {
+      if (this->m_UseVoxelList)
+      {
+        if (this->m_DensifyResults)
+        {
+          result.insert(std::make_pair(name, this->GetDenseResultImage(name)));
+        }
+      }
+      else
+      {
+        mitk::Image::Pointer paramImage = mitk::Image::New();
+        mitk::CastToMitkImage(outputImages[pos], paramImage);
+        result.insert(std::make_pair(name, paramImage));
+      }
+      ++pos;
+    }
+    return result;
+  };
+
+  size_t resultPos = 0;
+  this->m_TempResultMap = storeImages(paramNames, resultPos);
+  this->m_TempDerivedResultMap = storeImages(derivedParamNames, resultPos);
+  this->m_TempCriterionResultMap = storeImages(criterionNames, resultPos);
+  this->m_TempEvaluationResultMap = storeImages(evaluationParamNames, resultPos);
+  //also add debug params (if generated) to the evaluation result map
+  ParameterImageMapType debugMap = storeImages(debugParamNames, resultPos);
+  this->m_TempEvaluationResultMap.insert(debugMap.begin(), debugMap.end());
+}
+
+void
+  mitk::PixelBasedParameterFitImageGenerator::PrepareVoxelList(const unsigned char* maskBuffer, size_t numberOfVoxels)
+{
+  //the list only depends on the mask, so it is reused as long as the mask is unchanged
+  bool outdated = this->m_VoxelList.IsNull() || this->m_VoxelList->GetNumberOfRegionVoxels() != numberOfVoxels
+    || this->m_VoxelListMask.GetPointer() != this->m_Mask.GetPointer();
+
+  if (!outdated && this->m_Mask.IsNotNull() && this->m_Mask->GetMTime() > this->m_VoxelList->GetMTime())
+  {
+    outdated = true;
+  }
+
+  if (outdated)
+  {
+    this->m_VoxelList = MaskedVoxelList::New();
+    this->m_VoxelList->Initialize(maskBuffer, numberOfVoxels);
+    this->m_VoxelListMask = this->m_Mask;
+  }
+}
+
+mitk::Image::Pointer
+  mitk::PixelBasedParameterFitImageGenerator::GetDenseResultImage(const ParameterNameType& name) const
+{
+  auto finding = this->m_SparseResults.find(name);
+  if (finding == this->m_SparseResults.end() || this->m_SparseResultReference.IsNull() || this->m_VoxelList.IsNull())
+  {
+    mitkThrow() << "Cannot generate dense result image. No sparse result available for the parameter: " << name;
+  }
+
+  SparseResultReferenceImageType::Pointer denseImage = SparseResultReferenceImageType::New();
+  denseImage->CopyInformation(this->m_SparseResultReference);
+  denseImage->SetRegions(this->m_SparseResultReference->GetLargestPossibleRegion());
+  denseImage->Allocate();
+  this->m_VoxelList->Densify(finding->second, denseImage->GetBufferPointer());
+
+  mitk::Image::Pointer result = mitk::Image::New();
+  mitk::CastToMitkImage(denseImage, result);
+  return result;
+}
+
+void
+  mitk::PixelBasedParameterFitImageGenerator::PrepareTimeGrid()
+{
+  ModelBaseType::TimeGridType timeGrid = ExtractTimeGrid(m_DynamicImage);
+  if (m_TimeGridByParameterizer)
+  {
+    if (timeGrid.GetSize() != m_ModelParameterizer->GetDefaultTimeGrid().GetSize())
+    {
+      mitkThrow() << "Cannot do fitting. Filter is set to use default time grid of the parameterizer, but grid size does not match the number of input image frames. Grid size: " << m_ModelParameterizer->GetDefaultTimeGrid().GetSize() << "; frame count: " << timeGrid.GetSize();
+    }
+
+  }
+  else
+  {
+    this->m_ModelParameterizer->SetDefaultTimeGrid(timeGrid);
+  }
+}
+
 bool
   mitk::PixelBasedParameterFitImageGenerator::HasOutdatedResult() const
 {
@@ -228,7 +569,14 @@ void mitk::PixelBasedParameterFitImageGenerator::DoFitAndGetResults(ParameterIma
     this->m_InternalMask = nullptr;
   }
 
-  AccessFixedDimensionByItk(m_DynamicImage, mitk::PixelBasedParameterFitImageGenerator::DoParameterFit, 4);
+  if (this->m_UseBatchFitting || this->m_UseVoxelList)
+  {
+    AccessFixedDimensionByItk(m_DynamicImage, mitk::PixelBasedParameterFitImageGenerator::DoBatchParameterFit, 4);
+  }
+  else
+  {
+    AccessFixedDimensionByItk(m_DynamicImage, mitk::PixelBasedParameterFitImageGenerator::DoParameterFit, 4);
+  }
 
   parameterImages = this->m_TempResultMap;
   derivedParameterImages = this->m_TempDerivedResultMap;
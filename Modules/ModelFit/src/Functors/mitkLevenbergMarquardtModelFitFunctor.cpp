@@ -31,6 +31,17 @@ mitk::LevenbergMarquardtModelFitFunctor::
 ~LevenbergMarquardtModelFitFunctor()
 {};
 
+mitk::LevenbergMarquardtModelFitFunctor::LevenbergMarquardtFitWorkspace::
+LevenbergMarquardtFitWorkspace() : m_NumberOfParameters(0), m_NumberOfValues(0)
+{};
+
+std::unique_ptr<mitk::ModelFitFunctorBase::FitWorkspace>
+mitk::LevenbergMarquardtModelFitFunctor::
+CreateWorkspace() const
+{
+  return std::unique_ptr<FitWorkspace>(new LevenbergMarquardtFitWorkspace());
+};
+
 mitk::LevenbergMarquardtModelFitFunctor::ParameterNamesType
 mitk::LevenbergMarquardtModelFitFunctor::
 GetCriterionNames() const
@@ -106,6 +117,23 @@ DoModelFit(const SignalType& value, const ModelBase* model,
            const ModelBase::ParametersType& initialParameters,
            DebugParameterMapType& debugParameters) const
 {
+  //a fit without workspace uses a new optimizer and cost function
+  LevenbergMarquardtFitWorkspace workspace;
+  return this->DoModelFitInWorkspace(value, model, initialParameters, debugParameters, &workspace);
+};
+
+mitk::LevenbergMarquardtModelFitFunctor::ParametersType
+mitk::LevenbergMarquardtModelFitFunctor::
+DoModelFitInWorkspace(const SignalType& value, const ModelBase* model,
+           const ModelBase::ParametersType& initialParameters,
+           DebugParameterMapType& debugParameters, FitWorkspace* workspace) const
+{
+  auto* lmWorkspace = dynamic_cast<LevenbergMarquardtFitWorkspace*>(workspace);
+  if (!lmWorkspace)
+  {
+    mitkThrow() << "Cannot compute fit. Passed workspace was not created by this fit functor.";
+  }
+
     std::chrono::time_point<std::chrono::system_clock> startTime;
     startTime = std::chrono::system_clock::now();
   ::itk::LevenbergMarquardtOptimizer::ParametersType internalInitParam = initialParameters;
@@ -127,11 +155,40 @@ DoModelFit(const SignalType& value, const ModelBase* model,
     scales.Fill(1.0);
   }
 
-  mitk::MVModelFitCostFunction::Pointer metric = this->GenerateCostFunction(value, model);
+  if (lmWorkspace->m_CostFunction.IsNull())
+  {
+    lmWorkspace->m_CostFunction = this->GenerateCostFunction(value, model);
+    lmWorkspace->m_Optimizer = ::itk::LevenbergMarquardtOptimizer::New();
+  }
+  else
+  {
+    //only model and signal differ between the fits of a thread, so the cost function is reconfigured
+    lmWorkspace->m_CostFunction->SetModel(model);
+    lmWorkspace->m_CostFunction->SetSample(value);
+
+    auto* decorator = dynamic_cast<::mitk::MVConstrainedCostFunctionDecorator*>(lmWorkspace->m_CostFunction.GetPointer());
+    if (decorator)
+    {
+      //break constness to reconfigure the wrapped cost function. It was generated for this workspace
+      //and is only used by the thread owning it.
+      auto* wrapped = const_cast<MVModelFitCostFunction*>(decorator->GetWrappedCostFunction());
+      wrapped->SetModel(model);
+      wrapped->SetSample(value);
+      decorator->ResetEvaluationStatistics();
+    }
+  }
 
-  ::itk::LevenbergMarquardtOptimizer::Pointer optimizer = ::itk::LevenbergMarquardtOptimizer::New();
+  mitk::MVModelFitCostFunction::Pointer metric = lmWorkspace->m_CostFunction;
+  ::itk::LevenbergMarquardtOptimizer::Pointer optimizer = lmWorkspace->m_Optimizer;
 
-  optimizer->SetCostFunction(metric);
+  //setting the cost function rebuilds the internal vnl optimizer, which is only needed if the dimensions change
+  if (metric->GetNumberOfParameters() != lmWorkspace->m_NumberOfParameters ||
+      metric->GetNumberOfValues() != lmWorkspace->m_NumberOfValues)
+  {
+    optimizer->SetCostFunction(metric);
+    lmWorkspace->m_NumberOfParameters = metric->GetNumberOfParameters();
+    lmWorkspace->m_NumberOfValues = metric->GetNumberOfValues();
+  }
   optimizer->SetEpsilonFunction(m_Epsilon);
   optimizer->SetGradientTolerance(m_GradientTolerance);
   optimizer->SetNumberOfIterations(m_Iterations);
@@ -40,6 +40,28 @@ void mitk::MVModelFitCostFunction::GetDerivative (const ParametersType &paramete
 
   derivative.SetSize(paramCount,m_Sample.Size());
 
+  if (this->HasMeasureSignalDerivative())
+  {
+    ModelBase::ModelResultType signal;
+    ModelBase::SignalDerivativeType signalDerivatives;
+
+    if (m_Model->GetSignalDerivatives(parameters, signal, signalDerivatives))
+    {
+      if(signal.GetSize() != m_Sample.GetSize()) itkExceptionMacro("Signal size does not matche sample size!");
+
+      MeasureType measureDerivative = CalcMeasureSignalDerivative(parameters, signal);
+
+      for ( ParametersType::SizeValueType i = 0; i < paramCount; i++ )
+      {
+        for(MeasureType::SizeValueType j = 0; j<measureCount; ++j)
+        {
+          derivative[i][j] = measureDerivative[j] * signalDerivatives[i][j];
+        }
+      }
+      return;
+    }
+  }
+
   for ( ParametersType::SizeValueType i = 0; i < paramCount; i++ )
   {
     ParametersType newParameters = parameters;
@@ -61,6 +83,16 @@ void mitk::MVModelFitCostFunction::GetDerivative (const ParametersType &paramete
 
 };
 
+bool mitk::MVModelFitCostFunction::HasMeasureSignalDerivative() const
+{
+  return false;
+}
+
+mitk::MVModelFitCostFunction::MeasureType mitk::MVModelFitCostFunction::CalcMeasureSignalDerivative(const ParametersType &/*parameters*/, const SignalType &/*signal*/) const
+{
+  itkExceptionMacro("Cost function does not implement the analytical derivative of the measure.");
+}
+
 unsigned int mitk::MVModelFitCostFunction::GetNumberOfParameters() const
 {
   return m_Model->GetNumberOfParameters();
@@ -16,10 +16,27 @@ See LICENSE.txt or http://www.mitk.org for details.
 
 #include "mitkModelFitFunctorBase.h"
 
+mitk::ModelFitFunctorBase::FitWorkspace::~FitWorkspace()
+{};
+
+std::unique_ptr<mitk::ModelFitFunctorBase::FitWorkspace>
+mitk::ModelFitFunctorBase::CreateWorkspace() const
+{
+  return std::unique_ptr<FitWorkspace>(new FitWorkspace());
+};
+
 mitk::ModelFitFunctorBase::OutputPixelArrayType
 mitk::ModelFitFunctorBase::
 Compute(const InputPixelArrayType& value, const ModelBase* model,
         const ModelBase::ParametersType& initialParameters) const
+{
+  return this->Compute(value, model, initialParameters, nullptr);
+};
+
+mitk::ModelFitFunctorBase::OutputPixelArrayType
+mitk::ModelFitFunctorBase::
+Compute(const InputPixelArrayType& value, const ModelBase* model,
+        const ModelBase::ParametersType& initialParameters, FitWorkspace* workspace) const
 {
   if (!model)
   {
@@ -46,7 +63,9 @@ Compute(const InputPixelArrayType& value, const ModelBase* model,
     debugNames = this->GetDebugParameterNames();
   }
 
-  ParametersType fittedParameters = DoModelFit(sample, model, initialParameters, debugParams);
+  ParametersType fittedParameters = workspace
+    ? DoModelFitInWorkspace(sample, model, initialParameters, debugParams, workspace)
+    : DoModelFit(sample, model, initialParameters, debugParams);
 
   OutputPixelArrayType derivedParameters = this->GetDerivedParameters(model, fittedParameters);
 
@@ -190,6 +209,14 @@ mitk::ModelFitFunctorBase::GetDebugParameterNames() const
   return result;
 };
 
+mitk::ModelFitFunctorBase::ParametersType
+mitk::ModelFitFunctorBase::DoModelFitInWorkspace(const SignalType& value, const ModelBase* model,
+    const ModelBase::ParametersType& initialParameters, DebugParameterMapType& debugParameters,
+    FitWorkspace* /*workspace*/) const
+{
+  return this->DoModelFit(value, model, initialParameters, debugParameters);
+};
+
 mitk::ModelFitFunctorBase::
 ModelFitFunctorBase() : m_DebugParameterMaps(false)
 {};
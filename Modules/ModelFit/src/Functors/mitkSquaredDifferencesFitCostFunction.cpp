@@ -28,3 +28,21 @@ mitk::SquaredDifferencesFitCostFunction::MeasureType mitk::SquaredDifferencesFit
 
   return measure;
 }
+
+bool mitk::SquaredDifferencesFitCostFunction::HasMeasureSignalDerivative() const
+{
+  return true;
+}
+
+mitk::SquaredDifferencesFitCostFunction::MeasureType mitk::SquaredDifferencesFitCostFunction::CalcMeasureSignalDerivative(const ParametersType &/*parameters*/, const SignalType &signal) const
+{
+  MeasureType derivative;
+  derivative.SetSize(signal.GetSize());
+
+  for(SignalType::size_type i=0; i<signal.GetSize(); ++i)
+  {
+    derivative[i] = 2 * (signal[i] - m_Sample[i]);
+  }
+
+  return derivative;
+}
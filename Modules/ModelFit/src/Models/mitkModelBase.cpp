@@ -150,6 +150,32 @@ mitk::ModelBase::ModelResultType mitk::ModelBase::GetSignal(const ParametersType
   return signal;
 }
 
+bool mitk::ModelBase::GetSignalDerivatives(const ParametersType& parameters, ModelResultType& signal,
+                                           SignalDerivativeType& derivatives) const
+{
+  if (parameters.size() != this->GetNumberOfParameters())
+  {
+    itkExceptionMacro("Passed parameter set has wrong size for model. Cannot evaluate model. Required size: "
+                      << this->GetNumberOfParameters() << "; passed parameters: " << parameters);
+  }
+
+  std::string error;
+
+  if (!ValidateModel(error))
+  {
+    itkExceptionMacro("Cannot evaluate model and return signal. Model is in an invalid state. Validation error: "
+                      << error);
+  }
+
+  return ComputeModelfunctionDerivatives(parameters, signal, derivatives);
+}
+
+bool mitk::ModelBase::ComputeModelfunctionDerivatives(const ParametersType& /*parameters*/,
+    ModelResultType& /*signal*/, SignalDerivativeType& /*derivatives*/) const
+{
+  return false;
+}
+
 bool mitk::ModelBase::ValidateModel(std::string& /*error*/) const
 {
   return true;
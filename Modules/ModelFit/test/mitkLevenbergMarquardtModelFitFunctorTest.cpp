@@ -85,5 +85,22 @@ int mitkLevenbergMarquardtModelFitFunctorTest(int  /*argc*/, char*[] /*argv[]*/)
   MITK_TEST_CONDITION_REQUIRED(mitk::Equal(-5, output[2], 1e-6, true) == true,
                                "Check derived parameter 1 (x-intercept) for sample 2.");
 
+  //Test consecutive fits reusing one workspace, they have to give the same results as independent fits
+  std::unique_ptr<mitk::ModelFitFunctorBase::FitWorkspace> workspace = testFunctor->CreateWorkspace();
+  CPPUNIT_ASSERT_MESSAGE("Check workspace creation.", workspace != nullptr);
+
+  for (int run = 0; run < 2; ++run)
+  {
+    ValueArrayType workspaceOutput = testFunctor->Compute(sample1, model, initParams, workspace.get());
+    MITK_TEST_CONDITION_REQUIRED(mitk::Equal(5, workspaceOutput[0], 1e-6, true) == true &&
+                                 mitk::Equal(0, workspaceOutput[1], 1e-6, true) == true,
+                                 "Check fitted parameters for sample 1 with reused workspace.");
+
+    workspaceOutput = testFunctor->Compute(sample2, model, initParams, workspace.get());
+    MITK_TEST_CONDITION_REQUIRED(mitk::Equal(2, workspaceOutput[0], 1e-6, true) == true &&
+                                 mitk::Equal(10, workspaceOutput[1], 1e-6, true) == true,
+                                 "Check fitted parameters for sample 2 with reused workspace.");
+  }
+
   MITK_TEST_END()
 }
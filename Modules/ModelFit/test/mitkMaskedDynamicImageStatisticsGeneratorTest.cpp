@@ -75,5 +75,48 @@ int mitkMaskedDynamicImageStatisticsGeneratorTest(int  /*argc*/, char*[] /*argv[
   CPPUNIT_ASSERT_MESSAGE("Check computed variance[0]",21.208791208791204 == variance[0]);
   CPPUNIT_ASSERT_MESSAGE("Check computed sum[0]",96.000000000000000 == sum[0]);
 
+  //Test voxel list mode, results must equal the filter based computation
+  generator->SetUseVoxelList(true);
+  generator->Generate();
+
+  MITK_TEST_CONDITION(10 == generator->GetMean().size(), "Check size of mean (voxel list)");
+  for (unsigned int i = 0; i < 10; ++i)
+  {
+    MITK_TEST_CONDITION(mitk::Equal(max[i], generator->GetMaximum()[i], 1e-10, true), "Check computed maximum[" << i << "] (voxel list)");
+    MITK_TEST_CONDITION(mitk::Equal(min[i], generator->GetMinimum()[i], 1e-10, true), "Check computed minimum[" << i << "] (voxel list)");
+    MITK_TEST_CONDITION(mitk::Equal(mean[i], generator->GetMean()[i], 1e-10, true), "Check computed mean[" << i << "] (voxel list)");
+    MITK_TEST_CONDITION(mitk::Equal(sig[i], generator->GetSigma()[i], 1e-10, true), "Check computed sigma[" << i << "] (voxel list)");
+    MITK_TEST_CONDITION(mitk::Equal(variance[i], generator->GetVariance()[i], 1e-10, true), "Check computed variance[" << i << "] (voxel list)");
+    MITK_TEST_CONDITION(mitk::Equal(sum[i], generator->GetSum()[i], 1e-10, true), "Check computed sum[" << i << "] (voxel list)");
+  }
+
+  //Test voxel list mode with an empty mask, statistics must be 0 instead of NaN
+  mitk::TestMaskType::Pointer emptyITKMask = mitk::TestMaskType::New();
+  mitk::TestMaskType::SizeType maskSize;
+  maskSize.Fill(3);
+  mitk::TestMaskType::RegionType maskRegion;
+  maskRegion.SetSize(maskSize);
+  emptyITKMask->SetRegions(maskRegion);
+  emptyITKMask->Allocate();
+  emptyITKMask->FillBuffer(0);
+
+  mitk::Image::Pointer emptyMask = mitk::Image::New();
+  emptyMask->InitializeByItk(emptyITKMask.GetPointer());
+  emptyMask->SetVolume(emptyITKMask->GetBufferPointer());
+
+  generator->SetMask(emptyMask);
+  generator->Generate();
+
+  MITK_TEST_CONDITION(10 == generator->GetMean().size(), "Check size of mean (empty voxel list)");
+  for (unsigned int i = 0; i < 10; ++i)
+  {
+    MITK_TEST_CONDITION(0 == generator->GetMaximum()[i], "Check computed maximum[" << i << "] (empty voxel list)");
+    MITK_TEST_CONDITION(0 == generator->GetMinimum()[i], "Check computed minimum[" << i << "] (empty voxel list)");
+    MITK_TEST_CONDITION(0 == generator->GetMean()[i], "Check computed mean[" << i << "] (empty voxel list)");
+    MITK_TEST_CONDITION(0 == generator->GetSigma()[i], "Check computed sigma[" << i << "] (empty voxel list)");
+    MITK_TEST_CONDITION(0 == generator->GetVariance()[i], "Check computed variance[" << i << "] (empty voxel list)");
+    MITK_TEST_CONDITION(0 == generator->GetSum()[i], "Check computed sum[" << i << "] (empty voxel list)");
+  }
+
   MITK_TEST_END()
 }
@@ -155,5 +155,82 @@ int mitkPixelBasedParameterFitImageGeneratorTest(int  /*argc*/, char*[] /*argv[]
     testValue = offsetAccessor2.GetPixelByIndex(testIndex6);
     MITK_TEST_CONDITION_REQUIRED(mitk::Equal(0,testValue, 1e-5, true)==true, "Check param #2 (offset) at index #6");
 
+    //Test batch fitting mode with mask set
+    generator->SetUseBatchFitting(true);
+    generator->SetBatchSize(4);
+    generator->SetWarmStart(true);
+
+    generator->Generate();
+
+    resultImages = generator->GetParameterImages();
+    derivedResultImages = generator->GetDerivedParameterImages();
+
+    CPPUNIT_ASSERT_MESSAGE("Check number of parameter images (batch fitting)", 2 == resultImages.size());
+    CPPUNIT_ASSERT_MESSAGE("Check number of derived parameter images (batch fitting)", 1 == derivedResultImages.size());
+    MITK_TEST_CONDITION(generator->GetVoxelsPerSecond() > 0, "Check fit throughput (batch fitting)");
+
+    mitk::ImagePixelReadAccessor<mitk::ScalarType,3> slopeAccessor3(resultImages["slope"]);
+    mitk::ImagePixelReadAccessor<mitk::ScalarType,3> offsetAccessor3(resultImages["offset"]);
+
+    testValue = slopeAccessor3.GetPixelByIndex(testIndex2);
+    MITK_TEST_CONDITION_REQUIRED(mitk::Equal(2000,testValue, 1e-4, true)==true, "Check param #1 (slope) at index #2 (batch fitting)");
+    testValue = slopeAccessor3.GetPixelByIndex(testIndex3);
+    MITK_TEST_CONDITION_REQUIRED(mitk::Equal(0,testValue, 1e-5, true)==true, "Check param #1 (slope) at index #3 (batch fitting)");
+    testValue = slopeAccessor3.GetPixelByIndex(testIndex4);
+    MITK_TEST_CONDITION_REQUIRED(mitk::Equal(8000,testValue, 1e-4, true)==true, "Check param #1 (slope) at index #4 (batch fitting)");
+    testValue = slopeAccessor3.GetPixelByIndex(testIndex5);
+    MITK_TEST_CONDITION_REQUIRED(mitk::Equal(4000,testValue, 1e-4, true)==true, "Check param #1 (slope) at index #5 (batch fitting)");
+
+    testValue = offsetAccessor3.GetPixelByIndex(testIndex2);
+    MITK_TEST_CONDITION_REQUIRED(mitk::Equal(10,testValue, 1e-5, true)==true, "Check param #2 (offset) at index #2 (batch fitting)");
+    testValue = offsetAccessor3.GetPixelByIndex(testIndex5);
+    MITK_TEST_CONDITION_REQUIRED(mitk::Equal(10,testValue, 1e-5, true)==true, "Check param #2 (offset) at index #5 (batch fitting)");
+    testValue = offsetAccessor3.GetPixelByIndex(testIndex6);
+    MITK_TEST_CONDITION_REQUIRED(mitk::Equal(0,testValue, 1e-5, true)==true, "Check param #2 (offset) at index #6 (batch fitting)");
+
+    //Test voxel list mode with mask set and sparse results
+    generator->SetUseBatchFitting(false);
+    generator->SetUseVoxelList(true);
+    generator->SetDensifyResults(false);
+
+    generator->Generate();
+
+    resultImages = generator->GetParameterImages();
+    CPPUNIT_ASSERT_MESSAGE("Check that no parameter images are generated (sparse voxel list)", resultImages.empty());
+
+    const mitk::MaskedVoxelList* voxelList = generator->GetVoxelList();
+    MITK_TEST_CONDITION_REQUIRED(voxelList != nullptr, "Check voxel list (voxel list mode)");
+    mitk::PixelBasedParameterFitImageGenerator::SparseResultMapType sparseResults = generator->GetSparseResults();
+    CPPUNIT_ASSERT_MESSAGE("Check number of sparse results (voxel list mode)", 3 <= sparseResults.size());
+    CPPUNIT_ASSERT_MESSAGE("Check size of sparse slope result (voxel list mode)", voxelList->GetNumberOfVoxels() == sparseResults["slope"].size());
+
+    mitk::Image::Pointer denseSlopeImage = generator->GetDenseResultImage("slope");
+    mitk::Image::Pointer denseOffsetImage = generator->GetDenseResultImage("offset");
+    mitk::ImagePixelReadAccessor<mitk::ScalarType,3> slopeAccessor4(denseSlopeImage);
+    mitk::ImagePixelReadAccessor<mitk::ScalarType,3> offsetAccessor4(denseOffsetImage);
+
+    testValue = slopeAccessor4.GetPixelByIndex(testIndex2);
+    MITK_TEST_CONDITION_REQUIRED(mitk::Equal(2000,testValue, 1e-4, true)==true, "Check param #1 (slope) at index #2 (voxel list)");
+    testValue = slopeAccessor4.GetPixelByIndex(testIndex3);
+    MITK_TEST_CONDITION_REQUIRED(mitk::Equal(0,testValue, 1e-5, true)==true, "Check param #1 (slope) at index #3 (voxel list)");
+    testValue = slopeAccessor4.GetPixelByIndex(testIndex4);
+    MITK_TEST_CONDITION_REQUIRED(mitk::Equal(8000,testValue, 1e-4, true)==true, "Check param #1 (slope) at index #4 (voxel list)");
+    testValue = slopeAccessor4.GetPixelByIndex(testIndex5);
+    MITK_TEST_CONDITION_REQUIRED(mitk::Equal(4000,testValue, 1e-4, true)==true, "Check param #1 (slope) at index #5 (voxel list)");
+
+    testValue = offsetAccessor4.GetPixelByIndex(testIndex2);
+    MITK_TEST_CONDITION_REQUIRED(mitk::Equal(10,testValue, 1e-5, true)==true, "Check param #2 (offset) at index #2 (voxel list)");
+    testValue = offsetAccessor4.GetPixelByIndex(testIndex6);
+    MITK_TEST_CONDITION_REQUIRED(mitk::Equal(0,testValue, 1e-5, true)==true, "Check param #2 (offset) at index #6 (voxel list)");
+
+    //densified results equal the images of the batch mode
+    generator->SetDensifyResults(true);
+    generator->Generate();
+    resultImages = generator->GetParameterImages();
+    CPPUNIT_ASSERT_MESSAGE("Check number of parameter images (densified voxel list)", 2 == resultImages.size());
+    mitk::ImagePixelReadAccessor<mitk::ScalarType,3> slopeAccessor5(resultImages["slope"]);
+    testValue = slopeAccessor5.GetPixelByIndex(testIndex5);
+    MITK_TEST_CONDITION_REQUIRED(mitk::Equal(4000,testValue, 1e-4, true)==true, "Check param #1 (slope) at index #5 (densified voxel list)");
+
   MITK_TEST_END()
 }
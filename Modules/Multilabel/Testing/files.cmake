@@ -6,3 +6,10 @@ set(MODULE_TESTS
     mitkLabelSetImageSurfaceStampFilterTest.cpp
 )
 
+if(MITK_ENABLE_RENDERING_TESTING)
+set(MODULE_TESTS
+  ${MODULE_TESTS}
+  mitkLabelSetImageVtkMapper2DTest.cpp
+  mitkLabelSetImageVtkMapper2DBenchmarkTest.cpp # timings of the mapper, rendered offscreen
+)
+endif()
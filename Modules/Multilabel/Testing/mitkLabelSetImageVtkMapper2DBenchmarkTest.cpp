@@ -0,0 +1,88 @@
+/*===================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center,
+Division of Medical and Biological Informatics.
+All rights reserved.
+
+This software is distributed WITHOUT ANY WARRANTY; without
+even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE.
+
+See LICENSE.txt or http://www.mitk.org for details.
+
+===================================================================*/
+
+#include <mitkImageGenerator.h>
+#include <mitkLabelSetImage.h>
+#include <mitkLabelSetImageVtkMapper2D.h>
+#include <mitkProperties.h>
+#include <mitkRenderingBenchmark.h>
+#include <mitkRenderingTestHelper.h>
+#include <mitkTestFixture.h>
+#include <mitkTestingMacros.h>
+
+#include <algorithm>
+
+/**
+ * @brief Rendering benchmark of the LabelSetImageVtkMapper2D with several layers, see mitk::RenderingBenchmark.
+ */
+class mitkLabelSetImageVtkMapper2DBenchmarkTestSuite : public mitk::TestFixture
+{
+  CPPUNIT_TEST_SUITE(mitkLabelSetImageVtkMapper2DBenchmarkTestSuite);
+  MITK_TEST(FourLayers_CompositeLayers);
+  MITK_TEST(FourLayers_TexturePerLayer);
+  CPPUNIT_TEST_SUITE_END();
+
+private:
+  mitk::LabelSetImage::Pointer m_LabelSetImage;
+
+  void Run(const std::string &name, bool compositeLayers)
+  {
+    mitk::DataNode::Pointer node = mitk::DataNode::New();
+    node->SetData(m_LabelSetImage);
+    mitk::LabelSetImageVtkMapper2D::SetDefaultProperties(node);
+    node->SetBoolProperty("labelset.composite layers", compositeLayers);
+
+    mitk::RenderingTestHelper renderingHelper(640, 480);
+    renderingHelper.SetMapperIDToRender2D();
+    mitk::RenderingBenchmark benchmark(renderingHelper);
+    benchmark.SetGenerateTimeFunction([](mitk::Mapper *mapper, mitk::BaseRenderer *renderer) -> itk::ModifiedTimeType {
+      auto *labelSetMapper = dynamic_cast<mitk::LabelSetImageVtkMapper2D *>(mapper);
+      if (labelSetMapper == nullptr)
+        return 0;
+      mitk::LabelSetImageVtkMapper2D::LocalStorage *localStorage = labelSetMapper->GetLocalStorage(renderer);
+      return std::max(localStorage->m_LastDataUpdateTime.GetMTime(), localStorage->m_LastPropertyUpdateTime.GetMTime());
+    });
+
+    mitk::RenderingBenchmark::Result result = benchmark.Run(name, node);
+    mitk::RenderingBenchmark::Print(result);
+    CPPUNIT_ASSERT(result.NumberOfFrames > 0);
+    // every measured update has to generate the slices again
+    CPPUNIT_ASSERT(result.NumberOfUpdates > 0);
+    CPPUNIT_ASSERT_EQUAL(result.NumberOfUpdates, result.NumberOfRegenerations);
+  }
+
+public:
+  void setUp() override
+  {
+    // every pixel of every layer is labeled with one of ten labels
+    m_LabelSetImage = mitk::LabelSetImage::New();
+    m_LabelSetImage->InitializeByLabeledImage(
+      mitk::ImageGenerator::GenerateRandomImage<mitk::Label::PixelType>(256, 256, 64, 1, 1, 1, 1, 10.0, 0.0));
+    for (int layer = 1; layer < 4; ++layer)
+    {
+      m_LabelSetImage->AddLayer(
+        mitk::ImageGenerator::GenerateRandomImage<mitk::Label::PixelType>(256, 256, 64, 1, 1, 1, 1, 10.0, 0.0));
+    }
+  }
+
+  void tearDown() override { m_LabelSetImage = nullptr; }
+
+  void FourLayers_CompositeLayers() { this->Run("LabelSetImageVtkMapper2D 4 layers, composite", true); }
+
+  void FourLayers_TexturePerLayer() { this->Run("LabelSetImageVtkMapper2D 4 layers, texture per layer", false); }
+};
+
+MITK_TEST_SUITE_REGISTRATION(mitkLabelSetImageVtkMapper2DBenchmark)
@@ -0,0 +1,146 @@
+/*===================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center,
+Division of Medical and Biological Informatics.
+All rights reserved.
+
+This software is distributed WITHOUT ANY WARRANTY; without
+even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE.
+
+See LICENSE.txt or http://www.mitk.org for details.
+
+===================================================================*/
+
+#include <mitkImageWriteAccessor.h>
+#include <mitkLabelSetImage.h>
+#include <mitkLabelSetImageVtkMapper2D.h>
+#include <mitkRenderingTestHelper.h>
+#include <mitkTestFixture.h>
+#include <mitkTestingMacros.h>
+
+#include <vtkImageData.h>
+
+#include <algorithm>
+
+namespace
+{
+  const mitk::Label::PixelType LabelValue = 1;
+}
+
+/**
+ * @brief Tests that label edits which only modify the lookup table of a label set (color, visibility)
+ * are shown by the composited texture of mitk::LabelSetImageVtkMapper2D.
+ */
+class mitkLabelSetImageVtkMapper2DTestSuite : public mitk::TestFixture
+{
+  CPPUNIT_TEST_SUITE(mitkLabelSetImageVtkMapper2DTestSuite);
+  MITK_TEST(CompositeLayers_RecolorLabel_UpdatesTexture);
+  MITK_TEST(CompositeLayers_HideLabel_UpdatesTexture);
+  CPPUNIT_TEST_SUITE_END();
+
+private:
+  mitk::LabelSetImage::Pointer m_LabelSetImage;
+  mitk::DataNode::Pointer m_Node;
+
+  // RGBA of the center pixel of the composited slice
+  void GetCompositeCenterPixel(mitk::RenderingTestHelper &renderingHelper, unsigned char rgba[4])
+  {
+    renderingHelper.Render();
+
+    mitk::BaseRenderer *renderer = mitk::BaseRenderer::GetInstance(renderingHelper.GetVtkRenderWindow());
+    auto *mapper = dynamic_cast<mitk::LabelSetImageVtkMapper2D *>(m_Node->GetMapper(renderer->GetMapperID()));
+    CPPUNIT_ASSERT(mapper != nullptr);
+
+    vtkImageData *composite = mapper->GetLocalStorage(renderer)->m_CompositeImage;
+    int extent[6];
+    composite->GetExtent(extent);
+    auto *pixel = static_cast<unsigned char *>(
+      composite->GetScalarPointer((extent[0] + extent[1]) / 2, (extent[2] + extent[3]) / 2, extent[4]));
+    std::copy(pixel, pixel + 4, rgba);
+  }
+
+  void SetLabelColor(double red, double green, double blue)
+  {
+    mitk::Color color;
+    color.SetRed(red);
+    color.SetGreen(green);
+    color.SetBlue(blue);
+
+    // same as the label set widget: the label is changed, then only the lookup table is updated
+    m_LabelSetImage->GetLabel(LabelValue)->SetColor(color);
+    m_LabelSetImage->GetLabelSet()->UpdateLookupTable(LabelValue);
+  }
+
+public:
+  void setUp() override
+  {
+    // every pixel of the image belongs to the label
+    mitk::Image::Pointer labeledImage = mitk::Image::New();
+    unsigned int dimensions[3] = {20, 20, 5};
+    labeledImage->Initialize(mitk::MakeScalarPixelType<mitk::Label::PixelType>(), 3, dimensions);
+    {
+      mitk::ImageWriteAccessor accessor(labeledImage);
+      auto *data = static_cast<mitk::Label::PixelType *>(accessor.GetData());
+      std::fill(data, data + 20 * 20 * 5, LabelValue);
+    }
+
+    m_LabelSetImage = mitk::LabelSetImage::New();
+    m_LabelSetImage->InitializeByLabeledImage(labeledImage);
+    m_LabelSetImage->GetLabel(LabelValue)->SetOpacity(1.0);
+
+    m_Node = mitk::DataNode::New();
+    m_Node->SetData(m_LabelSetImage);
+    mitk::LabelSetImageVtkMapper2D::SetDefaultProperties(m_Node);
+    m_Node->SetBoolProperty("labelset.composite layers", true);
+    m_Node->SetOpacity(1.0);
+
+    this->SetLabelColor(1.0, 0.0, 0.0);
+  }
+
+  void tearDown() override
+  {
+    m_Node = nullptr;
+    m_LabelSetImage = nullptr;
+  }
+
+  void CompositeLayers_RecolorLabel_UpdatesTexture()
+  {
+    mitk::RenderingTestHelper renderingHelper(640, 480);
+    renderingHelper.SetMapperIDToRender2D();
+    renderingHelper.AddNodeToStorage(m_Node);
+
+    unsigned char rgba[4];
+    this->GetCompositeCenterPixel(renderingHelper, rgba);
+    CPPUNIT_ASSERT_EQUAL(255, static_cast<int>(rgba[0]));
+    CPPUNIT_ASSERT_EQUAL(0, static_cast<int>(rgba[2]));
+    CPPUNIT_ASSERT_EQUAL(255, static_cast<int>(rgba[3]));
+
+    // neither the slice nor the data changes
+    this->SetLabelColor(0.0, 0.0, 1.0);
+    this->GetCompositeCenterPixel(renderingHelper, rgba);
+    CPPUNIT_ASSERT_EQUAL(0, static_cast<int>(rgba[0]));
+    CPPUNIT_ASSERT_EQUAL(255, static_cast<int>(rgba[2]));
+    CPPUNIT_ASSERT_EQUAL(255, static_cast<int>(rgba[3]));
+  }
+
+  void CompositeLayers_HideLabel_UpdatesTexture()
+  {
+    mitk::RenderingTestHelper renderingHelper(640, 480);
+    renderingHelper.SetMapperIDToRender2D();
+    renderingHelper.AddNodeToStorage(m_Node);
+
+    unsigned char rgba[4];
+    this->GetCompositeCenterPixel(renderingHelper, rgba);
+    CPPUNIT_ASSERT_EQUAL(255, static_cast<int>(rgba[3]));
+
+    m_LabelSetImage->GetLabel(LabelValue)->SetVisible(false);
+    m_LabelSetImage->GetLabelSet()->UpdateLookupTable(LabelValue);
+    this->GetCompositeCenterPixel(renderingHelper, rgba);
+    CPPUNIT_ASSERT_EQUAL(0, static_cast<int>(rgba[3]));
+  }
+};
+
+MITK_TEST_SUITE_REGISTRATION(mitkLabelSetImageVtkMapper2D)
@@ -56,6 +56,98 @@ See LICENSE.txt or http://www.mitk.org for details.
 #include <itkRGBAPixel.h>
 #include <mitkRenderingModeProperty.h>
 
+#include <algorithm>
+#include <cmath>
+
+namespace
+{
+  template <typename TPixel>
+  void CompositeLabelLayers(const std::vector<vtkImageData *> &slices,
+                            const std::vector<const std::vector<unsigned char> *> &palettes,
+                            float opacity,
+                            const double clippingBounds[4],
+                            vtkImageData *composite)
+  {
+    int extent[6];
+    composite->GetExtent(extent);
+    const vtkIdType width = extent[1] - extent[0] + 1;
+    const vtkIdType height = extent[3] - extent[2] + 1;
+
+    auto *outPtr = static_cast<unsigned char *>(composite->GetScalarPointer());
+    std::fill(outPtr, outPtr + 4 * width * height, 0);
+
+    std::vector<const TPixel *> layers(slices.size());
+    for (size_t lidx = 0; lidx < slices.size(); ++lidx)
+    {
+      layers[lidx] = static_cast<const TPixel *>(slices[lidx]->GetScalarPointer());
+    }
+
+    // pixels are inside if clippingBounds[0] <= x < clippingBounds[1], same for y
+    const int xBegin = std::max(extent[0], static_cast<int>(std::ceil(clippingBounds[0])));
+    const int xEnd = std::min(extent[1] + 1, static_cast<int>(std::ceil(clippingBounds[1])));
+    const int yBegin = std::max(extent[2], static_cast<int>(std::ceil(clippingBounds[2])));
+    const int yEnd = std::min(extent[3] + 1, static_cast<int>(std::ceil(clippingBounds[3])));
+
+    for (int y = yBegin; y < yEnd; ++y)
+    {
+      for (int x = xBegin; x < xEnd; ++x)
+      {
+        const vtkIdType i = (y - extent[2]) * width + (x - extent[0]);
+
+        // blend the layers with premultiplied colors, later layers on top
+        float rgb[3] = {0.0f, 0.0f, 0.0f};
+        float alpha = 0.0f;
+        for (size_t lidx = 0; lidx < layers.size(); ++lidx)
+        {
+          const auto value = static_cast<vtkIdType>(layers[lidx][i]);
+          if (value < 0 || 4 * value >= static_cast<vtkIdType>(palettes[lidx]->size()))
+            continue;
+
+          const unsigned char *color = palettes[lidx]->data() + 4 * value;
+          if (color[3] == 0)
+            continue;
+
+          const float layerAlpha = color[3] * opacity / 255.0f;
+          for (int c = 0; c < 3; ++c)
+          {
+            rgb[c] = color[c] * layerAlpha + rgb[c] * (1.0f - layerAlpha);
+          }
+          alpha = layerAlpha + alpha * (1.0f - layerAlpha);
+        }
+
+        if (alpha > 0.0f)
+        {
+          unsigned char *pixel = outPtr + 4 * i;
+          for (int c = 0; c < 3; ++c)
+          {
+            pixel[c] = static_cast<unsigned char>(std::min(rgb[c] / alpha + 0.5f, 255.0f));
+          }
+          pixel[3] = static_cast<unsigned char>(std::min(255.0f * alpha + 0.5f, 255.0f));
+        }
+      }
+    }
+  }
+}
+
+namespace
+{
+  // label edits in the label set widget (color, visibility) only modify the lookup table of the label set,
+  // returns true if a lookup table changed since its palette was copied by CompositeLayers()
+  bool IsAnyPaletteOutdated(mitk::LabelSetImage *image, const std::vector<unsigned long> &paletteMTimes)
+  {
+    const unsigned int numberOfLayers = image->GetNumberOfLayers();
+    if (paletteMTimes.size() != numberOfLayers)
+      return true;
+
+    for (unsigned int lidx = 0; lidx < numberOfLayers; ++lidx)
+    {
+      if (image->GetLabelSet(lidx)->GetLookupTable()->GetVtkLookupTable()->GetMTime() != paletteMTimes[lidx])
+        return true;
+    }
+    return false;
+  }
+}
+
 mitk::LabelSetImageVtkMapper2D::LabelSetImageVtkMapper2D()
 {
 }
@@ -126,10 +218,18 @@ void mitk::LabelSetImageVtkMapper2D::GenerateDataForRenderer(mitk::BaseRenderer
       localStorage->m_Actors->AddPart(localStorage->m_LayerActorVector[lidx]);
     }
 
+    localStorage->m_Actors->AddPart(localStorage->m_CompositeActor);
     localStorage->m_Actors->AddPart(localStorage->m_OutlineShadowActor);
     localStorage->m_Actors->AddPart(localStorage->m_OutlineActor);
+
+    localStorage->m_LayerPaletteVector.clear();
+    localStorage->m_LayerPaletteMTimeVector.clear();
   }
 
+  // composite all layers into a single texture instead of rendering one texture per layer
+  bool compositeLayers = true;
+  node->GetBoolProperty("labelset.composite layers", compositeLayers, renderer);
+
   // early out if there is no intersection of the current rendering geometry
   // and the geometry of the image that is to be rendered.
   if (!RenderingGeometryIntersectsImage(worldGeometry, image->GetSlicedGeometry()))
@@ -144,9 +244,15 @@ void mitk::LabelSetImageVtkMapper2D::GenerateDataForRenderer(mitk::BaseRenderer
       localStorage->m_OutlineActor->SetVisibility(false);
       localStorage->m_OutlineShadowActor->SetVisibility(false);
     }
+    localStorage->m_CompositeMapper->SetInputData(localStorage->m_EmptyPolyData);
     return;
   }
 
+  // check for texture interpolation property
+  bool textureInterpolation = false;
+  node->GetBoolProperty("texture interpolation", textureInterpolation, renderer);
+
+  double textureClippingBounds[6];
   for (int lidx = 0; lidx < numberOfLayers; ++lidx)
   {
     mitk::Image *layerImage = nullptr;
@@ -201,7 +307,6 @@ void mitk::LabelSetImageVtkMapper2D::GenerateDataForRenderer(mitk::BaseRenderer
 
     const auto *planeGeometry = dynamic_cast<const PlaneGeometry *>(worldGeometry);
 
-    double textureClippingBounds[6];
     for (auto &textureClippingBound : textureClippingBounds)
     {
       textureClippingBound = 0.0;
@@ -217,6 +322,11 @@ void mitk::LabelSetImageVtkMapper2D::GenerateDataForRenderer(mitk::BaseRenderer
     textureClippingBounds[2] = static_cast<int>(textureClippingBounds[2] / localStorage->m_mmPerPixel[1] + 0.5);
     textureClippingBounds[3] = static_cast<int>(textureClippingBounds[3] / localStorage->m_mmPerPixel[1] + 0.5);
 
+    this->TransformActor(renderer);
+
+    if (compositeLayers)
+      continue;
+
     // clipping bounds for cutting the imageLayer
     localStorage->m_LevelWindowFilterVector[lidx]->SetClippingBounds(textureClippingBounds);
 
@@ -230,18 +340,12 @@ void mitk::LabelSetImageVtkMapper2D::GenerateDataForRenderer(mitk::BaseRenderer
     localStorage->m_LevelWindowFilterVector[lidx]->SetInputData(localStorage->m_ReslicedImageVector[lidx]);
     // connect the texture with the output of the levelwindow filter
 
-    // check for texture interpolation property
-    bool textureInterpolation = false;
-    node->GetBoolProperty("texture interpolation", textureInterpolation, renderer);
-
     // set the interpolation modus according to the property
     localStorage->m_LayerTextureVector[lidx]->SetInterpolate(textureInterpolation);
 
     localStorage->m_LayerTextureVector[lidx]->SetInputConnection(
       localStorage->m_LevelWindowFilterVector[lidx]->GetOutputPort());
 
-    this->TransformActor(renderer);
-
     // set the plane as input for the mapper
     localStorage->m_LayerMapperVector[lidx]->SetInputConnection(localStorage->m_Plane->GetOutputPort());
 
@@ -250,6 +354,19 @@ void mitk::LabelSetImageVtkMapper2D::GenerateDataForRenderer(mitk::BaseRenderer
     localStorage->m_LayerActorVector[lidx]->GetProperty()->SetOpacity(opacity);
   }
 
+  if (compositeLayers)
+  {
+    // the opacity is applied while compositing, see CompositeLayers()
+    this->CompositeLayers(renderer, image, textureClippingBounds, opacity);
+    localStorage->m_CompositeTexture->SetInterpolate(textureInterpolation);
+    localStorage->m_CompositeMapper->SetInputConnection(localStorage->m_Plane->GetOutputPort());
+  }
+  for (int lidx = 0; lidx < numberOfLayers; ++lidx)
+  {
+    localStorage->m_LayerActorVector[lidx]->SetVisibility(!compositeLayers);
+  }
+  localStorage->m_CompositeActor->SetVisibility(compositeLayers);
+
   mitk::Label* activeLabel = image->GetActiveLabel(activeLayer);
   if (nullptr != activeLabel)
   {
@@ -282,6 +399,63 @@ void mitk::LabelSetImageVtkMapper2D::GenerateDataForRenderer(mitk::BaseRenderer
   localStorage->m_OutlineShadowActor->SetVisibility(false);
 }
 
+void mitk::LabelSetImageVtkMapper2D::CompositeLayers(mitk::BaseRenderer *renderer,
+                                                     mitk::LabelSetImage *image,
+                                                     const double clippingBounds[4],
+                                                     float opacity)
+{
+  LocalStorage *localStorage = m_LSH.GetLocalStorage(renderer);
+  const int numberOfLayers = localStorage->m_NumberOfLayers;
+  if (numberOfLayers == 0)
+    return;
+
+  localStorage->m_LayerPaletteVector.resize(numberOfLayers);
+  localStorage->m_LayerPaletteMTimeVector.resize(numberOfLayers, 0);
+
+  vtkImageData *firstSlice = localStorage->m_ReslicedImageVector[0];
+  int extent[6];
+  firstSlice->GetExtent(extent);
+
+  std::vector<vtkImageData *> slices;
+  std::vector<const std::vector<unsigned char> *> palettes;
+  for (int lidx = 0; lidx < numberOfLayers; ++lidx)
+  {
+    // the palette is only copied if the lookup table changed, e.g. if a label was added or hidden
+    vtkLookupTable *lookupTable = image->GetLabelSet(lidx)->GetLookupTable()->GetVtkLookupTable();
+    if (lookupTable->GetMTime() != localStorage->m_LayerPaletteMTimeVector[lidx])
+    {
+      const unsigned char *table = lookupTable->GetPointer(0);
+      localStorage->m_LayerPaletteVector[lidx].assign(table, table + 4 * lookupTable->GetNumberOfTableValues());
+      localStorage->m_LayerPaletteMTimeVector[lidx] = lookupTable->GetMTime();
+    }
+
+    vtkImageData *slice = localStorage->m_ReslicedImageVector[lidx];
+    int *sliceExtent = slice->GetExtent();
+    if (slice->GetScalarType() != firstSlice->GetScalarType() || slice->GetNumberOfScalarComponents() != 1 ||
+        !std::equal(extent, extent + 4, sliceExtent))
+    {
+      MITK_WARN << "Layer " << lidx << " does not match the slice of the first layer and is not rendered.";
+      continue;
+    }
+    slices.push_back(slice);
+    palettes.push_back(&localStorage->m_LayerPaletteVector[lidx]);
+  }
+
+  vtkImageData *composite = localStorage->m_CompositeImage;
+  composite->SetExtent(extent);
+  composite->SetSpacing(firstSlice->GetSpacing());
+  composite->SetOrigin(firstSlice->GetOrigin());
+  composite->AllocateScalars(VTK_UNSIGNED_CHAR, 4);
+
+  switch (firstSlice->GetScalarType())
+  {
+    vtkTemplateMacro(CompositeLabelLayers<VTK_TT>(slices, palettes, opacity, clippingBounds, composite));
+    default:
+      MITK_WARN << "Unsupported pixel type of the layers: " << firstSlice->GetScalarTypeAsString();
+  }
+  composite->Modified();
+}
+
 bool mitk::LabelSetImageVtkMapper2D::RenderingGeometryIntersectsImage(const PlaneGeometry *renderingGeometry,
                                                                       SlicedGeometry3D *imageGeometry)
 {
@@ -524,6 +698,11 @@ void mitk::LabelSetImageVtkMapper2D::Update(mitk::BaseRenderer *renderer)
   image->UpdateOutputInformation();
   LocalStorage *localStorage = m_LSH.GetLocalStorage(renderer);
 
+  // the per layer textures pick lookup table changes up through vtkMitkLevelWindowFilter::GetMTime(),
+  // the composite has to be generated again
+  bool compositeLayers = true;
+  node->GetBoolProperty("labelset.composite layers", compositeLayers, renderer);
+
   // check if something important has changed and we need to re-render
 
   if ((localStorage->m_LastDataUpdateTime < image->GetMTime()) ||
@@ -536,7 +715,8 @@ void mitk::LabelSetImageVtkMapper2D::Update(mitk::BaseRenderer *renderer)
   }
   else if ((localStorage->m_LastPropertyUpdateTime < node->GetPropertyList()->GetMTime()) ||
            (localStorage->m_LastPropertyUpdateTime < node->GetPropertyList(renderer)->GetMTime()) ||
-           (localStorage->m_LastPropertyUpdateTime < image->GetPropertyList()->GetMTime()))
+           (localStorage->m_LastPropertyUpdateTime < image->GetPropertyList()->GetMTime()) ||
+           (compositeLayers && IsAnyPaletteOutdated(image, localStorage->m_LayerPaletteMTimeVector)))
   {
     this->GenerateDataForRenderer(renderer);
     localStorage->m_LastPropertyUpdateTime.Modified();
@@ -594,6 +774,10 @@ void mitk::LabelSetImageVtkMapper2D::TransformActor(mitk::BaseRenderer *renderer
     localStorage->m_LayerActorVector[lidx]->SetPosition(
       -0.5 * localStorage->m_mmPerPixel[0], -0.5 * localStorage->m_mmPerPixel[1], 0.0);
   }
+  // same for the composite actor
+  localStorage->m_CompositeActor->SetUserTransform(trans);
+  localStorage->m_CompositeActor->SetPosition(
+    -0.5 * localStorage->m_mmPerPixel[0], -0.5 * localStorage->m_mmPerPixel[1], 0.0);
   // same for outline actor
   localStorage->m_OutlineActor->SetUserTransform(trans);
   localStorage->m_OutlineActor->SetPosition(
@@ -624,6 +808,7 @@ void mitk::LabelSetImageVtkMapper2D::SetDefaultProperties(mitk::DataNode *node,
 
   node->SetProperty("labelset.contour.active", BoolProperty::New(true), renderer);
   node->SetProperty("labelset.contour.width", FloatProperty::New(2.0), renderer);
+  node->SetProperty("labelset.composite layers", BoolProperty::New(true), renderer);
 
   Superclass::SetDefaultProperties(node, renderer, overwrite);
 }
@@ -642,6 +827,10 @@ mitk::LabelSetImageVtkMapper2D::LocalStorage::LocalStorage()
   m_OutlineActor = vtkSmartPointer<vtkActor>::New();
   m_OutlineMapper = vtkSmartPointer<vtkPolyDataMapper>::New();
   m_OutlineShadowActor = vtkSmartPointer<vtkActor>::New();
+  m_CompositeActor = vtkSmartPointer<vtkActor>::New();
+  m_CompositeMapper = vtkSmartPointer<vtkPolyDataMapper>::New();
+  m_CompositeTexture = vtkSmartPointer<vtkNeverTranslucentTexture>::New();
+  m_CompositeImage = vtkSmartPointer<vtkImageData>::New();
 
   m_NumberOfLayers = 0;
   m_mmPerPixel = nullptr;
@@ -651,4 +840,12 @@ mitk::LabelSetImageVtkMapper2D::LocalStorage::LocalStorage()
 
   m_OutlineActor->SetVisibility(false);
   m_OutlineShadowActor->SetVisibility(false);
+
+  // do not repeat the texture and do not use a VTK lookup table, the composite slice holds the colors
+  m_CompositeTexture->RepeatOff();
+  m_CompositeTexture->SetColorModeToDirectScalars();
+  m_CompositeTexture->SetInputData(m_CompositeImage);
+  m_CompositeActor->SetMapper(m_CompositeMapper);
+  m_CompositeActor->SetTexture(m_CompositeTexture);
+  m_CompositeActor->SetVisibility(false);
 }
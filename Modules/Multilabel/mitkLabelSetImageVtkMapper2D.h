@@ -51,11 +51,14 @@ namespace mitk
    *
    *   - \b "labelset.contour.active": (BoolProperty) whether to show only the active label as a contour or not
    *   - \b "labelset.contour.width": (FloatProperty) line width of the contour
+   *   - \b "labelset.composite layers": (BoolProperty) whether to composite all layers into a single texture
+   *     or to render one texture per layer
 
    * The default properties are:
 
    *   - \b "labelset.contour.active", mitk::BoolProperty::New( true ), renderer, overwrite )
    *   - \b "labelset.contour.width", mitk::FloatProperty::New( 2.0 ), renderer, overwrite )
+   *   - \b "labelset.composite layers", mitk::BoolProperty::New( true ), renderer, overwrite )
 
    * \ingroup Mapper
    */
@@ -124,6 +127,16 @@ namespace mitk
       // vtkSmartPointer<vtkMitkLevelWindowFilter> m_LevelWindowFilter;
       std::vector<vtkSmartPointer<vtkMitkLevelWindowFilter>> m_LevelWindowFilterVector;
 
+      /** \brief Actor, mapper and texture showing all layers composited into a single RGBA slice. */
+      vtkSmartPointer<vtkActor> m_CompositeActor;
+      vtkSmartPointer<vtkPolyDataMapper> m_CompositeMapper;
+      vtkSmartPointer<vtkNeverTranslucentTexture> m_CompositeTexture;
+      vtkSmartPointer<vtkImageData> m_CompositeImage;
+
+      /** \brief RGBA colors of all label values of each layer, copied from the lookup tables of the label sets. */
+      std::vector<std::vector<unsigned char>> m_LayerPaletteVector;
+      std::vector<unsigned long> m_LayerPaletteMTimeVector;
+
       /** \brief Default constructor of the local storage. */
       LocalStorage();
       /** \brief Default deconstructor of the local storage. */
@@ -221,6 +234,17 @@ namespace mitk
      */
     void ApplyLevelWindow(mitk::BaseRenderer *renderer);
 
+    /** \brief Composites the resliced label images of all layers into the RGBA slice of the composite actor.
+      *
+      * The layers are blended in their order, each pixel with the color of its label value from the palette
+      * of its layer and the given opacity, like the textures of separate layers are blended by the renderer.
+      * Pixels outside of the clipping bounds (in pixels) are transparent.
+      */
+    void CompositeLayers(mitk::BaseRenderer *renderer,
+                         mitk::LabelSetImage *image,
+                         const double clippingBounds[4],
+                         float opacity);
+
     /** \brief Set the color of the image/polydata */
     void ApplyColor(mitk::BaseRenderer *renderer, const mitk::Color &color);
 
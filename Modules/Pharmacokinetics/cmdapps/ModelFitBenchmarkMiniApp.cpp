@@ -0,0 +1,287 @@
+/*===================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center,
+Division of Medical and Biological Informatics.
+All rights reserved.
+
+This software is distributed WITHOUT ANY WARRANTY; without
+even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE.
+
+See LICENSE.txt or http://www.mitk.org for details.
+
+===================================================================*/
+
+// std includes
+#include <algorithm>
+#include <cmath>
+#include <iomanip>
+#include <string>
+
+// itk includes
+#include <itkImage.h>
+#include <itkImageRegionIterator.h>
+
+// CTK includes
+#include "mitkCommandLineParser.h"
+
+// MITK includes
+#include <mitkArbitraryTimeGeometry.h>
+#include <mitkImageCast.h>
+
+#include <mitkPixelBasedParameterFitImageGenerator.h>
+#include <mitkLevenbergMarquardtModelFitFunctor.h>
+#include <mitkNormalizedSumOfSquaredDifferencesFitCostFunction.h>
+#include <mitkThreeStepLinearModelParameterizer.h>
+#include <mitkStandardToftsModelParameterizer.h>
+#include <mitkExtendedToftsModelParameterizer.h>
+#include <mitkTwoCompartmentExchangeModelParameterizer.h>
+#include <mitkOneTissueCompartmentModelParameterizer.h>
+#include <mitkExtendedOneTissueCompartmentModelParameterizer.h>
+#include <mitkTwoTissueCompartmentModelParameterizer.h>
+
+typedef itk::Image<double, 4> DynamicITKImageType;
+
+unsigned int dimX(64);
+unsigned int dimY(64);
+unsigned int dimZ(4);
+unsigned int timeSteps(60);
+double timeResolution(5.0);
+unsigned int batchSize(256);
+
+mitk::ModelBase::TimeGridType timeGrid;
+
+void setupParser(mitkCommandLineParser& parser)
+{
+    // set general information about your MiniApp
+    parser.setCategory("Dynamic Data Analysis Tools");
+    parser.setTitle("Model Fit Benchmark");
+    parser.setDescription("MiniApp that fits synthetic dynamic images with the pharmacokinetic models and reports the throughput (fitted voxels per second) of the default and the batch fitting mode of the pixel based fit generator.");
+    parser.setContributor("DKFZ MIC");
+
+    parser.setArgumentPrefix("--", "-");
+    parser.beginGroup("Image parameters");
+    parser.addArgument(
+        "dimx", "x", mitkCommandLineParser::Int, "Size x", "Number of voxels along x. Default is 64.", us::Any(64));
+    parser.addArgument(
+        "dimy", "y", mitkCommandLineParser::Int, "Size y", "Number of voxels along y. Default is 64.", us::Any(64));
+    parser.addArgument(
+        "dimz", "z", mitkCommandLineParser::Int, "Size z", "Number of voxels along z. Default is 4.", us::Any(4));
+    parser.addArgument(
+        "timesteps", "t", mitkCommandLineParser::Int, "Time steps", "Number of time steps. Default is 60.", us::Any(60));
+    parser.addArgument(
+        "resolution", "r", mitkCommandLineParser::Float, "Time resolution [s]", "Time between two time steps. Default is 5 s.", us::Any(5.0f));
+    parser.endGroup();
+
+    parser.beginGroup("Optional parameters");
+    parser.addArgument(
+        "batchsize", "b", mitkCommandLineParser::Int, "Batch size", "Number of voxels fitted per block in the batch mode. Default is 256.", us::Any(256));
+    parser.addArgument("help", "h", mitkCommandLineParser::Bool, "Help:", "Show this help text");
+    parser.endGroup();
+}
+
+bool configureApplicationSettings(std::map<std::string, us::Any> parsedArgs)
+{
+    if (parsedArgs.size() == 0)
+        return false;
+
+    if (parsedArgs.count("dimx"))
+        dimX = us::any_cast<int>(parsedArgs["dimx"]);
+    if (parsedArgs.count("dimy"))
+        dimY = us::any_cast<int>(parsedArgs["dimy"]);
+    if (parsedArgs.count("dimz"))
+        dimZ = us::any_cast<int>(parsedArgs["dimz"]);
+    if (parsedArgs.count("timesteps"))
+        timeSteps = us::any_cast<int>(parsedArgs["timesteps"]);
+    if (parsedArgs.count("resolution"))
+        timeResolution = us::any_cast<float>(parsedArgs["resolution"]);
+    if (parsedArgs.count("batchsize"))
+        batchSize = us::any_cast<int>(parsedArgs["batchsize"]);
+
+    return dimX > 0 && dimY > 0 && dimZ > 0 && timeSteps > 1 && timeResolution > 0 && batchSize > 0;
+}
+
+/** Gamma variate bolus used as arterial input function of the AIF based models.*/
+mitk::AIFBasedModelBase::AterialInputFunctionType generateAIF()
+{
+  mitk::AIFBasedModelBase::AterialInputFunctionType aif(timeGrid.GetSize());
+  const double arrival = 30.0;
+  for (unsigned int i = 0; i < timeGrid.GetSize(); ++i)
+  {
+    const double t = std::max(timeGrid[i] - arrival, 0.0) / 10.0;
+    aif[i] = 5.0 * t * t * std::exp(-t) + 0.1 * (timeGrid[i] > arrival ? 1.0 : 0.0);
+  }
+  return aif;
+}
+
+/** Generates a dynamic image whose signals are simulated with the given parameterizer. The true parameters
+ * vary along x, so neighbouring voxels have similar but not identical solutions.*/
+mitk::Image::Pointer generateDynamicImage(const mitk::ModelParameterizerBase* parameterizer)
+{
+  mitk::ModelBase::Pointer model = parameterizer->GenerateParameterizedModel();
+  const mitk::ModelBase::ParametersType initialParameters = parameterizer->GetDefaultInitialParameterization();
+
+  std::vector<mitk::ModelBase::ModelResultType> signals;
+  for (unsigned int x = 0; x < dimX; ++x)
+  {
+    mitk::ModelBase::ParametersType parameters = initialParameters;
+    const double scale = 0.6 + 0.8 * x / dimX;
+    for (unsigned int i = 0; i < parameters.GetSize(); ++i)
+    {
+      parameters[i] *= scale;
+    }
+    signals.push_back(model->GetSignal(parameters));
+  }
+
+  DynamicITKImageType::Pointer dynamicITKImage = DynamicITKImageType::New();
+  DynamicITKImageType::RegionType region;
+  region.SetSize(0, dimX);
+  region.SetSize(1, dimY);
+  region.SetSize(2, dimZ);
+  region.SetSize(3, timeSteps);
+  dynamicITKImage->SetRegions(region);
+  dynamicITKImage->Allocate();
+
+  itk::ImageRegionIterator<DynamicITKImageType> it(dynamicITKImage, region);
+  for (; !it.IsAtEnd(); ++it)
+  {
+    const DynamicITKImageType::IndexType index = it.GetIndex();
+    it.Set(signals[index[0]][index[3]]);
+  }
+
+  mitk::Image::Pointer dynamicImage;
+  mitk::CastToMitkImage(dynamicITKImage, dynamicImage);
+
+  mitk::ArbitraryTimeGeometry::Pointer timeGeometry = mitk::ArbitraryTimeGeometry::New();
+  timeGeometry->ClearAllGeometries();
+  for (unsigned int i = 0; i < timeSteps; ++i)
+  {
+    timeGeometry->AppendNewTimeStepClone(dynamicImage->GetGeometry(), timeGrid[i] * 1000.0, (timeGrid[i] + timeResolution) * 1000.0);
+  }
+  dynamicImage->SetTimeGeometry(timeGeometry);
+
+  return dynamicImage;
+}
+
+mitk::ModelFitFunctorBase::Pointer createDefaultFitFunctor(const mitk::ModelParameterizerBase* parameterizer)
+{
+    mitk::LevenbergMarquardtModelFitFunctor::Pointer fitFunctor =
+        mitk::LevenbergMarquardtModelFitFunctor::New();
+
+    mitk::NormalizedSumOfSquaredDifferencesFitCostFunction::Pointer chi2 =
+        mitk::NormalizedSumOfSquaredDifferencesFitCostFunction::New();
+    fitFunctor->RegisterEvaluationParameter("Chi^2", chi2);
+
+    mitk::ModelBase::Pointer refModel = parameterizer->GenerateParameterizedModel();
+
+    ::itk::LevenbergMarquardtOptimizer::ScalesType scales;
+    scales.SetSize(refModel->GetNumberOfParameters());
+    scales.Fill(1.0);
+    fitFunctor->SetScales(scales);
+
+    return fitFunctor.GetPointer();
+}
+
+double measureVoxelsPerSecond(mitk::ModelParameterizerBase* parameterizer, mitk::Image* image, bool batch, bool warmStart)
+{
+  mitk::PixelBasedParameterFitImageGenerator::Pointer fitGenerator =
+    mitk::PixelBasedParameterFitImageGenerator::New();
+
+  fitGenerator->SetModelParameterizer(parameterizer);
+  fitGenerator->SetDynamicImage(image);
+  fitGenerator->SetFitFunctor(createDefaultFitFunctor(parameterizer));
+  fitGenerator->SetUseBatchFitting(batch);
+  fitGenerator->SetBatchSize(batchSize);
+  fitGenerator->SetWarmStart(warmStart);
+  fitGenerator->Generate();
+
+  return fitGenerator->GetVoxelsPerSecond();
+}
+
+void benchmarkModel(const std::string& name, mitk::ModelParameterizerBase* parameterizer)
+{
+  parameterizer->SetDefaultTimeGrid(timeGrid);
+  mitk::Image::Pointer image = generateDynamicImage(parameterizer);
+
+  std::cout << std::left << std::setw(12) << name << std::right << std::fixed << std::setprecision(1);
+  std::cout << std::setw(14) << measureVoxelsPerSecond(parameterizer, image, false, false);
+  std::cout << std::setw(14) << measureVoxelsPerSecond(parameterizer, image, true, false);
+  std::cout << std::setw(14) << measureVoxelsPerSecond(parameterizer, image, true, true) << std::endl;
+}
+
+template <typename TParameterizer>
+void benchmarkModel(const std::string& name)
+{
+  typename TParameterizer::Pointer parameterizer = TParameterizer::New();
+  benchmarkModel(name, parameterizer);
+}
+
+template <typename TParameterizer>
+void benchmarkAIFBasedModel(const std::string& name)
+{
+  typename TParameterizer::Pointer parameterizer = TParameterizer::New();
+  parameterizer->SetAIF(generateAIF());
+  parameterizer->SetAIFTimeGrid(timeGrid);
+  benchmarkModel(name, parameterizer);
+}
+
+int main(int argc, char* argv[])
+{
+    mitkCommandLineParser parser;
+    setupParser(parser);
+    const std::map<std::string, us::Any>& parsedArgs = parser.parseArguments(argc, argv);
+
+    if (!configureApplicationSettings(parsedArgs))
+    {
+        return EXIT_FAILURE;
+    };
+
+    // Show a help message
+    if (parsedArgs.count("help") || parsedArgs.count("h"))
+    {
+        std::cout << parser.helpText();
+        return EXIT_SUCCESS;
+    }
+
+    try
+    {
+        timeGrid.SetSize(timeSteps);
+        for (unsigned int i = 0; i < timeSteps; ++i)
+        {
+          timeGrid[i] = i * timeResolution;
+        }
+
+        std::cout << "Image: " << dimX << " x " << dimY << " x " << dimZ << " voxels, " << timeSteps << " time steps" << std::endl;
+        std::cout << "Batch size: " << batchSize << std::endl;
+        std::cout << "Throughput [voxels/s]" << std::endl;
+        std::cout << std::left << std::setw(12) << "model" << std::right << std::setw(14) << "default"
+          << std::setw(14) << "batch" << std::setw(14) << "batch+warm" << std::endl;
+
+        benchmarkModel<mitk::ThreeStepLinearModelParameterizer>("3SL");
+        benchmarkAIFBasedModel<mitk::StandardToftsModelParameterizer>("tofts");
+        benchmarkAIFBasedModel<mitk::ExtendedToftsModelParameterizer>("ext. tofts");
+        benchmarkAIFBasedModel<mitk::TwoCompartmentExchangeModelParameterizer>("2CX");
+        benchmarkAIFBasedModel<mitk::OneTissueCompartmentModelParameterizer>("1TC");
+        benchmarkAIFBasedModel<mitk::ExtendedOneTissueCompartmentModelParameterizer>("ext. 1TC");
+        benchmarkAIFBasedModel<mitk::TwoTissueCompartmentModelParameterizer>("2TC");
+    }
+    catch (const itk::ExceptionObject& e)
+    {
+        MITK_ERROR << e.what();
+        return EXIT_FAILURE;
+    }
+    catch (const std::exception& e)
+    {
+        MITK_ERROR << e.what();
+        return EXIT_FAILURE;
+    }
+    catch (...)
+    {
+        MITK_ERROR << "Unexpected error encountered.";
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
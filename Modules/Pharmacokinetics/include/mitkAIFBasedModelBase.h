@@ -19,8 +19,11 @@ See LICENSE.txt or http://www.mitk.org for details.
 
 #include "MitkPharmacokineticsExports.h"
 #include "mitkModelBase.h"
+#include "mitkAIFConvolutionCache.h"
 #include "itkArray2D.h"
 
+#include <mutex>
+
 namespace mitk
 {
 
@@ -78,6 +81,15 @@ namespace mitk
      * if currentTimeGrid.Size() = 0 , the Original AIF will be returned*/
     const AterialInputFunctionType GetAterialInputFunction(TimeGridType currentTimeGrid) const;
 
+    /** Returns the convolution cache for the current AIF, AIF time grid and model time grid.
+     * The cache is (re)computed on demand if the model was changed since the last call.*/
+    AIFConvolutionCache::ConstPointer GetAIFConvolutionCache() const;
+
+    /** Sets a precomputed convolution cache, e.g. one that is shared by all models of a fit session.
+     * It is only used if it was initialized with the AIF and time grids of this model; otherwise
+     * GetAIFConvolutionCache() computes a new one.*/
+    void SetAIFConvolutionCache(const AIFConvolutionCache* cache);
+
     virtual ParameterNamesType GetStaticParameterNames() const override;
     virtual ParametersSizeType GetNumberOfStaticParameters() const override;
     virtual ParamterUnitMapType GetStaticParameterUnits() const override;
@@ -104,6 +116,10 @@ namespace mitk
     TimeGridType m_AterialInputFunctionTimeGrid;
     AterialInputFunctionType m_AterialInputFunctionValues;
 
+    mutable AIFConvolutionCache::ConstPointer m_AIFConvolutionCache;
+    /** MTime of the model when m_AIFConvolutionCache was validated the last time.*/
+    mutable itk::ModifiedTimeType m_AIFConvolutionCacheMTime;
+    mutable std::mutex m_AIFConvolutionCacheMutex;
 
   private:
 
@@ -20,6 +20,8 @@ See LICENSE.txt or http://www.mitk.org for details.
 #include "mitkAIFParametrizerHelper.h"
 #include "mitkAIFBasedModelBase.h"
 
+#include <mutex>
+
 namespace mitk
 {
   /** Base class for model parameterizers for Models using an Aterial Input Function
@@ -71,6 +73,22 @@ namespace mitk
       return result;
     };
 
+    /** Reimplementation that additionally passes the AIF convolution cache to the model.
+     * The cache is computed by the first generated model and then shared by all following models,
+     * as long as AIF and time grids are not changed.*/
+    virtual ModelBasePointer GenerateParameterizedModel(const IndexType& currentPosition) const override
+    {
+      ModelBasePointer newModel = Superclass::GenerateParameterizedModel(currentPosition);
+      this->ShareConvolutionCache(static_cast<ModelType*>(newModel.GetPointer()));
+      return newModel;
+    };
+
+    virtual ModelBasePointer GenerateParameterizedModel() const override
+    {
+      ModelBasePointer newModel = Superclass::GenerateParameterizedModel();
+      this->ShareConvolutionCache(static_cast<ModelType*>(newModel.GetPointer()));
+      return newModel;
+    };
 
   protected:
 
@@ -84,6 +102,31 @@ namespace mitk
     mitk::AIFBasedModelBase::AterialInputFunctionType m_AIF;
     mitk::ModelBase::TimeGridType m_AIFTimeGrid;
 
+    void ShareConvolutionCache(ModelType* model) const
+    {
+      std::lock_guard<std::mutex> lock(m_ConvolutionCacheMutex);
+
+      if (m_ConvolutionCache.IsNotNull() && m_ConvolutionCache->IsInitializedWith(model->GetTimeGrid(),
+          model->GetAterialInputFunctionValues(), model->GetAterialInputFunctionTimeGrid()))
+      {
+        model->SetAIFConvolutionCache(m_ConvolutionCache);
+      }
+      else
+      {
+        try
+        {
+          m_ConvolutionCache = model->GetAIFConvolutionCache();
+        }
+        catch (const itk::ExceptionObject&)
+        {
+          // AIF or time grids are not valid (yet); GetSignal() of the model reports that.
+          m_ConvolutionCache = nullptr;
+        }
+      }
+    };
+
+    mutable mitk::AIFConvolutionCache::ConstPointer m_ConvolutionCache;
+    mutable std::mutex m_ConvolutionCacheMutex;
 
   private:
 
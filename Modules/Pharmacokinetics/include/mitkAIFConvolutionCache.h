@@ -0,0 +1,103 @@
+/*===================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center,
+Division of Medical and Biological Informatics.
+All rights reserved.
+
+This software is distributed WITHOUT ANY WARRANTY; without
+even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE.
+
+See LICENSE.txt or http://www.mitk.org for details.
+
+===================================================================*/
+
+#ifndef __MITK_AIF_CONVOLUTION_CACHE_H_
+#define __MITK_AIF_CONVOLUTION_CACHE_H_
+
+#include <vector>
+
+#include <itkObject.h>
+
+#include "mitkModelBase.h"
+#include "MitkPharmacokineticsExports.h"
+
+namespace mitk
+{
+  /** \class AIFConvolutionCache
+   * \brief Holds everything of the convolution of an aterial input function (AIF) with a residue
+   * function that does not depend on the model parameters.
+   *
+   * The AIF is interpolated once to the model time grid, and the time steps, slopes and intercepts of the linearly
+   * interpolated AIF segments are precomputed. ConvoluteWithExponential() and ConvoluteWithConstant() then only
+   * evaluate the closed-form recursion of mitk::convoluteAIFWithExponential() / mitk::convoluteAIFWithConstant().
+   * If the time grid is equidistant, exp(-lambda*dt) is evaluated only once per convolution instead of once per time
+   * step.
+   *
+   * The cache is not changed after Initialize(). Thus one instance can be shared by all models (and threads) of a fit
+   * session that use the same AIF and time grid (see AIFBasedModelParameterizerBase).*/
+  class MITKPHARMACOKINETICS_EXPORT AIFConvolutionCache : public itk::Object
+  {
+  public:
+    mitkClassMacroItkParent(AIFConvolutionCache, itk::Object);
+    itkFactorylessNewMacro(Self);
+
+    typedef ModelBase::TimeGridType TimeGridType;
+    typedef itk::Array<double> AterialInputFunctionType;
+    typedef ModelBase::ModelResultType ConvolutionResultType;
+
+    /** Precomputes the cache for the passed model time grid.
+     * @param timeGrid Time grid of the model. The convolution results are defined on this grid.
+     * @param aif AIF values.
+     * @param aifTimeGrid Time grid of the AIF values. If it is empty, the AIF is assumed to be defined on timeGrid.*/
+    void Initialize(const TimeGridType& timeGrid, const AterialInputFunctionType& aif, const TimeGridType& aifTimeGrid);
+
+    /** Returns true if the cache was initialized with exactly the passed values.*/
+    bool IsInitializedWith(const TimeGridType& timeGrid, const AterialInputFunctionType& aif, const TimeGridType& aifTimeGrid) const;
+
+    /** AIF interpolated to the model time grid.*/
+    itkGetConstReferenceMacro(AterialInputFunction, AterialInputFunctionType);
+    itkGetConstReferenceMacro(TimeGrid, TimeGridType);
+
+    /** Step width, slope and intercept of the linearly interpolated AIF segments; segment i covers
+     * [t_i, t_i+1] and the AIF in it is intercept_i + slope_i * t.*/
+    itkGetConstReferenceMacro(StepWidths, std::vector<double>);
+    itkGetConstReferenceMacro(Slopes, std::vector<double>);
+    itkGetConstReferenceMacro(Intercepts, std::vector<double>);
+
+    /** Convolution of the AIF with exp(-lambda*t). Same result as mitk::convoluteAIFWithExponential().*/
+    ConvolutionResultType ConvoluteWithExponential(double lambda) const;
+
+    /** Convolution of the AIF with a constant. Same result as mitk::convoluteAIFWithConstant().*/
+    ConvolutionResultType ConvoluteWithConstant(double constant) const;
+
+  protected:
+    AIFConvolutionCache();
+    ~AIFConvolutionCache() override;
+
+    void PrintSelf(std::ostream& os, ::itk::Indent indent) const override;
+
+  private:
+    TimeGridType m_TimeGrid;
+    AterialInputFunctionType m_AterialInputFunction;
+
+    /** Values passed to Initialize(), used to check if the cache is still valid.*/
+    AterialInputFunctionType m_SourceAterialInputFunction;
+    TimeGridType m_SourceAterialInputFunctionTimeGrid;
+
+    /** Time step, slope and intercept (aif(t_i) - slope*t_i) of the AIF segment [t_i, t_i+1].*/
+    std::vector<double> m_StepWidths;
+    std::vector<double> m_Slopes;
+    std::vector<double> m_Intercepts;
+
+    /** Indicates that all time steps are equal (up to rounding), so one step width can be used for all segments.*/
+    bool m_IsEquidistant;
+
+    AIFConvolutionCache(const Self& source);
+    void operator=(const Self&);  //purposely not implemented
+  };
+}
+
+#endif
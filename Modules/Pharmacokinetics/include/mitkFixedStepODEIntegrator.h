@@ -0,0 +1,123 @@
+/*===================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center,
+Division of Medical and Biological Informatics.
+All rights reserved.
+
+This software is distributed WITHOUT ANY WARRANTY; without
+even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE.
+
+See LICENSE.txt or http://www.mitk.org for details.
+
+===================================================================*/
+
+#ifndef __MITK_FIXED_STEP_ODE_INTEGRATOR_H_
+#define __MITK_FIXED_STEP_ODE_INTEGRATOR_H_
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <vector>
+
+#include "mitkAIFConvolutionCache.h"
+
+namespace mitk
+{
+  /** \class FixedStepODEIntegrator
+   * \brief Classic 4th order Runge-Kutta integration of small linear compartment systems driven by an AIF.
+   *
+   * The state has the compile-time size TStateSize, so no memory is allocated during the integration.
+   * The system is a functor with the signature
+   *   void operator()(const StateType& x, StateType& dxdt, double ca) const
+   * where ca is the AIF value at the evaluation time. The AIF is linear between two time points of the
+   * model time grid; its segments are taken from an AIFConvolutionCache, so no interpolation search is needed.
+   *
+   * Every interval of the time grid is split into equal steps of at most maxStepSize, thus the states are
+   * computed exactly at the time points of the grid and need no interpolation afterwards. The integration starts
+   * with a zero state at t = 0; if the grid starts later, the AIF is assumed to be constant AIF(t_0) before.*/
+  template <unsigned int TStateSize>
+  class FixedStepODEIntegrator
+  {
+  public:
+    typedef std::array<double, TStateSize> StateType;
+    typedef std::vector<StateType> StatesType;
+
+    /** Integrates the system over the time grid of the cache. states[i] is the state at time point i.*/
+    template <typename TSystem>
+    static void IntegrateOnTimeGrid(const TSystem& system, const AIFConvolutionCache& cache, double maxStepSize,
+                                    StatesType& states)
+    {
+      const AIFConvolutionCache::TimeGridType& grid = cache.GetTimeGrid();
+      const std::vector<double>& slopes = cache.GetSlopes();
+      const std::vector<double>& intercepts = cache.GetIntercepts();
+
+      states.resize(grid.GetSize());
+
+      StateType x;
+      x.fill(0.0);
+
+      if (grid[0] > 0.0)
+      {
+        IntegrateSegment(system, x, 0.0, grid[0], cache.GetAterialInputFunction()[0], 0.0, maxStepSize);
+      }
+      states[0] = x;
+
+      for (unsigned int i = 0; i + 1 < grid.GetSize(); ++i)
+      {
+        IntegrateSegment(system, x, grid[i], grid[i + 1], intercepts[i], slopes[i], maxStepSize);
+        states[i + 1] = x;
+      }
+    }
+
+  private:
+    /** Integrates from t0 to t1 while the AIF is intercept + slope * t.*/
+    template <typename TSystem>
+    static void IntegrateSegment(const TSystem& system, StateType& x, double t0, double t1, double intercept,
+                                 double slope, double maxStepSize)
+    {
+      const double length = t1 - t0;
+      if (length <= 0.0)
+      {
+        return;
+      }
+
+      const unsigned int steps = std::max(1u, static_cast<unsigned int>(std::ceil(length / maxStepSize - 1e-9)));
+      const double h = length / steps;
+
+      StateType k1, k2, k3, k4, tmp;
+
+      for (unsigned int step = 0; step < steps; ++step)
+      {
+        const double caStart = intercept + slope * (t0 + step * h);
+        const double caMid = caStart + 0.5 * slope * h;
+        const double caEnd = caStart + slope * h;
+
+        system(x, k1, caStart);
+        for (unsigned int i = 0; i < TStateSize; ++i)
+        {
+          tmp[i] = x[i] + 0.5 * h * k1[i];
+        }
+        system(tmp, k2, caMid);
+        for (unsigned int i = 0; i < TStateSize; ++i)
+        {
+          tmp[i] = x[i] + 0.5 * h * k2[i];
+        }
+        system(tmp, k3, caMid);
+        for (unsigned int i = 0; i < TStateSize; ++i)
+        {
+          tmp[i] = x[i] + h * k3[i];
+        }
+        system(tmp, k4, caEnd);
+        for (unsigned int i = 0; i < TStateSize; ++i)
+        {
+          x[i] += h / 6.0 * (k1[i] + 2.0 * k2[i] + 2.0 * k3[i] + k4[i]);
+        }
+      }
+    }
+  };
+}
+
+#endif
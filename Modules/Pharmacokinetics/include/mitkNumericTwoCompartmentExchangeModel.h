@@ -15,8 +15,8 @@ namespace mitk
    * ve * dCi(t)/dt = PS * (Cp(t) - Ci(t))
    *
    * with concentration curve Cp(t) of the Blood Plasma p and Ce(t) of the Extracellular Extravascular Space(EES)(interstitial volume). CA(t) is the aterial concentration, i.e. the AIF
-   * Cp(t) and Ce(t) are found numerical via Runge-Kutta methode, implemented in Boosts numeric library ODEINT. Here we use a runge_kutta_cash_karp54 stepper with
-   * adaptive step size and error controll.
+   * Cp(t) and Ce(t) are found numerical via a classic 4th order Runge-Kutta methode (see FixedStepODEIntegrator). Every interval of the time grid
+   * is split into equal steps of at most ODEINTStepSize, so the concentrations are computed exactly at the time points of the grid.
    * From the resulting curves Cp(t) and Ce(t) the measured concentration Ctotal(t) is found vial
    *
    * Ctotal(t) = vp * Cp(t) + ve * Ce(t)
@@ -93,6 +93,10 @@ namespace mitk
 
     virtual ModelResultType ComputeModelfunction(const ParametersType& parameters) const override;
 
+    /** Derivatives are computed by integrating the sensitivity equations together with the model.*/
+    virtual bool ComputeModelfunctionDerivatives(const ParametersType& parameters, ModelResultType& signal,
+                                                 SignalDerivativeType& derivatives) const override;
+
     virtual void SetStaticParameter(const ParameterNameType& name, const StaticParameterValuesType& values);
     virtual StaticParameterValuesType GetStaticParameterValue(const ParameterNameType& name) const;
 
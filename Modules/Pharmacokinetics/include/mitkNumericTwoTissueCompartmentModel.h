@@ -65,6 +65,9 @@ namespace mitk
 
     static const unsigned int NUMBER_OF_PARAMETERS;
 
+    /** Step size (in s) of the Runge-Kutta integration of the mass balance equations.*/
+    static const double ODE_STEP_SIZE;
+
     virtual std::string GetModelDisplayName() const override;
 
     virtual std::string GetModelType() const override;
@@ -86,6 +89,10 @@ namespace mitk
 
     virtual ModelResultType ComputeModelfunction(const ParametersType& parameters) const override;
 
+    /** Derivatives are computed by integrating the sensitivity equations together with the model.*/
+    virtual bool ComputeModelfunctionDerivatives(const ParametersType& parameters, ModelResultType& signal,
+                                                 SignalDerivativeType& derivatives) const override;
+
     virtual void PrintSelf(std::ostream& os, ::itk::Indent indent) const;
 
   private:
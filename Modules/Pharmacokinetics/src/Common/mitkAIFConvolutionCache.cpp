@@ -0,0 +1,130 @@
+/*===================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center,
+Division of Medical and Biological Informatics.
+All rights reserved.
+
+This software is distributed WITHOUT ANY WARRANTY; without
+even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE.
+
+See LICENSE.txt or http://www.mitk.org for details.
+
+===================================================================*/
+
+#include "mitkAIFConvolutionCache.h"
+#include "mitkTimeGridHelper.h"
+
+#include <cmath>
+
+mitk::AIFConvolutionCache::AIFConvolutionCache() : m_IsEquidistant(false)
+{
+}
+
+mitk::AIFConvolutionCache::~AIFConvolutionCache()
+{
+}
+
+void mitk::AIFConvolutionCache::Initialize(const TimeGridType& timeGrid, const AterialInputFunctionType& aif,
+  const TimeGridType& aifTimeGrid)
+{
+  if (timeGrid.GetSize() == 0)
+  {
+    itkExceptionMacro("No Time Grid Set! Cannot initialize AIF convolution cache.");
+  }
+
+  const TimeGridType& sourceGrid = aifTimeGrid.empty() ? timeGrid : aifTimeGrid;
+  if (sourceGrid.GetSize() != aif.GetSize())
+  {
+    itkExceptionMacro("Number of elements of the AIF time grid does not match number of elements of the AIF.");
+  }
+
+  m_TimeGrid = timeGrid;
+  m_SourceAterialInputFunction = aif;
+  m_SourceAterialInputFunctionTimeGrid = aifTimeGrid;
+  m_AterialInputFunction = mitk::InterpolateSignalToNewTimeGrid(aif, sourceGrid, timeGrid);
+
+  const unsigned int segments = timeGrid.GetSize() - 1;
+  m_StepWidths.resize(segments);
+  m_Slopes.resize(segments);
+  m_Intercepts.resize(segments);
+
+  m_IsEquidistant = true;
+  for (unsigned int i = 0; i < segments; ++i)
+  {
+    const double dt = timeGrid(i + 1) - timeGrid(i);
+    const double m = (m_AterialInputFunction(i + 1) - m_AterialInputFunction(i)) / dt;
+
+    m_StepWidths[i] = dt;
+    m_Slopes[i] = m;
+    m_Intercepts[i] = m_AterialInputFunction(i) - m * timeGrid(i);
+
+    if (std::abs(dt - m_StepWidths[0]) > 1e-9 * std::abs(m_StepWidths[0]))
+    {
+      m_IsEquidistant = false;
+    }
+  }
+
+  this->Modified();
+}
+
+bool mitk::AIFConvolutionCache::IsInitializedWith(const TimeGridType& timeGrid, const AterialInputFunctionType& aif,
+  const TimeGridType& aifTimeGrid) const
+{
+  return m_TimeGrid == timeGrid && m_SourceAterialInputFunction == aif && m_SourceAterialInputFunctionTimeGrid == aifTimeGrid;
+}
+
+mitk::AIFConvolutionCache::ConvolutionResultType mitk::AIFConvolutionCache::ConvoluteWithExponential(double lambda) const
+{
+  const unsigned int timeSteps = m_TimeGrid.GetSize();
+  ConvolutionResultType convolution(timeSteps);
+  convolution.fill(0.0);
+
+  const double invLambda = 1.0 / lambda;
+  const double invLambda2 = invLambda * invLambda;
+
+  // one exponential for all segments if the sampling is equidistant
+  double edt = m_IsEquidistant && timeSteps > 1 ? std::exp(-lambda * m_StepWidths[0]) : 0.0;
+
+  for (unsigned int i = 0; i + 1 < timeSteps; ++i)
+  {
+    if (!m_IsEquidistant)
+    {
+      edt = std::exp(-lambda * m_StepWidths[i]);
+    }
+
+    convolution(i + 1) = edt * convolution(i)
+      + m_Intercepts[i] * invLambda * (1 - edt)
+      + m_Slopes[i] * invLambda2 * ((lambda * m_TimeGrid(i + 1) - 1) - edt * (lambda * m_TimeGrid(i) - 1));
+  }
+
+  return convolution;
+}
+
+mitk::AIFConvolutionCache::ConvolutionResultType mitk::AIFConvolutionCache::ConvoluteWithConstant(double constant) const
+{
+  const unsigned int timeSteps = m_TimeGrid.GetSize();
+  ConvolutionResultType convolution(timeSteps);
+  convolution.fill(0.0);
+
+  for (unsigned int i = 0; i + 1 < timeSteps; ++i)
+  {
+    const double dt = m_StepWidths[i];
+    const double m = m_Slopes[i];
+    convolution(i + 1) = convolution(i) + constant * (m_AterialInputFunction(i)*dt + m*m_TimeGrid(i)*dt
+      + m / 2 * (m_TimeGrid(i + 1)*m_TimeGrid(i + 1) - m_TimeGrid(i)*m_TimeGrid(i)));
+  }
+
+  return convolution;
+}
+
+void mitk::AIFConvolutionCache::PrintSelf(std::ostream& os, ::itk::Indent indent) const
+{
+  Superclass::PrintSelf(os, indent);
+
+  os << indent << "Time Grid: " << m_TimeGrid << std::endl;
+  os << indent << "Aterial Input Function: " << m_AterialInputFunction << std::endl;
+  os << indent << "Equidistant: " << m_IsEquidistant << std::endl;
+}
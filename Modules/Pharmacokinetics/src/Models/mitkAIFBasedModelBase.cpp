@@ -34,7 +34,7 @@ std::string mitk::AIFBasedModelBase::GetYAxisUnit() const
   return "";
 }
 
-mitk::AIFBasedModelBase::AIFBasedModelBase()
+mitk::AIFBasedModelBase::AIFBasedModelBase() : m_AIFConvolutionCacheMTime(0)
 {
 }
 
@@ -69,6 +69,34 @@ mitk::AIFBasedModelBase::GetAterialInputFunction(TimeGridType CurrentTimeGrid) c
   }
 }
 
+mitk::AIFConvolutionCache::ConstPointer mitk::AIFBasedModelBase::GetAIFConvolutionCache() const
+{
+  std::lock_guard<std::mutex> lock(m_AIFConvolutionCacheMutex);
+
+  if (m_AIFConvolutionCache.IsNull() || m_AIFConvolutionCacheMTime != this->GetMTime())
+  {
+    if (m_AIFConvolutionCache.IsNull() || !m_AIFConvolutionCache->IsInitializedWith(this->m_TimeGrid,
+        this->m_AterialInputFunctionValues, this->m_AterialInputFunctionTimeGrid))
+    {
+      AIFConvolutionCache::Pointer cache = AIFConvolutionCache::New();
+      cache->Initialize(this->m_TimeGrid, this->m_AterialInputFunctionValues, this->m_AterialInputFunctionTimeGrid);
+      m_AIFConvolutionCache = cache.GetPointer();
+    }
+    m_AIFConvolutionCacheMTime = this->GetMTime();
+  }
+
+  return m_AIFConvolutionCache;
+}
+
+void mitk::AIFBasedModelBase::SetAIFConvolutionCache(const AIFConvolutionCache* cache)
+{
+  std::lock_guard<std::mutex> lock(m_AIFConvolutionCacheMutex);
+
+  m_AIFConvolutionCache = cache;
+  // forces the validation of the cache on its first use
+  m_AIFConvolutionCacheMTime = 0;
+}
+
 mitk::AIFBasedModelBase::ParameterNamesType mitk::AIFBasedModelBase::GetStaticParameterNames() const
 {
   ParameterNamesType result;
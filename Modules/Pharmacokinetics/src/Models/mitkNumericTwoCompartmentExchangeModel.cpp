@@ -17,10 +17,7 @@ See LICENSE.txt or http://www.mitk.org for details.
 #include "mitkNumericTwoCompartmentExchangeModel.h"
 #include "mitkAIFParametrizerHelper.h"
 #include "mitkTimeGridHelper.h"
-#include "mitkTwoCompartmentExchangeModelDifferentialEquations.h"
-#include <vnl/algo/vnl_fft_1d.h>
-#include <boost/numeric/odeint.hpp>
-#include <fstream>
+#include "mitkFixedStepODEIntegrator.h"
 
 const std::string mitk::NumericTwoCompartmentExchangeModel::MODEL_DISPLAY_NAME =
   "Numeric Two Compartment Exchange Model";
@@ -44,6 +41,63 @@ const unsigned int mitk::NumericTwoCompartmentExchangeModel::NUMBER_OF_PARAMETER
 
 const std::string mitk::NumericTwoCompartmentExchangeModel::NAME_STATIC_PARAMETER_ODEINTStepSize = "ODEIntStepSize";
 
+namespace
+{
+  /** Mass balance equations of the two compartment exchange model, x = (Cp, Ce).*/
+  class TwoCompartmentExchangeSystem
+  {
+  public:
+    TwoCompartmentExchangeSystem(double F, double PS, double ve, double vp) : m_F(F), m_PS(PS), m_ve(ve), m_vp(vp)
+    {
+    }
+
+    void operator()(const mitk::FixedStepODEIntegrator<2>::StateType& x, mitk::FixedStepODEIntegrator<2>::StateType& dxdt,
+                    double ca) const
+    {
+      dxdt[0] = (m_F * (ca - x[0]) - m_PS * (x[0] - x[1])) / m_vp;
+      dxdt[1] = m_PS * (x[0] - x[1]) / m_ve;
+    }
+
+  private:
+    double m_F, m_PS, m_ve, m_vp;
+  };
+
+  /** Mass balance equations extended by the sensitivity equations d/dt (dx/dp) = J * dx/dp + df/dp.
+   * x = (Cp, Ce, dCp/dF, dCe/dF, dCp/dPS, dCe/dPS, dCp/dve, dCe/dve, dCp/dvp, dCe/dvp).*/
+  class TwoCompartmentExchangeSensitivitySystem
+  {
+  public:
+    TwoCompartmentExchangeSensitivitySystem(double F, double PS, double ve, double vp) : m_F(F), m_PS(PS), m_ve(ve), m_vp(vp)
+    {
+    }
+
+    void operator()(const mitk::FixedStepODEIntegrator<10>::StateType& x, mitk::FixedStepODEIntegrator<10>::StateType& dxdt,
+                    double ca) const
+    {
+      const double inflow = ca - x[0];
+      const double exchange = x[0] - x[1];
+
+      dxdt[0] = (m_F * inflow - m_PS * exchange) / m_vp;
+      dxdt[1] = m_PS * exchange / m_ve;
+
+      for (unsigned int p = 2; p < 10; p += 2)
+      {
+        dxdt[p] = (-(m_F + m_PS) * x[p] + m_PS * x[p + 1]) / m_vp;
+        dxdt[p + 1] = m_PS * (x[p] - x[p + 1]) / m_ve;
+      }
+
+      dxdt[2] += inflow / m_vp;
+      dxdt[4] -= exchange / m_vp;
+      dxdt[5] += exchange / m_ve;
+      dxdt[7] -= dxdt[1] / m_ve;
+      dxdt[8] -= dxdt[0] / m_vp;
+    }
+
+  private:
+    double m_F, m_PS, m_ve, m_vp;
+  };
+}
+
 
 std::string mitk::NumericTwoCompartmentExchangeModel::GetModelDisplayName() const
 {
@@ -56,7 +110,7 @@ std::string mitk::NumericTwoCompartmentExchangeModel::GetModelType() const
 };
 
 
-mitk::NumericTwoCompartmentExchangeModel::NumericTwoCompartmentExchangeModel()
+mitk::NumericTwoCompartmentExchangeModel::NumericTwoCompartmentExchangeModel() : m_ODEINTStepSize(0.05)
 {
 
 }
@@ -167,32 +221,19 @@ mitk::NumericTwoCompartmentExchangeModel::ModelResultType
 mitk::NumericTwoCompartmentExchangeModel::ComputeModelfunction(const ParametersType& parameters)
 const
 {
-  typedef itk::Array<double> ConcentrationCurveType;
-  typedef std::vector<double> ConcentrationVectorType;
-
   if (this->m_TimeGrid.GetSize() == 0)
   {
     itkExceptionMacro("No Time Grid Set! Cannot Calculate Signal");
   }
 
-  AterialInputFunctionType aterialInputFunction;
-  aterialInputFunction = GetAterialInputFunction(this->m_TimeGrid);
-
-  unsigned int timeSteps = this->m_TimeGrid.GetSize();
-
-  /** @brief Boost::numeric::odeint works with type std::vector<double> thus, aif and grid are converted to ModelParameters( of type std::vector)
-   */
-  mitk::TwoCompartmentExchangeModelDifferentialEquations::AIFType aif = mitk::convertArrayToParameter(
-        aterialInputFunction);
-  mitk::TwoCompartmentExchangeModelDifferentialEquations::AIFType grid =
-    mitk::convertArrayToParameter(m_TimeGrid);
-
-  mitk::TwoCompartmentExchangeModelDifferentialEquations::AIFType aifODE = aif;
-  aifODE.push_back(aif[timeSteps - 1]);
-  mitk::TwoCompartmentExchangeModelDifferentialEquations::AIFType gridODE = grid;
-  gridODE.push_back(grid[timeSteps - 1] + (grid[timeSteps - 1] - grid[timeSteps - 2]));
+  if (!(this->m_ODEINTStepSize > 0.0))
+  {
+    itkExceptionMacro("Invalid ODE step size (" << this->m_ODEINTStepSize << ")! Cannot Calculate Signal");
+  }
 
+  AIFConvolutionCache::ConstPointer convolutionCache = this->GetAIFConvolutionCache();
 
+  unsigned int timeSteps = this->m_TimeGrid.GetSize();
 
   //Model Parameters
   double F = (double) parameters[POSITION_PARAMETER_F] / 6000.0;
@@ -200,81 +241,74 @@ const
   double ve = (double) parameters[POSITION_PARAMETER_ve];
   double vp = (double) parameters[POSITION_PARAMETER_vp];
 
+  /** @brief states[i] = (Cp, Ce) at time point i of the time grid*/
+  TwoCompartmentExchangeSystem system(F, PS, ve, vp);
+  FixedStepODEIntegrator<2>::StatesType states;
+  FixedStepODEIntegrator<2>::IntegrateOnTimeGrid(system, *convolutionCache, this->m_ODEINTStepSize, states);
 
-  /** @brief Initialize class TwoCompartmentExchangeModelDifferentialEquations defining the differential equations. AIF and Grid must be set so that at step t the aterial Concentration Ca(t) can be interpolated from AIF*/
-  mitk::TwoCompartmentExchangeModelDifferentialEquations ode;
-  ode.initialize(F, PS, ve, vp);
-  ode.setAIF(aifODE);
-  ode.setAIFTimeGrid(gridODE);
-
-  state_type x(2);
-  x[0] = 0.0;
-  x[1] = 0.0;
-  typedef boost::numeric::odeint::runge_kutta_cash_karp54<state_type> error_stepper_type;
-  //typedef boost::numeric::odeint::runge_kutta4< state_type > stepper_type;
-
-  /** @brief Results of odeeint x[0] and x[1]*/
-  ConcentrationVectorType Cp;
-  ConcentrationVectorType Ce;
-  ConcentrationVectorType odeTimeGrid;
-
-  error_stepper_type stepper;
+  //Signal that will be returned by ComputeModelFunction
+  mitk::ModelBase::ModelResultType signal(timeSteps);
 
+  for (unsigned int i = 0; i < timeSteps; ++i)
+  {
+    signal[i] = vp * states[i][0] + ve * states[i][1];
+  }
 
-  /** @brief Stepsize. Should be adapted by stepper (runge_kutta_cash_karp54) */
-//  const double dt = 0.05;
-   const double dt = this->m_ODEINTStepSize;
+  return signal;
 
+}
 
-  /** @brief perform Step t -> t+dt to calculate approximate value x(t+dt)*/
-  for (double t = 0.0; t < this->m_TimeGrid(this->m_TimeGrid.GetSize() - 1) - 2*dt; t += dt)
+bool mitk::NumericTwoCompartmentExchangeModel::ComputeModelfunctionDerivatives(const ParametersType& parameters,
+    ModelResultType& signal, SignalDerivativeType& derivatives) const
+{
+  if (this->m_TimeGrid.GetSize() == 0)
   {
-    stepper.do_step(ode, x, t, dt);
-    Cp.push_back(x[0]);
-    Ce.push_back(x[1]);
-    odeTimeGrid.push_back(t);
+    itkExceptionMacro("No Time Grid Set! Cannot Calculate Signal");
   }
 
-  /** @brief transfom result of Differential equations back to itk::Array and interpolate to m_TimeGrid (they are calculated on a different grid defined by stepsize of odeint)*/
-  ConcentrationCurveType plasmaConcentration = mitk::convertParameterToArray(Cp);
-  ConcentrationCurveType EESConcentration = mitk::convertParameterToArray(Ce);
-  ConcentrationCurveType rungeKuttaTimeGrid = mitk::convertParameterToArray(odeTimeGrid);
-
-  mitk::ModelBase::ModelResultType C_Plasma = mitk::InterpolateSignalToNewTimeGrid(plasmaConcentration, rungeKuttaTimeGrid, m_TimeGrid);
-  mitk::ModelBase::ModelResultType C_EES = mitk::InterpolateSignalToNewTimeGrid(EESConcentration, rungeKuttaTimeGrid, m_TimeGrid);
-
+  if (!(this->m_ODEINTStepSize > 0.0))
+  {
+    itkExceptionMacro("Invalid ODE step size (" << this->m_ODEINTStepSize << ")! Cannot Calculate Signal");
+  }
 
-  //Signal that will be returned by ComputeModelFunction
-  mitk::ModelBase::ModelResultType signal(timeSteps);
-  signal.fill(0.0);
+  AIFConvolutionCache::ConstPointer convolutionCache = this->GetAIFConvolutionCache();
 
-  mitk::ModelBase::ModelResultType::iterator signalPos = signal.begin();
-  mitk::ModelBase::ModelResultType::const_iterator CePos = C_EES.begin();
+  unsigned int timeSteps = this->m_TimeGrid.GetSize();
 
-  mitk::ModelBase::ModelResultType::const_iterator t = this->m_TimeGrid.begin();
-  mitk::ModelBase::ModelResultType::const_iterator Cin = aterialInputFunction.begin();
+  double F = (double) parameters[POSITION_PARAMETER_F] / 6000.0;
+  double PS  = (double) parameters[POSITION_PARAMETER_PS] / 6000.0;
+  double ve = (double) parameters[POSITION_PARAMETER_ve];
+  double vp = (double) parameters[POSITION_PARAMETER_vp];
 
+  TwoCompartmentExchangeSensitivitySystem system(F, PS, ve, vp);
+  FixedStepODEIntegrator<10>::StatesType states;
+  FixedStepODEIntegrator<10>::IntegrateOnTimeGrid(system, *convolutionCache, this->m_ODEINTStepSize, states);
 
+  signal.SetSize(timeSteps);
+  derivatives.SetSize(NUMBER_OF_PARAMETERS, timeSteps);
 
-  for (mitk::ModelBase::ModelResultType::const_iterator CpPos = C_Plasma.begin();
-       CpPos != C_Plasma.end(); ++CpPos, ++CePos, ++signalPos, ++t, ++Cin)
+  for (unsigned int i = 0; i < timeSteps; ++i)
   {
-    *signalPos = vp * (*CpPos) + ve * (*CePos);
+    const FixedStepODEIntegrator<10>::StateType& x = states[i];
 
-  }
+    signal[i] = vp * x[0] + ve * x[1];
 
-  return signal;
+    // F and PS are passed in ml/min/100ml but used in 1/s
+    derivatives[POSITION_PARAMETER_F][i] = (vp * x[2] + ve * x[3]) / 6000.0;
+    derivatives[POSITION_PARAMETER_PS][i] = (vp * x[4] + ve * x[5]) / 6000.0;
+    derivatives[POSITION_PARAMETER_ve][i] = vp * x[6] + ve * x[7] + x[1];
+    derivatives[POSITION_PARAMETER_vp][i] = vp * x[8] + ve * x[9] + x[0];
+  }
 
+  return true;
 }
 
-
-
-
 itk::LightObject::Pointer mitk::NumericTwoCompartmentExchangeModel::InternalClone() const
 {
   NumericTwoCompartmentExchangeModel::Pointer newClone = NumericTwoCompartmentExchangeModel::New();
 
   newClone->SetTimeGrid(this->m_TimeGrid);
+  newClone->SetODEINTStepSize(this->m_ODEINTStepSize);
 
   return newClone.GetPointer();
 }
@@ -17,10 +17,7 @@ See LICENSE.txt or http://www.mitk.org for details.
 #include "mitkNumericTwoTissueCompartmentModel.h"
 #include "mitkAIFParametrizerHelper.h"
 #include "mitkTimeGridHelper.h"
-#include "mitkTwoTissueCompartmentModelDifferentialEquations.h"
-#include <vnl/algo/vnl_fft_1d.h>
-#include <boost/numeric/odeint.hpp>
-#include <fstream>
+#include "mitkFixedStepODEIntegrator.h"
 
 const std::string mitk::NumericTwoTissueCompartmentModel::MODEL_DISPLAY_NAME =
   "Numeric Two Tissue Compartment Model";
@@ -45,6 +42,63 @@ const unsigned int mitk::NumericTwoTissueCompartmentModel::POSITION_PARAMETER_VB
 
 const unsigned int mitk::NumericTwoTissueCompartmentModel::NUMBER_OF_PARAMETERS = 5;
 
+const double mitk::NumericTwoTissueCompartmentModel::ODE_STEP_SIZE = 0.1;
+
+namespace
+{
+  /** Mass balance equations of the two tissue compartment model, x = (C1, C2).*/
+  class TwoTissueCompartmentSystem
+  {
+  public:
+    TwoTissueCompartmentSystem(double K1, double k2, double k3, double k4) : m_K1(K1), m_k2(k2), m_k3(k3), m_k4(k4)
+    {
+    }
+
+    void operator()(const mitk::FixedStepODEIntegrator<2>::StateType& x, mitk::FixedStepODEIntegrator<2>::StateType& dxdt,
+                    double ca) const
+    {
+      dxdt[0] = m_K1 * ca - (m_k2 + m_k3) * x[0] + m_k4 * x[1];
+      dxdt[1] = m_k3 * x[0] - m_k4 * x[1];
+    }
+
+  private:
+    double m_K1, m_k2, m_k3, m_k4;
+  };
+
+  /** Mass balance equations extended by the sensitivity equations d/dt (dx/dp) = J * dx/dp + df/dp.
+   * x = (C1, C2, dC1/dK1, dC2/dK1, dC1/dk2, dC2/dk2, dC1/dk3, dC2/dk3, dC1/dk4, dC2/dk4).*/
+  class TwoTissueCompartmentSensitivitySystem
+  {
+  public:
+    TwoTissueCompartmentSensitivitySystem(double K1, double k2, double k3, double k4) : m_K1(K1), m_k2(k2), m_k3(k3), m_k4(k4)
+    {
+    }
+
+    void operator()(const mitk::FixedStepODEIntegrator<10>::StateType& x, mitk::FixedStepODEIntegrator<10>::StateType& dxdt,
+                    double ca) const
+    {
+      dxdt[0] = m_K1 * ca - (m_k2 + m_k3) * x[0] + m_k4 * x[1];
+      dxdt[1] = m_k3 * x[0] - m_k4 * x[1];
+
+      for (unsigned int p = 2; p < 10; p += 2)
+      {
+        dxdt[p] = -(m_k2 + m_k3) * x[p] + m_k4 * x[p + 1];
+        dxdt[p + 1] = m_k3 * x[p] - m_k4 * x[p + 1];
+      }
+
+      dxdt[2] += ca;
+      dxdt[4] -= x[0];
+      dxdt[6] -= x[0];
+      dxdt[7] += x[0];
+      dxdt[8] += x[1];
+      dxdt[9] -= x[1];
+    }
+
+  private:
+    double m_K1, m_k2, m_k3, m_k4;
+  };
+}
+
 
 std::string mitk::NumericTwoTissueCompartmentModel::GetModelDisplayName() const
 {
@@ -104,31 +158,16 @@ mitk::NumericTwoTissueCompartmentModel::GetParameterUnits() const
 mitk::NumericTwoTissueCompartmentModel::ModelResultType
 mitk::NumericTwoTissueCompartmentModel::ComputeModelfunction(const ParametersType& parameters) const
 {
-  typedef itk::Array<double> ConcentrationCurveType;
-  typedef std::vector<double> ConcentrationVectorType;
-
   if (this->m_TimeGrid.GetSize() == 0)
   {
     itkExceptionMacro("No Time Grid Set! Cannot Calculate Signal");
   }
 
-  AterialInputFunctionType aterialInputFunction;
-  aterialInputFunction = GetAterialInputFunction(this->m_TimeGrid);
+  AIFConvolutionCache::ConstPointer convolutionCache = this->GetAIFConvolutionCache();
+  const AterialInputFunctionType& aterialInputFunction = convolutionCache->GetAterialInputFunction();
 
   unsigned int timeSteps = this->m_TimeGrid.GetSize();
 
-  /** @brief Boost::numeric::odeint works with type std::vector<double> thus, aif and grid are converted to ModelParameters( of type std::vector)
-   */
-  mitk::TwoTissueCompartmentModelDifferentialEquations::AIFType aif = mitk::convertArrayToParameter(
-        aterialInputFunction);
-  mitk::TwoTissueCompartmentModelDifferentialEquations::AIFType grid = mitk::convertArrayToParameter(
-        m_TimeGrid);
-
-  mitk::TwoTissueCompartmentModelDifferentialEquations::AIFType aifODE = aif;
-  aifODE.push_back(aif[timeSteps - 1]);
-  mitk::TwoTissueCompartmentModelDifferentialEquations::AIFType gridODE = grid;
-  gridODE.push_back(grid[timeSteps - 1] + (grid[timeSteps - 1] - grid[timeSteps - 2]));
-
   //Model Parameters
   double K1 = (double)parameters[POSITION_PARAMETER_K1] / 60.0;
   double k2 = (double)parameters[POSITION_PARAMETER_k2] / 60.0;
@@ -136,67 +175,64 @@ mitk::NumericTwoTissueCompartmentModel::ComputeModelfunction(const ParametersTyp
   double k4 = (double)parameters[POSITION_PARAMETER_k4] / 60.0;
   double VB = parameters[POSITION_PARAMETER_VB];
 
+  TwoTissueCompartmentSystem system(K1, k2, k3, k4);
+  FixedStepODEIntegrator<2>::StatesType states;
+  FixedStepODEIntegrator<2>::IntegrateOnTimeGrid(system, *convolutionCache, ODE_STEP_SIZE, states);
 
-  /** @brief Initialize class TwpTissueCompartmentModelDifferentialEquations defining the differential equations. AIF and Grid must be set so that at step t the aterial Concentration Ca(t) can be interpolated from AIF*/
-  mitk::TwoTissueCompartmentModelDifferentialEquations ode;
-  ode.initialize(K1, k2, k3, k4);
-  ode.setAIF(aifODE);
-  ode.setAIFTimeGrid(gridODE);
-
-  state_type x(2);
-  x[0] = 0.0;
-  x[1] = 0.0;
-  typedef boost::numeric::odeint::runge_kutta_cash_karp54<state_type> error_stepper_type;
-  //typedef boost::numeric::odeint::runge_kutta4< state_type > stepper_type;
+  //Signal that will be returned by ComputeModelFunction
+  mitk::ModelBase::ModelResultType signal(timeSteps);
 
-  /** @brief Results of odeeint x[0] and x[1]*/
-  ConcentrationVectorType C1;
-  ConcentrationVectorType C2;
-  ConcentrationVectorType odeTimeGrid;
+  for (unsigned int i = 0; i < timeSteps; ++i)
+  {
+    signal[i] = VB * aterialInputFunction[i] + (1 - VB) * (states[i][0] + states[i][1]);
+  }
 
-  error_stepper_type stepper;
-  /** @brief Stepsize. Should be adapted by stepper (runge_kutta_cash_karp54) */
-  const double dt = 0.1;
-  /** @brief perform Step t -> t+dt to calculate approximate value x(t+dt)*/
+  return signal;
 
-  double T = this->m_TimeGrid(timeSteps - 1) + (grid[timeSteps - 1] - grid[timeSteps - 2]);
+}
 
-  for (double t = 0.0; t < T; t += dt)
+bool mitk::NumericTwoTissueCompartmentModel::ComputeModelfunctionDerivatives(const ParametersType& parameters,
+    ModelResultType& signal, SignalDerivativeType& derivatives) const
+{
+  if (this->m_TimeGrid.GetSize() == 0)
   {
-    stepper.do_step(ode, x, t, dt);
-    C1.push_back(x[0]);
-    C2.push_back(x[1]);
-    odeTimeGrid.push_back(t);
-
+    itkExceptionMacro("No Time Grid Set! Cannot Calculate Signal");
   }
 
-  /** @brief transfom result of Differential equations back to itk::Array and interpolate to m_TimeGrid (they are calculated on a different grid defined by stepsize of odeint)*/
-  ConcentrationCurveType ConcentrationCompartment1 = mitk::convertParameterToArray(C1);
-  ConcentrationCurveType ConcentrationCompartment2 = mitk::convertParameterToArray(C2);
-  ConcentrationCurveType rungeKuttaTimeGrid = mitk::convertParameterToArray(odeTimeGrid);
+  AIFConvolutionCache::ConstPointer convolutionCache = this->GetAIFConvolutionCache();
+  const AterialInputFunctionType& aterialInputFunction = convolutionCache->GetAterialInputFunction();
 
-  mitk::ModelBase::ModelResultType C_1 = mitk::InterpolateSignalToNewTimeGrid(
-      ConcentrationCompartment1, rungeKuttaTimeGrid, m_TimeGrid);
-  mitk::ModelBase::ModelResultType C_2 = mitk::InterpolateSignalToNewTimeGrid(
-      ConcentrationCompartment2, rungeKuttaTimeGrid, m_TimeGrid);
+  unsigned int timeSteps = this->m_TimeGrid.GetSize();
 
+  double K1 = (double)parameters[POSITION_PARAMETER_K1] / 60.0;
+  double k2 = (double)parameters[POSITION_PARAMETER_k2] / 60.0;
+  double k3 = (double)parameters[POSITION_PARAMETER_k3] / 60.0;
+  double k4 = (double)parameters[POSITION_PARAMETER_k4] / 60.0;
+  double VB = parameters[POSITION_PARAMETER_VB];
 
-  //Signal that will be returned by ComputeModelFunction
-  mitk::ModelBase::ModelResultType signal(timeSteps);
-  signal.fill(0.0);
-  mitk::ModelBase::ModelResultType::iterator signalPos = signal.begin();
-  mitk::ModelBase::ModelResultType::const_iterator C1Pos = C_1.begin();
-  mitk::ModelBase::ModelResultType::const_iterator C2Pos = C_2.begin();
+  TwoTissueCompartmentSensitivitySystem system(K1, k2, k3, k4);
+  FixedStepODEIntegrator<10>::StatesType states;
+  FixedStepODEIntegrator<10>::IntegrateOnTimeGrid(system, *convolutionCache, ODE_STEP_SIZE, states);
 
+  signal.SetSize(timeSteps);
+  derivatives.SetSize(NUMBER_OF_PARAMETERS, timeSteps);
 
-  for (AterialInputFunctionType::const_iterator aifpos = aterialInputFunction.begin();
-       aifpos != aterialInputFunction.end(); ++aifpos, ++C1Pos, ++C2Pos, ++signalPos)
+  for (unsigned int i = 0; i < timeSteps; ++i)
   {
-    *signalPos = VB * (*aifpos) + (1 - VB) * (*C1Pos + *C2Pos);
-  }
+    const FixedStepODEIntegrator<10>::StateType& x = states[i];
+    const double tissue = x[0] + x[1];
 
-  return signal;
+    signal[i] = VB * aterialInputFunction[i] + (1 - VB) * tissue;
+
+    // rate constants are passed in 1/min but used in 1/s
+    derivatives[POSITION_PARAMETER_K1][i] = (1 - VB) * (x[2] + x[3]) / 60.0;
+    derivatives[POSITION_PARAMETER_k2][i] = (1 - VB) * (x[4] + x[5]) / 60.0;
+    derivatives[POSITION_PARAMETER_k3][i] = (1 - VB) * (x[6] + x[7]) / 60.0;
+    derivatives[POSITION_PARAMETER_k4][i] = (1 - VB) * (x[8] + x[9]) / 60.0;
+    derivatives[POSITION_PARAMETER_VB][i] = aterialInputFunction[i] - tissue;
+  }
 
+  return true;
 }
 
 itk::LightObject::Pointer mitk::NumericTwoTissueCompartmentModel::InternalClone() const
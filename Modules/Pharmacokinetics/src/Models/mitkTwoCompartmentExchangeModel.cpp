@@ -107,8 +107,8 @@ mitk::TwoCompartmentExchangeModel::ComputeModelfunction(const ParametersType& pa
     itkExceptionMacro("No Time Grid Set! Cannot Calculate Signal");
     }
 
-    AterialInputFunctionType aterialInputFunction;
-    aterialInputFunction = GetAterialInputFunction(this->m_TimeGrid);
+    AIFConvolutionCache::ConstPointer convolutionCache = this->GetAIFConvolutionCache();
+    const AterialInputFunctionType& aterialInputFunction = convolutionCache->GetAterialInputFunction();
 
     unsigned int timeSteps = this->m_TimeGrid.GetSize();
     mitk::ModelBase::ModelResultType signal(timeSteps);
@@ -133,8 +133,8 @@ mitk::TwoCompartmentExchangeModel::ComputeModelfunction(const ParametersType& pa
 
 
 
-        ConvolutionResultType expp = mitk::convoluteAIFWithExponential(this->m_TimeGrid, aterialInputFunction,Kp);
-        ConvolutionResultType expm = mitk::convoluteAIFWithExponential(this->m_TimeGrid, aterialInputFunction,Km);
+        ConvolutionResultType expp = convolutionCache->ConvoluteWithExponential(Kp);
+        ConvolutionResultType expm = convolutionCache->ConvoluteWithExponential(Km);
 
         //Signal that will be returned by ComputeModelFunction
 
@@ -151,7 +151,7 @@ mitk::TwoCompartmentExchangeModel::ComputeModelfunction(const ParametersType& pa
     else
     {
         double Kp = F/vp;
-        ConvolutionResultType exp = mitk::convoluteAIFWithExponential(this->m_TimeGrid, aterialInputFunction,Kp);
+        ConvolutionResultType exp = convolutionCache->ConvoluteWithExponential(Kp);
         mitk::ModelBase::ModelResultType::const_iterator expPos = exp.begin();
 
         for( mitk::ModelBase::ModelResultType::iterator signalPos = signal.begin(); signalPos!=signal.end(); ++expPos, ++signalPos)
@@ -96,8 +96,8 @@ mitk::TwoTissueCompartmentFDGModel::ComputeModelfunction(const ParametersType& p
     itkExceptionMacro("No Time Grid Set! Cannot Calculate Signal");
   }
 
-  AterialInputFunctionType aterialInputFunction;
-  aterialInputFunction = GetAterialInputFunction(this->m_TimeGrid);
+  AIFConvolutionCache::ConstPointer convolutionCache = this->GetAIFConvolutionCache();
+  const AterialInputFunctionType& aterialInputFunction = convolutionCache->GetAterialInputFunction();
 
 
   unsigned int timeSteps = this->m_TimeGrid.GetSize();
@@ -113,9 +113,8 @@ mitk::TwoTissueCompartmentFDGModel::ComputeModelfunction(const ParametersType& p
 
   double lambda = k2+k3;
   //double lambda2 = -alpha2;
-  mitk::ModelBase::ModelResultType exp = mitk::convoluteAIFWithExponential(this->m_TimeGrid,
-                                          aterialInputFunction, lambda);
-  mitk::ModelBase::ModelResultType CA = mitk::convoluteAIFWithConstant(this->m_TimeGrid, aterialInputFunction, k3);
+  mitk::ModelBase::ModelResultType exp = convolutionCache->ConvoluteWithExponential(lambda);
+  mitk::ModelBase::ModelResultType CA = convolutionCache->ConvoluteWithConstant(k3);
 
 
   //Signal that will be returned by ComputeModelFunction
@@ -107,8 +107,8 @@ mitk::TwoTissueCompartmentModel::ComputeModelfunction(const ParametersType& para
     itkExceptionMacro("No Time Grid Set! Cannot Calculate Signal");
   }
 
-  AterialInputFunctionType aterialInputFunction;
-  aterialInputFunction = GetAterialInputFunction(this->m_TimeGrid);
+  AIFConvolutionCache::ConstPointer convolutionCache = this->GetAIFConvolutionCache();
+  const AterialInputFunctionType& aterialInputFunction = convolutionCache->GetAterialInputFunction();
 
 
   unsigned int timeSteps = this->m_TimeGrid.GetSize();
@@ -127,10 +127,8 @@ mitk::TwoTissueCompartmentModel::ComputeModelfunction(const ParametersType& para
 
   //double lambda1 = -alpha1;
   //double lambda2 = -alpha2;
-  mitk::ModelBase::ModelResultType exp1 = mitk::convoluteAIFWithExponential(this->m_TimeGrid,
-                                          aterialInputFunction, alpha1);
-  mitk::ModelBase::ModelResultType exp2 = mitk::convoluteAIFWithExponential(this->m_TimeGrid,
-                                          aterialInputFunction, alpha2);
+  mitk::ModelBase::ModelResultType exp1 = convolutionCache->ConvoluteWithExponential(alpha1);
+  mitk::ModelBase::ModelResultType exp2 = convolutionCache->ConvoluteWithExponential(alpha2);
 
 
   //Signal that will be returned by ComputeModelFunction
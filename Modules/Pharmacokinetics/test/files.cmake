@@ -1,4 +1,6 @@
 SET(MODULE_TESTS
   mitkDescriptivePharmacokineticBrixModelTest.cpp
+  mitkAIFConvolutionCacheTest.cpp
+  mitkNumericCompartmentModelsTest.cpp
   #ConvertToConcentrationTest.cpp
 )
@@ -0,0 +1,161 @@
+/*===================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center,
+Division of Medical and Biological Informatics.
+All rights reserved.
+
+This software is distributed WITHOUT ANY WARRANTY; without
+even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE.
+
+See LICENSE.txt or http://www.mitk.org for details.
+
+===================================================================*/
+
+#include <algorithm>
+#include <cmath>
+
+#include <itkTimeProbe.h>
+
+#include "mitkTestingMacros.h"
+
+#include "mitkAIFConvolutionCache.h"
+#include "mitkConvolutionHelper.h"
+#include "mitkTimeGridHelper.h"
+#include "mitkStandardToftsModel.h"
+#include "mitkStandardToftsModelParameterizer.h"
+
+namespace
+{
+  mitk::AIFBasedModelBase::AterialInputFunctionType generateAIF(const mitk::ModelBase::TimeGridType& grid)
+  {
+    mitk::AIFBasedModelBase::AterialInputFunctionType aif(grid.GetSize());
+    for (unsigned int i = 0; i < grid.GetSize(); ++i)
+    {
+      const double t = std::max(grid[i] - 20.0, 0.0) / 10.0;
+      aif[i] = 5.0 * t * t * std::exp(-t);
+    }
+    return aif;
+  }
+
+  mitk::ModelBase::ModelResultType scale(const mitk::ModelBase::ModelResultType& values, double factor)
+  {
+    mitk::ModelBase::ModelResultType result(values.GetSize());
+    for (unsigned int i = 0; i < values.GetSize(); ++i)
+    {
+      result[i] = values[i] * factor;
+    }
+    return result;
+  }
+
+  bool isEqual(const mitk::ModelBase::ModelResultType& a, const mitk::ModelBase::ModelResultType& b)
+  {
+    if (a.GetSize() != b.GetSize())
+    {
+      return false;
+    }
+    for (unsigned int i = 0; i < a.GetSize(); ++i)
+    {
+      if (std::abs(a[i] - b[i]) > 1e-9 * (1.0 + std::abs(a[i])))
+      {
+        return false;
+      }
+    }
+    return true;
+  }
+}
+
+int mitkAIFConvolutionCacheTest(int  /*argc*/ , char*[] /*argv[]*/)
+{
+  MITK_TEST_BEGIN("AIFConvolutionCache")
+
+  mitk::ModelBase::TimeGridType grid(60);
+  mitk::ModelBase::TimeGridType irregularGrid(60);
+  for (unsigned int i = 0; i < grid.GetSize(); ++i)
+  {
+    grid[i] = 0.1 * 50 * i;
+    irregularGrid[i] = 295.0 * std::pow(i / 59.0, 1.3);
+  }
+  mitk::AIFBasedModelBase::AterialInputFunctionType aif = generateAIF(grid);
+  mitk::ModelBase::TimeGridType emptyGrid;
+
+  mitk::AIFConvolutionCache::Pointer cache = mitk::AIFConvolutionCache::New();
+  cache->Initialize(grid, aif, emptyGrid);
+  MITK_TEST_CONDITION(cache->IsInitializedWith(grid, aif, emptyGrid), "Check IsInitializedWith() for the passed values");
+  MITK_TEST_CONDITION(!cache->IsInitializedWith(irregularGrid, aif, emptyGrid), "Check IsInitializedWith() for another time grid");
+
+  const double lambdas[] = { 1e-3, 0.05, 0.7 };
+  for (double lambda : lambdas)
+  {
+    MITK_TEST_CONDITION(isEqual(cache->ConvoluteWithExponential(lambda), mitk::convoluteAIFWithExponential(grid, aif, lambda)),
+      "Check exponential convolution on equidistant grid, lambda = " << lambda);
+  }
+  MITK_TEST_CONDITION(isEqual(cache->ConvoluteWithConstant(0.3), mitk::convoluteAIFWithConstant(grid, aif, 0.3)),
+    "Check constant convolution");
+
+  // AIF defined on another time grid is interpolated to the model grid
+  mitk::AIFConvolutionCache::Pointer irregularCache = mitk::AIFConvolutionCache::New();
+  irregularCache->Initialize(irregularGrid, aif, grid);
+  mitk::AIFBasedModelBase::AterialInputFunctionType interpolatedAIF = mitk::InterpolateSignalToNewTimeGrid(aif, grid, irregularGrid);
+  MITK_TEST_CONDITION(isEqual(irregularCache->GetAterialInputFunction(), interpolatedAIF), "Check interpolated AIF");
+  for (double lambda : lambdas)
+  {
+    MITK_TEST_CONDITION(isEqual(irregularCache->ConvoluteWithExponential(lambda), mitk::convoluteAIFWithExponential(irregularGrid, interpolatedAIF, lambda)),
+      "Check exponential convolution on irregular grid, lambda = " << lambda);
+  }
+
+  mitk::ModelBase::TimeGridType shortGrid(10);
+  shortGrid.Fill(0.0);
+  MITK_TEST_FOR_EXCEPTION_BEGIN(itk::ExceptionObject)
+  cache->Initialize(grid, aif, shortGrid);
+  MITK_TEST_FOR_EXCEPTION_END(itk::ExceptionObject)
+
+  // models generated by one parameterizer share the cache and compute the same signal as before
+  mitk::StandardToftsModelParameterizer::Pointer parameterizer = mitk::StandardToftsModelParameterizer::New();
+  parameterizer->SetDefaultTimeGrid(grid);
+  parameterizer->SetAIF(aif);
+  parameterizer->SetAIFTimeGrid(grid);
+
+  mitk::ModelBase::Pointer model1 = parameterizer->GenerateParameterizedModel();
+  mitk::ModelBase::Pointer model2 = parameterizer->GenerateParameterizedModel();
+  mitk::StandardToftsModel* toftsModel1 = dynamic_cast<mitk::StandardToftsModel*>(model1.GetPointer());
+  mitk::StandardToftsModel* toftsModel2 = dynamic_cast<mitk::StandardToftsModel*>(model2.GetPointer());
+  MITK_TEST_CONDITION_REQUIRED(toftsModel1 && toftsModel2, "Check generated models");
+  MITK_TEST_CONDITION(toftsModel1->GetAIFConvolutionCache() == toftsModel2->GetAIFConvolutionCache(), "Check that models share the cache");
+
+  mitk::ModelBase::ParametersType parameters(2);
+  parameters[mitk::StandardToftsModel::POSITION_PARAMETER_Ktrans] = 20;
+  parameters[mitk::StandardToftsModel::POSITION_PARAMETER_ve] = 0.4;
+  const double ktrans = 20 / 6000.0;
+  mitk::ModelBase::ModelResultType expectedSignal = scale(mitk::convoluteAIFWithExponential(grid, aif, ktrans / 0.4), ktrans);
+  MITK_TEST_CONDITION(isEqual(model1->GetSignal(parameters), expectedSignal), "Check signal of the model");
+
+  // changing the model invalidates its cache
+  toftsModel2->SetAterialInputFunctionValues(scale(aif, 2.0));
+  MITK_TEST_CONDITION(toftsModel1->GetAIFConvolutionCache() != toftsModel2->GetAIFConvolutionCache(), "Check that a changed model does not use the shared cache");
+  MITK_TEST_CONDITION(isEqual(model2->GetSignal(parameters), scale(expectedSignal, 2.0)), "Check signal of the changed model");
+
+  // compare with the uncached path; informative only, the numbers depend on the machine
+  const unsigned int repetitions = 20000;
+  double checksum = 0;
+  itk::TimeProbe uncachedProbe;
+  uncachedProbe.Start();
+  for (unsigned int i = 0; i < repetitions; ++i)
+  {
+    checksum += mitk::convoluteAIFWithExponential(grid, aif, 0.01 + 1e-6 * i)[59];
+  }
+  uncachedProbe.Stop();
+  itk::TimeProbe cachedProbe;
+  cachedProbe.Start();
+  for (unsigned int i = 0; i < repetitions; ++i)
+  {
+    checksum -= cache->ConvoluteWithExponential(0.01 + 1e-6 * i)[59];
+  }
+  cachedProbe.Stop();
+  MITK_INFO << "Exponential convolution, " << repetitions << " repetitions: uncached " << uncachedProbe.GetTotal()
+            << " s, cached " << cachedProbe.GetTotal() << " s (checksum difference " << checksum << ")";
+
+  MITK_TEST_END()
+}
@@ -0,0 +1,167 @@
+/*===================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center,
+Division of Medical and Biological Informatics.
+All rights reserved.
+
+This software is distributed WITHOUT ANY WARRANTY; without
+even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE.
+
+See LICENSE.txt or http://www.mitk.org for details.
+
+===================================================================*/
+
+#include <algorithm>
+#include <cmath>
+
+#include "mitkTestingMacros.h"
+
+#include "mitkNumericTwoCompartmentExchangeModel.h"
+#include "mitkNumericTwoTissueCompartmentModel.h"
+#include "mitkTwoCompartmentExchangeModel.h"
+#include "mitkTwoTissueCompartmentModel.h"
+
+namespace
+{
+  mitk::AIFBasedModelBase::AterialInputFunctionType generateAIF(const mitk::ModelBase::TimeGridType& grid)
+  {
+    mitk::AIFBasedModelBase::AterialInputFunctionType aif(grid.GetSize());
+    for (unsigned int i = 0; i < grid.GetSize(); ++i)
+    {
+      const double t = std::max(grid[i] - 20.0, 0.0) / 10.0;
+      aif[i] = 5.0 * t * t * std::exp(-t);
+    }
+    return aif;
+  }
+
+  /** Relative difference of two signals with respect to the maximum of the reference.*/
+  double signalDifference(const mitk::ModelBase::ModelResultType& reference, const mitk::ModelBase::ModelResultType& test)
+  {
+    double maxReference = 0.0;
+    double maxDifference = 0.0;
+    for (unsigned int i = 0; i < reference.GetSize(); ++i)
+    {
+      maxReference = std::max(maxReference, std::abs(reference[i]));
+      maxDifference = std::max(maxDifference, std::abs(reference[i] - test[i]));
+    }
+    return maxDifference / std::max(maxReference, 1e-12);
+  }
+
+  /** Checks the analytical derivatives of the model against central finite differences.*/
+  bool checkDerivatives(const mitk::ModelBase* model, const mitk::ModelBase::ParametersType& parameters)
+  {
+    mitk::ModelBase::ModelResultType signal;
+    mitk::ModelBase::SignalDerivativeType derivatives;
+    if (!model->GetSignalDerivatives(parameters, signal, derivatives))
+    {
+      return false;
+    }
+
+    if (signalDifference(model->GetSignal(parameters), signal) > 1e-12)
+    {
+      return false;
+    }
+
+    bool result = true;
+    for (unsigned int p = 0; p < parameters.GetSize(); ++p)
+    {
+      const double h = 1e-5 * std::max(std::abs(parameters[p]), 1.0);
+      mitk::ModelBase::ParametersType plus = parameters;
+      mitk::ModelBase::ParametersType minus = parameters;
+      plus[p] += h;
+      minus[p] -= h;
+      mitk::ModelBase::ModelResultType signalPlus = model->GetSignal(plus);
+      mitk::ModelBase::ModelResultType signalMinus = model->GetSignal(minus);
+
+      mitk::ModelBase::ModelResultType numeric(signal.GetSize());
+      mitk::ModelBase::ModelResultType analytic(signal.GetSize());
+      for (unsigned int i = 0; i < signal.GetSize(); ++i)
+      {
+        numeric[i] = (signalPlus[i] - signalMinus[i]) / (2 * h);
+        analytic[i] = derivatives[p][i];
+      }
+
+      const double difference = signalDifference(numeric, analytic);
+      if (difference > 1e-4)
+      {
+        MITK_INFO << "Derivative of parameter " << p << " differs from finite differences: " << difference;
+        result = false;
+      }
+    }
+    return result;
+  }
+}
+
+int mitkNumericCompartmentModelsTest(int  /*argc*/ , char*[] /*argv[]*/)
+{
+  MITK_TEST_BEGIN("NumericCompartmentModels")
+
+  mitk::ModelBase::TimeGridType grid(60);
+  for (unsigned int i = 0; i < grid.GetSize(); ++i)
+  {
+    grid[i] = 5.0 * i;
+  }
+  mitk::AIFBasedModelBase::AterialInputFunctionType aif = generateAIF(grid);
+
+  // two tissue compartment model
+  mitk::TwoTissueCompartmentModel::Pointer analytic2TC = mitk::TwoTissueCompartmentModel::New();
+  analytic2TC->SetTimeGrid(grid);
+  analytic2TC->SetAterialInputFunctionValues(aif);
+  analytic2TC->SetAterialInputFunctionTimeGrid(grid);
+
+  mitk::NumericTwoTissueCompartmentModel::Pointer numeric2TC = mitk::NumericTwoTissueCompartmentModel::New();
+  numeric2TC->SetTimeGrid(grid);
+  numeric2TC->SetAterialInputFunctionValues(aif);
+  numeric2TC->SetAterialInputFunctionTimeGrid(grid);
+
+  mitk::ModelBase::ParametersType parameters2TC(5);
+  parameters2TC[mitk::NumericTwoTissueCompartmentModel::POSITION_PARAMETER_K1] = 0.5;
+  parameters2TC[mitk::NumericTwoTissueCompartmentModel::POSITION_PARAMETER_k2] = 0.3;
+  parameters2TC[mitk::NumericTwoTissueCompartmentModel::POSITION_PARAMETER_k3] = 0.1;
+  parameters2TC[mitk::NumericTwoTissueCompartmentModel::POSITION_PARAMETER_k4] = 0.05;
+  parameters2TC[mitk::NumericTwoTissueCompartmentModel::POSITION_PARAMETER_VB] = 0.1;
+
+  MITK_TEST_CONDITION(signalDifference(analytic2TC->GetSignal(parameters2TC), numeric2TC->GetSignal(parameters2TC)) < 1e-3,
+    "Check numeric two tissue compartment model against analytical solution");
+  MITK_TEST_CONDITION(checkDerivatives(numeric2TC, parameters2TC),
+    "Check derivatives of numeric two tissue compartment model");
+
+  // two compartment exchange model
+  mitk::TwoCompartmentExchangeModel::Pointer analytic2CX = mitk::TwoCompartmentExchangeModel::New();
+  analytic2CX->SetTimeGrid(grid);
+  analytic2CX->SetAterialInputFunctionValues(aif);
+  analytic2CX->SetAterialInputFunctionTimeGrid(grid);
+
+  mitk::NumericTwoCompartmentExchangeModel::Pointer numeric2CX = mitk::NumericTwoCompartmentExchangeModel::New();
+  numeric2CX->SetTimeGrid(grid);
+  numeric2CX->SetAterialInputFunctionValues(aif);
+  numeric2CX->SetAterialInputFunctionTimeGrid(grid);
+  numeric2CX->SetODEINTStepSize(0.05);
+
+  mitk::ModelBase::ParametersType parameters2CX(4);
+  parameters2CX[mitk::NumericTwoCompartmentExchangeModel::POSITION_PARAMETER_F] = 60;
+  parameters2CX[mitk::NumericTwoCompartmentExchangeModel::POSITION_PARAMETER_PS] = 10;
+  parameters2CX[mitk::NumericTwoCompartmentExchangeModel::POSITION_PARAMETER_ve] = 0.3;
+  parameters2CX[mitk::NumericTwoCompartmentExchangeModel::POSITION_PARAMETER_vp] = 0.05;
+
+  MITK_TEST_CONDITION(signalDifference(analytic2CX->GetSignal(parameters2CX), numeric2CX->GetSignal(parameters2CX)) < 1e-3,
+    "Check numeric two compartment exchange model against analytical solution");
+  MITK_TEST_CONDITION(checkDerivatives(numeric2CX, parameters2CX),
+    "Check derivatives of numeric two compartment exchange model");
+
+  // models without analytical derivatives report it
+  mitk::ModelBase::ModelResultType signal;
+  mitk::ModelBase::SignalDerivativeType derivatives;
+  MITK_TEST_CONDITION(!analytic2CX->GetSignalDerivatives(parameters2CX, signal, derivatives),
+    "Check that models without analytical derivatives return false");
+
+  MITK_TEST_FOR_EXCEPTION_BEGIN(itk::ExceptionObject)
+  numeric2CX->SetODEINTStepSize(0.0);
+  numeric2CX->GetSignal(parameters2CX);
+  MITK_TEST_FOR_EXCEPTION_END(itk::ExceptionObject)
+
+  MITK_TEST_END()
+}
@@ -28,6 +28,9 @@ See LICENSE.txt or http://www.mitk.org for details.
 #include <itkMedianImageFilter.h>
 #include <mitkImagePixelReadAccessor.h>
 
+#include <algorithm>
+#include <cmath>
+
 
 /**Documentation
 *  \brief test for the class "ToFCompositeFilter".
@@ -293,6 +296,76 @@ int mitkToFCompositeFilterTest(int /* argc */, char* /*argv*/[])
   MITK_TEST_CONDITION_REQUIRED( mitk::Equal(*itkOutputImageConverted, *mitkOutputImage, mitk::eps, true),
                                "Test threshold filter, bilateral filter and temporal median filter in pipeline");
 
+  MITK_TEST_CONDITION_REQUIRED(compositeFilter->GetStageTime(mitk::ToFCompositeFilter::BilateralFilterStage) >= 0.0 &&
+                               compositeFilter->GetTotalTime() >= compositeFilter->GetStageTime(mitk::ToFCompositeFilter::BilateralFilterStage),
+                               "Test stage times of the pipeline");
+
+  //separable approximation of the bilateral filter
+  compositeFilter->SetUseSeparableBilateralFilter(true);
+  MITK_TEST_CONDITION_REQUIRED(compositeFilter->GetUseSeparableBilateralFilter(),"Get/Set UseSeparableBilateralFilter");
+  mitkOutputImage->Update();
+  MITK_TEST_CONDITION_REQUIRED(mitkOutputImage->GetDimension(0)==itkOutputImageConverted->GetDimension(0) &&
+                               mitkOutputImage->GetDimension(1)==itkOutputImageConverted->GetDimension(1),
+                               "Test separable bilateral filter in pipeline");
+
+  //switching back has to reuse the ITK bilateral filter with the current data
+  compositeFilter->SetUseSeparableBilateralFilter(false);
+  mitkOutputImage->Update();
+  MITK_TEST_CONDITION_REQUIRED( mitk::Equal(*itkOutputImageConverted, *mitkOutputImage, mitk::eps, true),
+                               "Test reused bilateral filter in pipeline");
+
+  //the separable approximation has to match the bilateral filter on an image with a step edge and a ramp,
+  //away from the image border where the two filters handle the kernel differently
+  {
+    const unsigned int dim = 40;
+    const double separableDomainSigma = 2.0;
+    const int margin = static_cast<int>(std::ceil(2.5*separableDomainSigma));
+    ItkImageType_2D::Pointer itkEdgeImage = ItkImageType_2D::New();
+    ItkImageType_2D::RegionType region;
+    region.SetSize(0, dim);
+    region.SetSize(1, dim);
+    itkEdgeImage->SetRegions(region);
+    itkEdgeImage->Allocate();
+    for (ItkImageRegionIteratorType2D it(itkEdgeImage, region); !it.IsAtEnd(); ++it)
+    {
+      it.Set((it.GetIndex()[0] < static_cast<int>(dim/2) ? 100.0f : 500.0f) + 2.0f*it.GetIndex()[1]);
+    }
+    mitk::Image::Pointer mitkEdgeImage;
+    mitk::CastToMitkImage(itkEdgeImage, mitkEdgeImage);
+
+    mitk::ToFCompositeFilter::Pointer bilateralCompositeFilter = mitk::ToFCompositeFilter::New();
+    bilateralCompositeFilter->SetApplyThresholdFilter(false);
+    bilateralCompositeFilter->SetApplyMedianFilter(false);
+    bilateralCompositeFilter->SetApplyTemporalMedianFilter(false);
+    bilateralCompositeFilter->SetApplyBilateralFilter(true);
+    bilateralCompositeFilter->SetBilateralFilterParameter(separableDomainSigma, 60.0, 0);
+    bilateralCompositeFilter->SetInput(mitkEdgeImage);
+    mitk::Image::Pointer bilateralOutput = bilateralCompositeFilter->GetOutput();
+    bilateralOutput->Update();
+    std::vector<float> reference(dim*dim);
+    {
+      mitk::ImagePixelReadAccessor<float,2> referenceAccessor(bilateralOutput);
+      std::copy(referenceAccessor.GetData(), referenceAccessor.GetData() + dim*dim, reference.begin());
+    }
+
+    bilateralCompositeFilter->SetUseSeparableBilateralFilter(true);
+    bilateralOutput->Update();
+    mitk::ImagePixelReadAccessor<float,2> separableAccessor(bilateralOutput);
+    const float* separable = separableAccessor.GetData();
+    float maxDifference = 0.0f;
+    for (int y = margin; y < static_cast<int>(dim) - margin; y++)
+    {
+      for (int x = margin; x < static_cast<int>(dim) - margin; x++)
+      {
+        maxDifference = std::max(maxDifference, std::abs(separable[y*dim+x] - reference[y*dim+x]));
+      }
+    }
+    MITK_TEST_CONDITION_REQUIRED(maxDifference < 0.5f, "Test separable bilateral filter against bilateral filter, max. difference " << maxDifference);
+    MITK_TEST_CONDITION_REQUIRED(std::abs(separable[(dim/2)*dim + dim/2 - 1] - (100.0f + dim)) < 0.5f &&
+                                 std::abs(separable[(dim/2)*dim + dim/2] - (500.0f + dim)) < 0.5f,
+                                 "Test edge preservation of separable bilateral filter");
+  }
+
 
   //-------------------------------------------------------------------------------------------------------
   // TODO: Rewrite this. This don't make sense. the itk reference applies a median filter
@@ -28,6 +28,7 @@ See LICENSE.txt or http://www.mitk.org for details.
 
 #include <vtkPoints.h>
 #include <vtkPolyData.h>
+#include <vtkCellArray.h>
 #include <vtkSmartPointer.h>
 
 /**
@@ -379,6 +380,66 @@ int mitkToFDistanceImageToSurfaceFilterTest(int /* argc */, char* /*argv*/[])
   }
   MITK_TEST_CONDITION_REQUIRED(compareToInput,"Testing backward transformation compared to original image with interpixeldistance");
 
+  //Triangle strips have to cover the same triangles as the triangular mesh
+  filter->SetGenerateTriangularMesh(true);
+  filter->SetGenerateTriangleStrips(false);
+  filter->Modified();
+  filter->Update();
+  vtkIdType numberOfTriangles = filter->GetOutput()->GetVtkPolyData()->GetNumberOfPolys();
+  vtkIdType numberOfPoints = filter->GetOutput()->GetVtkPolyData()->GetNumberOfPoints();
+  filter->SetGenerateTriangleStrips(true);
+  filter->Update();
+  vtkPolyData* stripMesh = filter->GetOutput()->GetVtkPolyData();
+  vtkIdType numberOfStripTriangles = 0;
+  vtkIdType numberOfStripPoints = 0;
+  vtkIdType* stripPoints = nullptr;
+  vtkCellArray* strips = stripMesh->GetStrips();
+  for (strips->InitTraversal(); strips->GetNextCell(numberOfStripPoints, stripPoints);)
+  {
+    numberOfStripTriangles += numberOfStripPoints - 2;
+  }
+  MITK_TEST_CONDITION_REQUIRED(stripMesh->GetNumberOfPoints() == numberOfPoints, "Testing number of points with triangle strips");
+  MITK_TEST_CONDITION_REQUIRED(numberOfStripTriangles == numberOfTriangles, "Testing number of triangles in triangle strips");
+  filter->SetGenerateTriangleStrips(false);
+
+  //Buffers are reused for consecutive frames, results have to stay the same
+  filter->Modified();
+  filter->Update();
+  vtkPoints* reusedResult = filter->GetOutput()->GetVtkPolyData()->GetPoints();
+  bool reusedPointsEqual = (reusedResult->GetNumberOfPoints() == expectedResult->GetNumberOfPoints());
+  for (int i=0; reusedPointsEqual && i<expectedResult->GetNumberOfPoints(); i++)
+  {
+    double* expected = expectedResult->GetPoint(i);
+    double* res = reusedResult->GetPoint(i);
+    reusedPointsEqual = mitk::Equal(expected[0], res[0]) && mitk::Equal(expected[1], res[1]) && mitk::Equal(expected[2], res[2]);
+  }
+  MITK_TEST_CONDITION_REQUIRED(reusedPointsEqual, "Testing repeated update with reused buffers");
+
+  //A surface of an earlier frame must not change when the next frame is generated
+  vtkSmartPointer<vtkPolyData> previousFrame = filter->GetOutput()->GetVtkPolyData();
+  vtkSmartPointer<vtkPoints> previousPoints = vtkSmartPointer<vtkPoints>::New();
+  previousPoints->DeepCopy(previousFrame->GetPoints());
+  vtkSmartPointer<vtkCellArray> previousPolys = vtkSmartPointer<vtkCellArray>::New();
+  previousPolys->DeepCopy(previousFrame->GetPolys());
+  filter->SetInput(mitk::ImageGenerator::GenerateRandomImage<float>(dimX,dimY));
+  filter->Update();
+  MITK_TEST_CONDITION_REQUIRED(filter->GetOutput()->GetVtkPolyData()->GetPoints() != previousFrame->GetPoints(), "Testing that the next frame has its own points");
+  bool previousFrameUnchanged = previousFrame->GetNumberOfPoints() == previousPoints->GetNumberOfPoints() &&
+    previousFrame->GetPolys()->GetNumberOfConnectivityEntries() == previousPolys->GetNumberOfConnectivityEntries();
+  for (int i=0; previousFrameUnchanged && i<previousPoints->GetNumberOfPoints(); i++)
+  {
+    double* expected = previousPoints->GetPoint(i);
+    double* res = previousFrame->GetPoint(i);
+    previousFrameUnchanged = mitk::Equal(expected[0], res[0]) && mitk::Equal(expected[1], res[1]) && mitk::Equal(expected[2], res[2]);
+  }
+  vtkIdType* previousIds = previousFrame->GetPolys()->GetPointer();
+  vtkIdType* expectedIds = previousPolys->GetPointer();
+  for (vtkIdType i=0; previousFrameUnchanged && i<previousPolys->GetNumberOfConnectivityEntries(); i++)
+  {
+    previousFrameUnchanged = previousIds[i] == expectedIds[i];
+  }
+  MITK_TEST_CONDITION_REQUIRED(previousFrameUnchanged, "Testing that the surface of the previous frame is unchanged by the next frame");
+
   //clean up
   delete[] point;
   //  expectedResult->Delete();
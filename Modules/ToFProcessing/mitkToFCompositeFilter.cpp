@@ -19,15 +19,21 @@ See LICENSE.txt or http://www.mitk.org for details.
 #include "mitkImageReadAccessor.h"
 
 #include <itkImage.h>
+#include <itkTimeProbe.h>
 
 #include "opencv2/imgproc.hpp"
 
+#include <algorithm>
+#include <cmath>
+
 mitk::ToFCompositeFilter::ToFCompositeFilter() : m_SegmentationMask(nullptr), m_ImageWidth(0), m_ImageHeight(0), m_ImageSize(0),
 m_IplDistanceImage(nullptr), m_IplOutputImage(nullptr), m_ItkInputImage(nullptr), m_ApplyTemporalMedianFilter(false), m_ApplyAverageFilter(false),
   m_ApplyMedianFilter(false), m_ApplyThresholdFilter(false), m_ApplyMaskSegmentation(false), m_ApplyBilateralFilter(false), m_DataBuffer(nullptr),
 m_DataBufferCurrentIndex(0), m_DataBufferMaxSize(0), m_TemporalMedianFilterNumOfFrames(10), m_ThresholdFilterMin(1),
-m_ThresholdFilterMax(7000), m_BilateralFilterDomainSigma(2), m_BilateralFilterRangeSigma(60), m_BilateralFilterKernelRadius(0)
+m_ThresholdFilterMax(7000), m_BilateralFilterDomainSigma(2), m_BilateralFilterRangeSigma(60), m_BilateralFilterKernelRadius(0),
+m_UseSeparableBilateralFilter(false), m_BilateralFilter(BilateralFilterType::New()), m_BilateralBuffer(), m_TotalTime(0.0)
 {
+  std::fill(m_StageTimes, m_StageTimes + NumberOfProcessingStages, 0.0);
 }
 
 mitk::ToFCompositeFilter::~ToFCompositeFilter()
@@ -119,33 +125,77 @@ void mitk::ToFCompositeFilter::GenerateData()
   //mitk::Image::Pointer inputDistanceImage = this->GetInput();
   ImageReadAccessor inputAcc(this->GetInput(), this->GetInput()->GetSliceData(0, 0, 0) );
 
+  std::fill(m_StageTimes, m_StageTimes + NumberOfProcessingStages, 0.0);
+  itk::TimeProbe totalProbe;
+  totalProbe.Start();
+
   // copy initial distance image to ipl image
   float* distanceFloatData = (float*)inputAcc.GetData();
   memcpy(this->m_IplDistanceImage->imageData, (void*)distanceFloatData, this->m_ImageSize);
   if (m_ApplyThresholdFilter||m_ApplyMaskSegmentation)
   {
+    itk::TimeProbe probe;
+    probe.Start();
     ProcessSegmentation(this->m_IplDistanceImage);
+    probe.Stop();
+    m_StageTimes[SegmentationStage] = probe.GetTotal() * 1000.0;
   }
   if (this->m_ApplyTemporalMedianFilter||this->m_ApplyAverageFilter)
   {
+    itk::TimeProbe probe;
+    probe.Start();
     ProcessStreamedQuickSelectMedianImageFilter(this->m_IplDistanceImage);
+    probe.Stop();
+    m_StageTimes[TemporalFilterStage] = probe.GetTotal() * 1000.0;
   }
   if (this->m_ApplyMedianFilter)
   {
+    itk::TimeProbe probe;
+    probe.Start();
     ProcessCVMedianFilter(this->m_IplDistanceImage, this->m_IplOutputImage);
     memcpy( this->m_IplDistanceImage->imageData, this->m_IplOutputImage->imageData, this->m_ImageSize );
+    probe.Stop();
+    m_StageTimes[MedianFilterStage] = probe.GetTotal() * 1000.0;
   }
   if (this->m_ApplyBilateralFilter)
   {
+    itk::TimeProbe probe;
+    probe.Start();
+    if (this->m_UseSeparableBilateralFilter)
+    {
+      ProcessSeparableBilateralFilter(this->m_IplDistanceImage);
+    }
+    else
+    {
       float* itkFloatData = this->m_ItkInputImage->GetBufferPointer();
       memcpy(itkFloatData, this->m_IplDistanceImage->imageData, this->m_ImageSize );
       ItkImageType2D::Pointer itkOutputImage = ProcessItkBilateralFilter(this->m_ItkInputImage);
       memcpy( this->m_IplDistanceImage->imageData, itkOutputImage->GetBufferPointer(), this->m_ImageSize );
+    }
+    probe.Stop();
+    m_StageTimes[BilateralFilterStage] = probe.GetTotal() * 1000.0;
 
     //ProcessCVBilateralFilter(this->m_IplDistanceImage, this->m_OutputIplImage, domainSigma, rangeSigma, kernelRadius);
     //memcpy( distanceFloatData, this->m_OutputIplImage->imageData, distanceImageSize );
   }
   memcpy( outputDistanceFloatData, this->m_IplDistanceImage->imageData, this->m_ImageSize );
+
+  totalProbe.Stop();
+  m_TotalTime = totalProbe.GetTotal() * 1000.0;
+}
+
+double mitk::ToFCompositeFilter::GetStageTime(ProcessingStage stage) const
+{
+  if (stage < 0 || stage >= NumberOfProcessingStages)
+  {
+    return 0.0;
+  }
+  return m_StageTimes[stage];
+}
+
+double mitk::ToFCompositeFilter::GetTotalTime() const
+{
+  return m_TotalTime;
 }
 
 void mitk::ToFCompositeFilter::CreateOutputsForAllInputs()
@@ -189,7 +239,9 @@ void mitk::ToFCompositeFilter::ProcessSegmentation(IplImage* inputIplImage)
     segmentationMask = nullptr;
   }
   float *f = (float*)inputIplImage->imageData;
-  for(int i=0; i<this->m_ImageWidth*this->m_ImageHeight; i++)
+  const int numberOfPixels = this->m_ImageWidth*this->m_ImageHeight;
+#pragma omp parallel for
+  for(int i=0; i<numberOfPixels; i++)
   {
     if (this->m_ApplyThresholdFilter)
     {
@@ -218,16 +270,89 @@ void mitk::ToFCompositeFilter::ProcessSegmentation(IplImage* inputIplImage)
 ItkImageType2D::Pointer mitk::ToFCompositeFilter::ProcessItkBilateralFilter(ItkImageType2D::Pointer inputItkImage)
 {
   ItkImageType2D::Pointer outputItkImage;
-  BilateralFilterType::Pointer bilateralFilter = BilateralFilterType::New();
-  bilateralFilter->SetInput(inputItkImage);
-  bilateralFilter->SetDomainSigma(m_BilateralFilterDomainSigma);
-  bilateralFilter->SetRangeSigma(m_BilateralFilterRangeSigma);
-  //bilateralFilter->SetRadius(m_BilateralFilterKernelRadius);
-  outputItkImage = bilateralFilter->GetOutput();
+  // the image buffer was written directly, so the pipeline has to be told about it
+  inputItkImage->Modified();
+  m_BilateralFilter->SetInput(inputItkImage);
+  m_BilateralFilter->SetDomainSigma(m_BilateralFilterDomainSigma);
+  m_BilateralFilter->SetRangeSigma(m_BilateralFilterRangeSigma);
+  //m_BilateralFilter->SetRadius(m_BilateralFilterKernelRadius);
+  outputItkImage = m_BilateralFilter->GetOutput();
   outputItkImage->Update();
   return outputItkImage;
 }
 
+void mitk::ToFCompositeFilter::ProcessSeparableBilateralFilter(IplImage* inputIplImage)
+{
+  float* data = (float*)inputIplImage->imageData;
+  const int width = inputIplImage->width;
+  const int height = inputIplImage->height;
+
+  // same automatic kernel size as itk::BilateralImageFilter (DomainMu = 2.5)
+  int radius = m_BilateralFilterKernelRadius;
+  if (radius <= 0)
+  {
+    radius = static_cast<int>(std::ceil(2.5 * m_BilateralFilterDomainSigma));
+  }
+
+  std::vector<float> domainWeights(radius+1);
+  for (int k=0; k<=radius; k++)
+  {
+    domainWeights[k] = static_cast<float>(std::exp(-0.5 * k * k / (m_BilateralFilterDomainSigma * m_BilateralFilterDomainSigma)));
+  }
+  const float rangeFactor = static_cast<float>(-0.5 / (m_BilateralFilterRangeSigma * m_BilateralFilterRangeSigma));
+
+  m_BilateralBuffer.resize(width*height);
+  float* buffer = &m_BilateralBuffer[0];
+
+  // first pass: filter along the rows into the buffer
+#pragma omp parallel for
+  for (int y=0; y<height; y++)
+  {
+    const float* row = data + y*width;
+    float* outputRow = buffer + y*width;
+    for (int x=0; x<width; x++)
+    {
+      const float center = row[x];
+      float sum = 0.0f;
+      float weightSum = 0.0f;
+      const int begin = std::max(x-radius, 0);
+      const int end = std::min(x+radius, width-1);
+      for (int xx=begin; xx<=end; xx++)
+      {
+        const float difference = row[xx] - center;
+        const float weight = domainWeights[std::abs(xx-x)] * std::exp(difference*difference*rangeFactor);
+        sum += weight*row[xx];
+        weightSum += weight;
+      }
+      outputRow[x] = sum / weightSum;
+    }
+  }
+
+  // second pass: filter along the columns back into the image
+#pragma omp parallel for
+  for (int y=0; y<height; y++)
+  {
+    const int begin = std::max(y-radius, 0);
+    const int end = std::min(y+radius, height-1);
+    float* outputRow = data + y*width;
+    for (int x=0; x<width; x++)
+    {
+      const float center = buffer[y*width+x];
+      float sum = 0.0f;
+      float weightSum = 0.0f;
+      for (int yy=begin; yy<=end; yy++)
+      {
+        const float value = buffer[yy*width+x];
+        const float difference = value - center;
+        const float weight = domainWeights[std::abs(yy-y)] * std::exp(difference*difference*rangeFactor);
+        sum += weight*value;
+        weightSum += weight;
+      }
+      outputRow[x] = sum / weightSum;
+    }
+  }
+}
+
 void mitk::ToFCompositeFilter::ProcessCVBilateralFilter(IplImage* inputIplImage, IplImage* outputIplImage)
 {
   int diameter = m_BilateralFilterKernelRadius;
@@ -246,7 +371,6 @@ void mitk::ToFCompositeFilter::ProcessStreamedQuickSelectMedianImageFilter(IplIm
   float* data = (float*)inputIplImage->imageData;
 
   int imageSize = inputIplImage->width * inputIplImage->height;
-  float* tmpArray;
 
   if (this->m_TemporalMedianFilterNumOfFrames == 0)
   {
@@ -276,7 +400,6 @@ void mitk::ToFCompositeFilter::ProcessStreamedQuickSelectMedianImageFilter(IplIm
   }
 
   int currentBufferSize = this->m_DataBufferMaxSize;
-  tmpArray = new float[this->m_DataBufferMaxSize];
 
   // copy data to buffer
   if (this->m_DataBuffer[this->m_DataBufferCurrentIndex] == nullptr)
@@ -285,36 +408,36 @@ void mitk::ToFCompositeFilter::ProcessStreamedQuickSelectMedianImageFilter(IplIm
     currentBufferSize = this->m_DataBufferCurrentIndex + 1;
   }
 
-  for(int j=0; j<imageSize; j++)
-  {
-    this->m_DataBuffer[this->m_DataBufferCurrentIndex][j] = data[j];
-  }
+  memcpy(this->m_DataBuffer[this->m_DataBufferCurrentIndex], data, imageSize*sizeof(float));
 
-  float tmpValue = 0.0f;
-  for(int i=0; i<imageSize; i++)
+  // pixels are independent of each other, every thread uses its own array for the quickselect
+#pragma omp parallel
   {
-    if (m_ApplyAverageFilter)
+    std::vector<float> tmpArray(currentBufferSize);
+#pragma omp for
+    for(int i=0; i<imageSize; i++)
     {
-      tmpValue = 0.0f;
-      for(int j=0; j<currentBufferSize; j++)
+      if (m_ApplyAverageFilter)
       {
-          tmpValue+=this->m_DataBuffer[j][i];
+        float tmpValue = 0.0f;
+        for(int j=0; j<currentBufferSize; j++)
+        {
+            tmpValue+=this->m_DataBuffer[j][i];
+        }
+        data[i] = tmpValue/currentBufferSize;
       }
-      data[i] = tmpValue/currentBufferSize;
-    }
-    else if (m_ApplyTemporalMedianFilter)
-    {
-      for(int j=0; j<currentBufferSize; j++)
+      else if (m_ApplyTemporalMedianFilter)
       {
-        tmpArray[j] = this->m_DataBuffer[j][i];
+        for(int j=0; j<currentBufferSize; j++)
+        {
+          tmpArray[j] = this->m_DataBuffer[j][i];
+        }
+        data[i] = quick_select(&tmpArray[0], currentBufferSize);
       }
-      data[i] = quick_select(tmpArray, currentBufferSize);
     }
   }
 
   this->m_DataBufferCurrentIndex = (this->m_DataBufferCurrentIndex + 1) % this->m_DataBufferMaxSize;
-
-  delete[] tmpArray;
 }
 
 #define ELEM_SWAP(a,b) { register float t=(a);(a)=(b);(b)=t; }
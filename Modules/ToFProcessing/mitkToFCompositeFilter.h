@@ -22,6 +22,8 @@ See LICENSE.txt or http://www.mitk.org for details.
 #include <itkBilateralImageFilter.h>
 #include "opencv2/core.hpp"
 
+#include <vector>
+
 typedef itk::Image<float, 2> ItkImageType2D;
 typedef itk::Image<float, 3> ItkImageType3D;
 typedef itk::BilateralImageFilter<ItkImageType2D,ItkImageType2D> BilateralFilterType;
@@ -39,6 +41,10 @@ namespace mitk
   * - spatial median filter
   * - bilateral filter
   *
+  * All stages work in place on buffers which are only reallocated if the image size changes. The pixel-wise stages
+  * (segmentation, temporal filter, separable bilateral filter) are processed in parallel. The time spent in every
+  * stage during the last update can be queried with GetStageTime() to check whether a fixed frame budget is met.
+  *
   * @ingroup ToFProcessing
   */
   class MITKTOFPROCESSING_EXPORT ToFCompositeFilter : public ImageToImageFilter
@@ -62,6 +68,27 @@ namespace mitk
     itkGetConstMacro(ApplyMaskSegmentation,bool);
     itkSetMacro(ApplyBilateralFilter,bool);
     itkGetConstMacro(ApplyBilateralFilter,bool);
+    /*!
+    \brief If set, the bilateral filter is approximated by two one-dimensional bilateral filters (first along the
+    rows, then along the columns). This reduces the costs per pixel from (2r+1)^2 to 2(2r+1) kernel evaluations.
+    Otherwise the ITK bilateral filter is used. Default: false
+    */
+    itkSetMacro(UseSeparableBilateralFilter,bool);
+    itkGetConstMacro(UseSeparableBilateralFilter,bool);
+
+    /*!
+    \brief Processing stages of this filter in the order they are applied
+    */
+    enum ProcessingStage { SegmentationStage = 0, TemporalFilterStage, MedianFilterStage, BilateralFilterStage, NumberOfProcessingStages };
+
+    /*!
+    \brief Returns the time in ms the given stage needed during the last update (0 if the stage was not applied)
+    */
+    double GetStageTime(ProcessingStage stage) const;
+    /*!
+    \brief Returns the time in ms the last update needed in total
+    */
+    double GetTotalTime() const;
 
     using itk::ProcessObject::SetInput;
 
@@ -151,6 +178,12 @@ namespace mitk
     */
     void ProcessCVMedianFilter(IplImage* inputIplImage, IplImage* outputIplImage, int radius = 3);
     /*!
+    \brief Applies a separable approximation of the bilateral filter to the input image (in place).
+    The kernel radius is taken from SetBilateralFilterParameter(), if it is 0 the radius is derived from the domain
+    sigma in the same way as by the ITK bilateral filter.
+    */
+    void ProcessSeparableBilateralFilter(IplImage* inputIplImage);
+    /*!
     \brief Performs temporal median filter on an image given the number of frames to be considered
     */
     void ProcessStreamedQuickSelectMedianImageFilter(IplImage* inputIplImage);
@@ -195,6 +228,13 @@ namespace mitk
     double m_BilateralFilterDomainSigma; ///< Parameter of the bilateral filter controlling the smoothing effect of the filter. Default value: 2
     double m_BilateralFilterRangeSigma; ///< Parameter of the bilateral filter controlling the edge preserving effect of the filter. Default value: 60
     int m_BilateralFilterKernelRadius; ///< Kernel radius of the bilateral filter mask
+    bool m_UseSeparableBilateralFilter; ///< Flag indicating if the separable approximation of the bilateral filter is used
+
+    BilateralFilterType::Pointer m_BilateralFilter; ///< ITK bilateral filter, reused for every frame
+    std::vector<float> m_BilateralBuffer; ///< Intermediate result of the separable bilateral filter
+
+    double m_StageTimes[NumberOfProcessingStages]; ///< Time in ms every stage needed during the last update
+    double m_TotalTime; ///< Time in ms of the last update
 
   };
 } //END mitk namespace
@@ -28,14 +28,17 @@ See LICENSE.txt or http://www.mitk.org for details.
 #include <vtkFloatArray.h>
 #include <vtkSmartPointer.h>
 #include <vtkIdList.h>
+#include <vtkIdTypeArray.h>
 
 #include <cmath>
 #include <vtkMath.h>
 
 mitk::ToFDistanceImageToSurfaceFilter::ToFDistanceImageToSurfaceFilter() :
   m_IplScalarImage(nullptr), m_CameraIntrinsics(), m_TextureImageWidth(0), m_TextureImageHeight(0), m_InterPixelDistance(), m_TextureIndex(0),
-  m_GenerateTriangularMesh(true), m_TriangulationThreshold(0.0)
+  m_GenerateTriangularMesh(true), m_TriangulationThreshold(0.0), m_GenerateTriangleStrips(false)
 {
+  m_VertexIdList = vtkSmartPointer<vtkIdList>::New();
+
   m_InterPixelDistance.Fill(0.045);
   m_CameraIntrinsics = mitk::CameraIntrinsics::New();
   m_CameraIntrinsics->SetFocalLength(273.138946533,273.485900879);
@@ -48,6 +51,49 @@ mitk::ToFDistanceImageToSurfaceFilter::~ToFDistanceImageToSurfaceFilter()
 {
 }
 
+mitk::ToFDistanceImageToSurfaceFilter::OutputBuffers::OutputBuffers() :
+  Points(vtkSmartPointer<vtkPoints>::New()), Polys(vtkSmartPointer<vtkCellArray>::New()), PolyIds(vtkSmartPointer<vtkIdTypeArray>::New()),
+  Vertices(vtkSmartPointer<vtkCellArray>::New()), VertexIds(vtkSmartPointer<vtkIdTypeArray>::New()),
+  ScalarArray(vtkSmartPointer<vtkFloatArray>::New()), TextureCoords(vtkSmartPointer<vtkFloatArray>::New())
+{
+  Points->SetDataTypeToDouble();
+  TextureCoords->SetNumberOfComponents(2);
+}
+
+bool mitk::ToFDistanceImageToSurfaceFilter::OutputBuffers::IsReferenced() const
+{
+  //The id arrays are only referenced by the cell arrays
+  return Points->GetReferenceCount() > 1 || Polys->GetReferenceCount() > 1 || Vertices->GetReferenceCount() > 1 ||
+    ScalarArray->GetReferenceCount() > 1 || TextureCoords->GetReferenceCount() > 1;
+}
+
+void mitk::ToFDistanceImageToSurfaceFilter::SelectUnreferencedOutputBuffers()
+{
+  if (!m_OutputBuffers.IsReferenced())
+  {
+    return;
+  }
+
+  m_OutputBufferPool.push_back(m_OutputBuffers);
+  for (auto it = m_OutputBufferPool.begin(); it != m_OutputBufferPool.end(); ++it)
+  {
+    if (!it->IsReferenced())
+    {
+      m_OutputBuffers = *it;
+      m_OutputBufferPool.erase(it);
+      return;
+    }
+  }
+
+  //All earlier surfaces are still in use (e.g. by a recorder). Their arrays stay
+  //valid for them, the pool only keeps the most recent ones for later reuse.
+  m_OutputBuffers = OutputBuffers();
+  if (m_OutputBufferPool.size() > 2)
+  {
+    m_OutputBufferPool.erase(m_OutputBufferPool.begin());
+  }
+}
+
 void mitk::ToFDistanceImageToSurfaceFilter::SetInput( Image* distanceImage, mitk::CameraIntrinsics::Pointer cameraIntrinsics )
 {
   this->SetCameraIntrinsics(cameraIntrinsics);
@@ -99,28 +145,21 @@ void mitk::ToFDistanceImageToSurfaceFilter::GenerateData()
   int xDimension = input->GetDimension(0);
   int yDimension = input->GetDimension(1);
   unsigned int size = xDimension*yDimension; //size of the image-array
-  std::vector<bool> isPointValid;
-  isPointValid.resize(size);
-  vtkSmartPointer<vtkPoints> points = vtkSmartPointer<vtkPoints>::New();
-  points->SetDataTypeToDouble();
-  vtkSmartPointer<vtkCellArray> polys = vtkSmartPointer<vtkCellArray>::New();
-  vtkSmartPointer<vtkCellArray> vertices = vtkSmartPointer<vtkCellArray>::New();
-  vtkSmartPointer<vtkFloatArray> scalarArray = vtkSmartPointer<vtkFloatArray>::New();
-  vtkSmartPointer<vtkFloatArray> textureCoords = vtkSmartPointer<vtkFloatArray>::New();
-  textureCoords->SetNumberOfComponents(2);
-  textureCoords->Allocate(size);
-
-  //Make a vtkIdList to save the ID's of the polyData corresponding to the image
-  //pixel ID's. See below for more documentation.
-  m_VertexIdList = vtkSmartPointer<vtkIdList>::New();
-  //Allocate the object once else it would automatically allocate new memory
-  //for every vertex and perform a copy which is expensive.
-  m_VertexIdList->Allocate(size);
-  m_VertexIdList->SetNumberOfIds(size);
-  for(unsigned int i = 0; i < size; ++i)
+
+  if ((m_ReconstructionMode != WithOutInterPixelDistance) && (m_ReconstructionMode != WithInterPixelDistance) && (m_ReconstructionMode != Kinect))
+  {
+    MITK_ERROR << "Incorrect reconstruction mode!";
+    return;
+  }
+
+  //The vtkIdList saves the ID's of the polyData corresponding to the image
+  //pixel ID's. See below for more documentation. It is reused for every frame
+  //and thus only allocates memory if the image size grows.
+  if (m_VertexIdList == nullptr)
   {
-    m_VertexIdList->SetId(i, 0);
+    m_VertexIdList = vtkSmartPointer<vtkIdList>::New();
   }
+  m_VertexIdList->SetNumberOfIds(size);
 
   float* scalarFloatData = nullptr;
 
@@ -145,19 +184,13 @@ void mitk::ToFDistanceImageToSurfaceFilter::GenerateData()
     focalLengthInPixelUnits[1] = m_CameraIntrinsics->GetFocalLengthY();
     focalLengthInMm = 0.0;
   }
-  else if( m_ReconstructionMode == WithInterPixelDistance)
+  else
   {
     //convert focallength from pixel to mm
     focalLengthInPixelUnits[0] = 0.0;
     focalLengthInPixelUnits[1] = 0.0;
     focalLengthInMm = (m_CameraIntrinsics->GetFocalLengthX()*m_InterPixelDistance[0]+m_CameraIntrinsics->GetFocalLengthY()*m_InterPixelDistance[1])/2.0;
   }
-  else
-  {
-    focalLengthInPixelUnits[0] = 0.0;
-    focalLengthInPixelUnits[1] = 0.0;
-    focalLengthInMm = 0.0;
-  }
 
   mitk::ToFProcessingCommon::ToFPoint2D principalPoint;
   principalPoint[0] = m_CameraIntrinsics->GetPrincipalPointX();
@@ -166,149 +199,353 @@ void mitk::ToFDistanceImageToSurfaceFilter::GenerateData()
   mitk::Point3D origin = input->GetGeometry()->GetOrigin();
   mitk::Vector3D spacing = input->GetGeometry()->GetSpacing();
 
+  this->UpdateViewingRays(xDimension, yDimension, origin, spacing, focalLengthInPixelUnits, focalLengthInMm, principalPoint);
+
+  m_CartesianCoordinates.resize(3*size);
+  m_IsPointValid.resize(size);
+  m_RowPointOffsets.resize(yDimension+1);
+  m_RowPointOffsets[0] = 0;
+
+  //Back-projection of all pixels. The rows are independent of each other and
+  //are processed in parallel. Instead of inserting the points one by one, the
+  //number of valid points per row is counted, so that the point ID's can be
+  //assigned in parallel afterwards.
+#pragma omp parallel for
   for (int j=0; j<yDimension; j++)
   {
+    const unsigned int rowStart = j*xDimension;
+    mitk::ToFProcessingCommon::ToFScalarType* rowCoordinates = &m_CartesianCoordinates[3*rowStart];
+
+    if (m_ReconstructionMode == Kinect)
+    {
+      for (int i=0; i<xDimension; i++)
+      {
+        mitk::ToFProcessingCommon::ToFPoint3D cartesianCoordinates =
+          mitk::ToFProcessingCommon::KinectIndexToCartesianCoordinates(m_IndicesX[i],m_IndicesY[j],inputFloatData[rowStart+i],focalLengthInPixelUnits,principalPoint);
+        rowCoordinates[3*i] = cartesianCoordinates[0];
+        rowCoordinates[3*i+1] = cartesianCoordinates[1];
+        rowCoordinates[3*i+2] = cartesianCoordinates[2];
+      }
+    }
+    else
+    {
+      mitk::ToFProcessingCommon::ViewingRaysToCartesianCoordinates(inputFloatData+rowStart, &m_ViewingRays[4*rowStart], xDimension, rowCoordinates);
+    }
+
+    vtkIdType numberOfValidPoints = 0;
     for (int i=0; i<xDimension; i++)
     {
-      unsigned int pixelID = i+j*xDimension;
+      //Epsilon here, because we may have small float values like 0.00000001 which in fact represents 0.
+      bool isValid = (double)inputFloatData[rowStart+i] > mitk::eps;
+      m_IsPointValid[rowStart+i] = isValid;
+      numberOfValidPoints += isValid;
+    }
+    m_RowPointOffsets[j+1] = numberOfValidPoints;
+  }
 
-      mitk::ToFProcessingCommon::ToFScalarType distance = (double)inputFloatData[pixelID];
+  for (int j=0; j<yDimension; j++)
+  {
+    m_RowPointOffsets[j+1] += m_RowPointOffsets[j];
+  }
+  vtkIdType numberOfPoints = m_RowPointOffsets[yDimension];
+
+  //Surfaces of earlier frames must not change, so their arrays are not overwritten
+  this->SelectUnreferencedOutputBuffers();
+  vtkPoints* outputPoints = m_OutputBuffers.Points;
+  vtkCellArray* outputPolys = m_OutputBuffers.Polys;
+  vtkIdTypeArray* outputPolyIds = m_OutputBuffers.PolyIds;
+  vtkCellArray* outputVertices = m_OutputBuffers.Vertices;
+  vtkIdTypeArray* outputVertexIds = m_OutputBuffers.VertexIds;
+  vtkFloatArray* outputScalars = m_OutputBuffers.ScalarArray;
+  vtkFloatArray* outputTextureCoords = m_OutputBuffers.TextureCoords;
+
+  outputPoints->SetNumberOfPoints(numberOfPoints);
+  double* points = static_cast<double*>(outputPoints->GetData()->GetVoidPointer(0));
+  outputTextureCoords->SetNumberOfTuples(numberOfPoints);
+  float* textureCoords = outputTextureCoords->GetPointer(0);
+  outputScalars->SetNumberOfTuples(scalarFloatData ? numberOfPoints : 0);
+  float* scalars = outputScalars->GetPointer(0);
+
+  //VTK would insert empty points into the polydata if we used the pixel ID's
+  //as point ID's. Thus, only valid points are stored and their ID's are saved
+  //in the vertexIdList (invalid pixels are mapped to ID 0).
+#pragma omp parallel for
+  for (int j=0; j<yDimension; j++)
+  {
+    vtkIdType pointID = m_RowPointOffsets[j];
+    for (int i=0; i<xDimension; i++)
+    {
+      unsigned int pixelID = i+j*xDimension;
+      if (!m_IsPointValid[pixelID])
+      {
+        m_VertexIdList->SetId(pixelID, 0);
+        continue;
+      }
 
-      /** Here we have to incorporate spacing and origin to allow processing of cropped/resampled images
-      * Usually origin will be [0, 0, 0] and spacing will be [1, 1, 1], but just in case the image is moved
-      * due to cropping or the spacing differes due to up- or downsampling.*/
-      unsigned int completeIndexX = i*spacing[0]+origin[0];
-      unsigned int completeIndexY = j*spacing[1]+origin[1];
+      m_VertexIdList->SetId(pixelID, pointID);
+      points[3*pointID] = m_CartesianCoordinates[3*pixelID];
+      points[3*pointID+1] = m_CartesianCoordinates[3*pixelID+1];
+      points[3*pointID+2] = m_CartesianCoordinates[3*pixelID+2];
 
-      mitk::ToFProcessingCommon::ToFPoint3D cartesianCoordinates;
-      switch (m_ReconstructionMode)
-      {
-      case WithOutInterPixelDistance:
+      //Scalar values are necessary for mapping colors/texture onto the surface
+      if (scalarFloatData)
       {
-        cartesianCoordinates = mitk::ToFProcessingCommon::IndexToCartesianCoordinates(completeIndexX,completeIndexY,distance,focalLengthInPixelUnits,principalPoint);
-        break;
+        scalars[pointID] = scalarFloatData[pixelID];
       }
-      case WithInterPixelDistance:
+      //These Texture Coordinates will map color pixel and vertices 1:1 (e.g. for Kinect).
+      textureCoords[2*pointID] = (((float)i)/xDimension);// correct video texture scale for kinect
+      textureCoords[2*pointID+1] = ((float)j)/yDimension; //don't flip. we don't need to flip.
+      ++pointID;
+    }
+  }
+
+  //The cells are generated in two passes: the first one counts the cells of
+  //every row, the second one writes them to their final position.
+  m_RowPolyOffsets.resize(yDimension+1);
+  m_RowPolyIdOffsets.resize(yDimension+1);
+  m_RowVertexOffsets.resize(yDimension+1);
+  m_RowPolyOffsets[0] = m_RowPolyIdOffsets[0] = m_RowVertexOffsets[0] = 0;
+
+#pragma omp parallel for
+  for (int j=0; j<yDimension; j++)
+  {
+    this->GenerateCellsForRow(j, xDimension, nullptr, m_RowPolyOffsets[j+1], m_RowPolyIdOffsets[j+1], nullptr, m_RowVertexOffsets[j+1]);
+  }
+
+  for (int j=0; j<yDimension; j++)
+  {
+    m_RowPolyOffsets[j+1] += m_RowPolyOffsets[j];
+    m_RowPolyIdOffsets[j+1] += m_RowPolyIdOffsets[j];
+    m_RowVertexOffsets[j+1] += m_RowVertexOffsets[j];
+  }
+
+  outputPolyIds->SetNumberOfValues(m_RowPolyIdOffsets[yDimension]);
+  vtkIdType* polyIds = outputPolyIds->GetPointer(0);
+  outputVertexIds->SetNumberOfValues(2*m_RowVertexOffsets[yDimension]);
+  vtkIdType* vertexIds = outputVertexIds->GetPointer(0);
+
+#pragma omp parallel for
+  for (int j=0; j<yDimension; j++)
+  {
+    vtkIdType numberOfPolys, polyIdsSize, numberOfVertices;
+    this->GenerateCellsForRow(j, xDimension, polyIds + m_RowPolyIdOffsets[j], numberOfPolys, polyIdsSize,
+      vertexIds + 2*m_RowVertexOffsets[j], numberOfVertices);
+  }
+
+  outputPolys->SetCells(m_RowPolyOffsets[yDimension], outputPolyIds);
+  outputVertices->SetCells(m_RowVertexOffsets[yDimension], outputVertexIds);
+
+  //The arrays were written directly, so VTK has to be told about the changes
+  outputPoints->GetData()->Modified();
+  outputPoints->Modified();
+  outputTextureCoords->Modified();
+  outputScalars->Modified();
+  outputPolyIds->Modified();
+  outputPolys->Modified();
+  outputVertexIds->Modified();
+  outputVertices->Modified();
+
+  //The buffers are shared with the new polydata, only the (lightweight)
+  //polydata itself is created per frame.
+  vtkSmartPointer<vtkPolyData> mesh = vtkSmartPointer<vtkPolyData>::New();
+  mesh->SetPoints(outputPoints);
+  if (m_GenerateTriangleStrips)
+  {
+    mesh->SetStrips(outputPolys);
+  }
+  else
+  {
+    mesh->SetPolys(outputPolys);
+  }
+  mesh->SetVerts(outputVertices);
+  //Pass the scalars to the polydata (if they were set).
+  if (outputScalars->GetNumberOfTuples()>0)
+  {
+    mesh->GetPointData()->SetScalars(outputScalars);
+  }
+  //Pass the TextureCoords to the polydata anyway (to save them).
+  mesh->GetPointData()->SetTCoords(outputTextureCoords);
+  output->SetVtkPolyData(mesh);
+}
+
+void mitk::ToFDistanceImageToSurfaceFilter::UpdateViewingRays(int xDimension, int yDimension, const mitk::Point3D& origin, const mitk::Vector3D& spacing,
+  const ToFProcessingCommon::ToFPoint2D& focalLengthInPixelUnits, ToFProcessingCommon::ToFScalarType focalLengthInMm,
+  const ToFProcessingCommon::ToFPoint2D& principalPoint)
+{
+  ToFProcessingCommon::ToFScalarType parameters[] = { (double)xDimension, (double)yDimension, origin[0], origin[1], spacing[0], spacing[1],
+    (double)m_ReconstructionMode, focalLengthInPixelUnits[0], focalLengthInPixelUnits[1], focalLengthInMm,
+    principalPoint[0], principalPoint[1], m_InterPixelDistance[0], m_InterPixelDistance[1] };
+  std::vector<ToFProcessingCommon::ToFScalarType> currentParameters(parameters, parameters + sizeof(parameters)/sizeof(parameters[0]));
+
+  if (currentParameters == m_ViewingRaysParameters)
+  {
+    return;
+  }
+  m_ViewingRaysParameters = currentParameters;
+
+  /** Here we have to incorporate spacing and origin to allow processing of cropped/resampled images
+  * Usually origin will be [0, 0, 0] and spacing will be [1, 1, 1], but just in case the image is moved
+  * due to cropping or the spacing differes due to up- or downsampling.*/
+  m_IndicesX.resize(xDimension);
+  for (int i=0; i<xDimension; i++)
+  {
+    m_IndicesX[i] = static_cast<unsigned int>(i*spacing[0]+origin[0]);
+  }
+  m_IndicesY.resize(yDimension);
+  for (int j=0; j<yDimension; j++)
+  {
+    m_IndicesY[j] = static_cast<unsigned int>(j*spacing[1]+origin[1]);
+  }
+
+  switch (m_ReconstructionMode)
+  {
+  case WithOutInterPixelDistance:
+  {
+    mitk::ToFProcessingCommon::ComputeViewingRays(m_IndicesX, m_IndicesY, focalLengthInPixelUnits[0], focalLengthInPixelUnits[1],
+      principalPoint[0], principalPoint[1], m_ViewingRays);
+    break;
+  }
+  case WithInterPixelDistance:
+  {
+    mitk::ToFProcessingCommon::ComputeViewingRaysWithInterpixdist(m_IndicesX, m_IndicesY, focalLengthInMm,
+      m_InterPixelDistance[0], m_InterPixelDistance[1], principalPoint[0], principalPoint[1], m_ViewingRays);
+    break;
+  }
+  default:
+  {
+    //Kinect reconstruction is cheap enough to be computed directly
+    m_ViewingRays.clear();
+  }
+  }
+}
+
+void mitk::ToFDistanceImageToSurfaceFilter::GenerateCellsForRow(int j, int xDimension, vtkIdType* polyIds, vtkIdType& numberOfPolys, vtkIdType& polyIdsSize,
+  vtkIdType* vertexIds, vtkIdType& numberOfVertices) const
+{
+  numberOfPolys = 0;
+  polyIdsSize = 0;
+  numberOfVertices = 0;
+
+  const unsigned int rowStart = j*xDimension;
+
+  if (!m_GenerateTriangularMesh)
+  {
+    //We dont want triangulation, we only want vertices
+    for (int i=0; i<xDimension; i++)
+    {
+      if (m_IsPointValid[rowStart+i])
       {
-        cartesianCoordinates = mitk::ToFProcessingCommon::IndexToCartesianCoordinatesWithInterpixdist(completeIndexX,completeIndexY,distance,focalLengthInMm,m_InterPixelDistance,principalPoint);
-        break;
+        if (vertexIds)
+        {
+          vertexIds[2*numberOfVertices] = 1;
+          vertexIds[2*numberOfVertices+1] = m_VertexIdList->GetId(rowStart+i);
+        }
+        ++numberOfVertices;
       }
-      case Kinect:
+    }
+    return;
+  }
+
+  //We can only start triangulation if we are at vertex (1,1),
+  //because we need the other 3 vertices near this one.
+  if (j < 1)
+  {
+    return;
+  }
+
+  vtkIdType stripStart = -1; // position of the size entry of the current triangle strip
+  for (int i=1; i<xDimension; i++)
+  {
+    //This little piece of art explains the ID's:
+    //
+    // P(x_1y_1)---P(xy_1)
+    // |           |
+    // |           |
+    // |           |
+    // P(x_1y)-----P(xy)
+    //
+    //To go one pixel line back in the image array, we have to
+    //subtract 1x xDimension.
+    vtkIdType xy = rowStart+i;
+    vtkIdType x_1y = xy-1;
+    vtkIdType xy_1 = xy-xDimension;
+    vtkIdType x_1y_1 = xy_1-1;
+
+    bool isCellValid = m_IsPointValid[xy]&&m_IsPointValid[x_1y]&&m_IsPointValid[x_1y_1]&&m_IsPointValid[xy_1];
+    bool isTriangulated = false;
+
+    if (isCellValid) // check if points of cell are valid
+    {
+      const double* pointXY = &m_CartesianCoordinates[3*xy];
+      const double* pointX_1Y = &m_CartesianCoordinates[3*x_1y];
+      const double* pointXY_1 = &m_CartesianCoordinates[3*xy_1];
+      const double* pointX_1Y_1 = &m_CartesianCoordinates[3*x_1y_1];
+
+      isTriangulated = (mitk::Equal(m_TriangulationThreshold, 0.0)) || ((vtkMath::Distance2BetweenPoints(pointXY, pointX_1Y) <= m_TriangulationThreshold)
+                                                                      && (vtkMath::Distance2BetweenPoints(pointXY, pointXY_1) <= m_TriangulationThreshold)
+                                                                      && (vtkMath::Distance2BetweenPoints(pointX_1Y, pointX_1Y_1) <= m_TriangulationThreshold)
+                                                                      && (vtkMath::Distance2BetweenPoints(pointXY_1, pointX_1Y_1) <= m_TriangulationThreshold));
+    }
+
+    if (!isTriangulated)
+    {
+      stripStart = -1;
+    }
+
+    if (isTriangulated && m_GenerateTriangleStrips)
+    {
+      //The strip zig-zags between the previous (y_1) and the current (y) row:
+      //x_1y_1, x_1y, xy_1, xy, ... This keeps the orientation of the
+      //triangles, but splits the cells along the other diagonal.
+      if (stripStart < 0)
       {
-        cartesianCoordinates = mitk::ToFProcessingCommon::KinectIndexToCartesianCoordinates(completeIndexX,completeIndexY,distance,focalLengthInPixelUnits,principalPoint);
-        break;
+        stripStart = polyIdsSize;
+        if (polyIds)
+        {
+          polyIds[stripStart] = 2;
+          polyIds[stripStart+1] = m_VertexIdList->GetId(x_1y_1);
+          polyIds[stripStart+2] = m_VertexIdList->GetId(x_1y);
+        }
+        polyIdsSize += 3;
+        ++numberOfPolys;
       }
-      default:
+      if (polyIds)
       {
-        MITK_ERROR << "Incorrect reconstruction mode!";
+        polyIds[stripStart] += 2;
+        polyIds[polyIdsSize] = m_VertexIdList->GetId(xy_1);
+        polyIds[polyIdsSize+1] = m_VertexIdList->GetId(xy);
       }
-      }
-      //Epsilon here, because we may have small float values like 0.00000001 which in fact represents 0.
-      if (distance<=mitk::eps)
+      polyIdsSize += 2;
+    }
+    else if (isTriangulated)
+    {
+      if (polyIds)
       {
-        isPointValid[pixelID] = false;
+        vtkIdType* cell = polyIds + polyIdsSize;
+        cell[0] = 3;
+        cell[1] = m_VertexIdList->GetId(x_1y);
+        cell[2] = m_VertexIdList->GetId(xy);
+        cell[3] = m_VertexIdList->GetId(x_1y_1);
+
+        cell[4] = 3;
+        cell[5] = m_VertexIdList->GetId(x_1y_1);
+        cell[6] = m_VertexIdList->GetId(xy);
+        cell[7] = m_VertexIdList->GetId(xy_1);
       }
-      else
+      polyIdsSize += 8;
+      numberOfPolys += 2;
+    }
+    else if (isCellValid)
+    {
+      //We dont want triangulation, but we want to keep the vertex
+      if (vertexIds)
       {
-        isPointValid[pixelID] = true;
-        //VTK would insert empty points into the polydata if we use
-        //points->InsertPoint(pixelID, cartesianCoordinates.GetDataPointer()).
-        //If we use points->InsertNextPoint(...) instead, the ID's do not
-        //correspond to the image pixel ID's. Thus, we have to save them
-        //in the vertexIdList.
-        m_VertexIdList->SetId(pixelID, points->InsertNextPoint(cartesianCoordinates.GetDataPointer()));
-
-        if (m_GenerateTriangularMesh)
-        {
-          if((i >= 1) && (j >= 1))
-          {
-            //This little piece of art explains the ID's:
-            //
-            // P(x_1y_1)---P(xy_1)
-            // |           |
-            // |           |
-            // |           |
-            // P(x_1y)-----P(xy)
-            //
-            //We can only start triangulation if we are at vertex (1,1),
-            //because we need the other 3 vertices near this one.
-            //To go one pixel line back in the image array, we have to
-            //subtract 1x xDimension.
-            vtkIdType xy = pixelID;
-            vtkIdType x_1y = pixelID-1;
-            vtkIdType xy_1 = pixelID-xDimension;
-            vtkIdType x_1y_1 = xy_1-1;
-
-            //Find the corresponding vertex ID's in the saved vertexIdList:
-            vtkIdType xyV = m_VertexIdList->GetId(xy);
-            vtkIdType x_1yV = m_VertexIdList->GetId(x_1y);
-            vtkIdType xy_1V = m_VertexIdList->GetId(xy_1);
-            vtkIdType x_1y_1V = m_VertexIdList->GetId(x_1y_1);
-
-            if (isPointValid[xy]&&isPointValid[x_1y]&&isPointValid[x_1y_1]&&isPointValid[xy_1]) // check if points of cell are valid
-            {
-              double pointXY[3], pointX_1Y[3], pointXY_1[3], pointX_1Y_1[3];
-
-              points->GetPoint(xyV, pointXY);
-              points->GetPoint(x_1yV, pointX_1Y);
-              points->GetPoint(xy_1V, pointXY_1);
-              points->GetPoint(x_1y_1V, pointX_1Y_1);
-
-              if( (mitk::Equal(m_TriangulationThreshold, 0.0)) || ((vtkMath::Distance2BetweenPoints(pointXY, pointX_1Y) <= m_TriangulationThreshold)
-                                                                   && (vtkMath::Distance2BetweenPoints(pointXY, pointXY_1) <= m_TriangulationThreshold)
-                                                                   && (vtkMath::Distance2BetweenPoints(pointX_1Y, pointX_1Y_1) <= m_TriangulationThreshold)
-                                                                   && (vtkMath::Distance2BetweenPoints(pointXY_1, pointX_1Y_1) <= m_TriangulationThreshold)))
-              {
-                polys->InsertNextCell(3);
-                polys->InsertCellPoint(x_1yV);
-                polys->InsertCellPoint(xyV);
-                polys->InsertCellPoint(x_1y_1V);
-
-                polys->InsertNextCell(3);
-                polys->InsertCellPoint(x_1y_1V);
-                polys->InsertCellPoint(xyV);
-                polys->InsertCellPoint(xy_1V);
-              }
-              else
-              {
-                //We dont want triangulation, but we want to keep the vertex
-                vertices->InsertNextCell(1);
-                vertices->InsertCellPoint(xyV);
-              }
-            }
-          }
-        }
-        else
-        {
-          //We dont want triangulation, we only want vertices
-          vertices->InsertNextCell(1);
-          vertices->InsertCellPoint(m_VertexIdList->GetId(pixelID));
-        }
-        //Scalar values are necessary for mapping colors/texture onto the surface
-        if (scalarFloatData)
-        {
-          scalarArray->InsertTuple1(m_VertexIdList->GetId(pixelID), scalarFloatData[pixelID]);
-        }
-        //These Texture Coordinates will map color pixel and vertices 1:1 (e.g. for Kinect).
-        float xNorm = (((float)i)/xDimension);// correct video texture scale for kinect
-        float yNorm = ((float)j)/yDimension; //don't flip. we don't need to flip.
-        textureCoords->InsertTuple2(m_VertexIdList->GetId(pixelID), xNorm, yNorm);
+        vertexIds[2*numberOfVertices] = 1;
+        vertexIds[2*numberOfVertices+1] = m_VertexIdList->GetId(xy);
       }
+      ++numberOfVertices;
     }
   }
-
-  vtkSmartPointer<vtkPolyData> mesh = vtkSmartPointer<vtkPolyData>::New();
-  mesh->SetPoints(points);
-  mesh->SetPolys(polys);
-  mesh->SetVerts(vertices);
-  //Pass the scalars to the polydata (if they were set).
-  if (scalarArray->GetNumberOfTuples()>0)
-  {
-    mesh->GetPointData()->SetScalars(scalarArray);
-  }
-  //Pass the TextureCoords to the polydata anyway (to save them).
-  mesh->GetPointData()->SetTCoords(textureCoords);
-  output->SetVtkPolyData(mesh);
 }
 
 void mitk::ToFDistanceImageToSurfaceFilter::CreateOutputsForAllInputs()
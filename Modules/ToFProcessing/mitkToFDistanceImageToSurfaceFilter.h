@@ -27,6 +27,12 @@ See LICENSE.txt or http://www.mitk.org for details.
 
 #include <vtkSmartPointer.h>
 #include <vtkIdList.h>
+#include <vtkIdTypeArray.h>
+#include <vtkPoints.h>
+#include <vtkCellArray.h>
+#include <vtkFloatArray.h>
+
+#include <vector>
 
 namespace mitk
 {
@@ -42,6 +48,11 @@ namespace mitk
   * The definition of the image plane and its coordinate systems (pixel and mm) is depicted in the following image
   * \image html ../Modules/ToFProcessing/Documentation/ImagePlane.png
   *
+  * The image rows are processed in parallel. The distance independent part of the back-projection is only
+  * computed when image geometry or intrinsics change, and the point, cell and attribute arrays of the output
+  * are reused for consecutive frames. Note that therefore the arrays of a previously generated surface are
+  * overwritten by the next update of the filter.
+  *
   * @ingroup SurfaceFilters
   * @ingroup ToFProcessing
   */
@@ -81,6 +92,16 @@ namespace mitk
     itkSetMacro(GenerateTriangularMesh,bool);
     itkGetMacro(GenerateTriangularMesh,bool);
 
+    /**
+     * @brief SetGenerateTriangleStrips If set (and GenerateTriangularMesh is on),
+     * neighbouring triangles of an image row are joined to triangle strips instead of
+     * being stored as single triangles. This roughly halves the size of the cell array
+     * and the amount of data uploaded for rendering. Default is false.
+     */
+    itkSetMacro(GenerateTriangleStrips,bool);
+    itkGetMacro(GenerateTriangleStrips,bool);
+    itkBooleanMacro(GenerateTriangleStrips);
+
 
     /**
      * @brief The ReconstructionModeType enum: Defines the reconstruction mode, if using no interpixeldistances and focal lenghts in pixel units  or interpixeldistances and focal length in mm. The Kinect option defines a special reconstruction mode for the kinect.
@@ -173,6 +194,22 @@ namespace mitk
     */
     void CreateOutputsForAllInputs();
 
+    /**
+    * \brief Recomputes the viewing rays of all pixels if image geometry,
+    * intrinsics or reconstruction mode changed since the last frame.
+    */
+    void UpdateViewingRays(int xDimension, int yDimension, const mitk::Point3D& origin, const mitk::Vector3D& spacing,
+      const ToFProcessingCommon::ToFPoint2D& focalLengthInPixelUnits, ToFProcessingCommon::ToFScalarType focalLengthInMm,
+      const ToFProcessingCommon::ToFPoint2D& principalPoint);
+
+    /**
+    * \brief Computes the cells of one image row. If polyIds and vertexIds are nullptr, only the
+    * number of cells and the size of their id arrays are counted, otherwise the cells are written
+    * to the given positions.
+    */
+    void GenerateCellsForRow(int j, int xDimension, vtkIdType* polyIds, vtkIdType& numberOfPolys, vtkIdType& polyIdsSize,
+      vtkIdType* vertexIds, vtkIdType& numberOfVertices) const;
+
     IplImage* m_IplScalarImage; ///< Scalar image used for surface texturing
 
     mitk::CameraIntrinsics::Pointer m_CameraIntrinsics; ///< Specifies the intrinsic parameters
@@ -190,6 +227,47 @@ namespace mitk
 
     double m_TriangulationThreshold;
 
+    bool m_GenerateTriangleStrips; ///< Join the triangles of a row to triangle strips
+
+    // buffers reused across frames, so that no memory has to be allocated for every frame
+    std::vector<unsigned int> m_IndicesX; ///< pixel index of every column (incorporates spacing and origin)
+    std::vector<unsigned int> m_IndicesY; ///< pixel index of every row (incorporates spacing and origin)
+    std::vector<ToFProcessingCommon::ToFScalarType> m_ViewingRays; ///< distance independent part of the back-projection
+    std::vector<ToFProcessingCommon::ToFScalarType> m_ViewingRaysParameters; ///< geometry and intrinsics the viewing rays were computed for
+    std::vector<ToFProcessingCommon::ToFScalarType> m_CartesianCoordinates; ///< back-projected coordinates of all pixels
+    std::vector<unsigned char> m_IsPointValid;
+    std::vector<vtkIdType> m_RowPointOffsets; ///< id of the first point of every row
+    std::vector<vtkIdType> m_RowPolyOffsets; ///< number of polys/strips preceding every row
+    std::vector<vtkIdType> m_RowPolyIdOffsets; ///< position of the first cell id of every row
+    std::vector<vtkIdType> m_RowVertexOffsets; ///< number of vertices preceding every row
+
+    /**
+    * \brief Arrays of one output surface.
+    *
+    * The arrays are shared with the polydata of the output, so they are only
+    * written again once no surface of an earlier frame refers to them anymore.
+    */
+    struct OutputBuffers
+    {
+      OutputBuffers();
+      /** \brief True if a polydata (e.g. a surface of an earlier frame) still refers to the arrays. */
+      bool IsReferenced() const;
+
+      vtkSmartPointer<vtkPoints> Points;
+      vtkSmartPointer<vtkCellArray> Polys;
+      vtkSmartPointer<vtkIdTypeArray> PolyIds;
+      vtkSmartPointer<vtkCellArray> Vertices;
+      vtkSmartPointer<vtkIdTypeArray> VertexIds;
+      vtkSmartPointer<vtkFloatArray> ScalarArray;
+      vtkSmartPointer<vtkFloatArray> TextureCoords;
+    };
+
+    /** \brief Makes m_OutputBuffers a set of arrays no surface refers to, taken from the pool or newly allocated. */
+    void SelectUnreferencedOutputBuffers();
+
+    OutputBuffers m_OutputBuffers; ///< arrays of the current frame
+    std::vector<OutputBuffers> m_OutputBufferPool; ///< arrays of earlier frames, reused once their surfaces are released
+
   };
 } //END mitk namespace
 #endif
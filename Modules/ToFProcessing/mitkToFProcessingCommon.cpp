@@ -161,6 +161,68 @@ namespace mitk
     return cartesianCoordinates;
   }
 
+  void ToFProcessingCommon::ComputeViewingRays(const std::vector<unsigned int>& indicesX, const std::vector<unsigned int>& indicesY,
+    ToFScalarType focalLengthX, ToFScalarType focalLengthY, ToFScalarType principalPointX, ToFScalarType principalPointY,
+    std::vector<ToFScalarType>& viewingRays)
+  {
+    const std::size_t dimX = indicesX.size();
+    viewingRays.resize(4*dimX*indicesY.size());
+
+    // same computation as in IndexToCartesianCoordinates() to obtain identical results
+    const ToFScalarType focalLengthRatio = focalLengthX / focalLengthY;
+    for (std::size_t j = 0; j < indicesY.size(); ++j)
+    {
+      ToFScalarType imageY = indicesY[j] - principalPointY;
+      ToFScalarType imageY_in_pX = imageY * focalLengthRatio;
+      ToFScalarType* ray = &viewingRays[4*j*dimX];
+      for (std::size_t i = 0; i < dimX; ++i, ray += 4)
+      {
+        ToFScalarType imageX = indicesX[i] - principalPointX;
+        ray[0] = imageX;
+        ray[1] = imageY_in_pX;
+        ray[2] = focalLengthX;
+        ray[3] = sqrt(imageX*imageX + imageY_in_pX*imageY_in_pX + focalLengthX*focalLengthX);
+      }
+    }
+  }
+
+  void ToFProcessingCommon::ComputeViewingRaysWithInterpixdist(const std::vector<unsigned int>& indicesX, const std::vector<unsigned int>& indicesY,
+    ToFScalarType focalLength, ToFScalarType interPixelDistanceX, ToFScalarType interPixelDistanceY,
+    ToFScalarType principalPointX, ToFScalarType principalPointY, std::vector<ToFScalarType>& viewingRays)
+  {
+    const std::size_t dimX = indicesX.size();
+    viewingRays.resize(4*dimX*indicesY.size());
+
+    // same computation as in IndexToCartesianCoordinatesWithInterpixdist() to obtain identical results
+    for (std::size_t j = 0; j < indicesY.size(); ++j)
+    {
+      ToFScalarType imageY = (( indicesY[j] - principalPointY ) * interPixelDistanceY);
+      ToFScalarType* ray = &viewingRays[4*j*dimX];
+      for (std::size_t i = 0; i < dimX; ++i, ray += 4)
+      {
+        ToFScalarType imageX = (( indicesX[i] - principalPointX ) * interPixelDistanceX);
+        ray[0] = imageX;
+        ray[1] = imageY;
+        ray[2] = focalLength;
+        ray[3] = sqrt(imageX*imageX + imageY*imageY + focalLength*focalLength);
+      }
+    }
+  }
+
+  void ToFProcessingCommon::ViewingRaysToCartesianCoordinates(const float* distances, const ToFScalarType* viewingRays,
+    unsigned int numberOfPixels, ToFScalarType* cartesianCoordinates)
+  {
+    for (unsigned int p = 0; p < numberOfPixels; ++p)
+    {
+      const ToFScalarType distance = distances[p];
+      const ToFScalarType* ray = viewingRays + 4*p;
+      ToFScalarType* point = cartesianCoordinates + 3*p;
+      point[0] = distance*ray[0] / ray[3]; //Strahlensatz: x / imageX = distance / d
+      point[1] = distance*ray[1] / ray[3]; //Strahlensatz: y / imageY = distance / d
+      point[2] = distance*ray[2] / ray[3]; //Strahlensatz: z / f = distance / d
+    }
+  }
+
   ToFProcessingCommon::ToFScalarType ToFProcessingCommon::CalculateViewAngle( mitk::CameraIntrinsics::Pointer intrinsics, unsigned int dimX )
   {
     ToFScalarType viewAngle = 180*(atan2(intrinsics->GetPrincipalPointX(),intrinsics->GetFocalLengthX()) + atan2((dimX-intrinsics->GetPrincipalPointX()),intrinsics->GetFocalLengthX()))/vnl_math::pi;
@@ -22,6 +22,8 @@ See LICENSE.txt or http://www.mitk.org for details.
 #include "mitkNumericTypes.h"
 #include <vnl/vnl_math.h>
 
+#include <vector>
+
 namespace mitk
 {
   /**
@@ -332,6 +334,42 @@ namespace mitk
      */
     static ToFProcessingCommon::ToFPoint3D ContinuousKinectIndexToCartesianCoordinates(mitk::Point2D continuousIndex, ToFScalarType distance, ToFScalarType focalLengthX, ToFScalarType focalLengthY, ToFScalarType principalPointX, ToFScalarType principalPointY);
 
+    /**
+     * @brief Precomputes the distance independent part of the back-projection for all pixels of an image grid.
+     * For every pixel (i,j) the four values {rayX, rayY, rayZ, d} are written to viewingRays (row-major, 4 values per pixel)
+     * such that the cartesian coordinates of a distance value are given by distance*ray/d. The results are identical
+     * to IndexToCartesianCoordinates(), but the square root is only evaluated once per pixel and not once per frame.
+     * @param indicesX index in x direction of every image column (allows to incorporate spacing and origin)
+     * @param indicesY index in y direction of every image row
+     * @param focalLengthX focal length of optical system in pixel units in x-direction (mostly obtained from camera calibration)
+     * @param focalLengthY focal length of optical system in pixel units in y-direction (mostly obtained from camera calibration)
+     * @param principalPointX x coordinate of principal point on image plane in pixel
+     * @param principalPointY y coordinate of principal point on image plane in pixel
+     * @param viewingRays resized to 4*indicesX.size()*indicesY.size() values
+     */
+    static void ComputeViewingRays(const std::vector<unsigned int>& indicesX, const std::vector<unsigned int>& indicesY,
+      ToFScalarType focalLengthX, ToFScalarType focalLengthY, ToFScalarType principalPointX, ToFScalarType principalPointY,
+      std::vector<ToFScalarType>& viewingRays);
+
+    /**
+     * @brief Same as ComputeViewingRays(), but with focal length and inter pixel distances in mm. The results are identical
+     * to IndexToCartesianCoordinatesWithInterpixdist().
+     */
+    static void ComputeViewingRaysWithInterpixdist(const std::vector<unsigned int>& indicesX, const std::vector<unsigned int>& indicesY,
+      ToFScalarType focalLength, ToFScalarType interPixelDistanceX, ToFScalarType interPixelDistanceY,
+      ToFScalarType principalPointX, ToFScalarType principalPointY, std::vector<ToFScalarType>& viewingRays);
+
+    /**
+     * @brief Converts a contiguous run of distance values to cartesian coordinates using precomputed viewing rays.
+     * The loop has no branches and no dependencies between pixels, so it is vectorized by the compiler.
+     * @param distances numberOfPixels distance values in mm
+     * @param viewingRays 4*numberOfPixels values as computed by ComputeViewingRays() for the same pixels
+     * @param numberOfPixels number of distance values to convert
+     * @param cartesianCoordinates 3*numberOfPixels values (x,y,z per pixel) are written here
+     */
+    static void ViewingRaysToCartesianCoordinates(const float* distances, const ToFScalarType* viewingRays,
+      unsigned int numberOfPixels, ToFScalarType* cartesianCoordinates);
+
     /**
     \brief Calculates the horizontal view angle of the camera with the given intrinsics
     \param intrinsics intrinsic parameters of the camera
@@ -18,6 +18,30 @@ See LICENSE.txt or http://www.mitk.org for details.
 #include "mitkUSProbe.h"
 #include "mitkTestingMacros.h"
 
+/**
+* Video device which allows to publish frames without an acquisition thread.
+*/
+class USDeviceTestDevice : public mitk::USVideoDevice
+{
+public:
+  mitkClassMacro(USDeviceTestDevice, mitk::USVideoDevice);
+  mitkNewMacro3Param(Self, std::string, std::string, std::string);
+
+  void PublishFrames(unsigned int numberOfFrames)
+  {
+    for (unsigned int i = 0; i < numberOfFrames; ++i)
+    {
+      m_FrameBuffer->PublishWriteFrame();
+    }
+  }
+
+protected:
+  USDeviceTestDevice(std::string videoFilePath, std::string manufacturer, std::string model)
+    : mitk::USVideoDevice(videoFilePath, manufacturer, model)
+  {
+  }
+};
+
 class mitkUSDeviceTestClass
 {
 public:
@@ -32,6 +56,21 @@ public:
     //MITK_TEST_CONDITION_REQUIRED((device->GetDeviceModel().compare("Model") == 0), "Model should be set correctly");
   }
 
+  static void TestResetFrameLatencyStatistics()
+  {
+    USDeviceTestDevice::Pointer device = USDeviceTestDevice::New("IllegalPath", "Manufacturer", "Model");
+
+    // nobody acquires the frames, so all but the last one are dropped
+    device->PublishFrames(3);
+    MITK_TEST_CONDITION_REQUIRED(device->GetFrameLatencyStatistics().NumberOfDroppedFrames == 2,
+      "Frames which were not displayed should be counted as dropped");
+
+    device->ResetFrameLatencyStatistics();
+    mitk::USDevice::FrameLatencyStatistics statistics = device->GetFrameLatencyStatistics();
+    MITK_TEST_CONDITION_REQUIRED(statistics.NumberOfDroppedFrames == 0, "Reset should clear the dropped frames");
+    MITK_TEST_CONDITION_REQUIRED(statistics.NumberOfFrames == 0, "Reset should clear the number of frames");
+  }
+
   static void TestAddProbe()
   {
   }
@@ -49,6 +88,7 @@ int mitkUSDeviceTest(int /* argc */, char* /*argv*/[])
   MITK_TEST_BEGIN("mitkUSDeviceTest");
 
   mitkUSDeviceTestClass::TestInstantiation();
+  mitkUSDeviceTestClass::TestResetFrameLatencyStatistics();
   mitkUSDeviceTestClass::TestAddProbe();
   mitkUSDeviceTestClass::TestActivateProbe();
 
@@ -0,0 +1,107 @@
+/*===================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center,
+Division of Medical and Biological Informatics.
+All rights reserved.
+
+This software is distributed WITHOUT ANY WARRANTY; without
+even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE.
+
+See LICENSE.txt or http://www.mitk.org for details.
+
+===================================================================*/
+
+#include "mitkUSImageTripleBuffer.h"
+#include "mitkTestingMacros.h"
+
+class mitkUSImageTripleBufferTestClass
+{
+public:
+
+  static void TestInstantiation()
+  {
+    mitk::USImageTripleBuffer::Pointer buffer = mitk::USImageTripleBuffer::New();
+    MITK_TEST_CONDITION_REQUIRED(buffer.IsNotNull(), "USImageTripleBuffer should not be null after instantiation");
+    MITK_TEST_CONDITION_REQUIRED(!buffer->AcquireReadFrame(), "No frame should be available before anything was published");
+  }
+
+  static void TestPublishAndAcquire()
+  {
+    mitk::USImageTripleBuffer::Pointer buffer = mitk::USImageTripleBuffer::New();
+
+    mitk::Image::Pointer image = mitk::Image::New();
+    buffer->GetWriteFrame().Images.push_back(image);
+    buffer->GetWriteFrame().CaptureTime = 42;
+    buffer->PublishWriteFrame();
+
+    MITK_TEST_CONDITION_REQUIRED(buffer->GetWriteFrame().Images.empty(), "Producer should get a different slot after publishing");
+    MITK_TEST_CONDITION_REQUIRED(buffer->AcquireReadFrame(), "Published frame should be available for the consumer");
+    MITK_TEST_CONDITION_REQUIRED(buffer->GetReadFrame().Images.size() == 1 && buffer->GetReadFrame().Images[0] == image,
+      "Consumer should get the published images");
+    MITK_TEST_CONDITION_REQUIRED(buffer->GetReadFrame().CaptureTime == 42, "Capture time should be handed over");
+    MITK_TEST_CONDITION_REQUIRED(!buffer->AcquireReadFrame(), "Frame should only be acquired once");
+    MITK_TEST_CONDITION_REQUIRED(buffer->GetReadFrame().Images[0] == image, "Read frame should stay unchanged without new frame");
+  }
+
+  static void TestDroppedFrames()
+  {
+    mitk::USImageTripleBuffer::Pointer buffer = mitk::USImageTripleBuffer::New();
+
+    for (unsigned int i = 0; i < 3; ++i)
+    {
+      buffer->PublishWriteFrame();
+    }
+
+    MITK_TEST_CONDITION_REQUIRED(buffer->GetNumberOfDroppedFrames() == 2, "Two frames should be dropped without consumer");
+    MITK_TEST_CONDITION_REQUIRED(buffer->AcquireReadFrame(), "Latest frame should be available");
+    MITK_TEST_CONDITION_REQUIRED(buffer->GetReadFrame().FrameId == 2, "Consumer should get the most recent frame");
+
+    buffer->PublishWriteFrame();
+    buffer->PublishWriteFrame();
+    buffer->ResetNumberOfDroppedFrames();
+    MITK_TEST_CONDITION_REQUIRED(buffer->GetNumberOfDroppedFrames() == 0, "Dropped frames should be reset");
+    MITK_TEST_CONDITION_REQUIRED(buffer->AcquireReadFrame(), "Resetting the dropped frames should keep the pending frame");
+
+    buffer->PublishWriteFrame();
+    buffer->PublishWriteFrame();
+    buffer->Clear();
+    MITK_TEST_CONDITION_REQUIRED(buffer->GetNumberOfDroppedFrames() == 0, "Clear should reset the dropped frames");
+  }
+
+  static void TestSlotsAreRecycled()
+  {
+    mitk::USImageTripleBuffer::Pointer buffer = mitk::USImageTripleBuffer::New();
+    for (unsigned int i = 0; i < 3; ++i)
+    {
+      buffer->GetWriteFrame().Images.push_back(mitk::Image::New());
+      buffer->PublishWriteFrame();
+      buffer->AcquireReadFrame();
+    }
+
+    // every slot got exactly one image, no further allocations are needed
+    for (unsigned int i = 0; i < 3; ++i)
+    {
+      MITK_TEST_CONDITION_REQUIRED(buffer->GetWriteFrame().Images.size() == 1, "Recycled slot should keep its images");
+      buffer->PublishWriteFrame();
+      buffer->AcquireReadFrame();
+    }
+  }
+};
+
+/**
+* This function is testing methods of the class USImageTripleBuffer.
+*/
+int mitkUSImageTripleBufferTest(int /* argc */, char* /*argv*/[])
+{
+  MITK_TEST_BEGIN("mitkUSImageTripleBufferTest");
+
+  mitkUSImageTripleBufferTestClass::TestInstantiation();
+  mitkUSImageTripleBufferTestClass::TestPublishAndAcquire();
+  mitkUSImageTripleBufferTestClass::TestDroppedFrames();
+  mitkUSImageTripleBufferTestClass::TestSlotsAreRecycled();
+
+  MITK_TEST_END();
+}
@@ -17,6 +17,12 @@ See LICENSE.txt or http://www.mitk.org for details.
 #include "mitkUSImageSource.h"
 #include "mitkProperties.h"
 
+// OpenCV
+#include <opencv2/imgproc.hpp>
+
+// ITK
+#include <itkRGBPixel.h>
+
 const char* mitk::USImageSource::IMAGE_PROPERTY_IDENTIFIER = "id_nummer";
 
 mitk::USImageSource::USImageSource()
@@ -50,7 +56,12 @@ bool mitk::USImageSource::GetIsFilterInThePipeline(AbstractOpenCVImageFilter::Po
 std::vector<mitk::Image::Pointer> mitk::USImageSource::GetNextImage()
 {
   std::vector<mitk::Image::Pointer> result;
+  this->GetNextImage(result);
+  return result;
+}
 
+void mitk::USImageSource::GetNextImage(std::vector<mitk::Image::Pointer>& result)
+{
   // Apply OpenCV based filters beforehand
   if (m_ImageFilter.IsNotNull() && !m_ImageFilter->GetIsEmpty())
   {
@@ -61,18 +72,33 @@ std::vector<mitk::Image::Pointer> mitk::USImageSource::GetNextImage()
 
     for (size_t i = 0; i < imageVector.size(); ++i)
     {
-      if (!imageVector[i].empty())
+      if (imageVector[i].empty())
+      {
+        // do not hand out the image of a previous frame again
+        result[i] = nullptr;
+      }
+      else
       {
         m_ImageFilterMutex->Lock();
         m_ImageFilter->FilterImage(imageVector[i], m_CurrentImageId);
         m_ImageFilterMutex->Unlock();
 
-        // convert to MITK image
-        this->m_OpenCVToMitkFilter->SetOpenCVMat(imageVector[i]);
-        this->m_OpenCVToMitkFilter->Update();
-
-        // OpenCVToMitkImageFilter returns a standard mitk::image.
-        result[i] = this->m_OpenCVToMitkFilter->GetOutput();
+        // the output of the conversion filter belongs to the filter and must not be overwritten
+        if (result[i].GetPointer() == this->m_OpenCVToMitkFilter->GetOutput())
+        {
+          result[i] = nullptr;
+        }
+
+        // copy into the (possibly reused) MITK image
+        if (!this->CopyOpenCVMatToImage(imageVector[i], result[i]))
+        {
+          // convert to MITK image
+          this->m_OpenCVToMitkFilter->SetOpenCVMat(imageVector[i]);
+          this->m_OpenCVToMitkFilter->Update();
+
+          // OpenCVToMitkImageFilter returns a standard mitk::image.
+          result[i] = this->m_OpenCVToMitkFilter->GetOutput();
+        }
       }
     }
   }
@@ -94,8 +120,73 @@ std::vector<mitk::Image::Pointer> mitk::USImageSource::GetNextImage()
     }
   }
   m_CurrentImageId++;
+}
 
-  return result;
+bool mitk::USImageSource::CopyOpenCVMatToImage(const cv::Mat& mat, mitk::Image::Pointer& image)
+{
+  if (mat.empty() || mat.dims != 2)
+  {
+    return false;
+  }
+
+  // same pixel types as produced by mitk::OpenCVToMitkImageFilter
+  mitk::PixelType pixelType = mitk::MakeScalarPixelType<unsigned char>();
+  if (mat.depth() == CV_8U && mat.channels() == 1)
+  {
+    pixelType = mitk::MakePixelType<itk::Image<unsigned char, 2> >();
+  }
+  else if (mat.depth() == CV_8U && mat.channels() == 3)
+  {
+    pixelType = mitk::MakePixelType<itk::Image<itk::RGBPixel<unsigned char>, 2> >();
+  }
+  else if (mat.depth() == CV_16U && mat.channels() == 1)
+  {
+    pixelType = mitk::MakePixelType<itk::Image<unsigned short, 2> >();
+  }
+  else if (mat.depth() == CV_32F && mat.channels() == 1)
+  {
+    pixelType = mitk::MakePixelType<itk::Image<float, 2> >();
+  }
+  else if (mat.depth() == CV_64F && mat.channels() == 1)
+  {
+    pixelType = mitk::MakePixelType<itk::Image<double, 2> >();
+  }
+  else
+  {
+    return false;
+  }
+
+  if (image.IsNull())
+  {
+    image = mitk::Image::New();
+  }
+
+  if (!image->IsInitialized() || image->GetDimension() != 2 ||
+    image->GetDimension(0) != static_cast<unsigned int>(mat.cols) ||
+    image->GetDimension(1) != static_cast<unsigned int>(mat.rows) ||
+    image->GetPixelType() != pixelType)
+  {
+    unsigned int dimensions[2] = { static_cast<unsigned int>(mat.cols), static_cast<unsigned int>(mat.rows) };
+    image->Initialize(pixelType, 2, dimensions);
+  }
+
+  // MITK expects RGB ordering and continuous memory
+  const cv::Mat* source = &mat;
+  if (mat.channels() == 3)
+  {
+    cv::cvtColor(mat, m_ConversionMat, cv::COLOR_BGR2RGB);
+    source = &m_ConversionMat;
+  }
+  else if (!mat.isContinuous())
+  {
+    mat.copyTo(m_ConversionMat);
+    source = &m_ConversionMat;
+  }
+
+  const void* data = source->data;
+  image->SetImportVolume(data);
+
+  return true;
 }
 
 void mitk::USImageSource::GetNextRawImage(std::vector<cv::Mat>& imageVector)
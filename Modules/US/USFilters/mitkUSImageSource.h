@@ -60,6 +60,17 @@ namespace mitk {
     */
     std::vector<mitk::Image::Pointer> GetNextImage();
 
+    /**
+    * \brief Retrieves the next frame into the given vector of images.
+    * Images already contained in the vector are reused if their dimensions
+    * and pixel type match the new frame, so no memory is allocated per frame
+    * when the vector is passed in again for every frame (e.g. by a frame
+    * pool of mitk::USDevice).
+    *
+    * \param images images to be reused, contains the next frame afterwards
+    */
+    void GetNextImage(std::vector<mitk::Image::Pointer>& images);
+
   protected:
     USImageSource();
     ~USImageSource() override;
@@ -79,6 +90,15 @@ namespace mitk {
     */
     virtual void GetNextRawImage(std::vector<mitk::Image::Pointer>&) = 0;
 
+    /**
+    * \brief Copies the pixel data of the given OpenCV image into the given
+    * mitk::Image. The image is only (re-)initialized if it is null or if its
+    * dimensions or pixel type do not match the OpenCV image.
+    *
+    * \return false if the pixel type of the OpenCV image is not supported
+    */
+    bool CopyOpenCVMatToImage(const cv::Mat& mat, mitk::Image::Pointer& image);
+
     /**
     * \brief Used to convert from OpenCV Images to MITK Images.
     */
@@ -97,6 +117,12 @@ namespace mitk {
     int                                        m_CurrentImageId;
 
     itk::FastMutexLock::Pointer m_ImageFilterMutex;
+
+    /**
+    * \brief Reused for color conversion of OpenCV images, so that no memory
+    * has to be allocated for every frame.
+    */
+    cv::Mat m_ConversionMat;
   };
 } // namespace mitk
 #endif /* MITKUSImageSource_H_HEADER_INCLUDED_ */
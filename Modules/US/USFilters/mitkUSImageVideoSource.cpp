@@ -204,14 +204,17 @@ void mitk::USImageVideoSource::GetNextRawImage(std::vector<mitk::Image::Pointer>
 
   this->GetNextRawImage(cv_img);
 
-  // convert to MITK-Image
-  IplImage ipl_img = cv_img[0];
+  // reuse the given image if possible, convert to MITK-Image otherwise
+  if (!this->CopyOpenCVMatToImage(cv_img[0], image[0]))
+  {
+    IplImage ipl_img = cv_img[0];
 
-  this->m_OpenCVToMitkFilter->SetOpenCVImage(&ipl_img);
-  this->m_OpenCVToMitkFilter->Update();
+    this->m_OpenCVToMitkFilter->SetOpenCVImage(&ipl_img);
+    this->m_OpenCVToMitkFilter->Update();
 
-  // OpenCVToMitkImageFilter returns a standard mitk::image. We then transform it into an USImage
-  image[0] = this->m_OpenCVToMitkFilter->GetOutput();
+    // OpenCVToMitkImageFilter returns a standard mitk::image. We then transform it into an USImage
+    image[0] = this->m_OpenCVToMitkFilter->GetOutput();
+  }
 
   // clean up
   cv_img[0].release();
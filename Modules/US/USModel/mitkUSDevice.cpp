@@ -50,7 +50,12 @@ mitk::USDevice::USDevice(std::string manufacturer, std::string model)
   m_ImageMutex(itk::FastMutexLock::New()),
   m_ThreadID(-1),
   m_ImageVector(),
+  m_FrameBuffer(mitk::USImageTripleBuffer::New()),
+  m_LatencyClock(mitk::RealTimeClock::New()),
+  m_FrameLatencyStatistics(),
+  m_FrameLatencyMutex(itk::FastMutexLock::New()),
   m_Spacing(),
+  m_SpacingIsCalibrated(false),
   m_IGTLServer(nullptr),
   m_IGTLMessageProvider(nullptr),
   m_ImageToIGTLMsgFilter(nullptr),
@@ -88,7 +93,12 @@ mitk::USDevice::USDevice(mitk::USImageMetadata::Pointer metadata)
   m_ImageMutex(itk::FastMutexLock::New()),
   m_ThreadID(-1),
   m_ImageVector(),
+  m_FrameBuffer(mitk::USImageTripleBuffer::New()),
+  m_LatencyClock(mitk::RealTimeClock::New()),
+  m_FrameLatencyStatistics(),
+  m_FrameLatencyMutex(itk::FastMutexLock::New()),
   m_Spacing(),
+  m_SpacingIsCalibrated(false),
   m_IGTLServer(nullptr),
   m_IGTLMessageProvider(nullptr),
   m_ImageToIGTLMsgFilter(nullptr),
@@ -329,6 +339,8 @@ bool mitk::USDevice::Activate()
 
     m_FreezeBarrier = itk::ConditionVariable::New();
 
+    this->ResetFrameLatencyStatistics();
+
     // spawn thread for aquire images if us device is active
     if (m_SpawnAcquireThread)
     {
@@ -567,10 +579,32 @@ output->Graft( graft );
 
 void mitk::USDevice::GrabImage()
 {
-  std::vector<mitk::Image::Pointer> image = this->GetUSImageSource()->GetNextImage();
-  m_ImageMutex->Lock();
-  this->SetImageVector(image);
-  m_ImageMutex->Unlock();
+  // the write frame is owned by this thread, so no locking is necessary here
+  mitk::USImageTripleBuffer::Frame& frame = m_FrameBuffer->GetWriteFrame();
+  // stamp before grabbing, so the latency includes the acquisition itself
+  frame.CaptureTime = m_LatencyClock->GetCurrentStamp();
+  this->GetUSImageSource()->GetNextImage(frame.Images);
+
+  m_FrameBuffer->PublishWriteFrame();
+}
+
+mitk::USDevice::FrameLatencyStatistics mitk::USDevice::GetFrameLatencyStatistics()
+{
+  m_FrameLatencyMutex->Lock();
+  FrameLatencyStatistics statistics = m_FrameLatencyStatistics;
+  m_FrameLatencyMutex->Unlock();
+
+  statistics.NumberOfDroppedFrames = m_FrameBuffer->GetNumberOfDroppedFrames();
+  return statistics;
+}
+
+void mitk::USDevice::ResetFrameLatencyStatistics()
+{
+  m_FrameLatencyMutex->Lock();
+  m_FrameLatencyStatistics = FrameLatencyStatistics();
+  m_FrameLatencyMutex->Unlock();
+
+  m_FrameBuffer->ResetNumberOfDroppedFrames();
 }
 
 //########### GETTER & SETTER ##################//
@@ -595,23 +629,16 @@ std::string mitk::USDevice::GetDeviceComment() { return m_Comment; }
 
 void mitk::USDevice::SetSpacing(double xSpacing, double ySpacing)
 {
+  // the spacing is applied to every frame in GenerateData(), because the
+  // images of the other slots of the frame buffer still have the old geometry
+  m_ImageMutex->Lock();
   m_Spacing[0] = xSpacing;
   m_Spacing[1] = ySpacing;
   m_Spacing[2] = 1;
+  m_SpacingIsCalibrated = true;
+  m_ImageMutex->Unlock();
 
-
-  if( m_ImageVector.size() > 0 )
-  {
-    for( size_t index = 0; index < m_ImageVector.size(); ++index )
-    {
-      auto& image = m_ImageVector[index];
-      if( image.IsNotNull() && image->IsInitialized() )
-      {
-        image->GetGeometry()->SetSpacing(m_Spacing);
-      }
-    }
-    this->Modified();
-  }
+  this->Modified();
   MITK_INFO << "Spacing: " << m_Spacing;
 }
 
@@ -619,6 +646,26 @@ void mitk::USDevice::GenerateData()
 {
   m_ImageMutex->Lock();
 
+  // take over the most recent frame of the acquisition thread (if any)
+  if (m_FrameBuffer->AcquireReadFrame())
+  {
+    mitk::USImageTripleBuffer::Frame& frame = m_FrameBuffer->GetReadFrame();
+    this->SetImageVector(frame.Images);
+
+    double latency = m_LatencyClock->GetCurrentStamp() - frame.CaptureTime;
+
+    m_FrameLatencyMutex->Lock();
+    FrameLatencyStatistics& statistics = m_FrameLatencyStatistics;
+    ++statistics.NumberOfFrames;
+    statistics.LastLatency = latency;
+    statistics.MeanLatency += (latency - statistics.MeanLatency) / statistics.NumberOfFrames;
+    if (latency > statistics.MaxLatency)
+    {
+      statistics.MaxLatency = latency;
+    }
+    m_FrameLatencyMutex->Unlock();
+  }
+
   for (unsigned int i = 0; i < m_ImageVector.size() && i < this->GetNumberOfIndexedOutputs(); ++i)
   {
     auto& image = m_ImageVector[i];
@@ -643,6 +690,10 @@ void mitk::USDevice::GenerateData()
       // copy contents of the given image into the member variable
       mitk::ImageReadAccessor inputReadAccessor(image);
       output->SetImportVolume(inputReadAccessor.GetData());
+      if (m_SpacingIsCalibrated)
+      {
+        image->GetGeometry()->SetSpacing(m_Spacing);
+      }
       output->SetGeometry(image->GetGeometry());
     }
   }  
@@ -24,6 +24,10 @@ See LICENSE.txt or http://www.mitk.org for details.
 #include "mitkUSProbe.h"
 #include <MitkUSExports.h>
 #include "mitkUSImageSource.h"
+#include "mitkUSImageTripleBuffer.h"
+
+// MitkIGTBase
+#include "mitkRealTimeClock.h"
 
 // MitkIGTL
 #include "mitkIGTLMessageProvider.h"
@@ -83,6 +87,19 @@ namespace mitk {
     itkSetMacro(SpawnAcquireThread, bool);
     itkGetMacro(SpawnAcquireThread, bool);
 
+    /**
+     * \brief Capture-to-display latency of the frames handed from the
+     * acquisition thread to the output of this device (all values in ms).
+     */
+    struct FrameLatencyStatistics
+    {
+      double LastLatency;
+      double MeanLatency;
+      double MaxLatency;
+      unsigned long NumberOfFrames;        ///< number of frames the latency was measured for
+      unsigned long NumberOfDroppedFrames; ///< frames overwritten by the acquisition before being displayed
+    };
+
     struct USImageCropArea
     {
       int cropLeft;
@@ -315,8 +332,22 @@ namespace mitk {
     itkGetMacro(DeviceState, DeviceStates)
     itkGetMacro(ServiceProperties, us::ServiceProperties)
 
+    /**
+    * \brief Grabs the next frame from the image source into the frame pool.
+    * Images of recycled frames are reused, so no memory has to be allocated
+    * for every frame. Called by the acquisition thread.
+    */
     void GrabImage();
 
+    /**
+    * \return latency statistics of all frames delivered by
+    * mitk::USDevice::GenerateData() since activation or the last call of
+    * mitk::USDevice::ResetFrameLatencyStatistics()
+    */
+    FrameLatencyStatistics GetFrameLatencyStatistics();
+
+    void ResetFrameLatencyStatistics();
+
     virtual void SetSpacing(double xSpacing, double ySpacing);
 
 
@@ -326,7 +357,7 @@ namespace mitk {
     itk::ConditionVariable::Pointer m_FreezeBarrier;
     itk::SimpleMutexLock        m_FreezeMutex;
     itk::MultiThreader::Pointer m_MultiThreader; ///< itk::MultiThreader used for thread handling
-    itk::FastMutexLock::Pointer m_ImageMutex; ///< mutex for images provided by the image source
+    itk::FastMutexLock::Pointer m_ImageMutex; ///< mutex for the images of m_ImageVector
     int m_ThreadID; ///< ID of the started thread
 
     virtual void SetImageVector(std::vector<mitk::Image::Pointer> vec)
@@ -341,10 +372,23 @@ namespace mitk {
     static ITK_THREAD_RETURN_TYPE Acquire(void* pInfoStruct);
     static ITK_THREAD_RETURN_TYPE ConnectThread(void* pInfoStruct);
 
-    std::vector<mitk::Image::Pointer> m_ImageVector;
+    std::vector<mitk::Image::Pointer> m_ImageVector; ///< images of the frame currently delivered to the outputs
+
+    /**
+    * \brief Frame pool shared between the acquisition thread and
+    * mitk::USDevice::GenerateData(). The producer fills its write frame
+    * without locking m_ImageMutex, so it never has to wait for the outputs
+    * being updated.
+    */
+    mitk::USImageTripleBuffer::Pointer m_FrameBuffer;
+
+    mitk::RealTimeClock::Pointer m_LatencyClock; ///< clock for the capture and display time stamps of frames
+    FrameLatencyStatistics       m_FrameLatencyStatistics;
+    itk::FastMutexLock::Pointer  m_FrameLatencyMutex;
 
     // Variables to determine if spacing was calibrated and needs to be applied to the incoming images
     mitk::Vector3D m_Spacing;
+    bool m_SpacingIsCalibrated;
 
     /**
     * \brief Registers an OpenIGTLink device as a microservice so that we can send the images of
@@ -0,0 +1,110 @@
+/*===================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center,
+Division of Medical and Biological Informatics.
+All rights reserved.
+
+This software is distributed WITHOUT ANY WARRANTY; without
+even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE.
+
+See LICENSE.txt or http://www.mitk.org for details.
+
+===================================================================*/
+
+#include "mitkUSImageTripleBuffer.h"
+
+#include <algorithm>
+
+mitk::USImageTripleBuffer::USImageTripleBuffer()
+  : m_WriteIndex(0),
+  m_PendingIndex(1),
+  m_ReadIndex(2),
+  m_PendingIsNew(false),
+  m_NextFrameId(0),
+  m_NumberOfDroppedFrames(0),
+  m_SwapMutex(itk::FastMutexLock::New())
+{
+  for (auto& frame : m_Frames)
+  {
+    frame.CaptureTime = 0;
+    frame.FrameId = 0;
+  }
+}
+
+mitk::USImageTripleBuffer::~USImageTripleBuffer()
+{
+}
+
+mitk::USImageTripleBuffer::Frame& mitk::USImageTripleBuffer::GetWriteFrame()
+{
+  return m_Frames[m_WriteIndex];
+}
+
+void mitk::USImageTripleBuffer::PublishWriteFrame()
+{
+  m_SwapMutex->Lock();
+  m_Frames[m_WriteIndex].FrameId = m_NextFrameId++;
+
+  if (m_PendingIsNew)
+  {
+    // consumer did not fetch the pending frame in time
+    ++m_NumberOfDroppedFrames;
+  }
+
+  std::swap(m_WriteIndex, m_PendingIndex);
+  m_PendingIsNew = true;
+  m_SwapMutex->Unlock();
+}
+
+bool mitk::USImageTripleBuffer::AcquireReadFrame()
+{
+  m_SwapMutex->Lock();
+  bool isNew = m_PendingIsNew;
+  if (isNew)
+  {
+    std::swap(m_ReadIndex, m_PendingIndex);
+    m_PendingIsNew = false;
+  }
+  m_SwapMutex->Unlock();
+
+  return isNew;
+}
+
+mitk::USImageTripleBuffer::Frame& mitk::USImageTripleBuffer::GetReadFrame()
+{
+  return m_Frames[m_ReadIndex];
+}
+
+unsigned long mitk::USImageTripleBuffer::GetNumberOfDroppedFrames()
+{
+  m_SwapMutex->Lock();
+  unsigned long numberOfDroppedFrames = m_NumberOfDroppedFrames;
+  m_SwapMutex->Unlock();
+
+  return numberOfDroppedFrames;
+}
+
+void mitk::USImageTripleBuffer::ResetNumberOfDroppedFrames()
+{
+  m_SwapMutex->Lock();
+  m_NumberOfDroppedFrames = 0;
+  m_SwapMutex->Unlock();
+}
+
+void mitk::USImageTripleBuffer::Clear()
+{
+  m_SwapMutex->Lock();
+  for (auto& frame : m_Frames)
+  {
+    frame.Images.clear();
+    frame.CaptureTime = 0;
+    frame.FrameId = 0;
+  }
+  m_PendingIsNew = false;
+  m_NextFrameId = 0;
+  m_NumberOfDroppedFrames = 0;
+  m_SwapMutex->Unlock();
+}
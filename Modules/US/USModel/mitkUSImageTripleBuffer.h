@@ -0,0 +1,127 @@
+/*===================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center,
+Division of Medical and Biological Informatics.
+All rights reserved.
+
+This software is distributed WITHOUT ANY WARRANTY; without
+even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE.
+
+See LICENSE.txt or http://www.mitk.org for details.
+
+===================================================================*/
+
+#ifndef MITKUSImageTripleBuffer_H_HEADER_INCLUDED_
+#define MITKUSImageTripleBuffer_H_HEADER_INCLUDED_
+
+// STL
+#include <vector>
+
+// MITK
+#include <MitkUSExports.h>
+#include <mitkCommon.h>
+#include <mitkImage.h>
+
+// ITK
+#include <itkObject.h>
+#include <itkObjectFactory.h>
+#include <itkFastMutexLock.h>
+
+namespace mitk {
+  /**
+  * \brief Preallocated pool of three frame slots shared between the acquisition
+  * thread of a mitk::USDevice and the consumer of its images.
+  *
+  * The producer always owns the write slot and the consumer always owns the
+  * read slot. Handing over a frame only exchanges slot indices under a mutex,
+  * so the producer never waits for the consumer to finish copying or rendering
+  * a frame and vice versa. Images of a slot are kept when the slot is recycled,
+  * which allows the producer to write new pixel data into already allocated
+  * images instead of creating new images for every frame.
+  *
+  * If the producer publishes a frame before the previously published one was
+  * acquired by the consumer, the older frame is dropped and counted.
+  *
+  * \ingroup US
+  */
+  class MITKUS_EXPORT USImageTripleBuffer : public itk::Object
+  {
+  public:
+    mitkClassMacroItkParent(USImageTripleBuffer, itk::Object);
+    itkFactorylessNewMacro(Self);
+
+    struct Frame
+    {
+      std::vector<mitk::Image::Pointer> Images;
+      double CaptureTime;     ///< time stamp (in ms) of the moment the frame was grabbed
+      unsigned long FrameId;  ///< consecutive number of the frame, set on publishing
+    };
+
+    /**
+    * \return slot which is exclusively owned by the producer until
+    * mitk::USImageTripleBuffer::PublishWriteFrame() is called
+    */
+    Frame& GetWriteFrame();
+
+    /**
+    * \brief Makes the current write frame available for the consumer and
+    * hands a free slot back to the producer.
+    */
+    void PublishWriteFrame();
+
+    /**
+    * \brief Exchanges the read frame with the most recently published frame.
+    *
+    * \return true if a new frame was published since the last call, false
+    * otherwise (read frame stays unchanged then)
+    */
+    bool AcquireReadFrame();
+
+    /**
+    * \return slot which is exclusively owned by the consumer until the next
+    * successful call of mitk::USImageTripleBuffer::AcquireReadFrame()
+    */
+    Frame& GetReadFrame();
+
+    /**
+    * \return number of frames which were published but overwritten before
+    * the consumer acquired them
+    */
+    unsigned long GetNumberOfDroppedFrames();
+
+    /**
+    * \brief Sets the number of dropped frames back to zero. In contrast to
+    * mitk::USImageTripleBuffer::Clear() this can be called while producer
+    * and consumer are running.
+    */
+    void ResetNumberOfDroppedFrames();
+
+    /**
+    * \brief Removes all images from the slots and resets frame counters.
+    * Must not be called while producer or consumer are working on a slot.
+    */
+    void Clear();
+
+  protected:
+    USImageTripleBuffer();
+    ~USImageTripleBuffer() override;
+
+  private:
+    Frame        m_Frames[3];
+
+    unsigned int m_WriteIndex;
+    unsigned int m_PendingIndex;
+    unsigned int m_ReadIndex;
+    bool         m_PendingIsNew;
+
+    unsigned long m_NextFrameId;
+    unsigned long m_NumberOfDroppedFrames;
+
+    itk::FastMutexLock::Pointer m_SwapMutex;
+  };
+} // namespace mitk
+
+#endif // MITKUSImageTripleBuffer_H_HEADER_INCLUDED_